@@ -1715,6 +1715,14 @@ double AlexTrajectoryGenerator::getStepDuration() {
     return trajectoryParameter.step_duration;
 }
 
+const PilotParameters &AlexTrajectoryGenerator::getPilotParameters() {
+    return pilotParameters;
+}
+
+const TrajectoryParameters &AlexTrajectoryGenerator::getTrajectoryParameters() {
+    return trajectoryParameter;
+}
+
 bool AlexTrajectoryGenerator::isTrajectoryFinished(double trajProgress) {
     double fracProgress = trajProgress / (double)trajectoryParameter.step_duration;
     if (fracProgress > 1.05) {
@@ -438,6 +438,16 @@ class AlexTrajectoryGenerator : public TrajectoryGenerator {
     void setTrajectoryStanceLeft();
 
     double getStepDuration();
+    /**
+     * \brief Get the pilot parameters (limb lengths) set by setPilotParameters()
+     *
+     */
+    const PilotParameters &getPilotParameters();
+    /**
+     * \brief Get the parameters of the current trajectory
+     *
+     */
+    const TrajectoryParameters &getTrajectoryParameters();
     /**
      * \brief Check if the trajectory has been completed based on last elapsed time
      * \param take in the progress of the current trajectory progress
@@ -22,18 +22,25 @@ void app_programStart(void) {
 }
 /******************************************************************************/
 void app_communicationReset(void) {
+    // Crutch entries are written by RPDO/SDO, get notified of changes instead of polling the OD
+    alexM.communicationReset(CO->SDO[0]);
 }
 /******************************************************************************/
 void app_programEnd(void) {
     printf("app_programEnd \n");
+    // summaries queued after the last mainline cycle
+    alexM.programAsync();
 }
 /******************************************************************************/
 void app_programAsync(uint16_t timer1msDiffy) {
+    alexM.programAsync();
 }
 
 void app_programControlLoop(void) {
     if (alexM.running) {
         alexM.hwStateUpdate();
         alexM.update();
+        // Send the new setpoints now rather than at the next CAN tick
+        CANrx_taskTmr_commitSetpoints();
     }
 }
@@ -39,6 +39,7 @@ pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
 
 static int mainline_epoll_fd; /*!< epoll file descriptor for mainline */
 static CO_time_t CO_time;     /*!< Object for current time */
+static CO_SYNCjitter_t SYNCjitter; /*!< Jitter measurement and phase correction of produced SYNC */
 bool readyToStart = false;    /*!< Flag used by control thread to indicate CAN stack functional */
 uint32_t tmr1msPrev = 0;
 
@@ -63,6 +64,7 @@ static void inc_period(struct period_info *pinfo);
 static void periodic_task_init(struct period_info *pinfo);
 static void wait_rest_of_period(struct period_info *pinfo);
 /* Forward declartion of CAN helper functions*/
+static void printSYNCjitter(void);
 void configureCANopen(int nodeId, int rtPriority, int CANdevice0Index, char *CANdevice);
 void CO_errExit(char *msg);              /*!< CAN object error code and exit program*/
 void CO_error(const uint32_t info);      /*!< send CANopen generic emergency message */
@@ -145,6 +147,10 @@ int main(int argc, char *argv[]) {
         /* Initialize time */
         CO_time_init(&CO_time, CO->SDO[0], &OD_time.epochTimeBaseMs, &OD_time.epochTimeOffsetMs, 0x2130);
 
+        /* Measure SYNC jitter from kernel transmit timestamps and keep SYNC on the timer grid */
+        if (CO_SYNCjitter_init(&SYNCjitter, CO->SYNC, true, TMR_TASK_INTERVAL_NS / 2) != CO_ERROR_NO)
+            printf("SYNC transmit timestamps are not supported, jitter is not measured\n");
+
         /* First time only initialization */
         if (firstRun) {
             firstRun = false;
@@ -156,12 +162,13 @@ int main(int argc, char *argv[]) {
             /* Init mainline */
             taskMain_init(mainline_epoll_fd, &OD_performance[ODA_performance_mainCycleMaxTime]);
             /* Configure epoll for rt_thread */
-            rt_thread_epoll_fd = epoll_create(2);
+            rt_thread_epoll_fd = epoll_create(3);
             if (rt_thread_epoll_fd == -1)
                 CO_errExit("Program init - epoll_create rt_thread failed");
             /* Init taskRT */
             CANrx_taskTmr_init(rt_thread_epoll_fd, TMR_TASK_INTERVAL_NS, &OD_performance[ODA_performance_timerCycleMaxTime]);
             OD_performance[ODA_performance_timerCycleTime] = TMR_TASK_INTERVAL_NS / 1000; /* informative */
+            CANrx_taskTmr_setSYNCjitter(&SYNCjitter);
 
             /* Create rt_thread */
             if (pthread_create(&rt_thread_id, NULL, rt_thread, NULL) != 0)
@@ -223,6 +230,7 @@ int main(int argc, char *argv[]) {
             CO_errExit("Program end - pthread_join failed");
         }
         app_programEnd();
+        printSYNCjitter();
         /* delete objects from memory */
         CANrx_taskTmr_close();
         taskMain_close();
@@ -249,6 +257,8 @@ static void *rt_thread(void *arg) {
             if (errno != EINTR) {
                 CO_error(0x12100000L + errno);
             }
+        } else if (CANrx_taskTmr_processCommit(ev.data.fd)) {
+            /* setpoints committed by the control loop were sent, interval is not advanced */
         } else if (CANrx_taskTmr_process(ev.data.fd)) {
             /* code was processed in the above function. Additional code process below */
             INCREMENT_1MS(CO_timer1ms);
@@ -319,6 +329,10 @@ static void inc_period(struct period_info *pinfo) {
 static void periodic_task_init(struct period_info *pinfo) {
     /* for simplicity, hardcoding a 1ms period */
     pinfo->period_ns = 8000000;
+#ifdef SIMULATED
+    /* simulated drives are advanced by SIMULATED_STEP per cycle, whatever the period */
+    pinfo->period_ns = (long)(SIMULATED_STEP * 1e9 / SIMULATED_TIME_SCALE);
+#endif
 
     clock_gettime(CLOCK_MONOTONIC, &(pinfo->next_period));
 }
@@ -360,4 +374,23 @@ void CO_errExit(char *msg) {
 void CO_error(const uint32_t info) {
     CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
     fprintf(stderr, "canopend generic error: 0x%X\n", info);
-}
\ No newline at end of file
+}
+static void printSYNCjitter(void) {
+    CO_SYNCjitter_stats_t stats;
+    CO_SYNCjitter_getStats(&SYNCjitter, &stats, false);
+    if (CO->CANmodule[0]->txTimestampDisabled) {
+        printf("SYNC transmit timestamps were disabled, the CAN driver does not provide them\n");
+    }
+    if (stats.noOfSamples == 0) {
+        return;
+    }
+    printf("SYNC period jitter over %u periods (%u not timestamped): min %+d us, max %+d us\n",
+           stats.noOfSamples, stats.noOfMissed, stats.periodDevMin / 1000, stats.periodDevMax / 1000);
+    printf("SYNC latency from timer tick: min %d us, mean %d us, max %d us, phase correction %d us\n",
+           stats.latencyMin / 1000, (int32_t)(stats.latencySum / stats.noOfSamples / 1000), stats.latencyMax / 1000, stats.advance / 1000);
+    for (int i = 0; i < CO_SYNC_JITTER_BINS; i++) {
+        if (stats.histogram[i] > 0) {
+            printf("  %s%4d us: %u\n", i == CO_SYNC_JITTER_BINS - 1 ? ">=" : "< ", (i + (i < CO_SYNC_JITTER_BINS - 1)) * CO_SYNC_JITTER_BIN_NS / 1000, stats.histogram[i]);
+        }
+    }
+}
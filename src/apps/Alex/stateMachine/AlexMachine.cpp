@@ -18,6 +18,11 @@ AlexMachine::AlexMachine() {
     downStairSelect = new DownStairSelect(this);
     isRPressed = new IsRPressed(this);
     resetButtonsPressed = new ResetButtons(this);
+    driveFault = new DriveFault(this);
+    trackingError = new TrackingError(this);
+    feedbackLost = new FeedbackLost(this);
+    homingSelect = new HomingSelect(this);
+    homingDone = new HomingDone(this);
 
     //States
     initState = new InitState(this, robot, trajectoryGenerator);
@@ -34,12 +39,35 @@ AlexMachine::AlexMachine() {
     steppingLastRight = new SteppingLastRight(this, robot, trajectoryGenerator);
     steppingLastLeft = new SteppingLastLeft(this, robot, trajectoryGenerator);
     errorState = new ErrorState(this, robot, trajectoryGenerator);
+    homingState = new HomingState(this, robot, trajectoryGenerator);
     backStepLeft = new BackStepLeft(this, robot, trajectoryGenerator);
     backStepRight = new BackStepRight(this, robot, trajectoryGenerator);
     steppingRightStair = new SteppingRightStair(this, robot, trajectoryGenerator);
     steppingLeftStair = new SteppingLeftStair(this, robot, trajectoryGenerator);
     steppingRightStairDown = new SteppingRightStairDown(this, robot, trajectoryGenerator);
     steppingLeftStairDown = new SteppingLeftStairDown(this, robot, trajectoryGenerator);
+    /**
+     * \brief Drive fault transitions, added first so they are checked before any other transition
+     * of the state (the fault is reported by updateRobot() in hwStateUpdate(), before update())
+     *
+     */
+    for (State *state : std::vector<State *>{initState, initialSitting, standing, sitting, standingUp, sittingDwn,
+                                             steppingFirstLeft, leftForward, steppingRight, rightForward, steppingLeft,
+                                             steppingLastRight, steppingLastLeft, backStepLeft, backStepRight,
+                                             steppingRightStair, steppingLeftStair, steppingRightStairDown, steppingLeftStairDown, homingState}) {
+        NewTransition(state, driveFault, errorState);
+    }
+    /**
+     * \brief Following error and stale feedback transitions of the moving states, after the drive faults (the limit
+     * is checked by moveThroughTraj() in during(), cleared by startNewTraj() in entry(), the feedback age by updateRobot())
+     *
+     */
+    for (State *state : std::vector<State *>{initialSitting, standingUp, sittingDwn, steppingFirstLeft, steppingRight,
+                                             steppingLeft, steppingLastRight, steppingLastLeft, backStepLeft, backStepRight,
+                                             steppingRightStair, steppingLeftStair, steppingRightStairDown, steppingLeftStairDown}) {
+        NewTransition(state, trackingError, errorState);
+        NewTransition(state, feedbackLost, errorState);
+    }
     /**
      * \brief Moving Trajectory Transitions
      *
@@ -58,6 +86,12 @@ AlexMachine::AlexMachine() {
      *
      */
     NewTransition(initState, startExo, initialSitting);
+    /**
+     * \brief Homing of the joints, from and back to the initialisation state
+     *
+     */
+    NewTransition(initState, homingSelect, homingState);
+    NewTransition(homingState, homingDone, initState);
     NewTransition(sitting, standSelect, standingUp);
     NewTransition(standing, sitSelect, sittingDwn);
     NewTransition(standing, walkSelect, steppingFirstLeft);
@@ -114,6 +148,13 @@ void AlexMachine::init() {
     robot->initialise();
     running = true;
 }
+/**
+ * \brief Subscribe the robot to changes of the crutch OD entries, called on every communication reset
+ *
+ */
+void AlexMachine::communicationReset(CO_SDO_t *SDO) {
+    robot->initCrutchNotifications(SDO);
+}
 
 ////////////////////////////////////////////////////////////////
 // Events ------------------------------------------------------------
@@ -234,7 +275,28 @@ bool AlexMachine::IsRPressed::check(void) {
     return OWNER->robot->buttons.getErrorButton();
 }
 bool AlexMachine::ResetButtons::check(void) {
-    return !(OWNER->robot->buttons.getErrorButton());
+    // drives must have left their fault (reset when the operator presses the error button, see ErrorState::during()),
+    // quick stop or following error too
+    return !(OWNER->robot->buttons.getErrorButton()) && (OWNER->robot->getDriveEvents() & DRIVE_EVENTS_STOP) == 0;
+}
+bool AlexMachine::DriveFault::check(void) {
+    return (OWNER->robot->getDriveEvents() & DRIVE_EVENTS_STOP) != 0;
+}
+bool AlexMachine::TrackingError::check(void) {
+    return OWNER->robot->isTrackingLimitExceeded();
+}
+bool AlexMachine::FeedbackLost::check(void) {
+    return !OWNER->robot->isFeedbackValid();
+}
+bool AlexMachine::HomingSelect::check(void) {
+    if (OWNER->robot->keyboard.getE()) {
+        std::cout << "LEAVING INIT and homing the joints" << endl;
+        return true;
+    }
+    return false;
+}
+bool AlexMachine::HomingDone::check(void) {
+    return !OWNER->robot->isHoming();
 }
 
 /**
@@ -245,3 +307,12 @@ bool AlexMachine::ResetButtons::check(void) {
 void AlexMachine::hwStateUpdate(void) {
     robot->updateRobot();
 }
+
+/**
+ * \brief Work of the state machine outside of the control loop, called from the mainline thread:
+ * file writes which would delay the control loop
+ *
+ */
+void AlexMachine::programAsync(void) {
+    robot->writeTrackingLog();
+}
@@ -47,6 +47,7 @@
 #include "BackStepLeft.h"
 #include "BackStepRight.h"
 #include "ErrorState.h"
+#include "HomingState.h"
 #include "InitState.h"
 #include "InitialSitting.h"
 #include "LeftForward.h"
@@ -77,10 +78,12 @@ class AlexMachine : public StateMachine {
      */
     AlexMachine();
     void init();
+    void communicationReset(CO_SDO_t *SDO);
     void activate();
     void deactivate();
 
     void hwStateUpdate();
+    void programAsync();
     State* gettCurState();
     void initRobot(AlexRobot* rb);
     bool trajComplete;
@@ -104,6 +107,7 @@ class AlexMachine : public StateMachine {
     SteppingLastRight* steppingLastRight;
     SteppingLastLeft* steppingLastLeft;
     ErrorState* errorState;
+    HomingState* homingState;
     BackStepLeft* backStepLeft;
     BackStepRight* backStepRight;
     SteppingLeftStair* steppingLeftStair;
@@ -136,6 +140,11 @@ class AlexMachine : public StateMachine {
     EventObject(BackStep) * backStep;
     EventObject(UpStairSelect) * upStairSelect;
     EventObject(DownStairSelect) * downStairSelect;
+    EventObject(DriveFault) * driveFault;
+    EventObject(TrackingError) * trackingError;
+    EventObject(FeedbackLost) * feedbackLost;
+    EventObject(HomingSelect) * homingSelect;
+    EventObject(HomingDone) * homingDone;
 
 };
 
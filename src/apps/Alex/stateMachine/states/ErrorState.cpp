@@ -6,6 +6,23 @@ void ErrorState::entry(void) {
               << "==================" << endl
               << "Reset -> R" << endl
               << "==================" << endl;
+    const JointStateBlock &joints = robot->getJointStateBlock();
+    for (int i = 0; i < joints.n; i++) {
+        if (joints.events[i] & DRIVE_EVENTS_STOP) {
+            std::cout << "Joint " << i << ": drive status word 0x" << std::hex << joints.status[i] << std::dec
+                      << ", state " << joints.state[i] << ", events 0x" << std::hex << joints.events[i] << std::dec << endl;
+        }
+    }
+    if (robot->isTrackingLimitExceeded()) {
+        const TrackingSummary &tracking = robot->getTrackingSummary();
+        std::cout << "Joint " << tracking.exceededJoint << ": following error " << tracking.last[tracking.exceededJoint] << " deg, "
+                  << (tracking.exceededRms ? "RMS " : "") << "limit exceeded" << endl;
+    }
+    for (int i = 0; i < joints.n; i++) {
+        if (!joints.valid[i]) {
+            std::cout << "Joint " << i << ": stale feedback, " << joints.age[i] << " SYNC cycles old" << endl;
+        }
+    }
     // /todo turn into function; disable joints
 
     // for (auto i = 0; i < NUM_JOINTS; i++) {
@@ -13,10 +30,24 @@ void ErrorState::entry(void) {
     // }
     // robot->copleyDrives[0]->setNextMotion(RobotMode::ERROR);
     robot->disableJoints();
+    // a press already held on entry (e.g. the one which stopped the robot) does not acknowledge the faults
+    errorButtonPressed = robot->buttons.getErrorButton();
+    resettingFaults = false;
 
     robot->setCurrentState(AlexState::Error);
 }
 void ErrorState::during(void) {
+    // faults are only reset once the operator acknowledged them by pressing the error button, the state
+    // is then left when it is released and no drive reports a fault (see AlexMachine::ResetButtons)
+    bool pressed = robot->buttons.getErrorButton();
+    if (pressed && !errorButtonPressed && !resettingFaults) {
+        std::cout << "Resetting drive faults" << endl;
+        resettingFaults = true;
+    }
+    errorButtonPressed = pressed;
+    if (resettingFaults) {
+        resettingFaults = robot->resetDriveFaults();
+    }
 }
 void ErrorState::exit(void) {
     DEBUG_OUT("EXITING ERROR STATE")
@@ -27,6 +27,12 @@ class ErrorState : public ExoTestState {
     void during(void);
     void exit(void);
     ErrorState(StateMachine *m, AlexRobot *exo, AlexTrajectoryGenerator *tg, const char *name = NULL) : ExoTestState(m, exo, tg, name){};
+
+   private:
+    /** Error button state of the last cycle, a press is detected on its rising edge */
+    bool errorButtonPressed = false;
+    /** The operator acknowledged the faults reported on entry, drive faults are reset until none is left */
+    bool resettingFaults = false;
 };
 
 #endif
\ No newline at end of file
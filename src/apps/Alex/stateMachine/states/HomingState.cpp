@@ -0,0 +1,20 @@
+#include "HomingState.h"
+
+void HomingState::entry(void) {
+    std::cout << "==================" << endl
+              << " HOMING JOINTS" << endl
+              << "==================" << endl;
+    robot->setCurrentState(AlexState::Homing);
+    homingStarted = robot->startHoming();
+}
+void HomingState::during(void) {
+    robot->updateHoming();
+}
+void HomingState::exit(void) {
+    robot->stopHoming();
+    if (!homingStarted) {
+        std::cout << "Nothing to home, no joint has a homing routine in the robot description" << endl;
+    } else {
+        std::cout << (robot->isHomingSuccessful() ? "Homing done" : "Homing FAILED, calibration of the failed joints unchanged") << endl;
+    }
+}
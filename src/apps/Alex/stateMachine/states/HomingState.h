@@ -0,0 +1,36 @@
+/**
+ * /file HomingState.h
+ * /author William Campbell
+ * /brief Homing state
+ * /version 0.1
+ * /date 2020-10-19
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef HomingState_H_INCLUDED
+#define HomingState_H_INCLUDED
+
+#include "ExoTestState.h"
+
+/**
+ * \brief Homing of the joints in process (see AlexRobot::startHoming()), instead of the homing scripts
+ * 
+ * All joints with a homing routine in the robot description are homed at once, and their calibration
+ * updated. Homing still running when the state is left (e.g. on a drive fault) is stopped.
+ * Control of transition is independent of this class and is defined in AlexMachine.
+ * 
+ */
+class HomingState : public ExoTestState {
+   public:
+    void entry(void);
+    void during(void);
+    void exit(void);
+    HomingState(StateMachine *m, AlexRobot *exo, AlexTrajectoryGenerator *tg, const char *name = NULL) : ExoTestState(m, exo, tg, name){};
+
+   private:
+    /** A joint has a homing routine, false if there was nothing to home */
+    bool homingStarted = false;
+};
+
+#endif
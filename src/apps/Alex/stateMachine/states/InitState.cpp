@@ -8,6 +8,7 @@ void InitState::entry(void) {
         << endl
         << "========================" << endl
         << " PRESS S to start program" << endl
+        << " PRESS E to home the joints" << endl
         << "========================" << endl;
     //Initialize OD entries - Must be something other then Initial -> must be sent by crutch @ startup
     robot->setCurrentState(AlexState::Init);
@@ -8,12 +8,12 @@ void InitialSitting::entry(void) {
 }
 void InitialSitting::during(void) {
     // w/o crutch Go button
-    //robot->pb.updateGO(true);
+    //robot->setGo(true);
     robot->moveThroughTraj();
 }
 void InitialSitting::exit(void) {
     // w/o crutch Go button
-    //robot->pb.updateGO(false);
+    //robot->setGo(false);
     DEBUG_OUT("Initial SITTING DOWN POS:")
     robot->printStatus();
     std::cout
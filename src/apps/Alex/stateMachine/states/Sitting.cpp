@@ -19,7 +19,7 @@ void Sitting::during() {
     //     std::cout << "Selected mode: " << robot->pb.printRobotMode(modeSelected) << std::endl;
     //     robot->setNextMotion(modeSelected);
     // }
-    //robot->pb.updateGO(robot->keyboard.getD());
+    //robot->setGo(robot->keyboard.getD());
     updateCrutch();
     updateFlag();
 }
@@ -13,12 +13,16 @@ void SittingDwn::entry(void) {
 }
 void SittingDwn::during(void) {
     // w/o crutch Go button
-    //robot->pb.updateGO(true);
+    //robot->setGo(true);
     robot->moveThroughTraj();
 }
 void SittingDwn::exit(void) {
     // w/o crutch Go button
-    //robot->pb.updateGO(false);
+    //robot->setGo(false);
+    // Seated again, back to position control (see StandingUp::entry())
+    if (robot->isIPControl() || robot->isCSPControl()) {
+        robot->initPositionControl();
+    }
     DEBUG_OUT("EXIT SITTING DOWN POS:")
     robot->printStatus();
     std::cout
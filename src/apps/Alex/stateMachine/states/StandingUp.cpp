@@ -6,6 +6,9 @@ void StandingUp::entry(void) {
               << " STANDING UP" << endl
               << " GREEN -> STAND UP" << endl
               << "===================" << endl;
+    // Seated, the drives can be switched: the motions up to sitting down again are fed into their buffers,
+    // or streamed every SYNC (see TRAJECTORY_CONTROL_MODE)
+    robot->initTrajectoryControl();
     trajectoryGenerator->initialiseTrajectory(RobotMode::STNDUP, robot->getJointStates());
     robot->startNewTraj();
     robot->setCurrentState(AlexState::StandingUp);
@@ -13,11 +16,11 @@ void StandingUp::entry(void) {
 
 void StandingUp::during(void) {
     // update go button do using keyboard d input.-> same as setting nm
-    //robot->pb.updateGO(true);
+    //robot->setGo(true);
     robot->moveThroughTraj();
 }
 void StandingUp::exit(void) {
-    //robot->pb.updateGO(false);
+    //robot->setGo(false);
     robot->printStatus();
     std::cout
         << "Standing up motion State Exited"
@@ -0,0 +1,196 @@
+/**
+ * CANopen Object Dictionary change notifications.
+ *
+ * @file        CO_ODnotify.c
+ * @author      William Campbell
+ * @copyright   2020
+ *
+ * See CO_ODnotify.h.
+ */
+
+
+#include "CO_ODnotify.h"
+#include <string.h>
+
+
+#define QUEUE_MASK (CO_ODNOTIFY_QUEUE_SIZE - 1U)
+
+#if (CO_ODNOTIFY_QUEUE_SIZE & QUEUE_MASK) != 0
+    #error CO_ODNOTIFY_QUEUE_SIZE must be power of 2
+#endif
+
+
+/* Push event into the queue, safe for multiple producers (bounded MPMC queue,
+ * each cell has sequence number: equal to position if cell is free, position+1
+ * if it is full). Returns false, if queue is full. */
+static bool_t queuePush(CO_ODnotify_t *notify, const CO_ODnotify_event_t *event) {
+    uint32_t pos = __atomic_load_n(&notify->head, __ATOMIC_RELAXED);
+    CO_ODnotify_cell_t *cell;
+
+    for(;;) {
+        int32_t diff;
+
+        cell = &notify->queue[pos & QUEUE_MASK];
+        diff = (int32_t)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - pos);
+        if(diff == 0) {
+            /* cell is free, claim it */
+            if(__atomic_compare_exchange_n(&notify->head, &pos, pos + 1U, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        }
+        else if(diff < 0) {
+            /* queue is full */
+            return false;
+        }
+        else {
+            /* other producer claimed the cell */
+            pos = __atomic_load_n(&notify->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->event = *event;
+    __atomic_store_n(&cell->sequence, pos + 1U, __ATOMIC_RELEASE);
+    return true;
+}
+
+
+/* Value of the OD variable, zero extended (CANopen and this processor are little endian) */
+static uint32_t readValue(const void *data, uint8_t length) {
+    uint32_t value = 0;
+
+    memcpy(&value, data, length);
+    return value;
+}
+
+
+/* OD function for subscribed entries. It is called by SDO server before the
+ * downloaded data are copied into OD and by RPDO after the data were copied.
+ * In both cases ODF_arg->data contains the new value. For more information see
+ * file CO_SDO.h. */
+static CO_SDO_abortCode_t CO_ODF_notify(CO_ODF_arg_t *ODF_arg) {
+    CO_ODnotify_t *notify;
+    uint8_t i;
+
+    notify = (CO_ODnotify_t*) ODF_arg->object;
+
+    if(ODF_arg->reading) {
+        return CO_SDO_AB_NONE;
+    }
+
+    for(i = 0; i < notify->noOfSubs; i++) {
+        CO_ODnotify_subscription_t *sub = &notify->subs[i];
+
+        if(sub->index == ODF_arg->index && sub->subIndex == ODF_arg->subIndex) {
+            CO_ODnotify_event_t event;
+
+            event.index = sub->index;
+            event.subIndex = sub->subIndex;
+            event.newValue = readValue(ODF_arg->data, sub->length);
+            /* exchange, as RPDO and SDO may write the same entry from different threads */
+            event.oldValue = __atomic_exchange_n(&sub->value, event.newValue, __ATOMIC_ACQ_REL);
+
+            if(event.oldValue != event.newValue && !queuePush(notify, &event)) {
+                __atomic_fetch_add(&notify->overflows, 1U, __ATOMIC_RELAXED);
+            }
+            break;
+        }
+    }
+
+    return CO_SDO_AB_NONE;
+}
+
+
+/******************************************************************************/
+void CO_ODnotify_init(CO_ODnotify_t *notify, CO_SDO_t *SDO) {
+    uint32_t i;
+
+    notify->SDO = SDO;
+    notify->noOfSubs = 0;
+    notify->head = 0;
+    notify->tail = 0;
+    notify->overflows = 0;
+    for(i = 0; i < CO_ODNOTIFY_QUEUE_SIZE; i++) {
+        notify->queue[i].sequence = i;
+    }
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_ODnotify_subscribe(CO_ODnotify_t *notify, uint16_t index, uint8_t subIndex) {
+    CO_ODnotify_subscription_t *sub;
+    uint16_t entryNo;
+    uint16_t length;
+    void *data;
+
+    entryNo = CO_OD_find(notify->SDO, index);
+    if(entryNo == 0xFFFF || subIndex > notify->SDO->OD[entryNo].maxSubIndex) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    length = CO_OD_getLength(notify->SDO, entryNo, subIndex);
+    data = CO_OD_getDataPointer(notify->SDO, entryNo, subIndex);
+    if(length == 0 || length > 4 || data == NULL) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    if(notify->noOfSubs >= CO_ODNOTIFY_MAX_SUBSCRIPTIONS) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* RPDOs write the OD (and call OD functions) with OD locked */
+    CO_LOCK_OD();
+    sub = &notify->subs[notify->noOfSubs];
+    sub->index = index;
+    sub->subIndex = subIndex;
+    sub->length = (uint8_t)length;
+    sub->value = readValue(data, sub->length);
+    notify->noOfSubs++;
+    CO_OD_configure(notify->SDO, index, CO_ODF_notify, (void*)notify, 0, 0);
+    CO_UNLOCK_OD();
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+bool_t CO_ODnotify_write(CO_ODnotify_t *notify, uint16_t index, uint8_t subIndex, uint32_t value) {
+    uint8_t i;
+
+    for(i = 0; i < notify->noOfSubs; i++) {
+        CO_ODnotify_subscription_t *sub = &notify->subs[i];
+
+        if(sub->index == index && sub->subIndex == subIndex) {
+            uint16_t entryNo = CO_OD_find(notify->SDO, index);
+            void *data = CO_OD_getDataPointer(notify->SDO, entryNo, subIndex);
+
+            CO_LOCK_OD();
+            memcpy(data, &value, sub->length);
+            __atomic_store_n(&sub->value, value, __ATOMIC_RELEASE);
+            CO_UNLOCK_OD();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/******************************************************************************/
+bool_t CO_ODnotify_pop(CO_ODnotify_t *notify, CO_ODnotify_event_t *event) {
+    uint32_t pos = notify->tail;
+    CO_ODnotify_cell_t *cell = &notify->queue[pos & QUEUE_MASK];
+
+    if((int32_t)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (pos + 1U)) < 0) {
+        /* queue is empty */
+        return false;
+    }
+
+    *event = cell->event;
+    /* free the cell for the next round */
+    __atomic_store_n(&cell->sequence, pos + CO_ODNOTIFY_QUEUE_SIZE, __ATOMIC_RELEASE);
+    notify->tail = pos + 1U;
+    return true;
+}
+
+
+/******************************************************************************/
+uint32_t CO_ODnotify_getOverflows(CO_ODnotify_t *notify) {
+    return __atomic_load_n(&notify->overflows, __ATOMIC_RELAXED);
+}
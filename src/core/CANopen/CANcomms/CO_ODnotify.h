@@ -0,0 +1,144 @@
+/**
+ * CANopen Object Dictionary change notifications.
+ *
+ * @file        CO_ODnotify.h
+ * @author      William Campbell
+ * @copyright   2020
+ *
+ * Application subscribes to OD entries (variables up to 4 bytes). When a
+ * subscribed entry is changed by a RPDO or by a SDO download, an event with the
+ * old and the new value is pushed into a lock-free queue. Application thread
+ * drains the queue with CO_ODnotify_pop() instead of polling the entries.
+ *
+ * Queue has multiple producers (RPDOs are processed by the CAN realtime thread,
+ * SDO by the mainline) and a single consumer.
+ *
+ * Notification is implemented as @ref CO_SDO_OD_function, so subscribed entries
+ * must not use another OD function. RPDO writes are notified only if
+ * RPDO_CALLS_EXTENSION is defined in CO_PDO.c. Application itself should
+ * write subscribed entries with CO_ODnotify_write(), which keeps the reference
+ * value of the subscription up to date (and generates no event).
+ */
+
+#ifndef CO_ODNOTIFY_H
+#define CO_ODNOTIFY_H
+
+#include <CO_driver.h>  // Must be included by CO_SDO.h due to typedefs being here.
+
+#include "CO_SDO.h"
+
+/** Maximum number of subscribed OD entries */
+#ifndef CO_ODNOTIFY_MAX_SUBSCRIPTIONS
+#define CO_ODNOTIFY_MAX_SUBSCRIPTIONS 16
+#endif
+
+/** Size of the event queue, must be power of 2 */
+#ifndef CO_ODNOTIFY_QUEUE_SIZE
+#define CO_ODNOTIFY_QUEUE_SIZE 64
+#endif
+
+/**
+ * Change of a subscribed OD entry.
+ */
+typedef struct {
+    uint16_t index;    /**< Index of the OD entry */
+    uint8_t subIndex;  /**< Subindex of the OD entry */
+    uint32_t oldValue; /**< Previous value (zero extended) */
+    uint32_t newValue; /**< New value (zero extended) */
+} CO_ODnotify_event_t;
+
+/**
+ * Subscribed OD entry.
+ */
+typedef struct {
+    uint16_t index;    /**< From CO_ODnotify_subscribe() */
+    uint8_t subIndex;  /**< From CO_ODnotify_subscribe() */
+    uint8_t length;    /**< Length of the variable in bytes (1 to 4) */
+    uint32_t value;    /**< Last notified value */
+} CO_ODnotify_subscription_t;
+
+/**
+ * Cell of the event queue.
+ */
+typedef struct {
+    uint32_t sequence;         /**< Position of the queue, for which the cell is free or full */
+    CO_ODnotify_event_t event; /**< Event */
+} CO_ODnotify_cell_t;
+
+/**
+ * OD notification object.
+ */
+typedef struct {
+    CO_SDO_t *SDO;                                                  /**< From CO_ODnotify_init() */
+    CO_ODnotify_subscription_t subs[CO_ODNOTIFY_MAX_SUBSCRIPTIONS]; /**< Subscribed entries */
+    uint8_t noOfSubs;                                               /**< Number of subscribed entries */
+    CO_ODnotify_cell_t queue[CO_ODNOTIFY_QUEUE_SIZE];               /**< Event queue */
+    uint32_t head;                                                  /**< Next position to push (producers) */
+    uint32_t tail;                                                  /**< Next position to pop (consumer) */
+    uint32_t overflows;                                             /**< Number of events lost, because queue was full */
+} CO_ODnotify_t;
+
+/**
+ * Initialize OD notification object, remove all subscriptions and clear the queue.
+ *
+ * Function must be called in the communication reset section, before
+ * subscriptions are made.
+ *
+ * @param notify This object will be initialized.
+ * @param SDO SDO server object.
+ */
+void CO_ODnotify_init(CO_ODnotify_t *notify, CO_SDO_t *SDO);
+
+/**
+ * Subscribe to changes of OD entry.
+ *
+ * Current value of the entry is taken as the reference for the first event.
+ *
+ * @param notify This object.
+ * @param index Index of the OD entry.
+ * @param subIndex Subindex of the OD entry.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT (entry does
+ * not exist or is longer than 4 bytes) or CO_ERROR_OUT_OF_MEMORY (too many
+ * subscriptions).
+ */
+CO_ReturnError_t CO_ODnotify_subscribe(CO_ODnotify_t *notify, uint16_t index, uint8_t subIndex);
+
+/**
+ * Write subscribed OD entry from the application.
+ *
+ * Value is written into OD and becomes the reference for the next event. No
+ * event is generated. Entries which are not subscribed are not written.
+ *
+ * @param notify This object.
+ * @param index Index of the OD entry.
+ * @param subIndex Subindex of the OD entry.
+ * @param value New value.
+ *
+ * @return true, if entry is subscribed and was written.
+ */
+bool_t CO_ODnotify_write(CO_ODnotify_t *notify, uint16_t index, uint8_t subIndex, uint32_t value);
+
+/**
+ * Get the oldest event from the queue.
+ *
+ * Must be called from one thread only.
+ *
+ * @param notify This object.
+ * @param [out] event Event.
+ *
+ * @return true, if event was returned, false if queue is empty.
+ */
+bool_t CO_ODnotify_pop(CO_ODnotify_t *notify, CO_ODnotify_event_t *event);
+
+/**
+ * Number of events lost, because queue was full. If it changes, application
+ * should read the subscribed entries directly.
+ *
+ * @param notify This object.
+ *
+ * @return Number of lost events since initialization.
+ */
+uint32_t CO_ODnotify_getOverflows(CO_ODnotify_t *notify);
+
+#endif
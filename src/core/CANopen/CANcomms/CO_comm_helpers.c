@@ -36,8 +36,8 @@
 const char spaceDelim[] = " \t\n\r\f\v";
 
 
-/* Storage for strtok_r. Functions here may be used within single thread only. */
-static char *strtokSavePtr = NULL;
+/* Storage for strtok_r. Each thread parses its own command line. */
+static __thread char *strtokSavePtr = NULL;
 
 
 /******************************************************************************/
@@ -86,7 +86,7 @@ int dtsHex(char *bufSdo, int bufSdoSize, char *strin);
  * Get token from currently parsing string.
  *
  * Function calls thread safe strtok_r function and returns token.
- * getTok itself may be used from one thread only.
+ * Parsing state is kept per thread, so each thread may parse its own string.
  *
  * @param initStr Same as first argument to strtok_r.
  * @param delim Same as second argument to strtok_r.
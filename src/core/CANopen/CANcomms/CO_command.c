@@ -33,6 +33,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -48,15 +49,55 @@
 
 #define STRING_BUFFER_SIZE (CO_COMMAND_SDO_BUFFER_SIZE * 4 + 100)
 #define LISTEN_BACKLOG 50
+#define MAX_EPOLL_EVENTS 16
+
+/* Connected client. Object is owned by command_thread and by each queued SDO
+ * request of that client, so socket is closed only after the last response. */
+typedef struct commandClient {
+    int fd;                  /* Client socket */
+    int refCount;            /* Number of owners, protected by clients_mtx */
+    int closed;              /* Client hung up, responses are discarded */
+    pthread_mutex_t fd_mtx;  /* Serialises responses from both threads */
+    char *buf;               /* Receive buffer for partially received lines */
+    size_t bufLen;           /* Number of bytes in buf */
+    struct commandClient *next; /* Next connected client, list owned by command_thread */
+} commandClient_t;
+
+/* Settings, which apply to single command. They are taken at the time command
+ * is received, so pipelined 'set' commands keep their order against SDOs. */
+typedef struct {
+    uint8_t node;                /* Default node */
+    uint16_t SDOtimeoutTime;     /* SDO timeout in milliseconds */
+    uint8_t blockTransferEnable; /* SDO block transfer enabled? */
+} commandSettings_t;
+
+/* SDO request waiting in SDO queue. */
+typedef struct commandSDOjob {
+    commandClient_t *client;
+    commandSettings_t settings;
+    size_t commandLength;
+    struct commandSDOjob *next;
+    char command[];              /* Zero terminated command line */
+} commandSDOjob_t;
 
 /* Globals */
 char *CO_command_socketPath = "/tmp/CO_command_socket"; /* Name of the local domain socket */
 
 /* Variables */
 static void *command_thread(void *arg);
+static void *command_SDO_thread(void *arg);
 static pthread_t command_thread_id;
-static void command_process(int fd, char *command, size_t commandLength);
+static pthread_t command_SDO_thread_id;
+static void command_process(commandClient_t *client, char *command, size_t commandLength, const commandSettings_t *settings);
+static void client_release(commandClient_t *client);
 static int fdSocket;
+static int fdEpoll;
+static pthread_mutex_t clients_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t SDOqueue_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t SDOqueue_cond = PTHREAD_COND_INITIALIZER;
+static commandSDOjob_t *SDOqueueHead = NULL;
+static commandSDOjob_t *SDOqueueTail = NULL;
+static commandClient_t *clientsHead = NULL; /* Connected clients */
 static unsigned short comm_net = 1;      /* default CAN net number */
 static uint8_t comm_node_default = 0xFF; /* CANopen Node ID number is undefined at startup. */
 static uint16_t SDOtimeoutTime = 500;    /* Timeout time for SDO transfer in milliseconds, if no response */
@@ -100,12 +141,31 @@ int CO_command_init(void) {
         exit(EXIT_FAILURE);
     }
 
-    /* Create thread */
+    /* Configure epoll for listening socket and clients */
+    fdEpoll = epoll_create(MAX_EPOLL_EVENTS);
+    if (fdEpoll == -1) {
+        perror("CO_command_init - epoll_create failed");
+        exit(EXIT_FAILURE);
+    } else {
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = NULL; /* NULL marks listening socket */
+        if (epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdSocket, &ev) == -1) {
+            perror("CO_command_init - epoll_ctl failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* Create threads */
     endProgram = 0;
     if (pthread_create(&command_thread_id, NULL, command_thread, NULL) != 0) {
         perror("CO_command_init - thread creation failed");
         exit(EXIT_FAILURE);
     }
+    if (pthread_create(&command_SDO_thread_id, NULL, command_SDO_thread, NULL) != 0) {
+        perror("CO_command_init - SDO thread creation failed");
+        exit(EXIT_FAILURE);
+    }
 
     return 0;
 }
@@ -128,16 +188,39 @@ int CO_command_clear(void) {
     strncpy(addr.sun_path, CO_command_socketPath, sizeof(addr.sun_path) - 1);
 
     if (connect(fd, (struct sockaddr *)&addr, sizeof(struct sockaddr_un)) == -1) {
+        close(fd);
         return -1;
     }
 
     close(fd);
 
-    /* Wait for thread to finish. */
+    /* Wait for threads to finish. */
     if (pthread_join(command_thread_id, NULL) != 0) {
         return -1;
     }
+    pthread_mutex_lock(&SDOqueue_mtx);
+    pthread_cond_signal(&SDOqueue_cond);
+    pthread_mutex_unlock(&SDOqueue_mtx);
+    if (pthread_join(command_SDO_thread_id, NULL) != 0) {
+        return -1;
+    }
+
+    /* Drop SDO requests not processed and clients still connected. */
+    while (SDOqueueHead != NULL) {
+        commandSDOjob_t *job = SDOqueueHead;
+        SDOqueueHead = job->next;
+        client_release(job->client);
+        free(job);
+    }
+    SDOqueueTail = NULL;
+    while (clientsHead != NULL) {
+        commandClient_t *client = clientsHead;
+        clientsHead = client->next;
+        client->closed = 1;
+        client_release(client);
+    }
 
+    close(fdEpoll);
     close(fdSocket);
 
     /* Remove socket from filesystem. */
@@ -149,32 +232,225 @@ int CO_command_clear(void) {
 }
 
 /******************************************************************************/
-static void *command_thread(void *arg) {
-    int fd;
+static void client_release(commandClient_t *client) {
+    int last;
+
+    pthread_mutex_lock(&clients_mtx);
+    last = (--client->refCount == 0);
+    pthread_mutex_unlock(&clients_mtx);
+
+    if (last) {
+        if (close(client->fd) == -1) {
+            CO_errorR(0x15900000L);
+        }
+        pthread_mutex_destroy(&client->fd_mtx);
+        free(client->buf);
+        free(client);
+    }
+}
+
+static void client_write(commandClient_t *client, const char *resp, int respLen) {
+    pthread_mutex_lock(&client->fd_mtx);
+    if (!client->closed) {
+        if (write(client->fd, resp, respLen) != respLen) {
+            CO_errorR(0x15200000L);
+        }
+    }
+    pthread_mutex_unlock(&client->fd_mtx);
+}
+
+/* Returns true, if command is SDO read or write, which may block for the SDO
+ * timeout. Other commands (NMT, set) are executed immediately. */
+static int command_isSDO(const char *command) {
+    const char *c = command;
+    int i;
+
+    /* skip '[<sequence>]' and up to two numerical tokens '[<net>] <node>' */
+    for (i = 0; i < 4; i++) {
+        size_t len;
+        while (*c != 0 && strchr(spaceDelim, *c) != NULL) c++;
+        len = strcspn(c, spaceDelim);
+        if (i > 0 && isdigit(c[0]) == 0) {
+            return (len == 1 && (c[0] == 'r' || c[0] == 'w')) ||
+                   (len == 4 && strncmp(c, "read", 4) == 0) ||
+                   (len == 5 && strncmp(c, "write", 5) == 0);
+        }
+        c += len;
+    }
+    return 0;
+}
+
+static void SDOqueue_push(commandClient_t *client, const char *command, size_t commandLength) {
+    commandSDOjob_t *job = (commandSDOjob_t *)malloc(sizeof(commandSDOjob_t) + commandLength + 1);
+
+    if (job == NULL) {
+        CO_errorR(0x15400000L);
+        return;
+    }
+    memcpy(job->command, command, commandLength);
+    job->command[commandLength] = 0;
+    job->commandLength = commandLength + 1;
+    job->settings.node = comm_node_default;
+    job->settings.SDOtimeoutTime = SDOtimeoutTime;
+    job->settings.blockTransferEnable = blockTransferEnable;
+    job->next = NULL;
+
+    pthread_mutex_lock(&clients_mtx);
+    client->refCount++;
+    job->client = client;
+    pthread_mutex_unlock(&clients_mtx);
+
+    pthread_mutex_lock(&SDOqueue_mtx);
+    if (SDOqueueTail == NULL) {
+        SDOqueueHead = job;
+    } else {
+        SDOqueueTail->next = job;
+    }
+    SDOqueueTail = job;
+    pthread_cond_signal(&SDOqueue_cond);
+    pthread_mutex_unlock(&SDOqueue_mtx);
+}
+
+/* Split received data into lines. SDO commands are queued, others are
+ * processed and answered immediately. */
+static void client_receive(commandClient_t *client) {
     ssize_t n;
-    char buf[STRING_BUFFER_SIZE];
+    char *line, *eol;
+
+    n = recv(client->fd, client->buf + client->bufLen, STRING_BUFFER_SIZE - client->bufLen - 1, MSG_DONTWAIT);
+    if (n <= 0) {
+        if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+            if (n == -1) {
+                CO_errorR(0x15800000L + errno);
+            }
+            /* Client hung up, drop it from epoll. Queued requests keep it alive. */
+            commandClient_t **c = &clientsHead;
+            while (*c != client) {
+                c = &(*c)->next;
+            }
+            *c = client->next;
+            epoll_ctl(fdEpoll, EPOLL_CTL_DEL, client->fd, NULL);
+            pthread_mutex_lock(&client->fd_mtx);
+            client->closed = 1;
+            pthread_mutex_unlock(&client->fd_mtx);
+            client_release(client);
+        }
+        return;
+    }
+    client->bufLen += n;
+
+    line = client->buf;
+    while ((eol = (char *)memchr(line, '\n', client->buf + client->bufLen - line)) != NULL) {
+        size_t len = eol - line;
+        commandSettings_t settings;
+
+        if (command_isSDO(line)) {
+            SDOqueue_push(client, line, len);
+        } else {
+            *eol = 0;
+            settings.node = comm_node_default;
+            settings.SDOtimeoutTime = SDOtimeoutTime;
+            settings.blockTransferEnable = blockTransferEnable;
+            command_process(client, line, len + 1, &settings);
+        }
+        line = eol + 1;
+    }
+
+    /* Keep partial line for next read. Line too long is discarded. */
+    client->bufLen -= line - client->buf;
+    if (client->bufLen >= STRING_BUFFER_SIZE - 1) {
+        CO_errorR(0x15300000L);
+        client->bufLen = 0;
+    } else if (line != client->buf) {
+        memmove(client->buf, line, client->bufLen);
+    }
+}
+
+/******************************************************************************/
+static void *command_thread(void *arg) {
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    int ready, i;
+
+    (void)arg;
 
     /* Almost endless loop */
     while (endProgram == 0) {
-        /* wait for new command */
-        fd = accept(fdSocket, NULL, NULL);
-        if (fd == -1) {
-            CO_errorR(0x15100000L);
+        ready = epoll_wait(fdEpoll, events, MAX_EPOLL_EVENTS, -1);
+        if (ready == -1) {
+            if (errno != EINTR) {
+                CO_errorR(0x15100000L + errno);
+            }
+            continue;
         }
 
-        /* Read command and send answer. */
-        while ((n = read(fd, buf, sizeof(buf) - 1)) > 0) {
-            buf[n++] = 0; /* terminate input string */
-            command_process(fd, buf, n);
+        for (i = 0; i < ready && endProgram == 0; i++) {
+            commandClient_t *client = (commandClient_t *)events[i].data.ptr;
+
+            if (client == NULL) {
+                /* new connection */
+                struct epoll_event ev;
+                int fd = accept(fdSocket, NULL, NULL);
+                if (fd == -1) {
+                    CO_errorR(0x15100000L);
+                    continue;
+                }
+                client = (commandClient_t *)calloc(1, sizeof(commandClient_t));
+                if (client != NULL) {
+                    client->buf = (char *)malloc(STRING_BUFFER_SIZE);
+                }
+                if (client == NULL || client->buf == NULL) {
+                    CO_errorR(0x15400000L);
+                    free(client);
+                    close(fd);
+                    continue;
+                }
+                client->fd = fd;
+                client->refCount = 1;
+                pthread_mutex_init(&client->fd_mtx, NULL);
+
+                ev.events = EPOLLIN;
+                ev.data.ptr = client;
+                if (epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fd, &ev) == -1) {
+                    CO_errorR(0x15100000L + errno);
+                    client_release(client);
+                } else {
+                    client->next = clientsHead;
+                    clientsHead = client;
+                }
+            } else {
+                client_receive(client);
+            }
         }
+    }
+
+    return NULL;
+}
+
+/******************************************************************************/
+static void *command_SDO_thread(void *arg) {
+    /* SDO transfers use single SDO client, so they are executed one by one in
+     * order of arrival from all clients. */
+    (void)arg;
+    while (endProgram == 0) {
+        commandSDOjob_t *job;
 
-        if (n == -1) {
-            CO_errorR(0x15800000L + errno);
+        pthread_mutex_lock(&SDOqueue_mtx);
+        while (SDOqueueHead == NULL && endProgram == 0) {
+            pthread_cond_wait(&SDOqueue_cond, &SDOqueue_mtx);
         }
+        job = SDOqueueHead;
+        if (job != NULL) {
+            SDOqueueHead = job->next;
+            if (SDOqueueHead == NULL) {
+                SDOqueueTail = NULL;
+            }
+        }
+        pthread_mutex_unlock(&SDOqueue_mtx);
 
-        /* close current communication */
-        if (close(fd) == -1) {
-            CO_errorR(0x15900000L);
+        if (job != NULL) {
+            command_process(job->client, job->command, job->commandLength, &job->settings);
+            client_release(job->client);
+            free(job);
         }
     }
 
@@ -182,7 +458,7 @@ static void *command_thread(void *arg) {
 }
 
 /******************************************************************************/
-static void command_process(int fd, char *command, size_t commandLength) {
+static void command_process(commandClient_t *client, char *command, size_t commandLength, const commandSettings_t *settings) {
     int err = 0; /* syntax or other error, true or false */
     int emptyLine = 0;
     char *token;
@@ -230,7 +506,7 @@ static void command_process(int fd, char *command, size_t commandLength) {
     if (err == 0) {
         switch (i) {
             case 0:                            /* only <command> (pointed by token) */
-                comm_node = comm_node_default; /* may be undefined */
+                comm_node = settings->node;    /* may be undefined */
                 break;
             case 1: /* <node> and <command> tokens */
                 if (ui[0] < 0 || ui[0] > 127) {
@@ -308,8 +584,8 @@ static void command_process(int fd, char *command, size_t commandLength) {
                     sizeof(dataRx),
                     &dataRxLen,
                     &SDOabortCode,
-                    SDOtimeoutTime,
-                    blockTransferEnable);
+                    settings->SDOtimeoutTime,
+                    settings->blockTransferEnable);
 
                 if (err != 0) {
                     respErrorCode = respErrorInternalState;
@@ -387,8 +663,8 @@ static void command_process(int fd, char *command, size_t commandLength) {
                     dataTx,
                     dataTxLen,
                     &SDOabortCode,
-                    SDOtimeoutTime,
-                    blockTransferEnable);
+                    settings->SDOtimeoutTime,
+                    settings->blockTransferEnable);
 
                 if (err != 0) {
                     respErrorCode = respErrorInternalState;
@@ -551,9 +827,7 @@ static void command_process(int fd, char *command, size_t commandLength) {
     resp[respLen++] = '\n';
     resp[respLen++] = '\0';
 
-    if (write(fd, resp, respLen) != respLen) {
-        CO_errorR(0x15200000L);
-    }
+    client_write(client, resp, respLen);
 }
 /******************************************************************************/
 void cancomm_socketFree(char *command, char **ret) {
@@ -54,6 +54,13 @@ extern char *CO_command_socketPath;
 /**
  * Initialize thread and create socket for command interface.
  *
+ * Any number of clients may be connected at the same time. Each command is a
+ * line terminated by '\n' and starts with "[<sequence>]". Clients may send
+ * several commands without waiting for responses. NMT and set commands are
+ * answered immediately, SDO read and write commands are queued and executed
+ * one by one on the SDO client. Responses are therefore not necessarily in
+ * order of requests; match them by "[<sequence>]".
+ *
  * Make sure, that global variable CO was properly initialized before this call.
  *
  * @return 0 on success.
@@ -63,6 +70,9 @@ int CO_command_init(void);
 /**
  * Terminate thread and remove socket.
  *
+ * Clients still connected are disconnected and SDO requests not processed yet
+ * are dropped, so the function may be followed by CO_command_init() again.
+ *
  * @return 0 on success.
  */
 int CO_command_clear(void);
@@ -65,6 +65,7 @@
 
 /* Global variables ***********************************************************/
     extern const CO_OD_entry_t CO_OD[CO_OD_NoOfElements];  /* Object Dictionary array */
+    extern const CO_OD_index_t CO_OD_index;                /* Object Dictionary index table */
     static CO_t COO;
     CO_t *CO = NULL;
 
@@ -150,6 +151,61 @@
 #endif
 
 
+/* Helper function for PDO processing *****************************************/
+/*
+ * Rebuild lists of active PDOs.
+ *
+ * PDO is active, if it is valid and NMT state is operational. Only active PDOs
+ * are processed every cycle. Inactive PDOs are set here into the state, in
+ * which CO_RPDO_process() and CO_TPDO_process() would leave them, so they
+ * start from it, when they become active again.
+ */
+static void CO_PDOlistsUpdate(CO_t *CO){
+    int16_t i;
+    bool_t operational;
+
+    /* Take the counter first. Change during the rebuild is caught next time. */
+    CO->PDOlistsCounter = CO->PDOconfigCounter;
+    CO->PDOlistsState = CO->NMT->operatingState;
+    operational = (CO->PDOlistsState == CO_NMT_OPERATIONAL) ? true : false;
+
+    CO->noOfRPDOactive = 0;
+    for(i=0; i<CO_NO_RPDO; i++){
+        CO_RPDO_t *RPDO = CO->RPDO[i];
+
+        if(operational && RPDO->valid){
+            CO->RPDOactive[CO->noOfRPDOactive++] = RPDO;
+        }
+        else{
+            RPDO->CANrxNew[0] = RPDO->CANrxNew[1] = false;
+        }
+    }
+
+    CO->noOfTPDOactive = 0;
+    for(i=0; i<CO_NO_TPDO; i++){
+        CO_TPDO_t *TPDO = CO->TPDO[i];
+
+        if(operational && TPDO->valid){
+            CO->TPDOactive[CO->noOfTPDOactive++] = TPDO;
+        }
+        else{
+            /* Force TPDO first send after operational or valid, timers expired. */
+            TPDO->sendRequest = (TPDO->TPDOCommPar->transmissionType>=254) ? 1 : 0;
+            TPDO->inhibitTimer = 0;
+            TPDO->eventTimer = 0;
+        }
+    }
+}
+
+
+/* Rebuild lists of active PDOs, if PDO configuration or NMT state changed. */
+static void CO_PDOlistsVerify(CO_t *CO){
+    if(CO->PDOlistsCounter != CO->PDOconfigCounter || CO->PDOlistsState != CO->NMT->operatingState){
+        CO_PDOlistsUpdate(CO);
+    }
+}
+
+
 /* Helper function for NMT master *********************************************/
 #if CO_NO_NMT_MASTER == 1
     CO_CANtx_t *NMTM_txBuff = 0;
@@ -402,6 +458,12 @@ CO_ReturnError_t CO_init(
 
     if(err){CO_delete(CANbaseAddress); return err;}
 
+    /* Constant time CO_OD_find(). If table is out of date, OD is searched instead. */
+    for (i=0; i<CO_NO_SDO_SERVER; i++)
+    {
+        CO_OD_setIndex(CO->SDO[i], &CO_OD_index);
+    }
+
 
     err = CO_EM_init(
             CO->em,
@@ -471,6 +533,7 @@ CO_ReturnError_t CO_init(
                 CO->SDO[0],
                 CO->SYNC,
                &CO->NMT->operatingState,
+               &CO->PDOconfigCounter,
                 nodeId,
                 ((i<4) ? (CO_CAN_ID_RPDO_1+i*0x100) : 0),
                 0,
@@ -491,6 +554,7 @@ CO_ReturnError_t CO_init(
                 CO->em,
                 CO->SDO[0],
                &CO->NMT->operatingState,
+               &CO->PDOconfigCounter,
                 nodeId,
                 ((i<4) ? (CO_CAN_ID_TPDO_1+i*0x100) : 0),
                 0,
@@ -504,6 +568,8 @@ CO_ReturnError_t CO_init(
         if(err){CO_delete(CANbaseAddress); return err;}
     }
 
+    CO_PDOlistsUpdate(CO);
+
 
     err = CO_HBconsumer_init(
             CO->HBcons,
@@ -681,8 +747,9 @@ bool_t CO_process_SYNC_RPDO(
             break;
     }
 
-    for(i=0; i<CO_NO_RPDO; i++){
-        CO_RPDO_process(CO->RPDO[i], syncWas);
+    CO_PDOlistsVerify(CO);
+    for(i=0; i<CO->noOfRPDOactive; i++){
+        CO_RPDO_process(CO->RPDOactive[i], syncWas);
     }
 
     return syncWas;
@@ -698,8 +765,10 @@ void CO_process_TPDO(
     int16_t i;
 
     /* Verify PDO Change Of State and process PDOs */
-    for(i=0; i<CO_NO_TPDO; i++){
-        if(!CO->TPDO[i]->sendRequest) CO->TPDO[i]->sendRequest = CO_TPDOisCOS(CO->TPDO[i]);
-        CO_TPDO_process(CO->TPDO[i], CO->SYNC, syncWas, timeDifference_us);
+    CO_PDOlistsVerify(CO);
+    for(i=0; i<CO->noOfTPDOactive; i++){
+        CO_TPDO_t *TPDO = CO->TPDOactive[i];
+        if(!TPDO->sendRequest) TPDO->sendRequest = CO_TPDOisCOS(TPDO);
+        CO_TPDO_process(TPDO, CO->SYNC, syncWas, timeDifference_us);
     }
 }
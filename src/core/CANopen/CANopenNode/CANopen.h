@@ -130,6 +130,13 @@ typedef struct{
     CO_SYNC_t          *SYNC;           /**< SYNC object */
     CO_RPDO_t          *RPDO[CO_NO_RPDO];/**< RPDO objects */
     CO_TPDO_t          *TPDO[CO_NO_TPDO];/**< TPDO objects */
+    CO_RPDO_t          *RPDOactive[CO_NO_RPDO];/**< Valid RPDOs in NMT operational, processed by CO_process_SYNC_RPDO() */
+    CO_TPDO_t          *TPDOactive[CO_NO_TPDO];/**< Valid TPDOs in NMT operational, processed by CO_process_TPDO() */
+    uint16_t            noOfRPDOactive; /**< Number of RPDOs in RPDOactive */
+    uint16_t            noOfTPDOactive; /**< Number of TPDOs in TPDOactive */
+    volatile uint32_t   PDOconfigCounter;/**< Incremented by PDO objects, when their communication parameter is configured */
+    uint32_t            PDOlistsCounter;/**< PDOconfigCounter, when active PDO lists were built */
+    CO_NMT_internalState_t PDOlistsState;/**< NMT operating state, when active PDO lists were built */
     CO_HBconsumer_t    *HBcons;         /**<  Heartbeat consumer object*/
 #if CO_NO_SDO_CLIENT == 1
     CO_SDOclient_t     *SDOclient;      /**< SDO client object */
@@ -216,6 +223,8 @@ CO_NMT_reset_cmd_t CO_process(
  *
  * Function must be called cyclically from real time thread with constant
  * interval (1ms typically). It processes SYNC and receive PDO CANopen objects.
+ * Only valid RPDOs are processed, and only in NMT operational state. List of
+ * them is rebuilt, when PDO communication parameter or NMT state changes.
  *
  * @param CO This object.
  * @param timeDifference_us Time difference from previous function call in [microseconds].
@@ -232,6 +241,8 @@ bool_t CO_process_SYNC_RPDO(
  *
  * Function must be called cyclically from real time thread with constant.
  * interval (1ms typically). It processes transmit PDO CANopen objects.
+ * Only valid TPDOs are processed, and only in NMT operational state (see
+ * CO_process_SYNC_RPDO()).
  *
  * @param CO This object.
  * @param syncWas True, if CANopen SYNC message was just received or transmitted.
@@ -72,27 +72,13 @@ static void CO_PDO_receive(void *object, const CO_CANrxMsg_t *msg){
     {
         if(RPDO->synchronous && RPDO->SYNC->CANrxToggle) {
             /* copy data into second buffer and set 'new message' flag */
-            RPDO->CANrxData[1][0] = msg->data[0];
-            RPDO->CANrxData[1][1] = msg->data[1];
-            RPDO->CANrxData[1][2] = msg->data[2];
-            RPDO->CANrxData[1][3] = msg->data[3];
-            RPDO->CANrxData[1][4] = msg->data[4];
-            RPDO->CANrxData[1][5] = msg->data[5];
-            RPDO->CANrxData[1][6] = msg->data[6];
-            RPDO->CANrxData[1][7] = msg->data[7];
+            memcpy(RPDO->CANrxData[1], msg->data, 8);
 
             RPDO->CANrxNew[1] = true;
         }
         else {
             /* copy data into default buffer and set 'new message' flag */
-            RPDO->CANrxData[0][0] = msg->data[0];
-            RPDO->CANrxData[0][1] = msg->data[1];
-            RPDO->CANrxData[0][2] = msg->data[2];
-            RPDO->CANrxData[0][3] = msg->data[3];
-            RPDO->CANrxData[0][4] = msg->data[4];
-            RPDO->CANrxData[0][5] = msg->data[5];
-            RPDO->CANrxData[0][6] = msg->data[6];
-            RPDO->CANrxData[0][7] = msg->data[7];
+            memcpy(RPDO->CANrxData[0], msg->data, 8);
 
             RPDO->CANrxNew[0] = true;
         }
@@ -100,13 +86,93 @@ static void CO_PDO_receive(void *object, const CO_CANrxMsg_t *msg){
 }
 
 
+/*
+ * Copy PDO data. Lengths of standard variables are copied with single load and
+ * store. Data in PDO and in Object Dictionary are not necessary aligned.
+ */
+static inline void CO_PDOcopy(uint8_t *dest, const uint8_t *src, uint8_t length){
+    switch(length){
+        case 1: *dest = *src; break;
+        case 2: memcpy(dest, src, 2); break;
+        case 4: memcpy(dest, src, 4); break;
+        case 8: memcpy(dest, src, 8); break;
+        default: memcpy(dest, src, length); break;
+    }
+}
+
+
+/*
+ * Copy PDO data into mapped objects (unpack == true) or mapped objects into PDO
+ * data (unpack == false), as compiled in the copy operations.
+ */
+static inline void CO_PDOcopyMapped(const CO_PDOmapOp_t *op, uint8_t noOfOps, uint8_t *PDOdata, bool_t unpack){
+    for(; noOfOps>0; noOfOps--, op++){
+        uint8_t *pPDOdata = &PDOdata[op->offset];
+#ifdef CO_BIG_ENDIAN
+        if(op->swap){
+            uint8_t i;
+            for(i=0; i<op->length; i++){
+                if(unpack) op->pData[op->length-1-i] = pPDOdata[i];
+                else       pPDOdata[i] = op->pData[op->length-1-i];
+            }
+            continue;
+        }
+#endif
+        if(unpack) CO_PDOcopy(op->pData, pPDOdata, op->length);
+        else       CO_PDOcopy(pPDOdata, op->pData, op->length);
+    }
+}
+
+
+/*
+ * Add mapped object to the copy operations of the PDO.
+ *
+ * If object follows the previous one in memory, previous copy operation is
+ * extended. So contiguous mapping is copied by single operation.
+ *
+ * @param ops Array of copy operations.
+ * @param pNoOfOps Pointer to number of operations in ops, incremented if operation is added.
+ * @param pData Pointer to data of mapped object.
+ * @param offset Position of the object in PDO data.
+ * @param length Length of the object in PDO in bytes.
+ * @param swap True, if byte order must be reversed.
+ */
+static void CO_PDOaddMapOp(
+        CO_PDOmapOp_t          *ops,
+        uint8_t                *pNoOfOps,
+        uint8_t                *pData,
+        uint8_t                 offset,
+        uint8_t                 length,
+        uint8_t                 swap)
+{
+    CO_PDOmapOp_t *op;
+
+    if(length == 0) return;
+
+    if(*pNoOfOps > 0){
+        op = &ops[*pNoOfOps - 1];
+        if(!swap && !op->swap && (op->pData + op->length) == pData){
+            op->length += length;
+            return;
+        }
+    }
+
+    op = &ops[(*pNoOfOps)++];
+    op->pData = pData;
+    op->offset = offset;
+    op->length = length;
+    op->swap = swap;
+    op->COS = CO_PDO_COS_NONE;
+}
+
+
 /*
  * Configure RPDO Communication parameter.
  *
  * Function is called from commuincation reset or when parameter changes.
  *
- * Function configures following variable from CO_RPDO_t: _valid_. It also
- * configures CAN rx buffer. If configuration fails, emergency message is send
+ * Function configures following variable from CO_RPDO_t: _valid_ and increments
+ * _configCounter_. It also configures CAN rx buffer. If configuration fails, emergency message is send
  * and device is not able to enter NMT operational.
  *
  * @param RPDO RPDO object.
@@ -143,6 +209,9 @@ static void CO_RPDOconfigCom(CO_RPDO_t* RPDO, uint32_t COB_IDUsedByRPDO){
         RPDO->valid = false;
         RPDO->CANrxNew[0] = RPDO->CANrxNew[1] = false;
     }
+    if(RPDO->configCounter != NULL){
+        (*RPDO->configCounter)++;
+    }
 }
 
 
@@ -151,8 +220,8 @@ static void CO_RPDOconfigCom(CO_RPDO_t* RPDO, uint32_t COB_IDUsedByRPDO){
  *
  * Function is called from commuincation reset or when parameter changes.
  *
- * Function configures following variable from CO_TPDO_t: _valid_. It also
- * configures CAN tx buffer. If configuration fails, emergency message is send
+ * Function configures following variable from CO_TPDO_t: _valid_ and increments
+ * _configCounter_. It also configures CAN tx buffer. If configuration fails, emergency message is send
  * and device is not able to enter NMT operational.
  *
  * @param TPDO TPDO object.
@@ -187,6 +256,9 @@ static void CO_TPDOconfigCom(CO_TPDO_t* TPDO, uint32_t COB_IDUsedByTPDO, uint8_t
     if(TPDO->CANtxBuff == 0){
         TPDO->valid = false;
     }
+    if(TPDO->configCounter != NULL){
+        (*TPDO->configCounter)++;
+    }
 }
 
 
@@ -202,6 +274,7 @@ static void CO_TPDOconfigCom(CO_TPDO_t* TPDO, uint32_t COB_IDUsedByTPDO, uint8_t
  * @param pLength Pointer to returning parameter: *add* length of mapped variable.
  * @param pSendIfCOSFlags Pointer to returning parameter: sendIfCOSFlags variable.
  * @param pIsMultibyteVar Pointer to returning parameter: true for multibyte variable.
+ * @param pEntryNo Pointer to returning parameter: entry number of mapped object, 0xFFFF for dummy entry.
  *
  * @return 0 on success, otherwise SDO abort code.
  */
@@ -212,7 +285,8 @@ static CO_SDO_abortCode_t CO_PDOfindMap(
         uint8_t               **ppData,
         uint8_t                *pLength,
         uint8_t                *pSendIfCOSFlags,
-        uint8_t                *pIsMultibyteVar)
+        uint8_t                *pIsMultibyteVar,
+        uint16_t               *pEntryNo)
 {
     uint16_t entryNo;
     uint16_t index;
@@ -224,6 +298,8 @@ static CO_SDO_abortCode_t CO_PDOfindMap(
     index = (uint16_t)(map>>16);
     subIndex = (uint8_t)(map>>8);
     dataLen = (uint8_t) map;   /* data length in bits */
+    *pEntryNo = 0xFFFF;
+    *pIsMultibyteVar = 0;
 
     /* data length must be byte aligned */
     if(dataLen&0x07) return CO_SDO_AB_NO_MAP;   /* Object cannot be mapped to the PDO. */
@@ -260,6 +336,7 @@ static CO_SDO_abortCode_t CO_PDOfindMap(
     /* Does object exist in OD? */
     if(entryNo == 0xFFFF || subIndex > SDO->OD[entryNo].maxSubIndex)
         return CO_SDO_AB_NOT_EXIST;   /* Object does not exist in the object dictionary. */
+    *pEntryNo = entryNo;
 
     attr = CO_OD_getAttribute(SDO, entryNo, subIndex);
     /* Is object Mappable for RPDO? */
@@ -300,8 +377,8 @@ static CO_SDO_abortCode_t CO_PDOfindMap(
  *
  * Function is called from communication reset or when parameter changes.
  *
- * Function configures following variables from CO_RPDO_t: _dataLength_ and
- * _mapPointer_.
+ * Function configures following variables from CO_RPDO_t: _dataLength_,
+ * _mapOps_, _noOfMapOps_, _mapEntryNo_ and _noOfMapEntries_.
  *
  * @param RPDO RPDO object.
  * @param noOfMappedObjects Number of mapped object (from OD).
@@ -314,8 +391,10 @@ static CO_SDO_abortCode_t CO_RPDOconfigMap(CO_RPDO_t* RPDO, uint8_t noOfMappedOb
     CO_SDO_abortCode_t ret = CO_SDO_AB_NONE;
     const uint32_t* pMap = &RPDO->RPDOMapPar->mappedObject1;
 
+    RPDO->noOfMapOps = 0;
+    RPDO->noOfMapEntries = 0;
+
     for(i=noOfMappedObjects; i>0; i--){
-        int16_t j;
         uint8_t* pData;
         uint8_t dummy = 0;
         uint8_t prevLength = length;
@@ -330,29 +409,23 @@ static CO_SDO_abortCode_t CO_RPDOconfigMap(CO_RPDO_t* RPDO, uint8_t noOfMappedOb
                 &pData,
                 &length,
                 &dummy,
-                &MBvar);
+                &MBvar,
+                &RPDO->mapEntryNo[RPDO->noOfMapEntries]);
         if(ret){
             length = 0;
+            RPDO->noOfMapOps = 0;
+            RPDO->noOfMapEntries = 0;
             CO_errorReport(RPDO->em, CO_EM_PDO_WRONG_MAPPING, CO_EMC_PROTOCOL_ERROR, map);
             break;
         }
+        RPDO->noOfMapEntries++;
 
-        /* write PDO data pointers */
+        /* add copy operation */
 #ifdef CO_BIG_ENDIAN
-        if(MBvar){
-            for(j=length-1; j>=prevLength; j--)
-                RPDO->mapPointer[j] = pData++;
-        }
-        else{
-            for(j=prevLength; j<length; j++)
-                RPDO->mapPointer[j] = pData++;
-        }
+        CO_PDOaddMapOp(RPDO->mapOps, &RPDO->noOfMapOps, pData, prevLength, length - prevLength, MBvar);
 #else
-        for(j=prevLength; j<length; j++){
-            RPDO->mapPointer[j] = pData++;
-        }
+        CO_PDOaddMapOp(RPDO->mapOps, &RPDO->noOfMapOps, pData, prevLength, length - prevLength, 0);
 #endif
-
     }
 
     RPDO->dataLength = length;
@@ -367,7 +440,7 @@ static CO_SDO_abortCode_t CO_RPDOconfigMap(CO_RPDO_t* RPDO, uint8_t noOfMappedOb
  * Function is called from communication reset or when parameter changes.
  *
  * Function configures following variables from CO_TPDO_t: _dataLength_,
- * _mapPointer_ and _sendIfCOSFlags_.
+ * _mapOps_, _noOfMapOps_, _sendIfCOSFlags_ and _COSmask_.
  *
  * @param TPDO TPDO object.
  * @param noOfMappedObjects Number of mapped object (from OD).
@@ -381,12 +454,13 @@ static CO_SDO_abortCode_t CO_TPDOconfigMap(CO_TPDO_t* TPDO, uint8_t noOfMappedOb
     const uint32_t* pMap = &TPDO->TPDOMapPar->mappedObject1;
 
     TPDO->sendIfCOSFlags = 0;
+    TPDO->noOfMapOps = 0;
 
     for(i=noOfMappedObjects; i>0; i--){
-        int16_t j;
         uint8_t* pData;
         uint8_t prevLength = length;
         uint8_t MBvar;
+        uint16_t entryNo;
         uint32_t map = *(pMap++);
 
         /* function do much checking of errors in map */
@@ -397,33 +471,38 @@ static CO_SDO_abortCode_t CO_TPDOconfigMap(CO_TPDO_t* TPDO, uint8_t noOfMappedOb
                 &pData,
                 &length,
                 &TPDO->sendIfCOSFlags,
-                &MBvar);
+                &MBvar,
+                &entryNo);
         if(ret){
             length = 0;
+            TPDO->noOfMapOps = 0;
             CO_errorReport(TPDO->em, CO_EM_PDO_WRONG_MAPPING, CO_EMC_PROTOCOL_ERROR, map);
             break;
         }
 
-        /* write PDO data pointers */
+        /* add copy operation */
 #ifdef CO_BIG_ENDIAN
-        if(MBvar){
-            for(j=length-1; j>=prevLength; j--)
-                TPDO->mapPointer[j] = pData++;
-        }
-        else{
-            for(j=prevLength; j<length; j++)
-                TPDO->mapPointer[j] = pData++;
-        }
+        CO_PDOaddMapOp(TPDO->mapOps, &TPDO->noOfMapOps, pData, prevLength, length - prevLength, MBvar);
 #else
-        for(j=prevLength; j<length; j++){
-            TPDO->mapPointer[j] = pData++;
-        }
+        CO_PDOaddMapOp(TPDO->mapOps, &TPDO->noOfMapOps, pData, prevLength, length - prevLength, 0);
 #endif
-
     }
 
     TPDO->dataLength = length;
 
+    /* Change of State is verified per copy operation: whole variables at once,
+     * or byte by byte, if only some of its bytes are flagged. */
+    TPDO->COSenabled = 0;
+    for(i=0; i<TPDO->noOfMapOps; i++){
+        CO_PDOmapOp_t *op = &TPDO->mapOps[i];
+        uint8_t flags = (uint8_t)(TPDO->sendIfCOSFlags >> op->offset) & (uint8_t)((1<<op->length) - 1);
+
+        if(flags == 0)                           op->COS = CO_PDO_COS_NONE;
+        else if(flags == ((1<<op->length) - 1))  op->COS = CO_PDO_COS_ALL;
+        else                                     op->COS = CO_PDO_COS_SOME;
+        TPDO->COSenabled |= flags;
+    }
+
     return ret;
 }
 
@@ -637,6 +716,7 @@ static CO_SDO_abortCode_t CO_ODF_RPDOmap(CO_ODF_arg_t *ODF_arg){
         uint8_t length = 0;
         uint8_t dummy = 0;
         uint8_t MBvar;
+        uint16_t entryNo;
 
         if(RPDO->dataLength)
             return CO_SDO_AB_UNSUPPORTED_ACCESS;  /* Unsupported access to an object. */
@@ -649,7 +729,8 @@ static CO_SDO_abortCode_t CO_ODF_RPDOmap(CO_ODF_arg_t *ODF_arg){
                &pData,
                &length,
                &dummy,
-               &MBvar);
+               &MBvar,
+               &entryNo);
     }
 
     return CO_SDO_AB_NONE;
@@ -703,6 +784,7 @@ static CO_SDO_abortCode_t CO_ODF_TPDOmap(CO_ODF_arg_t *ODF_arg){
         uint8_t length = 0;
         uint8_t dummy = 0;
         uint8_t MBvar;
+        uint16_t entryNo;
 
         if(TPDO->dataLength)
             return CO_SDO_AB_UNSUPPORTED_ACCESS;  /* Unsupported access to an object. */
@@ -715,7 +797,8 @@ static CO_SDO_abortCode_t CO_ODF_TPDOmap(CO_ODF_arg_t *ODF_arg){
                &pData,
                &length,
                &dummy,
-               &MBvar);
+               &MBvar,
+               &entryNo);
     }
 
     return CO_SDO_AB_NONE;
@@ -729,6 +812,7 @@ CO_ReturnError_t CO_RPDO_init(
         CO_SDO_t               *SDO,
         CO_SYNC_t              *SYNC,
 		CO_NMT_internalState_t *operatingState,
+        volatile uint32_t      *configCounter,
         uint8_t                 nodeId,
         uint16_t                defaultCOB_ID,
         uint8_t                 restrictionFlags,
@@ -752,6 +836,7 @@ CO_ReturnError_t CO_RPDO_init(
     RPDO->RPDOCommPar = RPDOCommPar;
     RPDO->RPDOMapPar = RPDOMapPar;
     RPDO->operatingState = operatingState;
+    RPDO->configCounter = configCounter;
     RPDO->nodeId = nodeId;
     RPDO->defaultCOB_ID = defaultCOB_ID;
     RPDO->restrictionFlags = restrictionFlags;
@@ -762,6 +847,9 @@ CO_ReturnError_t CO_RPDO_init(
 
     /* configure communication and mapping */
     RPDO->CANrxNew[0] = RPDO->CANrxNew[1] = false;
+    RPDO->rxCount = 0;
+    RPDO->rxCycle = 0;
+    RPDO->missedCycles = 0;
     RPDO->CANdevRx = CANdevRx;
     RPDO->CANdevRxIdx = CANdevRxIdx;
 
@@ -778,6 +866,7 @@ CO_ReturnError_t CO_TPDO_init(
         CO_EM_t                *em,
         CO_SDO_t               *SDO,
 		CO_NMT_internalState_t *operatingState,
+        volatile uint32_t      *configCounter,
         uint8_t                 nodeId,
         uint16_t                defaultCOB_ID,
         uint8_t                 restrictionFlags,
@@ -800,6 +889,7 @@ CO_ReturnError_t CO_TPDO_init(
     TPDO->TPDOCommPar = TPDOCommPar;
     TPDO->TPDOMapPar = TPDOMapPar;
     TPDO->operatingState = operatingState;
+    TPDO->configCounter = configCounter;
     TPDO->nodeId = nodeId;
     TPDO->defaultCOB_ID = defaultCOB_ID;
     TPDO->restrictionFlags = restrictionFlags;
@@ -832,22 +922,41 @@ CO_ReturnError_t CO_TPDO_init(
 /******************************************************************************/
 uint8_t CO_TPDOisCOS(CO_TPDO_t *TPDO){
 
-    /* Prepare TPDO data automatically from Object Dictionary variables */
-    uint8_t* pPDOdataByte;
-    uint8_t** ppODdataByte;
-
-    pPDOdataByte = &TPDO->CANtxBuff->data[TPDO->dataLength];
-    ppODdataByte = &TPDO->mapPointer[TPDO->dataLength];
-
-    switch(TPDO->dataLength){
-        case 8: if(*(--pPDOdataByte) != **(--ppODdataByte) && (TPDO->sendIfCOSFlags&0x80)) return 1;
-        case 7: if(*(--pPDOdataByte) != **(--ppODdataByte) && (TPDO->sendIfCOSFlags&0x40)) return 1;
-        case 6: if(*(--pPDOdataByte) != **(--ppODdataByte) && (TPDO->sendIfCOSFlags&0x20)) return 1;
-        case 5: if(*(--pPDOdataByte) != **(--ppODdataByte) && (TPDO->sendIfCOSFlags&0x10)) return 1;
-        case 4: if(*(--pPDOdataByte) != **(--ppODdataByte) && (TPDO->sendIfCOSFlags&0x08)) return 1;
-        case 3: if(*(--pPDOdataByte) != **(--ppODdataByte) && (TPDO->sendIfCOSFlags&0x04)) return 1;
-        case 2: if(*(--pPDOdataByte) != **(--ppODdataByte) && (TPDO->sendIfCOSFlags&0x02)) return 1;
-        case 1: if(*(--pPDOdataByte) != **(--ppODdataByte) && (TPDO->sendIfCOSFlags&0x01)) return 1;
+    /* Compare Object Dictionary variables with the last sent data */
+    const CO_PDOmapOp_t *op = TPDO->mapOps;
+    uint8_t i;
+
+    if(!TPDO->COSenabled) return 0;
+
+    for(i=TPDO->noOfMapOps; i>0; i--, op++){
+        const uint8_t *pPDOdata = &TPDO->CANtxBuff->data[op->offset];
+
+        if(op->COS == CO_PDO_COS_NONE) continue;
+#ifdef CO_BIG_ENDIAN
+        if(op->swap || op->COS == CO_PDO_COS_SOME){
+#else
+        if(op->COS == CO_PDO_COS_SOME){
+#endif
+            uint8_t j;
+            for(j=0; j<op->length; j++){
+#ifdef CO_BIG_ENDIAN
+                uint8_t ODbyte = op->swap ? op->pData[op->length-1-j] : op->pData[j];
+#else
+                uint8_t ODbyte = op->pData[j];
+#endif
+                if(pPDOdata[j] != ODbyte && (TPDO->sendIfCOSFlags & (1<<(op->offset+j)))) return 1;
+            }
+        }
+        else{
+            /* word compare for lengths of standard variables */
+            switch(op->length){
+                case 1: if(*pPDOdata != *op->pData) return 1; break;
+                case 2: if(memcmp(pPDOdata, op->pData, 2) != 0) return 1; break;
+                case 4: if(memcmp(pPDOdata, op->pData, 4) != 0) return 1; break;
+                case 8: if(memcmp(pPDOdata, op->pData, 8) != 0) return 1; break;
+                default: if(memcmp(pPDOdata, op->pData, op->length) != 0) return 1; break;
+            }
+        }
     }
 
     return 0;
@@ -856,9 +965,9 @@ uint8_t CO_TPDOisCOS(CO_TPDO_t *TPDO){
 //#define TPDO_CALLS_EXTENSION
 /******************************************************************************/
 int16_t CO_TPDOsend(CO_TPDO_t *TPDO){
+#ifdef TPDO_CALLS_EXTENSION
     int16_t i;
-    uint8_t* pPDOdataByte;
-    uint8_t** ppODdataByte;
+#endif
 
 #ifdef TPDO_CALLS_EXTENSION
     if(TPDO->SDO->ODExtensions){
@@ -888,21 +997,23 @@ int16_t CO_TPDOsend(CO_TPDO_t *TPDO){
         }
     }
 #endif
-    i = TPDO->dataLength;
-    pPDOdataByte = &TPDO->CANtxBuff->data[0];
-    ppODdataByte = &TPDO->mapPointer[0];
 
     /* Copy data from Object dictionary. */
-    for(; i>0; i--) {
-        *(pPDOdataByte++) = **(ppODdataByte++);
-    }
+    CO_PDOcopyMapped(TPDO->mapOps, TPDO->noOfMapOps, TPDO->CANtxBuff->data, false);
 
     TPDO->sendRequest = 0;
 
     return CO_CANsend(TPDO->CANdevTx, TPDO->CANtxBuff);
 }
 
-//#define RPDO_CALLS_EXTENSION
+
+/******************************************************************************/
+void CO_TPDOmarkSent(CO_TPDO_t *TPDO){
+    CO_PDOcopyMapped(TPDO->mapOps, TPDO->noOfMapOps, TPDO->CANtxBuff->data, false);
+}
+
+/* Call OD functions of the mapped entries after RPDO was copied (used by CO_ODnotify) */
+#define RPDO_CALLS_EXTENSION
 /******************************************************************************/
 void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
 
@@ -920,19 +1031,25 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
         }
 
         while(RPDO->CANrxNew[bufNo]){
+#ifdef RPDO_CALLS_EXTENSION
             int16_t i;
-            uint8_t* pPDOdataByte;
-            uint8_t** ppODdataByte;
-
-            i = RPDO->dataLength;
-            pPDOdataByte = &RPDO->CANrxData[bufNo][0];
-            ppODdataByte = &RPDO->mapPointer[0];
+#endif
 
             /* Copy data to Object dictionary. If between the copy operation CANrxNew
              * is set to true by receive thread, then copy the latest data again. */
             RPDO->CANrxNew[bufNo] = false;
-            for(; i>0; i--) {
-                **(ppODdataByte++) = *(pPDOdataByte++);
+            CO_PDOcopyMapped(RPDO->mapOps, RPDO->noOfMapOps, RPDO->CANrxData[bufNo], true);
+
+            /* Freshness of the data: count SYNC cycles, which passed without message */
+            {
+                uint32_t cycle = RPDO->SYNC->cycle;
+                uint32_t gap = cycle - RPDO->rxCycle;
+
+                if(gap > 1U && RPDO->rxCount != 0U){
+                    RPDO->missedCycles += gap - 1U;
+                }
+                RPDO->rxCycle = cycle;
+                RPDO->rxCount++;
             }
 
 #ifdef RPDO_CALLS_EXTENSION
@@ -941,11 +1058,11 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
                 const uint32_t* pMap = &RPDO->RPDOMapPar->mappedObject1;
                 CO_SDO_t *pSDO = RPDO->SDO;
 
-                for(i=RPDO->RPDOMapPar->numberOfMappedObjects; i>0; i--){
+                for(i=0; i<RPDO->noOfMapEntries; i++){
                     uint32_t map = *(pMap++);
                     uint16_t index = (uint16_t)(map>>16);
                     uint8_t subIndex = (uint8_t)(map>>8);
-                    uint16_t entryNo = CO_OD_find(pSDO, index);
+                    uint16_t entryNo = RPDO->mapEntryNo[i];
                     if ( entryNo == 0xFFFF ) continue;
                     CO_OD_extension_t *ext = &pSDO->ODExtensions[entryNo];
                     if( ext->pODFunc == NULL) continue;
@@ -957,7 +1074,8 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
                     ODF_arg.object = ext->object;
                     ODF_arg.attribute = CO_OD_getAttribute(pSDO, entryNo, subIndex);
                     ODF_arg.pFlags = CO_OD_getFlagsPointer(pSDO, entryNo, subIndex);
-                    ODF_arg.data = pSDO->OD[entryNo].pData;
+                    ODF_arg.data = (uint8_t*)CO_OD_getDataPointer(pSDO, entryNo, subIndex);
+                    ODF_arg.ODdataStorage = ODF_arg.data;
                     ODF_arg.dataLength = CO_OD_getLength(pSDO, entryNo, subIndex);
                     ext->pODFunc(&ODF_arg);
                 }
@@ -968,6 +1086,42 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
 }
 
 
+/******************************************************************************/
+uint32_t CO_RPDO_getAge(const CO_RPDO_t *RPDO){
+    if(RPDO->rxCount == 0U){
+        return 0xFFFFFFFFUL;
+    }
+    return RPDO->SYNC->cycle - RPDO->rxCycle;
+}
+
+
+/*
+ * Verify, if one of the copy operations covers the variable.
+ */
+static bool_t CO_PDOisMapped(const CO_PDOmapOp_t *op, uint8_t noOfOps, const void *pData){
+    const uint8_t *p = (const uint8_t*) pData;
+
+    for(; noOfOps>0; noOfOps--, op++){
+        if(p >= op->pData && p < (op->pData + op->length)){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/******************************************************************************/
+bool_t CO_RPDO_isMapped(const CO_RPDO_t *RPDO, const void *pData){
+    return RPDO->valid && CO_PDOisMapped(RPDO->mapOps, RPDO->noOfMapOps, pData);
+}
+
+
+/******************************************************************************/
+bool_t CO_TPDO_isMapped(const CO_TPDO_t *TPDO, const void *pData){
+    return TPDO->valid && CO_PDOisMapped(TPDO->mapOps, TPDO->noOfMapOps, pData);
+}
+
+
 /******************************************************************************/
 void CO_TPDO_process(
         CO_TPDO_t              *TPDO,
@@ -70,6 +70,9 @@ extern "C"
  * Features of the PDO as implemented here, in CANopenNode:
  *  - Dynamic PDO mapping.
  *  - Map granularity of one byte.
+ *  - Mapping is compiled into a short list of copy operations (#CO_PDOmapOp_t)
+ *    when it is configured. Mapped variables, which follow each other in
+ *    memory, are copied by one operation.
  *  - After RPDO is received from CAN bus, its data are copied to buffer.
  *    Function CO_RPDO_process() (called by application) copies data to
  *    mapped objects in Object Dictionary. Synchronous RPDOs are processed AFTER
@@ -178,6 +181,29 @@ extern "C"
         uint32_t mappedObject8; /**< Same */
     } CO_TPDOMapPar_t;
 
+    /**
+ * Change of State detection of the bytes copied by #CO_PDOmapOp_t.
+ */
+    typedef enum
+    {
+        CO_PDO_COS_NONE = 0, /**< No byte detects Change of State */
+        CO_PDO_COS_ALL = 1,  /**< All bytes detect Change of State */
+        CO_PDO_COS_SOME = 2  /**< Some bytes detect Change of State */
+    } CO_PDO_COS_t;
+
+    /**
+ * Copy operation of the PDO mapping, compiled by CO_RPDOconfigMap() or
+ * CO_TPDOconfigMap().
+ */
+    typedef struct
+    {
+        uint8_t *pData;  /**< Pointer to the mapped variable(s) in Object Dictionary */
+        uint8_t offset;  /**< Position of the first byte in the PDO data */
+        uint8_t length;  /**< Number of bytes to copy */
+        uint8_t swap;    /**< True, if byte order must be reversed (multibyte variable on big endian) */
+        uint8_t COS;     /**< TPDO only, which bytes detect Change of State, see #CO_PDO_COS_t */
+    } CO_PDOmapOp_t;
+
     /**
  * RPDO object.
  */
@@ -189,6 +215,7 @@ extern "C"
         const CO_RPDOCommPar_t *RPDOCommPar; /**< From CO_RPDO_init() */
         const CO_RPDOMapPar_t *RPDOMapPar;   /**< From CO_RPDO_init() */
         CO_NMT_internalState_t *operatingState;             /**< From CO_RPDO_init() */
+        volatile uint32_t *configCounter;    /**< From CO_RPDO_init() */
         uint8_t nodeId;                      /**< From CO_RPDO_init() */
         uint16_t defaultCOB_ID;              /**< From CO_RPDO_init() */
         uint8_t restrictionFlags;            /**< From CO_RPDO_init() */
@@ -198,12 +225,25 @@ extern "C"
         bool_t synchronous;
         /** Data length of the received PDO message. Calculated from mapping */
         uint8_t dataLength;
-        /** Pointers to 8 data objects, where PDO will be copied */
-        uint8_t *mapPointer[8];
+        /** Copy operations from PDO data into the mapped objects */
+        CO_PDOmapOp_t mapOps[8];
+        /** Number of operations in mapOps */
+        uint8_t noOfMapOps;
+        /** Number of valid entries in mapEntryNo */
+        uint8_t noOfMapEntries;
+        /** Entry numbers (CO_OD_find()) of the mapped objects, 0xFFFF for dummy entries */
+        uint16_t mapEntryNo[8];
         /** Variable indicates, if new PDO message received from CAN bus. */
         volatile bool_t CANrxNew[2];
         /** 8 data bytes of the received message. */
         uint8_t CANrxData[2][8];
+        /** Number of messages copied into the mapped objects since initialization */
+        uint32_t rxCount;
+        /** SYNC cycle (see CO_SYNC_t), in which the mapped objects were last written */
+        uint32_t rxCycle;
+        /** Number of SYNC cycles, which ended without a message (counted, when the
+    next message is received) */
+        uint32_t missedCycles;
         CO_CANmodule_t *CANdevRx; /**< From CO_RPDO_init() */
         uint16_t CANdevRxIdx;     /**< From CO_RPDO_init() */
     } CO_RPDO_t;
@@ -218,6 +258,7 @@ extern "C"
         const CO_TPDOCommPar_t *TPDOCommPar; /**< From CO_TPDO_init() */
         const CO_TPDOMapPar_t *TPDOMapPar;   /**< From CO_TPDO_init() */
         CO_NMT_internalState_t *operatingState;             /**< From CO_TPDO_init() */
+        volatile uint32_t *configCounter;    /**< From CO_TPDO_init() */
         uint8_t nodeId;                      /**< From CO_TPDO_init() */
         uint16_t defaultCOB_ID;              /**< From CO_TPDO_init() */
         uint8_t restrictionFlags;            /**< From CO_TPDO_init() */
@@ -227,12 +268,16 @@ extern "C"
         /** If application set this flag, PDO will be later sent by
     function CO_TPDO_process(). Depends on transmission type. */
         uint8_t sendRequest;
-        /** Pointers to 8 data objects, where PDO will be copied */
-        uint8_t *mapPointer[8];
-        /** Each flag bit is connected with one mapPointer. If flag bit
+        /** Copy operations from the mapped objects into PDO data */
+        CO_PDOmapOp_t mapOps[8];
+        /** Number of operations in mapOps */
+        uint8_t noOfMapOps;
+        /** Each flag bit is connected with one byte of PDO data. If flag bit
     is true, CO_TPDO_process() functiuon will send PDO if
-    Change of State is detected on value pointed by that mapPointer */
+    Change of State is detected on that byte */
         uint8_t sendIfCOSFlags;
+        /** True, if any mapped byte is flagged in sendIfCOSFlags */
+        uint8_t COSenabled;
         /** SYNC counter used for PDO sending */
         uint8_t syncCounter;
         /** Inhibit timer used for inhibit PDO sending translated to microseconds */
@@ -253,6 +298,8 @@ extern "C"
  * @param em Emergency object.
  * @param SDO SDO server object.
  * @param operatingState Pointer to variable indicating CANopen device NMT internal state.
+ * @param configCounter Pointer to variable, which is incremented each time the
+ * communication parameter is configured (_valid_ may change). May be NULL.
  * @param nodeId CANopen Node ID of this device. If default COB_ID is used, value will be added.
  * @param defaultCOB_ID Default COB ID for this PDO (without NodeId).
  * See #CO_Default_CAN_ID_t
@@ -280,6 +327,7 @@ extern "C"
         CO_SDO_t *SDO,
         CO_SYNC_t *SYNC,
         CO_NMT_internalState_t *operatingState,
+        volatile uint32_t *configCounter,
         uint8_t nodeId,
         uint16_t defaultCOB_ID,
         uint8_t restrictionFlags,
@@ -300,6 +348,8 @@ extern "C"
  * @param em Emergency object.
  * @param SDO SDO object.
  * @param operatingState Pointer to variable indicating CANopen device NMT internal state.
+ * @param configCounter Pointer to variable, which is incremented each time the
+ * communication parameter is configured (_valid_ may change). May be NULL.
  * @param nodeId CANopen Node ID of this device. If default COB_ID is used, value will be added.
  * @param defaultCOB_ID Default COB ID for this PDO (without NodeId).
  * See #CO_Default_CAN_ID_t
@@ -325,6 +375,7 @@ extern "C"
         CO_EM_t *em,
         CO_SDO_t *SDO,
         CO_NMT_internalState_t *operatingState,
+        volatile uint32_t *configCounter,
         uint8_t nodeId,
         uint16_t defaultCOB_ID,
         uint8_t restrictionFlags,
@@ -365,6 +416,28 @@ extern "C"
  */
     int16_t CO_TPDOsend(CO_TPDO_t *TPDO);
 
+    /**
+ * Mark current data of TPDO as sent.
+ *
+ * Function copies the mapped Object Dictionary variables into the TPDO data
+ * without sending it, so Change of State is detected only for later changes.
+ * It is used, if the data were transmitted by other means (see
+ * CO_setpointMux_process()). Must be called with OD locked.
+ *
+ * @param TPDO TPDO object.
+ */
+    void CO_TPDOmarkSent(CO_TPDO_t *TPDO);
+
+    /**
+ * Verify, if TPDO transmits an Object Dictionary variable.
+ *
+ * @param TPDO This object.
+ * @param pData Pointer to the variable in Object Dictionary.
+ *
+ * @return True, if TPDO is valid and one of its copy operations covers pData.
+ */
+    bool_t CO_TPDO_isMapped(const CO_TPDO_t *TPDO, const void *pData);
+
     /**
  * Process received PDO messages.
  *
@@ -377,6 +450,28 @@ extern "C"
  */
     void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas);
 
+    /**
+ * Age of the data received by RPDO.
+ *
+ * Function may be called from other threads than CO_RPDO_process().
+ *
+ * @param RPDO This object.
+ *
+ * @return Number of SYNC cycles since the mapped objects were last written
+ * (0 in the cycle of the last message), 0xFFFFFFFF if nothing was received yet.
+ */
+    uint32_t CO_RPDO_getAge(const CO_RPDO_t *RPDO);
+
+    /**
+ * Verify, if RPDO writes an Object Dictionary variable.
+ *
+ * @param RPDO This object.
+ * @param pData Pointer to the variable in Object Dictionary.
+ *
+ * @return True, if RPDO is valid and one of its copy operations covers pData.
+ */
+    bool_t CO_RPDO_isMapped(const CO_RPDO_t *RPDO, const void *pData);
+
     /**
  * Process transmitting PDO messages.
  *
@@ -47,6 +47,9 @@
 #include "CO_driver.h"
 #include "CO_SDO.h"
 #include "crc16-ccitt.h"
+#ifdef CO_OD_INDEX_SELFCHECK
+#include <assert.h>
+#endif
 
 
 /* Client command specifier, see DS301 */
@@ -310,6 +313,7 @@ CO_ReturnError_t CO_SDO_init(
         SDO->OD = OD;
         SDO->ODSize = ODSize;
         SDO->ODExtensions = ODExtensions;
+        SDO->ODIndex = NULL;
 
         /* clear pointers in ODExtensions */
         for(i=0U; i<ODSize; i++){
@@ -324,6 +328,7 @@ CO_ReturnError_t CO_SDO_init(
         SDO->OD = parentSDO->OD;
         SDO->ODSize = parentSDO->ODSize;
         SDO->ODExtensions = parentSDO->ODExtensions;
+        SDO->ODIndex = parentSDO->ODIndex;
     }
 
     /* Configure object variables */
@@ -410,8 +415,27 @@ void CO_OD_configure(
 }
 
 
-/******************************************************************************/
-uint16_t CO_OD_find(CO_SDO_t *SDO, uint16_t index){
+/*
+ * Find object in Object Dictionary with the index table.
+ *
+ * @return Sequence number of the OD entry, 0xFFFF if not found.
+ */
+static uint16_t CO_OD_findIndexed(const CO_OD_index_t *ODIndex, uint16_t index){
+    uint8_t page = ODIndex->page[index >> 8];
+
+    if(page == 0U){
+        return 0xFFFFU;
+    }
+    return ODIndex->entries[page - 1U][index & 0xFFU];
+}
+
+
+/*
+ * Find object in Object Dictionary with binary search.
+ *
+ * @return Sequence number of the OD entry, 0xFFFF if not found.
+ */
+static uint16_t CO_OD_findSorted(const CO_SDO_t *SDO, uint16_t index){
     /* Fast search in ordered Object Dictionary. If indexes are mixed, this won't work. */
     /* If Object Dictionary has up to 2^N entries, then N is max number of loop passes. */
     uint16_t cur, min, max;
@@ -446,6 +470,52 @@ uint16_t CO_OD_find(CO_SDO_t *SDO, uint16_t index){
 }
 
 
+/******************************************************************************/
+CO_ReturnError_t CO_OD_setIndex(CO_SDO_t *SDO, const CO_OD_index_t *ODIndex){
+    uint16_t i;
+
+    /* verify arguments */
+    if(SDO==NULL){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    SDO->ODIndex = NULL;
+    if(ODIndex == NULL){
+        return CO_ERROR_NO;
+    }
+
+    /* each entry must be found at its own position (catches outdated tables) */
+    for(i=0U; i<SDO->ODSize; i++){
+        if(CO_OD_findIndexed(ODIndex, SDO->OD[i].index) != i){
+            return CO_ERROR_PARAMETERS;
+        }
+    }
+
+    SDO->ODIndex = ODIndex;
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+uint16_t CO_OD_find(CO_SDO_t *SDO, uint16_t index){
+    uint16_t entryNo;
+
+    if(SDO->ODIndex == NULL){
+        return CO_OD_findSorted(SDO, index);
+    }
+
+    entryNo = CO_OD_findIndexed(SDO->ODIndex, index);
+    /* an entry of the table must point to its own index (table outdated or corrupted), search then */
+    if(entryNo != 0xFFFFU && (entryNo >= SDO->ODSize || SDO->OD[entryNo].index != index)){
+        return CO_OD_findSorted(SDO, index);
+    }
+#ifdef CO_OD_INDEX_SELFCHECK
+    assert(entryNo == CO_OD_findSorted(SDO, index));
+#endif
+    return entryNo;
+}
+
+
 /******************************************************************************/
 uint16_t CO_OD_getLength(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
     const CO_OD_entry_t* object = &SDO->OD[entryNo];
@@ -290,6 +290,11 @@ typedef enum {
  * 
  * Be aware that accessing the OD directly using CO_OD.h files is more CPU 
  * efficient as CO_OD_find() has to do a search everytime it is called.
+ *
+ * If the index table of the Object dictionary (#CO_OD_index_t, generated by
+ * tools/ODGenerator/genODIndex.py) is set with CO_OD_setIndex(), CO_OD_find()
+ * is a constant time table lookup. Otherwise it is a binary search and the
+ * Object dictionary must be sorted by index.
  * 
  */
 
@@ -588,6 +593,22 @@ typedef struct {
     uint8_t *flags;
 } CO_OD_extension_t;
 
+/**
+ * Direct index table of the @ref CO_SDO_objectDictionary, used by CO_OD_find().
+ *
+ * Table is generated together with the Object dictionary. If symbol
+ * CO_OD_INDEX_SELFCHECK is defined, every lookup is checked against the binary
+ * search (debug builds only).
+ */
+typedef struct {
+    /** For each high byte of the index: 0 if there are no OD entries with this
+    high byte, otherwise 1 + the number of the page in the entries array. */
+    const uint8_t *page;
+    /** Pages of 256 entries, one for each low byte of the index: sequence
+    number of the OD entry or 0xFFFF, if entry does not exist. */
+    const uint16_t (*entries)[256];
+} CO_OD_index_t;
+
 /**
  * SDO server object.
  */
@@ -605,6 +626,9 @@ typedef struct {
     /** Pointer to array of CO_OD_extension_t objects. Size of the array is
     equal to ODSize. */
     CO_OD_extension_t *ODExtensions;
+    /** Pointer to the #CO_OD_index_t of the @ref CO_SDO_objectDictionary or
+    NULL, if CO_OD_find() has to search the (sorted) Object dictionary. */
+    const CO_OD_index_t *ODIndex;
     /** Offset in buffer of next data segment being read/written */
     uint16_t bufferOffset;
     /** Sequence number of OD entry as returned from CO_OD_find() */
@@ -822,6 +846,23 @@ void CO_OD_configure(
     uint8_t *flags,
     uint8_t flagsSize);
 
+/**
+ * Set the index table of the Object dictionary, used by CO_OD_find().
+ *
+ * Table is verified against the Object dictionary: each entry must be found at
+ * its own sequence number. If verification fails, table is not used and
+ * CO_OD_find() keeps searching the sorted Object dictionary. Function must be
+ * called after CO_SDO_init() on all SDO objects, which share the same Object
+ * dictionary.
+ *
+ * @param SDO This object.
+ * @param ODIndex Pointer to the generated index table, or NULL to disable it.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_PARAMETERS, if table does
+ * not match the Object dictionary.
+ */
+CO_ReturnError_t CO_OD_setIndex(CO_SDO_t *SDO, const CO_OD_index_t *ODIndex);
+
 /**
  * Find object with specific index in Object dictionary.
  *
@@ -276,6 +276,7 @@ CO_ReturnError_t CO_SYNC_init(
     SYNC->CANrxToggle = false;
     SYNC->timer = 0;
     SYNC->counter = 0;
+    SYNC->cycle = 0;
     SYNC->receiveError = 0U;
 
     SYNC->em = em;
@@ -331,6 +332,7 @@ uint8_t CO_SYNC_process(
         /* was SYNC just received */
         if(SYNC->CANrxNew){
             SYNC->timer = 0;
+            SYNC->cycle++;
             ret = 1;
             SYNC->CANrxNew = false;
         }
@@ -340,6 +342,7 @@ uint8_t CO_SYNC_process(
             if(SYNC->timer >= SYNC->periodTime){
                 if(++SYNC->counter > SYNC->counterOverflowValue) SYNC->counter = 1;
                 SYNC->timer = 0;
+                SYNC->cycle++;
                 ret = 1;
                 SYNC->CANrxToggle = SYNC->CANrxToggle ? false : true;
                 SYNC->CANtxBuff->data[0] = SYNC->counter;
@@ -111,6 +111,9 @@ extern "C"
         bool_t CANrxToggle;
         /** Counter of the SYNC message if counterOverflowValue is different than zero */
         uint8_t counter;
+        /** Number of SYNC messages received or transmitted since initialization
+    (SYNC cycle). Used by RPDOs for the age of the received data. */
+        uint32_t cycle;
         /** Timer for the SYNC message in [microseconds].
     Set to zero after received or transmitted SYNC message */
         uint32_t timer;
@@ -25,9 +25,13 @@
 
 
 #include "CANopen.h"
+#include "CO_SYNCjitter.h"
+#include "CO_setpointMux.h"
+#include "CO_ipBuffer.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <sys/timerfd.h>
+#include <sys/eventfd.h>
 #include <sys/epoll.h>
 
 
@@ -182,8 +186,14 @@ void taskMain_cbSignal(void) {
 static struct {
     int                 fdRx0;          /* file descriptor for CANrx */
     int                 fdTmr;          /* file descriptor for taskTmr */
+    int                 fdCommit;       /* eventfd for committed setpoints */
     struct itimerspec   tmrSpec;
-    struct timespec    *tmrVal;
+    struct timespec    *tmrVal;         /* scheduled time of the next interval */
+    struct timespec     tmrNext;        /* storage for tmrVal */
+    struct timespec     tmrLast;        /* scheduled time of the last interval */
+    CO_SYNCjitter_t    *SYNCjitter;     /* from CANrx_taskTmr_setSYNCjitter() */
+    CO_setpointMux_t   *setpointMux;    /* from CANrx_taskTmr_setSetpointMux() */
+    CO_ipBuffer_t      *ipBuffer;       /* from CANrx_taskTmr_setIPbuffer() */
     long                intervalns;
     long                intervalus;
     uint16_t           *maxTime;
@@ -200,6 +210,12 @@ void CANrx_taskTmr_init(int fdEpoll, long intervalns, uint16_t *maxTime) {
     if(taskRT.fdTmr == -1)
         CO_errExit("CANrx_taskTmr_init - timerfd_create failed");
 
+    /* Control thread signals committed setpoints through eventfd, nonblocking,
+     * so it never waits for realtime thread. */
+    taskRT.fdCommit = eventfd(0, EFD_NONBLOCK);
+    if(taskRT.fdCommit == -1)
+        CO_errExit("CANrx_taskTmr_init - eventfd failed");
+
     /* add events for epoll */
     ev.events = EPOLLIN;
     ev.data.fd = taskRT.fdRx0;
@@ -211,14 +227,24 @@ void CANrx_taskTmr_init(int fdEpoll, long intervalns, uint16_t *maxTime) {
     if(epoll_ctl(fdEpoll, EPOLL_CTL_ADD, taskRT.fdTmr, &ev) == -1)
         CO_errExit("CANrx_taskTmr_init - epoll_ctl taskTmr failed");
 
+    ev.events = EPOLLIN;
+    ev.data.fd = taskRT.fdCommit;
+    if(epoll_ctl(fdEpoll, EPOLL_CTL_ADD, taskRT.fdCommit, &ev) == -1)
+        CO_errExit("CANrx_taskTmr_init - epoll_ctl commit failed");
+
     /* Prepare timer (one shot, each time calculate new expiration time) It is
      * necessary not to use taskRT.tmrSpec.it_interval, because it is sliding. */
     taskRT.tmrSpec.it_interval.tv_sec = 0;
     taskRT.tmrSpec.it_interval.tv_nsec = 0;
 
-    taskRT.tmrVal = &taskRT.tmrSpec.it_value;
+    taskRT.tmrVal = &taskRT.tmrNext;
     if(clock_gettime(CLOCK_MONOTONIC, taskRT.tmrVal) != 0)
         CO_errExit("CANrx_taskTmr_init - clock_gettime failed");
+    taskRT.tmrSpec.it_value = *taskRT.tmrVal;
+    taskRT.tmrLast = *taskRT.tmrVal;
+    taskRT.SYNCjitter = NULL;
+    taskRT.setpointMux = NULL;
+    taskRT.ipBuffer = NULL;
 
     if(timerfd_settime(taskRT.fdTmr, TFD_TIMER_ABSTIME, &taskRT.tmrSpec, NULL) != 0)
         CO_errExit("CANrx_taskTmr_init - timerfd_settime failed");
@@ -229,8 +255,35 @@ void CANrx_taskTmr_init(int fdEpoll, long intervalns, uint16_t *maxTime) {
 }
 
 
+void CANrx_taskTmr_setSYNCjitter(CO_SYNCjitter_t *jitter) {
+    CO_LOCK_OD();
+    taskRT.SYNCjitter = jitter;
+    CO_UNLOCK_OD();
+}
+
+
+CO_SYNCjitter_t *CANrx_taskTmr_getSYNCjitter(void) {
+    return taskRT.SYNCjitter;
+}
+
+
+void CANrx_taskTmr_setSetpointMux(CO_setpointMux_t *mux) {
+    CO_LOCK_OD();
+    taskRT.setpointMux = mux;
+    CO_UNLOCK_OD();
+}
+
+
+void CANrx_taskTmr_setIPbuffer(CO_ipBuffer_t *ip) {
+    CO_LOCK_OD();
+    taskRT.ipBuffer = ip;
+    CO_UNLOCK_OD();
+}
+
+
 void CANrx_taskTmr_close(void) {
     close(taskRT.fdTmr);
+    close(taskRT.fdCommit);
 }
 
 
@@ -245,6 +298,7 @@ bool_t CANrx_taskTmr_process(int fd) {
     /* Execute taskTmr */
     else if(fd == taskRT.fdTmr) {
         uint64_t tmrExp;
+        struct timespec tmrThis;
 
         /* Wait for timer to expire */
         if(read(taskRT.fdTmr, &tmrExp, sizeof(tmrExp)) != sizeof(uint64_t))
@@ -268,11 +322,30 @@ bool_t CANrx_taskTmr_process(int fd) {
         }
 
         /* Calculate next shot for the timer */
+        tmrThis = *taskRT.tmrVal;
+        taskRT.tmrLast = tmrThis;
         taskRT.tmrVal->tv_nsec += taskRT.intervalns;
         if(taskRT.tmrVal->tv_nsec >= NSEC_PER_SEC) {
             taskRT.tmrVal->tv_nsec -= NSEC_PER_SEC;
             taskRT.tmrVal->tv_sec++;
         }
+        taskRT.tmrSpec.it_value = *taskRT.tmrVal;
+        if(taskRT.SYNCjitter != NULL) {
+            CO_SYNC_t *SYNC = CO->SYNC;
+            uint32_t syncTimer = SYNC->timer + taskRT.intervalus;
+
+            /* If next interval will produce SYNC (this one is not processed
+             * yet), schedule it earlier by the phase correction. Grid in
+             * tmrVal is not changed. */
+            if(syncTimer >= SYNC->periodTime) syncTimer = 0;
+            if(SYNC->isProducer && SYNC->periodTime && (syncTimer + taskRT.intervalus) >= SYNC->periodTime) {
+                taskRT.tmrSpec.it_value.tv_nsec -= CO_SYNCjitter_getAdvance(taskRT.SYNCjitter);
+                if(taskRT.tmrSpec.it_value.tv_nsec < 0) {
+                    taskRT.tmrSpec.it_value.tv_nsec += NSEC_PER_SEC;
+                    taskRT.tmrSpec.it_value.tv_sec--;
+                }
+            }
+        }
         if(timerfd_settime(taskRT.fdTmr, TFD_TIMER_ABSTIME, &taskRT.tmrSpec, NULL) == -1)
             CO_error(0x22300000L + errno);
 
@@ -285,10 +358,19 @@ bool_t CANrx_taskTmr_process(int fd) {
 
             /* Process Sync and read inputs */
             syncWas = CO_process_SYNC_RPDO(CO, taskRT.intervalus);
+            if(syncWas && taskRT.SYNCjitter != NULL && CO->SYNC->isProducer) {
+                CO_SYNCjitter_produced(taskRT.SYNCjitter, &tmrThis);
+            }
 
             /* Further I/O or nonblocking application code may go here. */
 
             /* Write outputs */
+            if(taskRT.ipBuffer != NULL) {
+                CO_ipBuffer_process(taskRT.ipBuffer);
+            }
+            if(taskRT.setpointMux != NULL) {
+                CO_setpointMux_process(taskRT.setpointMux);
+            }
             CO_process_TPDO(CO, syncWas, taskRT.intervalus);
         }
 
@@ -302,3 +384,65 @@ bool_t CANrx_taskTmr_process(int fd) {
 
     return wasProcessed;
 }
+
+
+void CANrx_taskTmr_commitSetpoints(void) {
+    uint64_t one = 1;
+
+    /* If counter is already nonzero, commit is pending anyway */
+    if(write(taskRT.fdCommit, &one, sizeof(one)) == -1 && errno != EAGAIN)
+        CO_error(0x22500000L + errno);
+}
+
+
+/* Time since the SYNC is its timer at the last interval plus the time since
+ * that interval. The window is open if no window length (0x1007) is set. */
+static bool_t isInsideSYNCwindow(void) {
+    CO_SYNC_t *SYNC = CO->SYNC;
+    struct timespec now;
+    long sinceSYNC;
+
+    if(OD_synchronousWindowLength == 0 || SYNC->periodTime == 0)
+        return true;
+    if(clock_gettime(CLOCK_MONOTONIC, &now) == -1) {
+        CO_error(0x22600000L + errno);
+        return true;
+    }
+    sinceSYNC = (long)SYNC->timer
+              + (now.tv_sec - taskRT.tmrLast.tv_sec) * 1000000L
+              + (now.tv_nsec - taskRT.tmrLast.tv_nsec) / 1000;
+    return sinceSYNC <= (long)OD_synchronousWindowLength;
+}
+
+
+bool_t CANrx_taskTmr_processCommit(int fd) {
+    uint64_t commits;
+
+    if(fd != taskRT.fdCommit)
+        return false;
+
+    if(read(taskRT.fdCommit, &commits, sizeof(commits)) != sizeof(uint64_t))
+        return true;    /* already consumed */
+
+    /* Lock PDOs and OD */
+    CO_LOCK_OD();
+
+    /* Send event driven TPDOs with changed data now. No time has passed for
+     * PDO timers, synchronous TPDOs still wait for the SYNC. Outside of the
+     * synchronous window the commit is skipped, changed data is then sent in
+     * the next interval, as without commit. */
+    if(CO->CANmodule[0]->CANnormal && isInsideSYNCwindow()) {
+        if(taskRT.ipBuffer != NULL) {
+            CO_ipBuffer_process(taskRT.ipBuffer);
+        }
+        if(taskRT.setpointMux != NULL) {
+            CO_setpointMux_process(taskRT.setpointMux);
+        }
+        CO_process_TPDO(CO, false, 0);
+    }
+
+    /* Unlock */
+    CO_UNLOCK_OD();
+
+    return true;
+}
@@ -27,6 +27,10 @@
 #ifndef CO_LINUX_TASKS_H
 #define CO_LINUX_TASKS_H
 
+#include "CO_SYNCjitter.h"
+#include "CO_setpointMux.h"
+#include "CO_ipBuffer.h"
+
 
 /**
  * Initialize mainline task.
@@ -87,6 +91,52 @@ void taskMain_cbSignal(void);
  */
 void CANrx_taskTmr_init(int fdEpoll, long intervalns, uint16_t *maxTime);
 
+/**
+ * Measure jitter of produced SYNC messages in realtime task.
+ *
+ * SYNC is produced inside the interval. With this object, the realtime task
+ * reports the scheduled time of each produced SYNC to it and, if correction
+ * is enabled, schedules the interval, which produces SYNC, earlier by
+ * CO_SYNCjitter_getAdvance(). Other intervals stay on the grid.
+ *
+ * @param jitter SYNC jitter object, initialized with CO_SYNCjitter_init(). NULL
+ * disables measurement.
+ */
+void CANrx_taskTmr_setSYNCjitter(CO_SYNCjitter_t *jitter);
+
+/**
+ * Get the SYNC jitter object of the realtime task.
+ *
+ * @return Object from CANrx_taskTmr_setSYNCjitter(), NULL if none.
+ */
+CO_SYNCjitter_t *CANrx_taskTmr_getSYNCjitter(void);
+
+/**
+ * Send setpoints multiplexed into shared frames in realtime task.
+ *
+ * Before TPDOs are processed (in the interval and after
+ * CANrx_taskTmr_commitSetpoints()), CO_setpointMux_process() sends the
+ * multiplexed frames and marks their setpoints as sent in the per node
+ * TPDOs.
+ *
+ * @param mux Multiplexer, initialized with CO_setpointMux_init() and its
+ * slots added. NULL disables it, setpoints are then sent in per node TPDOs.
+ */
+void CANrx_taskTmr_setSetpointMux(CO_setpointMux_t *mux);
+
+/**
+ * Feed the buffers of the drives in Interpolated Position mode in realtime
+ * task.
+ *
+ * After SYNC is processed (in the interval and after
+ * CANrx_taskTmr_commitSetpoints()), CO_ipBuffer_process() counts the points
+ * taken by the drives and sends them the next samples.
+ *
+ * @param ip Buffer feeder, initialized with CO_ipBuffer_init() and its axes
+ * added. NULL disables it.
+ */
+void CANrx_taskTmr_setIPbuffer(CO_ipBuffer_t *ip);
+
 /**
  * Cleanup realtime task.
  */
@@ -103,6 +153,33 @@ void CANrx_taskTmr_close(void);
  */
 bool_t CANrx_taskTmr_process(int fd);
 
+/**
+ * Commit setpoints written into Object Dictionary by the application.
+ *
+ * Function may be called from any thread (typically from the control loop,
+ * after all setpoints of the cycle are written). It wakes the realtime thread,
+ * which sends event driven TPDOs (transmission type 254 and 255) with changed
+ * data immediately, instead of at the next interval. Inhibit time is
+ * respected. Synchronous TPDOs are sent after SYNC, as before.
+ *
+ * If synchronous window length (0x1007) is set, setpoints committed after the
+ * window closed are not sent immediately, but in the next interval, as without
+ * commit.
+ */
+void CANrx_taskTmr_commitSetpoints(void);
+
+/**
+ * Process committed setpoints in realtime task.
+ *
+ * Function must be called after epoll, before CANrx_taskTmr_process(). It does
+ * not advance the interval of the realtime task.
+ *
+ * @param fd Available file descriptor from epoll().
+ *
+ * @return True, if fd was matched.
+ */
+bool_t CANrx_taskTmr_processCommit(int fd);
+
 /**
  * Disable CAN receive thread temporary.
  *
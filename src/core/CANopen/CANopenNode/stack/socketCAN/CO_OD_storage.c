@@ -33,11 +33,105 @@
 #include <stdio.h>
 #include <string.h>     /* for memcpy */
 #include <stdlib.h>     /* for malloc, free */
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 
 #define RETURN_SUCCESS  0
 #define RETURN_ERROR   -1
 
+#define STORAGE_MAGIC   0x53444F43UL    /* "CODS" */
+#define STORAGE_SLOTS   2
+
+
+/* Header of one slot in the storage file. It is followed by CRC of each page
+ * (uint16_t[noOfPages]) and then by the memory block (at dataOffset). */
+typedef struct {
+    uint32_t    magic;
+    uint32_t    sequence;       /* incremented on each save */
+    uint32_t    odSize;
+    uint16_t    pageSize;
+    uint16_t    headerCRC;      /* CRC of header (with headerCRC=0) and page CRCs */
+} CO_OD_storageHeader_t;
+
+
+/* Helper functions ***********************************************************/
+static CO_OD_storageHeader_t *slotHeader(CO_OD_storage_t *odStor, int slot) {
+    return (CO_OD_storageHeader_t*)(odStor->map + slot * odStor->slotSize);
+}
+
+static uint16_t *slotPageCRC(CO_OD_storage_t *odStor, int slot) {
+    return (uint16_t*)(odStor->map + slot * odStor->slotSize + sizeof(CO_OD_storageHeader_t));
+}
+
+static uint8_t *slotData(CO_OD_storage_t *odStor, int slot) {
+    return odStor->map + slot * odStor->slotSize + odStor->dataOffset;
+}
+
+static uint32_t pageLength(CO_OD_storage_t *odStor, uint16_t page) {
+    uint32_t offset = (uint32_t)page * CO_OD_STORAGE_PAGE_SIZE;
+    uint32_t len = odStor->odSize - offset;
+    return len < CO_OD_STORAGE_PAGE_SIZE ? len : CO_OD_STORAGE_PAGE_SIZE;
+}
+
+static uint16_t headerCRC(CO_OD_storage_t *odStor, int slot) {
+    CO_OD_storageHeader_t header = *slotHeader(odStor, slot);
+
+    header.headerCRC = 0;
+    return crc16_ccitt((unsigned char*)slotPageCRC(odStor, slot), odStor->noOfPages * sizeof(uint16_t),
+                       crc16_ccitt((unsigned char*)&header, sizeof(header), 0));
+}
+
+/* Slot is valid, if header, header CRC and all page CRCs match. */
+static bool_t slotValid(CO_OD_storage_t *odStor, int slot) {
+    CO_OD_storageHeader_t *header = slotHeader(odStor, slot);
+    uint16_t *pageCRC = slotPageCRC(odStor, slot);
+    uint8_t *data = slotData(odStor, slot);
+    uint16_t page;
+
+    if(header->magic != STORAGE_MAGIC || header->odSize != odStor->odSize ||
+       header->pageSize != CO_OD_STORAGE_PAGE_SIZE || header->headerCRC != headerCRC(odStor, slot)) {
+        return false;
+    }
+    for(page = 0; page < odStor->noOfPages; page++) {
+        if(pageCRC[page] != crc16_ccitt(data + page * CO_OD_STORAGE_PAGE_SIZE, pageLength(odStor, page), 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Move the storage file, which can not be used, to "<filename>.bak" and
+ * start a new empty file in its place. */
+static int backupFile(CO_OD_storage_t *odStor) {
+    size_t len = strlen(odStor->filename);
+    char *backup = (char*)malloc(len + 5);
+    int ret;
+
+    if(backup == NULL) {
+        return RETURN_ERROR;
+    }
+    memcpy(backup, odStor->filename, len);
+    memcpy(backup + len, ".bak", 5);
+    ret = rename(odStor->filename, backup);
+    free(backup);
+    if(ret != 0) {
+        return RETURN_ERROR;
+    }
+    close(odStor->fd);
+    odStor->fd = open(odStor->filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    return odStor->fd < 0 ? RETURN_ERROR : RETURN_SUCCESS;
+}
+
+/* Flush part of the mapped file to disk (msync requires page aligned address). */
+static int syncRange(CO_OD_storage_t *odStor, uint32_t offset, uint32_t len) {
+    uint32_t aligned = offset - offset % (uint32_t)sysconf(_SC_PAGESIZE);
+
+    return msync(odStor->map + aligned, len + offset - aligned, MS_SYNC);
+}
+
 
 /******************************************************************************/
 CO_SDO_abortCode_t CO_ODF_1010(CO_ODF_arg_t *ODF_arg) {
@@ -55,7 +149,7 @@ CO_SDO_abortCode_t CO_ODF_1010(CO_ODF_arg_t *ODF_arg) {
         if(ODF_arg->subIndex == 1) {
             /* store parameters */
             if(value == 0x65766173UL) {
-                if(CO_OD_storage_saveSecure(odStor->odAddress, odStor->odSize, odStor->filename) != 0) {
+                if(CO_OD_storage_saveSecure(odStor) != 0) {
                     ret = CO_SDO_AB_HW;
                 }
             }
@@ -85,7 +179,7 @@ CO_SDO_abortCode_t CO_ODF_1011(CO_ODF_arg_t *ODF_arg) {
         if(ODF_arg->subIndex >= 1) {
             /* restore default parameters */
             if(value == 0x64616F6CUL) {
-                if(CO_OD_storage_restoreSecure(odStor->filename) != 0) {
+                if(CO_OD_storage_restoreSecure(odStor) != 0) {
                     ret = CO_SDO_AB_HW;
                 }
             }
@@ -100,124 +194,106 @@ CO_SDO_abortCode_t CO_ODF_1011(CO_ODF_arg_t *ODF_arg) {
 
 
 /******************************************************************************/
-int CO_OD_storage_saveSecure(
-        uint8_t                *odAddress,
-        uint32_t                odSize,
-        char                   *filename)
-{
-    int ret = RETURN_SUCCESS;
-
-    char *filename_old = NULL;
-    uint16_t CRC = 0;
-
-    /* Generate new string with extension '.old' and rename current file to it. */
-    filename_old = (char*)malloc(strlen(filename)+10);
-    if(filename_old != NULL) {
-        strcpy(filename_old, filename);
-        strcat(filename_old, ".old");
+int CO_OD_storage_saveSecure(CO_OD_storage_t *odStor) {
+    int slot;
+    uint16_t page;
+    uint16_t *pageCRC;
+    uint8_t *data;
+    uint8_t *copy = NULL;
+    bool_t changed = false;
+    bool_t copyAny = false;
+    CO_OD_storageHeader_t *header;
+
+    if(odStor == NULL || odStor->map == NULL) {
+        return RETURN_ERROR;
+    }
 
-        remove(filename_old);
-        if(rename(filename, filename_old) != 0) {
-            ret = RETURN_ERROR;
+    /* Find modified pages. Comparison is done without lock: page, which is
+     * being written just now, is either detected now or on the next save. */
+    if(odStor->activeSlot >= 0) {
+        uint8_t *active = slotData(odStor, odStor->activeSlot);
+        for(page = 0; page < odStor->noOfPages && !changed; page++) {
+            uint32_t offset = (uint32_t)page * CO_OD_STORAGE_PAGE_SIZE;
+            changed = memcmp(odStor->odAddress + offset, active + offset, pageLength(odStor, page)) != 0;
+        }
+        if(!changed) {
+            return RETURN_SUCCESS;
         }
-    } else {
-        ret = RETURN_ERROR;
     }
 
-    /* Open a new file and write data to it, including CRC. */
-    if(ret == RETURN_SUCCESS) {
-        FILE *fp = fopen(filename, "w");
-        if(fp != NULL) {
+    /* Write into the older slot. Pages which differ from its (older) content
+     * are copied, this includes pages modified before the last save. */
+    slot = odStor->activeSlot == 0 ? 1 : 0;
+    header = slotHeader(odStor, slot);
+    pageCRC = slotPageCRC(odStor, slot);
+    data = slotData(odStor, slot);
 
-            CO_LOCK_OD();
-            fwrite((const void *)odAddress, 1, odSize, fp);
-            CRC = crc16_ccitt((unsigned char*)odAddress, odSize, 0);
-            CO_UNLOCK_OD();
-
-            fwrite((const void *)&CRC, 1, 2, fp);
-            fclose(fp);
-        } else {
-            ret = RETURN_ERROR;
+    copy = (uint8_t*)calloc(odStor->noOfPages, 1);
+    if(copy == NULL) {
+        return RETURN_ERROR;
+    }
+    for(page = 0; page < odStor->noOfPages; page++) {
+        uint32_t offset = (uint32_t)page * CO_OD_STORAGE_PAGE_SIZE;
+        if(header->magic != STORAGE_MAGIC ||
+           memcmp(odStor->odAddress + offset, data + offset, pageLength(odStor, page)) != 0) {
+            copy[page] = 1;
+            copyAny = true;
         }
     }
 
-    /* Verify data */
-    if(ret == RETURN_SUCCESS) {
-        void *buf = NULL;
-        FILE *fp = NULL;
-        uint32_t cnt = 0;
-        uint16_t CRC2 = 0;
-
-        buf = malloc(odSize + 4);
-        if(buf != NULL) {
-            fp = fopen(filename, "r");
-            if(fp != NULL) {
-                cnt = fread(buf, 1, odSize, fp);
-                CRC2 = crc16_ccitt((unsigned char*)buf, odSize, 0);
-                /* read also two bytes of CRC */
-                cnt += fread(buf, 1, 4, fp);
-                fclose(fp);
+    /* Invalidate the slot, then copy modified pages. Lock is held only for memcpy. */
+    header->magic = 0;
+    if(copyAny) {
+        CO_LOCK_OD();
+        for(page = 0; page < odStor->noOfPages; page++) {
+            if(copy[page]) {
+                uint32_t offset = (uint32_t)page * CO_OD_STORAGE_PAGE_SIZE;
+                memcpy(data + offset, odStor->odAddress + offset, pageLength(odStor, page));
             }
-            free(buf);
         }
-        /* If size or CRC differs, report error */
-        if(buf == NULL || fp == NULL || cnt != (odSize + 2) || CRC != CRC2) {
-            ret = RETURN_ERROR;
+        CO_UNLOCK_OD();
+    }
+
+    for(page = 0; page < odStor->noOfPages; page++) {
+        if(copy[page]) {
+            pageCRC[page] = crc16_ccitt(data + page * CO_OD_STORAGE_PAGE_SIZE, pageLength(odStor, page), 0);
         }
     }
+    free(copy);
 
-    /* In case of error, set back the old file. */
-    if(ret != RETURN_SUCCESS && filename_old != NULL) {
-        remove(filename);
-        rename(filename_old, filename);
+    /* data must be on disk before the header, which commits the slot */
+    if(syncRange(odStor, slot * odStor->slotSize, odStor->slotSize) != 0) {
+        return RETURN_ERROR;
     }
 
-    free(filename_old);
+    header->sequence = odStor->activeSlot >= 0 ? slotHeader(odStor, odStor->activeSlot)->sequence + 1 : 1;
+    header->odSize = odStor->odSize;
+    header->pageSize = CO_OD_STORAGE_PAGE_SIZE;
+    header->magic = STORAGE_MAGIC;
+    header->headerCRC = headerCRC(odStor, slot);
+    if(syncRange(odStor, slot * odStor->slotSize, sizeof(CO_OD_storageHeader_t)) != 0) {
+        return RETURN_ERROR;
+    }
 
-    return ret;
+    odStor->activeSlot = slot;
+    return RETURN_SUCCESS;
 }
 
 
 /******************************************************************************/
-int CO_OD_storage_restoreSecure(char *filename) {
-    int ret = RETURN_SUCCESS;
-    FILE *fp = NULL;
-
-    /* If filename already exists, rename it to '.old'. */
-    fp = fopen(filename, "r");
-    if(fp != NULL) {
-        char *filename_old = NULL;
+int CO_OD_storage_restoreSecure(CO_OD_storage_t *odStor) {
+    int slot;
 
-        fclose(fp);
-
-        filename_old = (char*)malloc(strlen(filename)+10);
-        if(filename_old != NULL) {
-            strcpy(filename_old, filename);
-            strcat(filename_old, ".old");
-
-            remove(filename_old);
-            if(rename(filename, filename_old) != 0) {
-                ret = RETURN_ERROR;
-            }
-            free(filename_old);
-        }
-        else {
-            ret = RETURN_ERROR;
-        }
+    if(odStor == NULL || odStor->map == NULL) {
+        return RETURN_ERROR;
     }
 
-    /* create an empty file and write "-\n" to it. */
-    if(ret == RETURN_SUCCESS) {
-        fp = fopen(filename, "w");
-        if(fp != NULL) {
-            fputs("-\n", fp);
-            fclose(fp);
-        } else {
-            ret = RETURN_ERROR;
-        }
+    for(slot = 0; slot < STORAGE_SLOTS; slot++) {
+        slotHeader(odStor, slot)->magic = 0;
     }
+    odStor->activeSlot = -1;
 
-    return ret;
+    return msync(odStor->map, odStor->mapSize, MS_SYNC) == 0 ? RETURN_SUCCESS : RETURN_ERROR;
 }
 
 
@@ -229,62 +305,126 @@ CO_ReturnError_t CO_OD_storage_init(
         char                   *filename)
 {
     CO_ReturnError_t ret = CO_ERROR_NO;
-    void *buf = NULL;
+    struct stat st;
+    uint8_t *legacy = NULL;
+    uint32_t legacySize = 0;
 
     /* verify arguments */
-    if(odStor==NULL || odAddress==NULL) {
-        ret = CO_ERROR_ILLEGAL_ARGUMENT;
+    if(odStor==NULL || odAddress==NULL || odSize==0) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
     }
 
-    /* configure object variables and allocate buffer */
-    if(ret == CO_ERROR_NO) {
-        odStor->odAddress = odAddress;
-        odStor->odSize = odSize;
-        odStor->filename = filename;
-        odStor->fp = NULL;
-        odStor->tmr1msPrev = 0;
-        odStor->lastSavedMs = 0;
+    /* configure object variables */
+    odStor->odAddress = odAddress;
+    odStor->odSize = odSize;
+    odStor->filename = filename;
+    odStor->map = NULL;
+    odStor->activeSlot = -1;
+    odStor->tmr1msPrev = 0;
+    odStor->lastSavedMs = 0;
+    odStor->noOfPages = (odSize + CO_OD_STORAGE_PAGE_SIZE - 1) / CO_OD_STORAGE_PAGE_SIZE;
+    odStor->dataOffset = (sizeof(CO_OD_storageHeader_t) + odStor->noOfPages * sizeof(uint16_t) + 7U) & ~7U;
+    odStor->slotSize = (odStor->dataOffset + odSize + 7U) & ~7U;
+    odStor->mapSize = STORAGE_SLOTS * odStor->slotSize;
+
+    odStor->fd = open(filename, O_RDWR | O_CREAT, 0644);
+    if(odStor->fd < 0 || fstat(odStor->fd, &st) != 0) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* File in the old format (memory block + CRC) or "-\n" for default values.
+     * It is validated before the file is touched: a file, which can not be
+     * imported, is kept as backup and storage starts from default values. */
+    if(st.st_size > 0 && (uint32_t)st.st_size != odStor->mapSize) {
+        legacySize = (uint32_t)st.st_size;
+        legacy = (uint8_t*)malloc(legacySize);
+        if(legacy == NULL || pread(odStor->fd, legacy, legacySize, 0) != (ssize_t)legacySize) {
+            ret = CO_ERROR_DATA_CORRUPT;
+        }
+        else if(legacySize == 2 && legacy[0] == '-') {
+            /* file is empty, default values will be used, no error */
+        }
+        else if(legacySize == odSize + 2) {
+            uint16_t CRC;
+            memcpy(&CRC, legacy + odSize, 2);
+            if(CRC != crc16_ccitt(legacy, odSize, 0)) {
+                ret = CO_ERROR_CRC;
+            }
+        }
+        else {
+            /* file length does not match, e.g. written with a different Object Dictionary */
+            ret = CO_ERROR_DATA_CORRUPT;
+        }
 
-        buf = malloc(odStor->odSize);
-        if(buf == NULL) {
-            ret = CO_ERROR_OUT_OF_MEMORY;
+        if(ret != CO_ERROR_NO) {
+            free(legacy);
+            legacy = NULL;
+            if(backupFile(odStor) != 0) {
+                /* file is left as it is, storage is not available */
+                return ret;
+            }
+        }
+        else if(ftruncate(odStor->fd, 0) != 0) {
+            /* validated content is converted into an empty file */
+            free(legacy);
+            return CO_ERROR_OUT_OF_MEMORY;
         }
     }
 
-    /* read data from the file and verify CRC */
-    if(ret == CO_ERROR_NO) {
-        FILE *fp;
-        uint32_t cnt = 0;
-        uint16_t CRC[2];
-
-        fp = fopen(odStor->filename, "r");
-        if(fp) {
-            cnt = fread(buf, 1, odStor->odSize, fp);
-            /* read also two bytes of CRC from file */
-            cnt += fread(&CRC[0], 1, 4, fp);
-            CRC[1] = crc16_ccitt((unsigned char*)buf, odStor->odSize, 0);
-            fclose(fp);
+    if(ftruncate(odStor->fd, odStor->mapSize) != 0) {
+        free(legacy);
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    void *map = mmap(NULL, odStor->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, odStor->fd, 0);
+    if(map == MAP_FAILED) {
+        free(legacy);
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    odStor->map = (uint8_t*)map;
+
+    if(legacy != NULL) {
+        if(legacySize == odSize + 2) {
+            memcpy(odAddress, legacy, odSize);
+            if(CO_OD_storage_saveSecure(odStor) != RETURN_SUCCESS) {
+                ret = CO_ERROR_DATA_CORRUPT;
+            }
         }
+    }
+    else {
+        bool_t valid[STORAGE_SLOTS];
+        bool_t anyHeader = false;
+        int slot;
 
-        if(cnt == 2 && *((char*)buf) == '-') {
-            /* file is empty, default values will be used, no error */
-            ret = CO_ERROR_NO;
+        for(slot = 0; slot < STORAGE_SLOTS; slot++) {
+            valid[slot] = slotValid(odStor, slot);
+            anyHeader |= slotHeader(odStor, slot)->magic == STORAGE_MAGIC;
         }
-        else if(cnt != (odStor->odSize + 2)) {
-            /* file length does not match */
-            ret = CO_ERROR_DATA_CORRUPT;
+        if(valid[0] && valid[1]) {
+            int32_t diff = (int32_t)(slotHeader(odStor, 1)->sequence - slotHeader(odStor, 0)->sequence);
+            odStor->activeSlot = diff > 0 ? 1 : 0;
+        }
+        else if(valid[0] || valid[1]) {
+            odStor->activeSlot = valid[0] ? 0 : 1;
         }
-        else if(CRC[0] != CRC[1]) {
-            /* CRC does not match */
+        else if(anyHeader) {
+            /* slots were written, but none is valid */
             ret = CO_ERROR_CRC;
         }
-        else {
+
+        /* invalid slot is rewritten completely on the next save */
+        for(slot = 0; slot < STORAGE_SLOTS; slot++) {
+            if(!valid[slot]) {
+                slotHeader(odStor, slot)->magic = 0;
+            }
+        }
+
+        if(odStor->activeSlot >= 0) {
             /* no errors, copy data into Object dictionary */
-            memcpy(odStor->odAddress, buf, odStor->odSize);
+            memcpy(odAddress, slotData(odStor, odStor->activeSlot), odSize);
         }
     }
 
-    free(buf);
+    free(legacy);
 
     return ret;
 }
@@ -300,7 +440,7 @@ CO_ReturnError_t CO_OD_storage_autoSave(
 
     /* verify arguments */
     if(odStor==NULL || odStor->odAddress==NULL) {
-        ret = CO_ERROR_ILLEGAL_ARGUMENT;
+        return CO_ERROR_ILLEGAL_ARGUMENT;
     }
 
     /* don't save file more often than delay */
@@ -308,63 +448,11 @@ CO_ReturnError_t CO_OD_storage_autoSave(
         odStor->lastSavedMs += timer1ms - odStor->tmr1msPrev;
     }
     else {
-        void *buf = NULL;
-        bool_t saveData = false;
-
-        /* allocate buffer and open file if necessary */
-        if(ret == CO_ERROR_NO) {
-            buf = malloc(odStor->odSize);
-            if(odStor->fp == NULL) {
-                odStor->fp = fopen(odStor->filename, "r+");
-            }
-            if(buf == NULL || odStor->fp == NULL) {
-                ret = CO_ERROR_OUT_OF_MEMORY;
-            }
-        }
-
-        /* read data from the beginning of the file */
-        if(ret == CO_ERROR_NO) {
-            uint32_t cnt = 0;
-
-            rewind(odStor->fp);
-            cnt = fread(buf, 1, odStor->odSize, odStor->fp);
-
-            if(cnt == 2 && *((char*)buf) == '-') {
-                /* file is empty, data will be saved. */
-                saveData = true;
-            }
-            else if(cnt == odStor->odSize) {
-                /* verify, if data differs */
-                if(memcmp((const void *)buf, (const void *)odStor->odAddress, odStor->odSize) != 0) {
-                    saveData = true;
-                }
-            }
-            else {
-                /* file length does not match */
-                ret = CO_ERROR_DATA_CORRUPT;
-            }
-        }
-
-        /* Save the data to the file only if data differs. */
-        if(ret == CO_ERROR_NO && saveData) {
-            uint16_t CRC;
-
-            /* copy data to temporary buffer */
-            memcpy(buf, odStor->odAddress, odStor->odSize);
-
-            rewind(odStor->fp);
-            fwrite((const void *)buf, 1, odStor->odSize, odStor->fp);
-
-            /* write also CRC */
-            CRC = crc16_ccitt((unsigned char*)buf, odStor->odSize, 0);
-            fwrite((const void *)&CRC, 1, 2, odStor->fp);
-
-            fflush(odStor->fp);
-
-            odStor->lastSavedMs = 0;
+        /* Save only modified pages, nothing is written if data are the same. */
+        if(CO_OD_storage_saveSecure(odStor) != RETURN_SUCCESS) {
+            ret = CO_ERROR_DATA_CORRUPT;
         }
-
-        free(buf);
+        odStor->lastSavedMs = 0;
     }
 
     odStor->tmr1msPrev = timer1ms;
@@ -373,7 +461,13 @@ CO_ReturnError_t CO_OD_storage_autoSave(
 }
 
 void CO_OD_storage_autoSaveClose(CO_OD_storage_t *odStor) {
-    if(odStor->fp != NULL) {
-        fclose(odStor->fp);
+    if(odStor->map != NULL) {
+        msync(odStor->map, odStor->mapSize, MS_SYNC);
+        munmap(odStor->map, odStor->mapSize);
+        odStor->map = NULL;
+    }
+    if(odStor->fd >= 0) {
+        close(odStor->fd);
+        odStor->fd = -1;
     }
 }
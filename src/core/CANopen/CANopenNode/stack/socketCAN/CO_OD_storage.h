@@ -45,66 +45,85 @@ CO_SDO_abortCode_t CO_ODF_1011(CO_ODF_arg_t *ODF_arg);
 
 
 /**
- * Save memory block to a file.
+ * Size of the page (in bytes) of Object Dictionary storage.
  *
- * Function renames current file to filename.old, copies contents from odAddress
- * to filename, adds two bytes of CRC code. It then verifies the written file and
- * in case of errors sets back the old file and returns error.
- *
- * Function is used with CANopen OD object at index 1010.
+ * Storage tracks changes and calculates CRC for each page separately, so only
+ * modified pages are copied on save.
+ */
+#ifndef CO_OD_STORAGE_PAGE_SIZE
+    #define CO_OD_STORAGE_PAGE_SIZE     256U
+#endif
+
+
+/**
+ * Object Dictionary storage object.
  *
- * @param odAddress Address of the memory block, which will be stored.
- * @param odSize Size of the above memory block.
- * @param filename Name of the file, where data will be stored.
+ * Object is used with CANopen OD objects at index 1010 and 1011.
  *
- * @return 0 on success, -1 on error.
+ * Memory block is stored in a memory mapped file with two slots. Each slot
+ * contains a header (sequence number, CRC of each page and CRC of the header)
+ * and a copy of the memory block. Save copies the modified pages into the
+ * older slot and then writes its header with the next sequence number. If
+ * writing is interrupted, header or page CRC does not match and the other slot
+ * is used on next startup.
  */
-int CO_OD_storage_saveSecure(
-        uint8_t                *odAddress,
-        uint32_t                odSize,
-        char                   *filename);
+typedef struct {
+    uint8_t    *odAddress;      /**< From CO_OD_storage_init() */
+    uint32_t    odSize;         /**< From CO_OD_storage_init() */
+    char       *filename;       /**< From CO_OD_storage_init() */
+    int         fd;             /**< File descriptor of the storage file, -1 if not opened. */
+    uint8_t    *map;            /**< Memory mapped storage file, NULL if not mapped. */
+    uint32_t    mapSize;        /**< Size of the storage file. */
+    uint32_t    slotSize;       /**< Size of one slot in the storage file. */
+    uint32_t    dataOffset;     /**< Offset of memory block within the slot. */
+    uint16_t    noOfPages;      /**< Number of pages in memory block. */
+    int8_t      activeSlot;     /**< Slot with last saved data, -1 if none. */
+    uint16_t    tmr1msPrev;     /**< used with CO_OD_storage_autoSave. */
+    uint32_t    lastSavedMs;    /**< used with CO_OD_storage_autoSave. */
+} CO_OD_storage_t;
 
 
 /**
- * Remove OD storage file.
+ * Save memory block to the storage file.
  *
- * Function renames current file to filename.old, then creates empty file and
- * writes two bytes "-\n" to it. When program will start next time, default values
- * are used for Object Dictionary. In case of error in renaming to .old it
- * keeps the original file and returns error.
+ * Function compares memory block with the last saved data. If it differs, it
+ * copies modified pages into the older slot, while holding CO_LOCK_OD, then
+ * updates their CRC, flushes them to disk and commits the slot by writing its
+ * header.
  *
- * Writing data to file is secured with mutex CO_LOCK_OD.
- *
- * Function is used with CANopen OD object at index 1011.
+ * Function is used with CANopen OD object at index 1010.
  *
- * @param filename Name of the file.
+ * @param odStor OD storage object.
  *
- * @return 0 on success, -1 on error.
+ * @return 0 on success (or if memory block was not changed), -1 on error.
  */
-int CO_OD_storage_restoreSecure(char *filename);
+int CO_OD_storage_saveSecure(CO_OD_storage_t *odStor);
 
 
 /**
- * Object Dictionary storage object.
+ * Restore default values.
  *
- * Object is used with CANopen OD objects at index 1010 and 1011.
+ * Function invalidates both slots of the storage file. When program will start
+ * next time, default values are used for Object Dictionary.
+ *
+ * Function is used with CANopen OD object at index 1011.
+ *
+ * @param odStor OD storage object.
+ *
+ * @return 0 on success, -1 on error.
  */
-typedef struct {
-    uint8_t    *odAddress;      /**< From CO_OD_storage_init() */
-    uint32_t    odSize;         /**< From CO_OD_storage_init() */
-    char       *filename;       /**< From CO_OD_storage_init() */
-    /** If CO_OD_storage_autoSave() is used, file stays opened and fp is stored here. */
-    FILE       *fp;
-    uint16_t    tmr1msPrev;     /**< used with CO_OD_storage_autoSave. */
-    uint32_t    lastSavedMs;    /**< used with CO_OD_storage_autoSave. */
-} CO_OD_storage_t;
+int CO_OD_storage_restoreSecure(CO_OD_storage_t *odStor);
 
 
 /**
  * Initialize OD storage object and load data from file.
  *
- * Called after program startup. Load storage file and copy data to Object
- * Dictionary variables.
+ * Called after program startup. Open (or create) and map the storage file and
+ * copy data from the newest valid slot to Object Dictionary variables. File
+ * in the old format (memory block followed by CRC) is loaded and converted,
+ * once its CRC is verified. A file, which can not be loaded (CRC error, read
+ * error or size of a different memory block), is not modified: it is renamed
+ * to "<filename>.bak" and a new file with default values is used.
  *
  * @param odStor This object will be initialized.
  * @param odAddress Address of the memory block from Object dictionary, where data will be copied.
@@ -112,8 +131,8 @@ typedef struct {
  * @param filename Name of the file, where data are stored.
  *
  * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_DATA_CORRUPT (Data in file corrupt),
- * CO_ERROR_CRC (CRC from MBR does not match the CRC of OD_ROM block in file),
- * CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_OUT_OF_MEMORY (malloc failed).
+ * CO_ERROR_CRC (CRC of the slots or of the old format file does not match, default values are used),
+ * CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_OUT_OF_MEMORY (file can not be mapped).
  */
 CO_ReturnError_t CO_OD_storage_init(
         CO_OD_storage_t        *odStor,
@@ -125,16 +144,15 @@ CO_ReturnError_t CO_OD_storage_init(
 /**
  * Automatically save memory block if differs from file.
  *
- * Should be called cyclically by program. It first verifies, if memory block
- * differs from file and if it does, it saves it to file with two additional
- * CRC bytes. File remains opened.
+ * Should be called cyclically by program. It calls CO_OD_storage_saveSecure()
+ * at most once per delay.
  *
  * @param odStor OD storage object.
  * @param timer1ms Variable, which must increment each millisecond.
  * @param delay Delay (inhibit) time between writes to disk in milliseconds (60000 for example).
  *
- * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_DATA_CORRUPT (Data in file corrupt),
- * CO_ERROR_ILLEGAL_ARGUMENT or CO_ERROR_OUT_OF_MEMORY (malloc failed).
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_DATA_CORRUPT (Data could not be saved)
+ * or CO_ERROR_ILLEGAL_ARGUMENT.
  */
 CO_ReturnError_t CO_OD_storage_autoSave(
         CO_OD_storage_t        *odStor,
@@ -143,7 +161,7 @@ CO_ReturnError_t CO_OD_storage_autoSave(
 
 
 /**
- * Closes file opened by CO_OD_storage_autoSave.
+ * Unmaps and closes the storage file.
  *
  * @param odStor OD storage object.
  */
@@ -0,0 +1,181 @@
+/**
+ * CANopen SYNC producer jitter measurement and phase correction.
+ *
+ * @file        CO_SYNCjitter.c
+ * @author      William Campbell
+ * @copyright   2020
+ *
+ * See CO_SYNCjitter.h.
+ */
+
+
+#include "CO_SYNCjitter.h"
+#include <string.h>
+
+
+#define NSEC_PER_SEC 1000000000LL
+
+
+static int64_t toNs(const struct timespec *ts) {
+    return (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+
+static void clearStats(CO_SYNCjitter_stats_t *stats) {
+    int32_t advance = stats->advance;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->periodDevMin = INT32_MAX;
+    stats->periodDevMax = INT32_MIN;
+    stats->latencyMin = INT32_MAX;
+    stats->latencyMax = INT32_MIN;
+    stats->advance = advance;
+}
+
+
+/* Called by CO_CANrxWait() (realtime thread) with the transmit timestamp of
+ * the SYNC message (CLOCK_REALTIME). */
+static void CO_SYNCjitter_txTimestamp(void *object, const struct timespec *timestamp) {
+    CO_SYNCjitter_t *jitter = (CO_SYNCjitter_t*) object;
+    CO_SYNCjitter_stats_t *stats = &jitter->stats;
+    int64_t transmitted;
+    int32_t latency;
+    uint32_t entry;
+
+    if(!jitter->timestampPending) {
+        return;
+    }
+    jitter->timestampPending = false;
+
+    transmitted = toNs(timestamp) + jitter->realtimeOffset;
+    latency = (int32_t)(transmitted - jitter->scheduled);
+
+    /* period jitter */
+    if(jitter->lastTransmitted != 0) {
+        int32_t dev = (int32_t)(transmitted - jitter->lastTransmitted - (int64_t)jitter->SYNC->periodTime * 1000);
+        uint32_t bin = (uint32_t)(dev < 0 ? -dev : dev) / CO_SYNC_JITTER_BIN_NS;
+
+        if(bin >= CO_SYNC_JITTER_BINS) bin = CO_SYNC_JITTER_BINS - 1;
+        stats->histogram[bin]++;
+        if(dev < stats->periodDevMin) stats->periodDevMin = dev;
+        if(dev > stats->periodDevMax) stats->periodDevMax = dev;
+
+        if(latency < stats->latencyMin) stats->latencyMin = latency;
+        if(latency > stats->latencyMax) stats->latencyMax = latency;
+        stats->latencySum += latency;
+        stats->noOfSamples++;
+    }
+    jitter->lastTransmitted = transmitted;
+
+    /* Sequence lock: the entry is marked invalid before the time is written and
+     * valid after it, readers check the cycle before and after the time. The
+     * 64 bit time is written atomically, it could tear on 32 bit targets. */
+    entry = jitter->pendingCycle % CO_SYNC_JITTER_TIMES;
+    __atomic_store_n(&jitter->cycles[entry], jitter->pendingCycle + 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&jitter->times[entry], transmitted, __ATOMIC_RELAXED);
+    __atomic_store_n(&jitter->cycles[entry], jitter->pendingCycle, __ATOMIC_RELEASE);
+
+    /* Phase locked loop with sign phase detector. Latency is measured against
+     * the uncorrected tick, advance moves by a fixed step until half of the
+     * SYNC messages are transmitted before the grid and half after it (median
+     * latency), so single late wakeups do not pull it. */
+    if(jitter->correction) {
+        int32_t advance = stats->advance;
+
+        if(latency > 0) advance += CO_SYNC_JITTER_PLL_STEP_NS;
+        else if(latency < 0) advance -= CO_SYNC_JITTER_PLL_STEP_NS;
+        if(advance < 0) advance = 0;
+        else if(advance > jitter->maxAdvance) advance = jitter->maxAdvance;
+        stats->advance = advance;
+    }
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_SYNCjitter_init(CO_SYNCjitter_t *jitter, CO_SYNC_t *SYNC, bool_t correction, int32_t maxAdvance) {
+    uint32_t i;
+
+    if(jitter == NULL || SYNC == NULL || maxAdvance < 0) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    jitter->SYNC = SYNC;
+    jitter->correction = correction;
+    jitter->maxAdvance = maxAdvance;
+    jitter->scheduled = 0;
+    jitter->realtimeOffset = 0;
+    jitter->timestampPending = false;
+    jitter->lastTransmitted = 0;
+    jitter->pendingCycle = 0;
+    for(i = 0; i < CO_SYNC_JITTER_TIMES; i++) {
+        jitter->times[i] = 0;
+        jitter->cycles[i] = i + 1U;
+    }
+    jitter->stats.advance = 0;
+    clearStats(&jitter->stats);
+
+    if(!SYNC->isProducer) {
+        return CO_ERROR_NO;
+    }
+    return CO_CANtxTimestampInit(SYNC->CANdevTx, SYNC->CANtxBuff, (void*)jitter, CO_SYNCjitter_txTimestamp);
+}
+
+
+/******************************************************************************/
+void CO_SYNCjitter_produced(CO_SYNCjitter_t *jitter, const struct timespec *scheduled) {
+    struct timespec mono, real;
+    int64_t scheduledNs = toNs(scheduled);
+
+    if(jitter->timestampPending) {
+        /* previous SYNC was not timestamped, its period can not be measured */
+        jitter->stats.noOfMissed++;
+        jitter->lastTransmitted = 0;
+    }
+    if(scheduledNs - jitter->scheduled > (int64_t)jitter->SYNC->periodTime * 1500) {
+        /* SYNC was not produced for a while (NMT state, period changed) */
+        jitter->lastTransmitted = 0;
+    }
+
+    /* Kernel timestamps are CLOCK_REALTIME, realtime task runs on CLOCK_MONOTONIC */
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+    clock_gettime(CLOCK_REALTIME, &real);
+    jitter->realtimeOffset = toNs(&mono) - toNs(&real);
+
+    jitter->scheduled = scheduledNs;
+    jitter->pendingCycle = jitter->SYNC->cycle;
+    jitter->timestampPending = true;
+}
+
+
+/******************************************************************************/
+int32_t CO_SYNCjitter_getAdvance(CO_SYNCjitter_t *jitter) {
+    return jitter->correction ? jitter->stats.advance : 0;
+}
+
+
+/******************************************************************************/
+bool_t CO_SYNCjitter_getTransmitTime(const CO_SYNCjitter_t *jitter, uint32_t cycle, int64_t *time) {
+    uint32_t i = cycle % CO_SYNC_JITTER_TIMES;
+    int64_t t;
+
+    if(__atomic_load_n(&jitter->cycles[i], __ATOMIC_ACQUIRE) != cycle) {
+        return false;
+    }
+    t = __atomic_load_n(&jitter->times[i], __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if(__atomic_load_n(&jitter->cycles[i], __ATOMIC_RELAXED) != cycle) {
+        return false;
+    }
+    *time = t;
+    return true;
+}
+
+
+/******************************************************************************/
+void CO_SYNCjitter_getStats(CO_SYNCjitter_t *jitter, CO_SYNCjitter_stats_t *stats, bool_t reset) {
+    *stats = jitter->stats;
+    if(reset) {
+        clearStats(&jitter->stats);
+    }
+}
@@ -0,0 +1,159 @@
+/**
+ * CANopen SYNC producer jitter measurement and phase correction.
+ *
+ * @file        CO_SYNCjitter.h
+ * @author      William Campbell
+ * @copyright   2020
+ *
+ * SYNC is produced by CO_SYNC_process() on the tick of the realtime task
+ * (timerfd, CLOCK_MONOTONIC), drives latch PDOs on it. Time between the
+ * scheduled tick and the SYNC leaving the socket (wakeup latency of the
+ * realtime thread, processing before SYNC) is seen by every joint.
+ *
+ * This object requests kernel transmit timestamps for the SYNC message (see
+ * CO_CANtxTimestampInit()) and measures:
+ *  - period jitter: deviation of the time between two consecutive SYNC
+ *    messages from the communication cycle period, as min, max and histogram;
+ *  - latency: time from the scheduled tick to the transmit timestamp.
+ *
+ * With correction enabled, a phase locked loop estimates the median latency
+ * and the realtime task schedules the tick, which produces SYNC, that much
+ * earlier (see CANrx_taskTmr_setSYNCjitter()). SYNC is then on the bus at the
+ * CLOCK_MONOTONIC grid of the realtime task, independent of the constant part
+ * of the latency.
+ *
+ * Transmit timestamps require support of the CAN driver (software timestamp in
+ * the transmit path). If they are not provided, no samples are collected and
+ * noOfMissed increases.
+ */
+
+#ifndef CO_SYNC_JITTER_H
+#define CO_SYNC_JITTER_H
+
+#include <CO_driver.h>  // Must be included by CO_SYNC.h due to typedefs being here.
+
+#include "CO_SDO.h"
+#include "CO_Emergency.h"
+#include "CO_NMT_Heartbeat.h"
+#include "CO_SYNC.h"
+
+/** Number of bins of the period jitter histogram, last bin counts all larger deviations */
+#ifndef CO_SYNC_JITTER_BINS
+#define CO_SYNC_JITTER_BINS 16
+#endif
+
+/** Width of one histogram bin in nanoseconds */
+#ifndef CO_SYNC_JITTER_BIN_NS
+#define CO_SYNC_JITTER_BIN_NS 10000
+#endif
+
+/** Number of transmit times kept, see CO_SYNCjitter_getTransmitTime() */
+#ifndef CO_SYNC_JITTER_TIMES
+#define CO_SYNC_JITTER_TIMES 8
+#endif
+
+/** Change of the phase correction per SYNC period in nanoseconds */
+#ifndef CO_SYNC_JITTER_PLL_STEP_NS
+#define CO_SYNC_JITTER_PLL_STEP_NS 1000
+#endif
+
+/**
+ * SYNC jitter statistics.
+ */
+typedef struct {
+    uint32_t noOfSamples;                     /**< Number of measured SYNC periods */
+    uint32_t noOfMissed;                      /**< Number of SYNC messages without transmit timestamp */
+    int32_t periodDevMin;                     /**< Minimum deviation from the SYNC period [ns] */
+    int32_t periodDevMax;                     /**< Maximum deviation from the SYNC period [ns] */
+    uint32_t histogram[CO_SYNC_JITTER_BINS];  /**< Absolute deviation from the SYNC period, bins of CO_SYNC_JITTER_BIN_NS */
+    int32_t latencyMin;                       /**< Minimum time from scheduled tick to transmission [ns] */
+    int32_t latencyMax;                       /**< Maximum time from scheduled tick to transmission [ns] */
+    int64_t latencySum;                       /**< Sum of latencies, for mean value [ns] */
+    int32_t advance;                          /**< Current phase correction [ns] */
+} CO_SYNCjitter_stats_t;
+
+/**
+ * SYNC jitter object.
+ */
+typedef struct {
+    CO_SYNC_t *SYNC;                /**< From CO_SYNCjitter_init() */
+    bool_t correction;              /**< From CO_SYNCjitter_init() */
+    int32_t maxAdvance;             /**< From CO_SYNCjitter_init() */
+    int64_t scheduled;              /**< Scheduled time of the last produced SYNC (CLOCK_MONOTONIC) [ns] */
+    int64_t realtimeOffset;         /**< CLOCK_MONOTONIC - CLOCK_REALTIME, when the last SYNC was produced [ns] */
+    bool_t timestampPending;        /**< Last produced SYNC has no transmit timestamp yet */
+    int64_t lastTransmitted;        /**< Transmit time of the previous SYNC (CLOCK_MONOTONIC) [ns], 0 if unknown */
+    uint32_t pendingCycle;          /**< SYNC cycle (CO_SYNC_t::cycle) of the last produced SYNC */
+    int64_t times[CO_SYNC_JITTER_TIMES];   /**< Transmit times of the last SYNC messages (CLOCK_MONOTONIC) [ns] */
+    uint32_t cycles[CO_SYNC_JITTER_TIMES]; /**< SYNC cycle of each entry of times, (cycle + 1) for empty entries */
+    CO_SYNCjitter_stats_t stats;    /**< Statistics */
+} CO_SYNCjitter_t;
+
+/**
+ * Initialize SYNC jitter object.
+ *
+ * Function must be called in the communication reset section, after
+ * CO_init(). If the device is not SYNC producer, nothing is measured.
+ *
+ * @param jitter This object will be initialized.
+ * @param SYNC SYNC object.
+ * @param correction If true, the tick, which produces SYNC, is scheduled earlier by the median latency.
+ * @param maxAdvance Maximum phase correction [ns], typically half of the realtime task interval.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT (transmit
+ * timestamps are not supported).
+ */
+CO_ReturnError_t CO_SYNCjitter_init(CO_SYNCjitter_t *jitter, CO_SYNC_t *SYNC, bool_t correction, int32_t maxAdvance);
+
+/**
+ * Record the scheduled time of the SYNC message, which was just produced.
+ *
+ * Called by the realtime task after CO_process_SYNC_RPDO(), if SYNC was
+ * produced.
+ *
+ * @param jitter This object.
+ * @param scheduled Time of the tick without correction (CLOCK_MONOTONIC).
+ */
+void CO_SYNCjitter_produced(CO_SYNCjitter_t *jitter, const struct timespec *scheduled);
+
+/**
+ * Get the phase correction for the next SYNC.
+ *
+ * @param jitter This object.
+ *
+ * @return Time [ns], by which the tick producing SYNC is scheduled earlier,
+ * zero if correction is disabled.
+ */
+int32_t CO_SYNCjitter_getAdvance(CO_SYNCjitter_t *jitter);
+
+/**
+ * Get the transmit time of a SYNC message.
+ *
+ * Drives sample their feedback on SYNC, so this is the sample time of the
+ * feedback received in that SYNC cycle. Times of the last CO_SYNC_JITTER_TIMES
+ * SYNC messages are kept. Times are written by the realtime thread under a
+ * sequence lock (atomic accesses, release on write and acquire on read), the
+ * cycle of the entry is read before and after the time to detect a concurrent
+ * update, so any thread may call this function.
+ *
+ * @param jitter This object.
+ * @param cycle SYNC cycle (CO_SYNC_t::cycle after the SYNC was produced).
+ * @param [out] time Transmit time (CLOCK_MONOTONIC) [ns].
+ *
+ * @return true if the time is known, false if the SYNC was not timestamped
+ * or is too old.
+ */
+bool_t CO_SYNCjitter_getTransmitTime(const CO_SYNCjitter_t *jitter, uint32_t cycle, int64_t *time);
+
+/**
+ * Get the statistics and optionally reset them.
+ *
+ * Statistics are updated by the realtime thread, so a sample may be torn.
+ *
+ * @param jitter This object.
+ * @param [out] stats Statistics.
+ * @param reset If true, statistics are cleared (phase correction is kept).
+ */
+void CO_SYNCjitter_getStats(CO_SYNCjitter_t *jitter, CO_SYNCjitter_stats_t *stats, bool_t reset);
+
+#endif
@@ -30,6 +30,12 @@
 #include <stdlib.h> /* for malloc, free */
 #include <errno.h>
 #include <sys/socket.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+
+
+/* Maximum number of transmit timestamps not yet received */
+#define CO_CAN_TX_TIMESTAMP_MAX_PENDING 4U
 
 
 /******************************************************************************/
@@ -146,6 +152,10 @@ CO_ReturnError_t CO_CANmodule_init(
         CANmodule->CANtxCount = 0U;
         CANmodule->errOld = 0U;
         CANmodule->em = NULL;
+        CANmodule->txTimestampObject = NULL;
+        CANmodule->pFunctTxTimestamp = NULL;
+        CANmodule->txTimestampPending = 0U;
+        CANmodule->txTimestampDisabled = false;
 
 #ifdef CO_LOG_CAN_MESSAGES
         CANmodule->useCANrxFilters = false;
@@ -157,6 +167,7 @@ CO_ReturnError_t CO_CANmodule_init(
         }
         for(i=0U; i<txSize; i++){
             txArray[i].bufferFull = false;
+            txArray[i].txTimestamp = false;
         }
     }
 
@@ -299,13 +310,117 @@ CO_CANtx_t *CO_CANtxBufferInit(
 }
 
 
+/******************************************************************************/
+CO_ReturnError_t CO_CANtxTimestampInit(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANtx_t             *buffer,
+        void                   *object,
+        void                  (*pFunct)(void *object, const struct timespec *timestamp))
+{
+    /* Report software timestamps, but generate them only for frames, which
+     * request it (SO_TIMESTAMPING control message in sendmsg()). */
+    int flags = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_TSONLY;
+
+    if(CANmodule == NULL || buffer == NULL || pFunct == NULL){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    if(setsockopt(CANmodule->fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != 0){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    CANmodule->txTimestampObject = object;
+    CANmodule->pFunctTxTimestamp = pFunct;
+    CANmodule->txTimestampPending = 0U;
+    CANmodule->txTimestampDisabled = false;
+    buffer->txTimestamp = true;
+
+    return CO_ERROR_NO;
+}
+
+
+/* Send CAN message and request software transmit timestamp for it */
+static ssize_t sendTimestamped(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer, size_t count){
+    union {
+        char buf[CMSG_SPACE(sizeof(uint32_t))];
+        struct cmsghdr align;
+    } control;
+    struct iovec iov;
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+    uint32_t tsFlags = SOF_TIMESTAMPING_TX_SOFTWARE;
+    ssize_t n;
+
+    iov.iov_base = buffer;
+    iov.iov_len = count;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SO_TIMESTAMPING;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(tsFlags));
+    memcpy(CMSG_DATA(cmsg), &tsFlags, sizeof(tsFlags));
+
+    n = sendmsg(CANmodule->fd, &msg, 0);
+    if(n == (ssize_t)count){
+        CANmodule->txTimestampPending++;
+    }
+    return n;
+}
+
+
+/* Read one transmit timestamp from the socket error queue, nonblocking.
+ * Returns true, if timestamp was read. */
+static bool_t readTxTimestamp(CO_CANmodule_t *CANmodule){
+    char control[CMSG_SPACE(sizeof(struct scm_timestamping)) + CMSG_SPACE(sizeof(struct sock_extended_err))];
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if(recvmsg(CANmodule->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0){
+        return false;
+    }
+
+    if(CANmodule->txTimestampPending > 0U){
+        CANmodule->txTimestampPending--;
+    }
+    for(cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+        if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPING && CANmodule->pFunctTxTimestamp != NULL){
+            struct scm_timestamping ts;
+
+            /* ts[0] is software timestamp */
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            CANmodule->pFunctTxTimestamp(CANmodule->txTimestampObject, &ts.ts[0]);
+            break;
+        }
+    }
+    return true;
+}
+
+
 /******************************************************************************/
 CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
     CO_ReturnError_t err = CO_ERROR_NO;
     ssize_t n;
     size_t count = sizeof(struct can_frame);
 
-    n = write(CANmodule->fd, buffer, count);
+    if(buffer->txTimestamp && CANmodule->txTimestampPending >= CO_CAN_TX_TIMESTAMP_MAX_PENDING){
+        /* CAN driver does not provide timestamps, stop requesting them */
+        buffer->txTimestamp = false;
+        CANmodule->txTimestampDisabled = true;
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_TX_TIMESTAMP, CO_EMC_COMMUNICATION, CANmodule->txTimestampPending);
+        CANmodule->txTimestampPending = 0U;
+    }
+
+    if(buffer->txTimestamp && CANmodule->pFunctTxTimestamp != NULL){
+        n = sendTimestamped(CANmodule, buffer, count);
+    }else{
+        n = write(CANmodule->fd, buffer, count);
+    }
 #ifdef CO_LOG_CAN_MESSAGES
     void CO_logMessage(const CanMsg *msg);
     CO_logMessage((const CanMsg*) buffer);
@@ -399,9 +514,21 @@ void CO_CANrxWait(CO_CANmodule_t *CANmodule){
         CO_errExit("CO_CANreceive - CANmodule not configured.");
     }
 
-    /* Read socket and pre-process message */
+    /* Transmit timestamps make the socket readable (error queue), read the
+     * expected ones first. */
+    if(CANmodule->txTimestampPending > 0U && readTxTimestamp(CANmodule)){
+        return;
+    }
+
+    /* Read socket and pre-process message. Without a message, the socket was
+     * reported for its error queue (EPOLLERR): drain it, whatever the number
+     * of pending timestamps, or epoll reports the socket again forever. */
     size = sizeof(struct can_frame);
-    n = read(CANmodule->fd, &msg, size);
+    n = recv(CANmodule->fd, &msg, size, MSG_DONTWAIT);
+    if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+        while(readTxTimestamp(CANmodule));
+        return;
+    }
 
     if(CANmodule->CANnormal){
         if(n != size){
@@ -32,6 +32,7 @@
 #include <stdbool.h> /* for 'true', 'false' */
 #include <stddef.h>  /* for 'NULL' */
 #include <stdint.h>  /* for 'int8_t' to 'uint64_t' */
+#include <time.h>    /* for 'struct timespec' */
 #include <unistd.h>
 
 #ifndef CO_SINGLE_THREAD
@@ -131,6 +132,7 @@ typedef struct {
     uint8_t data[8] __attribute__((aligned(8)));
     volatile bool_t bufferFull;
     volatile bool_t syncFlag;
+    bool_t txTimestamp; /* request kernel transmit timestamp, see CO_CANtxTimestampInit */
 } CO_CANtx_t;
 
 /* CAN module object. */
@@ -154,6 +156,10 @@ typedef struct {
     volatile uint16_t CANtxCount;
     uint32_t errOld;
     void *em;
+    void *txTimestampObject; /* from CO_CANtxTimestampInit */
+    void (*pFunctTxTimestamp)(void *object, const struct timespec *timestamp);
+    uint16_t txTimestampPending; /* number of timestamps not yet read from error queue */
+    bool_t txTimestampDisabled; /* CAN driver did not provide timestamps, CO_CANsend() stopped requesting them */
 } CO_CANmodule_t;
 
 /* Endianes */
@@ -208,6 +214,27 @@ CO_CANtx_t *CO_CANtxBufferInit(
     uint8_t noOfBytes,
     bool_t syncFlag);
 
+/* Error status bit of the emergency reported, if transmit timestamps were
+ * requested, but the CAN driver does not provide them (manufacturer specific,
+ * info). */
+#define CO_EM_CAN_TX_TIMESTAMP 0x30U
+
+/* Request kernel transmit timestamps for one transmit buffer.
+ *
+ * Software timestamp (CLOCK_REALTIME) is taken by the kernel, when the frame
+ * is passed to the CAN driver. It is read from the socket error queue by
+ * CO_CANrxWait(), which then calls pFunct. Other transmit buffers are not
+ * timestamped. If the CAN driver does not provide timestamps (several are
+ * pending), CO_CANsend() stops requesting them, sets txTimestampDisabled and
+ * reports CO_EM_CAN_TX_TIMESTAMP emergency. Function must be called after
+ * CO_CANmodule_init(), in the communication reset section. Returns
+ * CO_ERROR_ILLEGAL_ARGUMENT, if kernel does not support timestamping. */
+CO_ReturnError_t CO_CANtxTimestampInit(
+    CO_CANmodule_t *CANmodule,
+    CO_CANtx_t *buffer,
+    void *object,
+    void (*pFunct)(void *object, const struct timespec *timestamp));
+
 /* Send CAN message. */
 
 CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer);
@@ -217,7 +244,13 @@ void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule);
 /* Verify all errors of CAN module. */
 void CO_CANverifyErrors(CO_CANmodule_t *CANmodule);
 
-/* Functions receives CAN messages. It is blocking.
+/* Functions receives CAN messages. It must be called after epoll reported the
+ * CAN socket, it does not block.
+ *
+ * If transmit timestamp is pending, it is read from the error queue first and
+ * the function returns (epoll reports the CAN socket again, if there is also a
+ * message). If there is no message, all entries of the error queue are read,
+ * also timestamps, which arrived after CO_CANsend() stopped requesting them.
  *
  * @param CANmodule This object.
  */
@@ -0,0 +1,221 @@
+/**
+ * CANopen Interpolated Position mode buffer feeder.
+ *
+ * @file        CO_ipBuffer.c
+ * @author      William Campbell
+ * @copyright   2020
+ *
+ * See CO_ipBuffer.h.
+ */
+
+
+#include "CO_ipBuffer.h"
+#include <string.h>
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_ipBuffer_init(CO_ipBuffer_t *ip, const CO_SYNC_t *SYNC, uint16_t depth, uint16_t lead, uint8_t maxPerProcess) {
+    if(ip == NULL || SYNC == NULL || lead == 0U || lead > depth || maxPerProcess == 0U) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    memset(ip, 0, sizeof(*ip));
+    ip->SYNC = SYNC;
+    ip->depth = depth;
+    ip->lead = lead;
+    ip->maxPerProcess = maxPerProcess;
+    ip->SYNCcycle = SYNC->cycle;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_ipBuffer_addAxis(CO_ipBuffer_t *ip, int32_t *target, const uint16_t *statusWord, CO_TPDO_t *const TPDOs[], uint16_t noOfTPDOs,
+                                     const uint16_t *bufferPosition, CO_RPDO_t *const RPDOs[], uint16_t noOfRPDOs) {
+    CO_ipBuffer_axis_t *axis;
+    uint16_t i, j;
+
+    if(ip->noOfAxes >= CO_IP_BUFFER_MAX_AXES) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    for(i = 0; i < noOfTPDOs; i++) {
+        if(TPDOs[i] != NULL && CO_TPDO_isMapped(TPDOs[i], target)) {
+            break;
+        }
+    }
+    if(i == noOfTPDOs || statusWord == NULL) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    if(bufferPosition != NULL) {
+        for(j = 0; j < noOfRPDOs; j++) {
+            if(RPDOs[j] != NULL && CO_RPDO_isMapped(RPDOs[j], bufferPosition)) {
+                break;
+            }
+        }
+        if(j == noOfRPDOs) {
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    axis = &ip->axes[ip->noOfAxes];
+    memset(axis, 0, sizeof(*axis));
+    axis->target = target;
+    axis->TPDO = TPDOs[i];
+    axis->statusWord = statusWord;
+    axis->bufferPosition = bufferPosition;
+    axis->noOfSent = ip->noOfPushed;
+    axis->noOfSentAtSYNC = ip->noOfPushed;
+    ip->noOfAxes++;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_ipBuffer_clear(CO_ipBuffer_t *ip) {
+    uint8_t i;
+
+    ip->noOfPushed = 0;
+    ip->finished = false;
+    ip->SYNCcycle = ip->SYNC->cycle;
+    for(i = 0; i < ip->noOfAxes; i++) {
+        ip->axes[i].noOfSent = 0;
+        ip->axes[i].noOfSentAtSYNC = 0;
+        ip->axes[i].level = 0;
+    }
+}
+
+
+/******************************************************************************/
+uint16_t CO_ipBuffer_getFree(const CO_ipBuffer_t *ip) {
+    uint32_t oldest = ip->noOfPushed;
+    uint8_t i;
+
+    /* sample stays in the ring, until it is sent to all drives */
+    for(i = 0; i < ip->noOfAxes; i++) {
+        if(ip->axes[i].noOfSent < oldest) {
+            oldest = ip->axes[i].noOfSent;
+        }
+    }
+    return (uint16_t)(CO_IP_BUFFER_RING_SIZE - (ip->noOfPushed - oldest));
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_ipBuffer_push(CO_ipBuffer_t *ip, const int32_t sample[]) {
+    if(ip->finished || CO_ipBuffer_getFree(ip) == 0U) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+
+    memcpy(ip->ring[ip->noOfPushed % CO_IP_BUFFER_RING_SIZE], sample, ip->noOfAxes * sizeof(int32_t));
+    ip->noOfPushed++;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_ipBuffer_finish(CO_ipBuffer_t *ip) {
+    ip->finished = true;
+}
+
+
+/******************************************************************************/
+bool_t CO_ipBuffer_isDone(const CO_ipBuffer_t *ip) {
+    uint8_t i;
+
+    if(!ip->finished) {
+        return false;
+    }
+    for(i = 0; i < ip->noOfAxes; i++) {
+        if(ip->axes[i].noOfSent != ip->noOfPushed || ip->axes[i].level != 0U) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/******************************************************************************/
+uint16_t CO_ipBuffer_getMinLevel(const CO_ipBuffer_t *ip) {
+    uint16_t level = 0;
+    uint8_t i;
+
+    for(i = 0; i < ip->noOfAxes; i++) {
+        if(i == 0U || ip->axes[i].level < level) {
+            level = ip->axes[i].level;
+        }
+    }
+    return level;
+}
+
+
+/******************************************************************************/
+uint32_t CO_ipBuffer_getNoOfTaken(const CO_ipBuffer_t *ip) {
+    uint32_t taken = 0;
+    uint8_t i;
+
+    for(i = 0; i < ip->noOfAxes; i++) {
+        uint32_t axisTaken = ip->axes[i].noOfSent - ip->axes[i].level;
+        if(i == 0U || axisTaken < taken) {
+            taken = axisTaken;
+        }
+    }
+    return taken;
+}
+
+
+/******************************************************************************/
+void CO_ipBuffer_process(CO_ipBuffer_t *ip) {
+    uint32_t taken = ip->SYNC->cycle - ip->SYNCcycle;
+    uint8_t i;
+
+    ip->SYNCcycle = ip->SYNC->cycle;
+
+    for(i = 0; i < ip->noOfAxes; i++) {
+        CO_ipBuffer_axis_t *axis = &ip->axes[i];
+        CO_TPDO_t *TPDO = axis->TPDO;
+        uint8_t n;
+
+        /* drive takes one point per SYNC, while Interpolated Position mode is active */
+        if(taken > 0U && (*axis->statusWord & CO_IP_BUFFER_STATUS_ACTIVE) != 0U) {
+            if(taken > axis->level) {
+                if(!ip->finished || axis->noOfSent != ip->noOfPushed) {
+                    axis->noOfUnderruns += taken - axis->level;
+                }
+                axis->level = 0;
+            }
+            else {
+                axis->level -= (uint16_t)taken;
+            }
+        }
+        if(taken > 0U) {
+            axis->noOfSentAtSYNC = axis->noOfSent;
+        }
+        if(axis->bufferPosition != NULL) {
+            /* position reported by the drive at the last SYNC, plus the points sent since,
+             * at most the points sent (position of the cleared buffer may not be received yet) */
+            uint32_t level = (uint32_t)*axis->bufferPosition + (axis->noOfSent - axis->noOfSentAtSYNC);
+            axis->level = (uint16_t)(level < axis->noOfSent ? level : axis->noOfSent);
+        }
+
+        if(!TPDO->valid || *TPDO->operatingState != CO_NMT_OPERATIONAL) {
+            continue;
+        }
+
+        /* top up, the burst is limited for the CAN transmit queue */
+        for(n = 0; n < ip->maxPerProcess; n++) {
+            if(axis->level >= ip->lead || axis->noOfSent == ip->noOfPushed) {
+                break;
+            }
+            *axis->target = ip->ring[axis->noOfSent % CO_IP_BUFFER_RING_SIZE][i];
+            if(CO_TPDOsend(TPDO) != CO_ERROR_NO) {
+                /* point is sent again in the next call */
+                break;
+            }
+            axis->noOfSent++;
+            axis->level++;
+        }
+    }
+}
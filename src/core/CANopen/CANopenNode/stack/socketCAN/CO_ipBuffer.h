@@ -0,0 +1,206 @@
+/**
+ * CANopen Interpolated Position mode buffer feeder.
+ *
+ * @file        CO_ipBuffer.h
+ * @author      William Campbell
+ * @copyright   2020
+ *
+ * In Interpolated Position mode (CiA 402 mode 7) the drive keeps a FIFO of
+ * interpolation data records (0x60C1) and takes one of them every
+ * interpolation time period (0x60C2, the SYNC period), while Interpolated
+ * Position mode is active (Control Word bit 4, Status Word bit 12). The
+ * host does not need to send a setpoint before each SYNC, it only keeps the
+ * drive buffer filled some points ahead.
+ *
+ * This object holds the samples of the motion in a ring, written by the
+ * application with CO_ipBuffer_push(), and in the realtime task tops up the
+ * buffer of each drive to `lead` points. A point is sent in the per node
+ * TPDO, which maps the OD variable of the axis (e.g. 0x607A subindex of the
+ * drive, mapped by the drive to 0x60C1 sub 1): the variable is written and
+ * the TPDO is sent immediately, several times per cycle if needed.
+ *
+ * Level of the drive buffer is the buffer-level feedback of the protocol.
+ * Drive takes one point per SYNC produced or received by this node while its
+ * Status Word reports Interpolated Position mode active, so the level is
+ * counted on the host: points sent minus points taken. If the drive sends its
+ * buffer position (0x60C4 sub 4, mapped by the master to the 0x60C4 subindex
+ * of the drive, see CO_OD_motors.h) every SYNC, the level is that position
+ * plus the points sent since the last SYNC instead, which follows points lost
+ * or not taken by the drive. Position received before the drive answered the
+ * last SYNC counts one point too many, until the next process call.
+ *
+ * If an active drive takes a point from an empty buffer, before the motion is
+ * finished (CO_ipBuffer_finish()), underrun is counted: the drive holds its
+ * last point and the motion is delayed.
+ */
+
+#ifndef CO_IP_BUFFER_H
+#define CO_IP_BUFFER_H
+
+#include <CO_driver.h>  // Must be included by CO_PDO.h due to typedefs being here.
+
+#include "CO_SDO.h"
+#include "CO_Emergency.h"
+#include "CO_NMT_Heartbeat.h"
+#include "CO_SYNC.h"
+#include "CO_PDO.h"
+
+/** Maximum number of axes (drives) of one buffer */
+#ifndef CO_IP_BUFFER_MAX_AXES
+#define CO_IP_BUFFER_MAX_AXES 8
+#endif
+
+/** Number of samples in the ring of the host */
+#ifndef CO_IP_BUFFER_RING_SIZE
+#define CO_IP_BUFFER_RING_SIZE 64
+#endif
+
+/** Status Word bit: Interpolated Position mode active */
+#define CO_IP_BUFFER_STATUS_ACTIVE 0x1000U
+
+/**
+ * One axis of the buffer.
+ */
+typedef struct {
+    int32_t *target;                /**< OD variable sent to the drive, from CO_ipBuffer_addAxis() */
+    CO_TPDO_t *TPDO;                /**< Per node TPDO, which maps target */
+    const uint16_t *statusWord;     /**< Status Word of the drive, from CO_ipBuffer_addAxis() */
+    const uint16_t *bufferPosition; /**< Buffer position received from the drive, from CO_ipBuffer_addAxis(), or NULL */
+    uint32_t noOfSentAtSYNC;        /**< noOfSent at the last SYNC, points sent since are not in bufferPosition yet */
+    uint32_t noOfSent;              /**< Number of samples sent to the drive */
+    uint16_t level;                 /**< Number of points in the drive buffer */
+    uint32_t noOfUnderruns;         /**< Number of points the active drive took from its empty buffer */
+} CO_ipBuffer_axis_t;
+
+/**
+ * Interpolated Position mode buffer feeder object.
+ */
+typedef struct {
+    const CO_SYNC_t *SYNC;          /**< From CO_ipBuffer_init() */
+    uint16_t depth;                 /**< From CO_ipBuffer_init() */
+    uint16_t lead;                  /**< From CO_ipBuffer_init() */
+    uint8_t maxPerProcess;          /**< From CO_ipBuffer_init() */
+    uint8_t noOfAxes;               /**< Number of added axes */
+    CO_ipBuffer_axis_t axes[CO_IP_BUFFER_MAX_AXES]; /**< Axes, in order of the samples */
+    int32_t ring[CO_IP_BUFFER_RING_SIZE][CO_IP_BUFFER_MAX_AXES]; /**< Samples not sent to all drives yet */
+    uint32_t noOfPushed;            /**< Number of samples pushed since CO_ipBuffer_clear() */
+    uint32_t SYNCcycle;             /**< SYNC cycle, at which the levels were last updated */
+    bool_t finished;                /**< True after CO_ipBuffer_finish(), no more samples will be pushed */
+} CO_ipBuffer_t;
+
+/**
+ * Initialize Interpolated Position mode buffer feeder object.
+ *
+ * Function must be called in the communication reset section, after
+ * CO_init(), and before axes are added.
+ *
+ * @param ip This object will be initialized.
+ * @param SYNC SYNC object, its cycle counts the points taken by the drives.
+ * @param depth Size of the drive buffers in points (0x60C4 sub 2).
+ * @param lead Number of points kept in the drive buffers, 1 to depth. Each
+ * point is one SYNC period of tolerance to the host.
+ * @param maxPerProcess Maximum number of points sent to one drive in one
+ * CO_ipBuffer_process() call, limits the burst on the CAN bus.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_ipBuffer_init(CO_ipBuffer_t *ip, const CO_SYNC_t *SYNC, uint16_t depth, uint16_t lead, uint8_t maxPerProcess);
+
+/**
+ * Add an axis, its value is the next element of the samples.
+ *
+ * @param ip This object.
+ * @param target OD variable sent to the drive (e.g. 0x607A subindex of the drive).
+ * @param statusWord Status Word of the drive (0x6041 subindex of the drive).
+ * @param TPDOs Array of pointers to TPDO objects (CO->TPDO), searched for the TPDO, which maps target.
+ * @param noOfTPDOs Number of TPDOs.
+ * @param bufferPosition Buffer position of the drive (0x60C4 subindex of the
+ * drive), or NULL to count the level on the host only.
+ * @param RPDOs Array of pointers to RPDO objects (CO->RPDO), searched for the RPDO, which maps bufferPosition.
+ * @param noOfRPDOs Number of RPDOs.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT (no valid
+ * TPDO maps target or no valid RPDO maps bufferPosition) or
+ * CO_ERROR_OUT_OF_MEMORY (all axes used).
+ */
+CO_ReturnError_t CO_ipBuffer_addAxis(CO_ipBuffer_t *ip, int32_t *target, const uint16_t *statusWord, CO_TPDO_t *const TPDOs[], uint16_t noOfTPDOs,
+                                     const uint16_t *bufferPosition, CO_RPDO_t *const RPDOs[], uint16_t noOfRPDOs);
+
+/**
+ * Clear the samples and the levels, start of a new motion.
+ *
+ * The drive buffers must be cleared too (0x60C4 sub 6), with Interpolated
+ * Position mode inactive. Function must be called with OD locked.
+ *
+ * @param ip This object.
+ */
+void CO_ipBuffer_clear(CO_ipBuffer_t *ip);
+
+/**
+ * Get number of samples, which can be pushed.
+ *
+ * @param ip This object.
+ *
+ * @return Number of free samples in the ring.
+ */
+uint16_t CO_ipBuffer_getFree(const CO_ipBuffer_t *ip);
+
+/**
+ * Push the next sample of the motion.
+ *
+ * Function must be called with OD locked.
+ *
+ * @param ip This object.
+ * @param sample One value per axis, in order of adding.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_OUT_OF_MEMORY (ring full).
+ */
+CO_ReturnError_t CO_ipBuffer_push(CO_ipBuffer_t *ip, const int32_t sample[]);
+
+/**
+ * Mark the motion finished: all samples are pushed, drives taking points from
+ * their empty buffers are not counted as underruns.
+ *
+ * @param ip This object.
+ */
+void CO_ipBuffer_finish(CO_ipBuffer_t *ip);
+
+/**
+ * Check if all samples were sent and taken by the drives.
+ *
+ * @param ip This object.
+ *
+ * @return True after CO_ipBuffer_finish(), when all drive buffers are empty.
+ */
+bool_t CO_ipBuffer_isDone(const CO_ipBuffer_t *ip);
+
+/**
+ * Get the lowest level of the drive buffers.
+ *
+ * @param ip This object.
+ *
+ * @return Lowest number of points in a drive buffer.
+ */
+uint16_t CO_ipBuffer_getMinLevel(const CO_ipBuffer_t *ip);
+
+/**
+ * Get the number of samples taken by all drives.
+ *
+ * @param ip This object.
+ *
+ * @return Lowest number of points taken by a drive since CO_ipBuffer_clear().
+ */
+uint32_t CO_ipBuffer_getNoOfTaken(const CO_ipBuffer_t *ip);
+
+/**
+ * Process Interpolated Position mode buffer feeder.
+ *
+ * Function updates the levels after SYNC and sends points to the drives
+ * below the lead. It must be called with OD locked, after
+ * CO_process_SYNC_RPDO() and before CO_process_TPDO().
+ *
+ * @param ip This object.
+ */
+void CO_ipBuffer_process(CO_ipBuffer_t *ip);
+
+#endif
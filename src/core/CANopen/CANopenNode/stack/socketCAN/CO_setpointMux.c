@@ -0,0 +1,131 @@
+/**
+ * CANopen multiplexed setpoint PDO.
+ *
+ * @file        CO_setpointMux.c
+ * @author      William Campbell
+ * @copyright   2020
+ *
+ * See CO_setpointMux.h.
+ */
+
+
+#include "CO_setpointMux.h"
+#include <string.h>
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_setpointMux_init(CO_setpointMux_t *mux, CO_CANmodule_t *CANdevTx, uint16_t COB_ID, uint16_t repeats) {
+    uint8_t i;
+
+    if(mux == NULL || CANdevTx == NULL ||
+       COB_ID == 0U || (COB_ID + CO_SETPOINT_MUX_FRAMES - 1U) > CAN_SFF_MASK) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    memset(mux, 0, sizeof(*mux));
+    mux->CANdevTx = CANdevTx;
+    mux->repeats = repeats;
+
+    /* Buffers are not in CAN module, socketCAN sends any buffer */
+    for(i = 0; i < CO_SETPOINT_MUX_FRAMES; i++) {
+        mux->CANtxBuff[i].ident = (uint32_t)(COB_ID + i) & CAN_SFF_MASK;
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_setpointMux_addSlot(CO_setpointMux_t *mux, const int32_t *target, CO_TPDO_t *const TPDOs[], uint16_t noOfTPDOs) {
+    CO_setpointMux_slot_t *slot;
+    uint16_t i;
+
+    if(mux->noOfSlots >= CO_SETPOINT_MUX_MAX_SLOTS) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    for(i = 0; i < noOfTPDOs; i++) {
+        if(TPDOs[i] != NULL && CO_TPDO_isMapped(TPDOs[i], target)) {
+            break;
+        }
+    }
+    if(i == noOfTPDOs) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    slot = &mux->slots[mux->noOfSlots];
+    slot->target = target;
+    slot->TPDO = TPDOs[i];
+    slot->sent = 0;
+    slot->sentValid = false;
+
+    /* frame length grows with its slots */
+    mux->CANtxBuff[mux->noOfSlots / CO_SETPOINT_MUX_SLOTS_PER_FRAME].DLC =
+        4U * (mux->noOfSlots % CO_SETPOINT_MUX_SLOTS_PER_FRAME + 1U);
+    mux->noOfSlots++;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_setpointMux_process(CO_setpointMux_t *mux) {
+    uint8_t frame;
+    uint8_t i;
+
+    if(mux->noOfSlots == 0U) {
+        return;
+    }
+    if(*mux->slots[0].TPDO->operatingState != CO_NMT_OPERATIONAL) {
+        /* drives get all setpoints, when PDOs are enabled again */
+        for(i = 0; i < mux->noOfSlots; i++) {
+            mux->slots[i].sentValid = false;
+        }
+        return;
+    }
+
+    for(frame = 0; frame * CO_SETPOINT_MUX_SLOTS_PER_FRAME < mux->noOfSlots; frame++) {
+        CO_CANtx_t *buffer = &mux->CANtxBuff[frame];
+        uint8_t first = frame * CO_SETPOINT_MUX_SLOTS_PER_FRAME;
+        uint8_t last = first + CO_SETPOINT_MUX_SLOTS_PER_FRAME;
+        bool_t changed = false;
+
+        if(last > mux->noOfSlots) {
+            last = mux->noOfSlots;
+        }
+        for(i = first; i < last; i++) {
+            CO_setpointMux_slot_t *slot = &mux->slots[i];
+            uint32_t target = (uint32_t)*slot->target;
+            uint8_t *data = &buffer->data[4 * (i - first)];
+
+            data[0] = (uint8_t)target;
+            data[1] = (uint8_t)(target >> 8);
+            data[2] = (uint8_t)(target >> 16);
+            data[3] = (uint8_t)(target >> 24);
+            if(!slot->sentValid || slot->sent != (int32_t)target) {
+                changed = true;
+            }
+        }
+
+        if(changed) {
+            mux->repeatsLeft[frame] = mux->repeats;
+        }
+        else if(mux->repeatsLeft[frame] > 0U) {
+            mux->repeatsLeft[frame]--;
+        }
+        else {
+            continue;
+        }
+
+        CO_CANsend(mux->CANdevTx, buffer);
+        mux->noOfFrames++;
+        for(i = first; i < last; i++) {
+            CO_setpointMux_slot_t *slot = &mux->slots[i];
+
+            slot->sent = *slot->target;
+            slot->sentValid = true;
+            if(slot->TPDO->valid) {
+                CO_TPDOmarkSent(slot->TPDO);
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ * CANopen multiplexed setpoint PDO.
+ *
+ * @file        CO_setpointMux.h
+ * @author      William Campbell
+ * @copyright   2020
+ *
+ * Each drive receives its target position (0x607A) in its own PDO, so the
+ * setpoints alone take one CAN frame per joint and cycle. This object packs
+ * the setpoints of two drives into one broadcast frame (manufacturer
+ * specific PDO, COB-ID given by the application), as absolute target
+ * positions:
+ *
+ * byte | 0..3        | 4..7
+ * ---- | ----------- | -----------
+ * data | slot 0      | slot 1
+ *
+ * Target position is INTEGER32, little endian. Drive maps its slot into an
+ * RPDO with COB-ID of the frame (dummy entry 0x0004 for the slot before it,
+ * see Drive::initPackedSetpoints()), so no manufacturer specific object is
+ * needed and a lost frame is corrected by the next one.
+ *
+ * A frame is sent, if any of its setpoints changed, then repeated for
+ * repeats cycles, so a lost last frame does not leave the drive short of its
+ * final setpoint.
+ *
+ * Each slot is backed by the usual per node TPDO of the master, which maps
+ * the same OD variable. When the frame is sent, the per node TPDO is marked
+ * as sent (see CO_TPDOmarkSent()), so its Change of State does not send the
+ * setpoint again.
+ *
+ * Drives, which can't map another RPDO, keep their per node PDOs and must
+ * not be added to the multiplexer.
+ */
+
+#ifndef CO_SETPOINT_MUX_H
+#define CO_SETPOINT_MUX_H
+
+#include <CO_driver.h>  // Must be included by CO_PDO.h due to typedefs being here.
+
+#include "CO_SDO.h"
+#include "CO_Emergency.h"
+#include "CO_NMT_Heartbeat.h"
+#include "CO_SYNC.h"
+#include "CO_PDO.h"
+
+/** Number of setpoints in one CAN frame */
+#define CO_SETPOINT_MUX_SLOTS_PER_FRAME 2
+
+/** Maximum number of setpoints of one multiplexer */
+#ifndef CO_SETPOINT_MUX_MAX_SLOTS
+#define CO_SETPOINT_MUX_MAX_SLOTS 8
+#endif
+
+/** Number of CAN frames of one multiplexer */
+#define CO_SETPOINT_MUX_FRAMES ((CO_SETPOINT_MUX_MAX_SLOTS + CO_SETPOINT_MUX_SLOTS_PER_FRAME - 1) / CO_SETPOINT_MUX_SLOTS_PER_FRAME)
+
+/**
+ * One setpoint of the multiplexer.
+ */
+typedef struct {
+    const int32_t *target;          /**< OD variable with the setpoint, from CO_setpointMux_addSlot() */
+    CO_TPDO_t *TPDO;                /**< Per node TPDO, which maps target */
+    int32_t sent;                   /**< Setpoint in the last sent frame */
+    bool_t sentValid;               /**< False, if the setpoint must be sent */
+} CO_setpointMux_slot_t;
+
+/**
+ * Multiplexed setpoint PDO object.
+ */
+typedef struct {
+    CO_CANmodule_t *CANdevTx;       /**< From CO_setpointMux_init() */
+    uint16_t repeats;               /**< From CO_setpointMux_init() */
+    uint8_t noOfSlots;              /**< Number of added slots */
+    CO_setpointMux_slot_t slots[CO_SETPOINT_MUX_MAX_SLOTS]; /**< Setpoints, in order of the frames */
+    CO_CANtx_t CANtxBuff[CO_SETPOINT_MUX_FRAMES]; /**< CAN frames, COB-ID of frame n is COB_ID + n */
+    uint16_t repeatsLeft[CO_SETPOINT_MUX_FRAMES]; /**< Number of cycles the unchanged frame is still sent */
+    uint32_t noOfFrames;            /**< Number of sent multiplexed frames */
+} CO_setpointMux_t;
+
+/**
+ * Initialize multiplexed setpoint PDO object.
+ *
+ * Function must be called in the communication reset section, after
+ * CO_init(), and before slots are added.
+ *
+ * @param mux This object will be initialized.
+ * @param CANdevTx CAN device for transmission.
+ * @param COB_ID CAN identifier of the first frame, following frames use next identifiers.
+ * @param repeats Number of cycles a frame is sent again after its setpoints stopped changing.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_setpointMux_init(CO_setpointMux_t *mux, CO_CANmodule_t *CANdevTx, uint16_t COB_ID, uint16_t repeats);
+
+/**
+ * Add a setpoint to the next slot.
+ *
+ * Slots are numbered in order of adding: slot n is in frame n / 2, at byte
+ * offset 4 * (n % 2).
+ *
+ * @param mux This object.
+ * @param target OD variable with the setpoint (e.g. 0x607A subindex of the drive).
+ * @param TPDOs Array of pointers to TPDO objects (CO->TPDO), searched for the TPDO, which maps target.
+ * @param noOfTPDOs Number of TPDOs.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT (no valid
+ * TPDO maps target) or CO_ERROR_OUT_OF_MEMORY (all slots used).
+ */
+CO_ReturnError_t CO_setpointMux_addSlot(CO_setpointMux_t *mux, const int32_t *target, CO_TPDO_t *const TPDOs[], uint16_t noOfTPDOs);
+
+/**
+ * Process multiplexed setpoints.
+ *
+ * Function sends the frames with changed (or repeated) setpoints and marks
+ * their per node TPDOs as sent. It must be called with OD locked, just before
+ * CO_process_TPDO(). Nothing is sent, if the node is not operational, all
+ * setpoints are sent when it is again.
+ *
+ * @param mux This object.
+ */
+void CO_setpointMux_process(CO_setpointMux_t *mux);
+
+#endif
@@ -117,12 +117,12 @@ struct sCO_OD_RAM CO_OD_RAM = {
               /*1410*/ {0x2L, 0x0191L, 0xfeL},
               /*1411*/ {0x2L, 0x0192L, 0xfeL},
               /*1412*/ {0x2L, 0x0193L, 0xfeL},
-              /*1413*/ {0x2L, 0x80000000L, 0xfeL},
-              /*1414*/ {0x2L, 0x80000000L, 0xfeL},
-              /*1415*/ {0x2L, 0x80000000L, 0xfeL},
-              /*1416*/ {0x2L, 0x80000000L, 0xfeL},
-              /*1417*/ {0x2L, 0x80000000L, 0xfeL},
-              /*1418*/ {0x2L, 0x80000000L, 0xfeL},
+              /*1413*/ {0x2L, 0x0481L, 0xfeL},
+              /*1414*/ {0x2L, 0x0482L, 0xfeL},
+              /*1415*/ {0x2L, 0x0483L, 0xfeL},
+              /*1416*/ {0x2L, 0x0484L, 0xfeL},
+              /*1417*/ {0x2L, 0x0485L, 0xfeL},
+              /*1418*/ {0x2L, 0x0486L, 0xfeL},
               /*1419*/ {0x2L, 0x80000000L, 0xfeL},
               /*141a*/ {0x2L, 0x80000000L, 0xfeL},
               /*141b*/ {0x2L, 0x80000000L, 0xfeL},
@@ -149,12 +149,12 @@ struct sCO_OD_RAM CO_OD_RAM = {
               /*1610*/ {0x1L, 0x60030010L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
               /*1611*/ {0x1L, 0x60040010L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
               /*1612*/ {0x1L, 0x60050010L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
-              /*1613*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
-              /*1614*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
-              /*1615*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
-              /*1616*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
-              /*1617*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
-              /*1618*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
+              /*1613*/ {0x1L, 0x60c40110L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
+              /*1614*/ {0x1L, 0x60c40210L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
+              /*1615*/ {0x1L, 0x60c40310L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
+              /*1616*/ {0x1L, 0x60c40410L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
+              /*1617*/ {0x1L, 0x60c40510L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
+              /*1618*/ {0x1L, 0x60c40610L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
               /*1619*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
               /*161a*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
               /*161b*/ {0x0L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
@@ -244,7 +244,7 @@ struct sCO_OD_RAM CO_OD_RAM = {
     /*2112*/ {0x0001L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
     /*2120*/ {0x5L, 0x1234567890abcdefL, 0x234567890abcdef1L, 12.345, 456.789, 0},
     /*2130*/ {0x3L, {'-'}, 0x00000000L, 0x0000L},
-    /*2209*/ {0x4L, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    /*2209*/ {0x6L, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
     /*2301*/ {{0x8L, 0x03e8L, 0x0L, {'T', 'r', 'a', 'c', 'e', '1'}, {'r', 'e', 'd'}, 0x0000L, 0x0L, 0x0L, 0x0000L},
               /*2302*/ {0x8L, 0x03e8L, 0x0L, {'T', 'r', 'a', 'c', 'e', '2'}, {'g', 'r', 'e', 'e', 'n'}, 0x0000L, 0x0L, 0x0L, 0x0000L},
               /*2303*/ {0x8L, 0x03e8L, 0x0L, {'n', 'a', 'm', 'e'}, {'r', 'e', 'd'}, 0x0000L, 0x0L, 0x0L, 0x0000L},
@@ -320,10 +320,11 @@ struct sCO_OD_RAM CO_OD_RAM = {
     /*6041*/ {0x6L, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
     /*6064*/ {0x6L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
     /*606c*/ {0x6L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
-    /*6077*/ {0x4L, 0x0000, 0x0000, 0x0000, 0x0000},
+    /*6077*/ {0x6L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
     /*607a*/ {0x6L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
     /*60ff*/ {0x6L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
-    /*6071*/ {0x4L, 0x0000, 0x0000, 0x0000, 0x0000},
+    /*6071*/ {0x6L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L, 0x0000L},
+    /*60c4*/ {0x6L, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
     /*6200*/ {0x0L, 0x0L, 0x0L, 0x0L, 0x0L, 0x0L, 0x0L, 0x0L},
     /*6401*/ {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
     /*6411*/ {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
@@ -1661,12 +1662,12 @@ struct sCO_OD_EEPROM CO_OD_EEPROM = {
 
 /*0x2209*/ const CO_OD_entryRecord_t OD_record2209[7] = {
     {(void *)&CO_OD_RAM.motorTempSensorVoltages.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor1, 0xbe, 0x2},
-    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor2, 0xbe, 0x2},
-    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor3, 0xbe, 0x2},
-    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor4, 0xbe, 0x2},
-    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor5, 0xbe, 0x2},
-    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor6, 0xbe, 0x2},
+    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor[0], 0xbe, 0x2},
+    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor[1], 0xbe, 0x2},
+    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor[2], 0xbe, 0x2},
+    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor[3], 0xbe, 0x2},
+    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor[4], 0xbe, 0x2},
+    {(void *)&CO_OD_RAM.motorTempSensorVoltages.motor[5], 0xbe, 0x2},
 };
 
 /*0x2301*/ const CO_OD_entryRecord_t OD_record2301[9] = {
@@ -2375,78 +2376,92 @@ struct sCO_OD_EEPROM CO_OD_EEPROM = {
 
 /*0x6040*/ const CO_OD_entryRecord_t OD_record6040[7] = {
     {(void *)&CO_OD_RAM.controlWords.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.controlWords.motor1, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.controlWords.motor2, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.controlWords.motor3, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.controlWords.motor4, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.controlWords.motor5, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.controlWords.motor6, 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.controlWords.motor[0], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.controlWords.motor[1], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.controlWords.motor[2], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.controlWords.motor[3], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.controlWords.motor[4], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.controlWords.motor[5], 0xfe, 0x2},
 };
 
 /*0x6041*/ const CO_OD_entryRecord_t OD_record6041[7] = {
     {(void *)&CO_OD_RAM.statusWords.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.statusWords.motor1, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.statusWords.motor2, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.statusWords.motor3, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.statusWords.motor4, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.statusWords.motor5, 0xfe, 0x2},
-    {(void *)&CO_OD_RAM.statusWords.motor6, 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.statusWords.motor[0], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.statusWords.motor[1], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.statusWords.motor[2], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.statusWords.motor[3], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.statusWords.motor[4], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.statusWords.motor[5], 0xfe, 0x2},
 };
 
 /*0x6064*/ const CO_OD_entryRecord_t OD_record6064[7] = {
     {(void *)&CO_OD_RAM.actualMotorPositions.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.actualMotorPositions.motor1, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorPositions.motor2, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorPositions.motor3, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorPositions.motor4, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorPositions.motor5, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorPositions.motor6, 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorPositions.motor[0], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorPositions.motor[1], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorPositions.motor[2], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorPositions.motor[3], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorPositions.motor[4], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorPositions.motor[5], 0xfe, 0x4},
 };
 
 /*0x606c*/ const CO_OD_entryRecord_t OD_record606c[7] = {
     {(void *)&CO_OD_RAM.actualMotorVelocities.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.actualMotorVelocities.motor1, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorVelocities.motor2, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorVelocities.motor3, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorVelocities.motor4, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorVelocities.motor5, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorVelocities.motor6, 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorVelocities.motor[0], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorVelocities.motor[1], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorVelocities.motor[2], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorVelocities.motor[3], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorVelocities.motor[4], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorVelocities.motor[5], 0xfe, 0x4},
 };
 
-/*0x6077*/ const CO_OD_entryRecord_t OD_record6077[5] = {
+/*0x6077*/ const CO_OD_entryRecord_t OD_record6077[7] = {
     {(void *)&CO_OD_RAM.actualMotorTorques.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.actualMotorTorques.motor1, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorTorques.motor2, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorTorques.motor3, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.actualMotorTorques.motor4, 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorTorques.motor[0], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorTorques.motor[1], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorTorques.motor[2], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorTorques.motor[3], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorTorques.motor[4], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.actualMotorTorques.motor[5], 0xfe, 0x4},
 };
 
 /*0x607a*/ const CO_OD_entryRecord_t OD_record607a[7] = {
     {(void *)&CO_OD_RAM.targetMotorPositions.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.targetMotorPositions.motor1, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorPositions.motor2, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorPositions.motor3, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorPositions.motor4, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorPositions.motor5, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorPositions.motor6, 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorPositions.motor[0], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorPositions.motor[1], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorPositions.motor[2], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorPositions.motor[3], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorPositions.motor[4], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorPositions.motor[5], 0xfe, 0x4},
 };
 
 /*0x60ff*/ const CO_OD_entryRecord_t OD_record60ff[7] = {
     {(void *)&CO_OD_RAM.targetMotorVelocities.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.targetMotorVelocities.motor1, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorVelocities.motor2, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorVelocities.motor3, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorVelocities.motor4, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorVelocities.motor5, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorVelocities.motor6, 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorVelocities.motor[0], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorVelocities.motor[1], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorVelocities.motor[2], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorVelocities.motor[3], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorVelocities.motor[4], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorVelocities.motor[5], 0xfe, 0x4},
 };
 
-/*0x6071*/ const CO_OD_entryRecord_t OD_record6071[5] = {
+/*0x6071*/ const CO_OD_entryRecord_t OD_record6071[7] = {
     {(void *)&CO_OD_RAM.targetMotorTorques.numberOfMotors, 0x06, 0x1},
-    {(void *)&CO_OD_RAM.targetMotorTorques.motor1, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorTorques.motor2, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorTorques.motor3, 0xfe, 0x4},
-    {(void *)&CO_OD_RAM.targetMotorTorques.motor4, 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorTorques.motor[0], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorTorques.motor[1], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorTorques.motor[2], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorTorques.motor[3], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorTorques.motor[4], 0xfe, 0x4},
+    {(void *)&CO_OD_RAM.targetMotorTorques.motor[5], 0xfe, 0x4},
+};
+
+/*0x60c4*/ const CO_OD_entryRecord_t OD_record60c4[7] = {
+    {(void *)&CO_OD_RAM.ipBufferPositions.numberOfMotors, 0x06, 0x1},
+    {(void *)&CO_OD_RAM.ipBufferPositions.motor[0], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.ipBufferPositions.motor[1], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.ipBufferPositions.motor[2], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.ipBufferPositions.motor[3], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.ipBufferPositions.motor[4], 0xfe, 0x2},
+    {(void *)&CO_OD_RAM.ipBufferPositions.motor[5], 0xfe, 0x2},
 };
 
 /*******************************************************************************
@@ -2701,9 +2716,10 @@ extern const CO_OD_entry_t CO_OD[CO_OD_NoOfElements] = {
     {0x6041, 0x06, 0x00, 0, (void *)&OD_record6041},
     {0x6064, 0x06, 0x00, 0, (void *)&OD_record6064},
     {0x606c, 0x06, 0x00, 0, (void *)&OD_record606c},
-    {0x6071, 0x04, 0x00, 0, (void *)&OD_record6071},
-    {0x6077, 0x04, 0x00, 0, (void *)&OD_record6077},
+    {0x6071, 0x06, 0x00, 0, (void *)&OD_record6071},
+    {0x6077, 0x06, 0x00, 0, (void *)&OD_record6077},
     {0x607a, 0x06, 0x00, 0, (void *)&OD_record607a},
+    {0x60c4, 0x06, 0x00, 0, (void *)&OD_record60c4},
     {0x60ff, 0x06, 0x00, 0, (void *)&OD_record60ff},
     {0x6200, 0x08, 0x0e, 1, (void *)&CO_OD_RAM.writeOutput8Bit[0]},
     {0x6401, 0x0c, 0x8e, 2, (void *)&CO_OD_RAM.readAnalogueInput16Bit[0]},
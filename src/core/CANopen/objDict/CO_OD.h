@@ -105,11 +105,12 @@ typedef domain_t CO_DOMAIN;
 #define CO_NO_RPDO 32       //Associated objects: 14xx, 16xx
 #define CO_NO_TPDO 32       //Associated objects: 18xx, 1Axx
 #define CO_NO_NMT_MASTER 1
+#define CO_NO_MOTORS 6  //Number of motor drives, see CO_OD_motors.h
 
 /*******************************************************************************
    OBJECT DICTIONARY
 *******************************************************************************/
-#define CO_OD_NoOfElements 254
+#define CO_OD_NoOfElements 255
 
 /*******************************************************************************
    TYPE DEFINITIONS FOR RECORDS
@@ -194,12 +195,7 @@ typedef domain_t CO_DOMAIN;
 /*2209    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    UNSIGNED16 motor1;
-    UNSIGNED16 motor2;
-    UNSIGNED16 motor3;
-    UNSIGNED16 motor4;
-    UNSIGNED16 motor5;
-    UNSIGNED16 motor6;
+    UNSIGNED16 motor[CO_NO_MOTORS];
 } OD_motorTempSensorVoltages_t;
 /*2301    */ typedef struct
 {
@@ -226,79 +222,48 @@ typedef domain_t CO_DOMAIN;
 /*6040    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    UNSIGNED16 motor1;
-    UNSIGNED16 motor2;
-    UNSIGNED16 motor3;
-    UNSIGNED16 motor4;
-    UNSIGNED16 motor5;
-    UNSIGNED16 motor6;
+    UNSIGNED16 motor[CO_NO_MOTORS];
 } OD_controlWords_t;
 /*6041    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    UNSIGNED16 motor1;
-    UNSIGNED16 motor2;
-    UNSIGNED16 motor3;
-    UNSIGNED16 motor4;
-    UNSIGNED16 motor5;
-    UNSIGNED16 motor6;
+    UNSIGNED16 motor[CO_NO_MOTORS];
 } OD_statusWords_t;
 /*6064    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    INTEGER32 motor1;
-    INTEGER32 motor2;
-    INTEGER32 motor3;
-    INTEGER32 motor4;
-    INTEGER32 motor5;
-    INTEGER32 motor6;
+    INTEGER32 motor[CO_NO_MOTORS];
 } OD_actualMotorPositions_t;
 /*606c    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    INTEGER32 motor1;
-    INTEGER32 motor2;
-    INTEGER32 motor3;
-    INTEGER32 motor4;
-    INTEGER32 motor5;
-    INTEGER32 motor6;
+    INTEGER32 motor[CO_NO_MOTORS];
 } OD_actualMotorVelocities_t;
 /*6077    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    INTEGER32 motor1;
-    INTEGER32 motor2;
-    INTEGER32 motor3;
-    INTEGER32 motor4;
+    INTEGER32 motor[CO_NO_MOTORS];
 } OD_actualMotorTorques_t;
 /*607a    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    INTEGER32 motor1;
-    INTEGER32 motor2;
-    INTEGER32 motor3;
-    INTEGER32 motor4;
-    INTEGER32 motor5;
-    INTEGER32 motor6;
+    INTEGER32 motor[CO_NO_MOTORS];
 } OD_targetMotorPositions_t;
 /*60ff    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    INTEGER32 motor1;
-    INTEGER32 motor2;
-    INTEGER32 motor3;
-    INTEGER32 motor4;
-    INTEGER32 motor5;
-    INTEGER32 motor6;
+    INTEGER32 motor[CO_NO_MOTORS];
 } OD_targetMotorVelocities_t;
 /*6071    */ typedef struct
 {
     UNSIGNED8 numberOfMotors;
-    INTEGER32 motor1;
-    INTEGER32 motor2;
-    INTEGER32 motor3;
-    INTEGER32 motor4;
+    INTEGER32 motor[CO_NO_MOTORS];
 } OD_targetMotorTorques_t;
+/*60c4    */ typedef struct
+{
+    UNSIGNED8 numberOfMotors;
+    UNSIGNED16 motor[CO_NO_MOTORS];
+} OD_ipBufferPositions_t;
 
 /*******************************************************************************
    TYPE DEFINITIONS FOR OBJECT DICTIONARY INDEXES
@@ -3103,6 +3068,8 @@ typedef domain_t CO_DOMAIN;
 #define OD_6077_2_actualMotorTorques_motor2 2
 #define OD_6077_3_actualMotorTorques_motor3 3
 #define OD_6077_4_actualMotorTorques_motor4 4
+#define OD_6077_5_actualMotorTorques_motor5 5
+#define OD_6077_6_actualMotorTorques_motor6 6
 
 /*607a */
 #define OD_607a_targetMotorPositions 0x607a
@@ -3134,6 +3101,19 @@ typedef domain_t CO_DOMAIN;
 #define OD_6071_2_targetMotorTorques_motor2 2
 #define OD_6071_3_targetMotorTorques_motor3 3
 #define OD_6071_4_targetMotorTorques_motor4 4
+#define OD_6071_5_targetMotorTorques_motor5 5
+#define OD_6071_6_targetMotorTorques_motor6 6
+
+/*60c4 */
+#define OD_60c4_ipBufferPositions 0x60c4
+
+#define OD_60c4_0_ipBufferPositions_maxSubIndex 0
+#define OD_60c4_1_ipBufferPositions_motor1 1
+#define OD_60c4_2_ipBufferPositions_motor2 2
+#define OD_60c4_3_ipBufferPositions_motor3 3
+#define OD_60c4_4_ipBufferPositions_motor4 4
+#define OD_60c4_5_ipBufferPositions_motor5 5
+#define OD_60c4_6_ipBufferPositions_motor6 6
 
 /*6200 */
 #define OD_6200_writeOutput8Bit 0x6200
@@ -3260,6 +3240,7 @@ struct sCO_OD_RAM {
     /*607a      */ OD_targetMotorPositions_t targetMotorPositions;
     /*60ff      */ OD_targetMotorVelocities_t targetMotorVelocities;
     /*6071      */ OD_targetMotorTorques_t targetMotorTorques;
+    /*60c4      */ OD_ipBufferPositions_t ipBufferPositions;
     /*6200      */ UNSIGNED8 writeOutput8Bit[8];
     /*6401      */ INTEGER16 readAnalogueInput16Bit[12];
     /*6411      */ INTEGER16 writeAnalogueOutput16Bit[8];
@@ -3520,6 +3501,9 @@ extern struct sCO_OD_EEPROM CO_OD_EEPROM;
 /*6071, Data Type: targetMotorTorques_t */
 #define OD_targetMotorTorques CO_OD_RAM.targetMotorTorques
 
+/*60c4, Data Type: ipBufferPositions_t */
+#define OD_ipBufferPositions CO_OD_RAM.ipBufferPositions
+
 /*6200, Data Type: UNSIGNED8, Array[8] */
 #define OD_writeOutput8Bit CO_OD_RAM.writeOutput8Bit
 #define ODL_writeOutput8Bit_arrayLength 8
@@ -0,0 +1,36 @@
+/* Generated by tools/ODGenerator/genMotorOD.py from motorOD.json - DON'T EDIT */
+#include "CO_OD_motors.h"
+
+const CO_OD_motor_t CO_OD_motors[CO_NO_MOTORS] = {
+    {&CO_OD_RAM.motorTempSensorVoltages.motor[0], &CO_OD_RAM.controlWords.motor[0], &CO_OD_RAM.statusWords.motor[0], &CO_OD_RAM.actualMotorPositions.motor[0], &CO_OD_RAM.actualMotorVelocities.motor[0], &CO_OD_RAM.actualMotorTorques.motor[0], &CO_OD_RAM.targetMotorPositions.motor[0], &CO_OD_RAM.targetMotorVelocities.motor[0], &CO_OD_RAM.targetMotorTorques.motor[0], &CO_OD_RAM.ipBufferPositions.motor[0]},
+    {&CO_OD_RAM.motorTempSensorVoltages.motor[1], &CO_OD_RAM.controlWords.motor[1], &CO_OD_RAM.statusWords.motor[1], &CO_OD_RAM.actualMotorPositions.motor[1], &CO_OD_RAM.actualMotorVelocities.motor[1], &CO_OD_RAM.actualMotorTorques.motor[1], &CO_OD_RAM.targetMotorPositions.motor[1], &CO_OD_RAM.targetMotorVelocities.motor[1], &CO_OD_RAM.targetMotorTorques.motor[1], &CO_OD_RAM.ipBufferPositions.motor[1]},
+    {&CO_OD_RAM.motorTempSensorVoltages.motor[2], &CO_OD_RAM.controlWords.motor[2], &CO_OD_RAM.statusWords.motor[2], &CO_OD_RAM.actualMotorPositions.motor[2], &CO_OD_RAM.actualMotorVelocities.motor[2], &CO_OD_RAM.actualMotorTorques.motor[2], &CO_OD_RAM.targetMotorPositions.motor[2], &CO_OD_RAM.targetMotorVelocities.motor[2], &CO_OD_RAM.targetMotorTorques.motor[2], &CO_OD_RAM.ipBufferPositions.motor[2]},
+    {&CO_OD_RAM.motorTempSensorVoltages.motor[3], &CO_OD_RAM.controlWords.motor[3], &CO_OD_RAM.statusWords.motor[3], &CO_OD_RAM.actualMotorPositions.motor[3], &CO_OD_RAM.actualMotorVelocities.motor[3], &CO_OD_RAM.actualMotorTorques.motor[3], &CO_OD_RAM.targetMotorPositions.motor[3], &CO_OD_RAM.targetMotorVelocities.motor[3], &CO_OD_RAM.targetMotorTorques.motor[3], &CO_OD_RAM.ipBufferPositions.motor[3]},
+    {&CO_OD_RAM.motorTempSensorVoltages.motor[4], &CO_OD_RAM.controlWords.motor[4], &CO_OD_RAM.statusWords.motor[4], &CO_OD_RAM.actualMotorPositions.motor[4], &CO_OD_RAM.actualMotorVelocities.motor[4], &CO_OD_RAM.actualMotorTorques.motor[4], &CO_OD_RAM.targetMotorPositions.motor[4], &CO_OD_RAM.targetMotorVelocities.motor[4], &CO_OD_RAM.targetMotorTorques.motor[4], &CO_OD_RAM.ipBufferPositions.motor[4]},
+    {&CO_OD_RAM.motorTempSensorVoltages.motor[5], &CO_OD_RAM.controlWords.motor[5], &CO_OD_RAM.statusWords.motor[5], &CO_OD_RAM.actualMotorPositions.motor[5], &CO_OD_RAM.actualMotorVelocities.motor[5], &CO_OD_RAM.actualMotorTorques.motor[5], &CO_OD_RAM.targetMotorPositions.motor[5], &CO_OD_RAM.targetMotorVelocities.motor[5], &CO_OD_RAM.targetMotorTorques.motor[5], &CO_OD_RAM.ipBufferPositions.motor[5]},
+};
+
+static struct {
+    UNSIGNED16 tempSensorVoltage;
+    UNSIGNED16 controlWord;
+    UNSIGNED16 statusWord;
+    INTEGER32 actualPosition;
+    INTEGER32 actualVelocity;
+    INTEGER32 actualTorque;
+    INTEGER32 targetPosition;
+    INTEGER32 targetVelocity;
+    INTEGER32 targetTorque;
+    UNSIGNED16 ipBufferPosition;
+} CO_OD_motorScratch;
+
+const CO_OD_motor_t CO_OD_motorUnmapped = {
+    &CO_OD_motorScratch.tempSensorVoltage,
+    &CO_OD_motorScratch.controlWord,
+    &CO_OD_motorScratch.statusWord,
+    &CO_OD_motorScratch.actualPosition,
+    &CO_OD_motorScratch.actualVelocity,
+    &CO_OD_motorScratch.actualTorque,
+    &CO_OD_motorScratch.targetPosition,
+    &CO_OD_motorScratch.targetVelocity,
+    &CO_OD_motorScratch.targetTorque,
+    &CO_OD_motorScratch.ipBufferPosition};
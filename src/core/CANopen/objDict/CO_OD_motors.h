@@ -0,0 +1,38 @@
+/* Generated by tools/ODGenerator/genMotorOD.py from motorOD.json - DON'T EDIT */
+/**
+ * Per drive accessors of the motor records of the Object Dictionary.
+ *
+ * CO_OD_motors[i] points to the subindex i+1 (drive with node ID i+1) of
+ * each motor record. CO_OD_motorUnmapped points to scratch variables and may
+ * be used by drives which have no entry in the Object Dictionary.
+ */
+#ifndef CO_OD_MOTORS_H
+#define CO_OD_MOTORS_H
+
+#include "CO_OD.h"
+
+typedef struct {
+    UNSIGNED16 *tempSensorVoltage; /* 0x2209 motorTempSensorVoltages */
+    UNSIGNED16 *controlWord; /* 0x6040 controlWords */
+    UNSIGNED16 *statusWord; /* 0x6041 statusWords */
+    INTEGER32  *actualPosition; /* 0x6064 actualMotorPositions */
+    INTEGER32  *actualVelocity; /* 0x606c actualMotorVelocities */
+    INTEGER32  *actualTorque; /* 0x6077 actualMotorTorques */
+    INTEGER32  *targetPosition; /* 0x607a targetMotorPositions */
+    INTEGER32  *targetVelocity; /* 0x60ff targetMotorVelocities */
+    INTEGER32  *targetTorque; /* 0x6071 targetMotorTorques */
+    UNSIGNED16 *ipBufferPosition; /* 0x60c4 ipBufferPositions */
+} CO_OD_motor_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const CO_OD_motor_t CO_OD_motors[CO_NO_MOTORS];
+extern const CO_OD_motor_t CO_OD_motorUnmapped;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
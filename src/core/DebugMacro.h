@@ -15,6 +15,7 @@
 #include <iostream>
 // #define NOROBOT
 // #define VIRTUAL
+// #define SIMULATED
 #define DEBUG
 #ifdef DEBUG
 #define DEBUG_OUT(x) (std::cout << x << std::endl);
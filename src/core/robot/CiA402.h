@@ -0,0 +1,116 @@
+/**
+ * \file CiA402.h
+ * \author William Campbell
+ * \brief Decoder of the CiA 402 status word (0x6041) of a drive: state of the power drive state machine
+ * and events reported by the drive.
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef CIA402_H_INCLUDED
+#define CIA402_H_INCLUDED
+#include <stdint.h>
+
+/**
+ * \brief States of the CiA 402 power drive state machine, as reported by the status word
+ *
+ */
+enum CiA402State {
+    CIA402_NOT_READY_TO_SWITCH_ON = 0, /**< 0 */
+    CIA402_SWITCH_ON_DISABLED = 1,     /**< 1 */
+    CIA402_READY_TO_SWITCH_ON = 2,     /**< 2 */
+    CIA402_SWITCHED_ON = 3,            /**< 3 */
+    CIA402_OPERATION_ENABLED = 4,      /**< 4 */
+    CIA402_QUICK_STOP_ACTIVE = 5,      /**< 5 */
+    CIA402_FAULT_REACTION_ACTIVE = 6,  /**< 6 */
+    CIA402_FAULT = 7,                  /**< 7 */
+};
+
+/**
+ * \brief Conditions reported by the status word of a drive, as bit flags
+ *
+ */
+enum DriveEvent {
+    DRIVE_EVENT_FAULT = 0x01,            /**< Fault or fault reaction active */
+    DRIVE_EVENT_QUICK_STOP = 0x02,       /**< Quick stop active */
+    DRIVE_EVENT_TARGET_REACHED = 0x04,   /**< Target reached (status word bit 10) */
+    DRIVE_EVENT_FOLLOWING_ERROR = 0x08,  /**< Following error (status word bit 13, position modes only) */
+    DRIVE_EVENT_WARNING = 0x10,          /**< Warning (status word bit 7) */
+};
+
+/**
+ * \brief Events which stop the motion of the robot
+ *
+ */
+#define DRIVE_EVENTS_STOP (DRIVE_EVENT_FAULT | DRIVE_EVENT_QUICK_STOP | DRIVE_EVENT_FOLLOWING_ERROR)
+
+/**
+ * \brief Status word bits
+ *
+ */
+#define CIA402_SW_FAULT 0x0008U
+#define CIA402_SW_WARNING 0x0080U
+#define CIA402_SW_TARGET_REACHED 0x0400U
+#define CIA402_SW_FOLLOWING_ERROR 0x2000U
+/** Homing mode: homing attained (bit 12) and homing error (bit 13) */
+#define CIA402_SW_HOMING_ATTAINED 0x1000U
+#define CIA402_SW_HOMING_ERROR 0x2000U
+
+/**
+ * \brief Decode the state of the power drive state machine (CiA 402, status word bits 0-3, 5 and 6)
+ *
+ * \param statusWord Status word of the drive (0x6041)
+ * \return CiA402State the state
+ */
+inline CiA402State decodeCiA402State(uint16_t statusWord) {
+    switch (statusWord & 0x6F) {
+        case 0x21:
+            return CIA402_READY_TO_SWITCH_ON;
+        case 0x23:
+            return CIA402_SWITCHED_ON;
+        case 0x27:
+            return CIA402_OPERATION_ENABLED;
+        case 0x07:
+            return CIA402_QUICK_STOP_ACTIVE;
+    }
+    switch (statusWord & 0x4F) {
+        case 0x40:
+            return CIA402_SWITCH_ON_DISABLED;
+        case 0x0F:
+            return CIA402_FAULT_REACTION_ACTIVE;
+        case 0x08:
+            return CIA402_FAULT;
+    }
+    return CIA402_NOT_READY_TO_SWITCH_ON;
+}
+
+/**
+ * \brief Decode the conditions reported by the status word
+ *
+ * \param statusWord Status word of the drive (0x6041)
+ * \param positionMode True if the drive is in a position mode, in which bit 13 is the following error
+ * \return uint16_t DriveEvent flags
+ */
+inline uint16_t decodeDriveEvents(uint16_t statusWord, bool positionMode) {
+    uint16_t events = 0;
+    CiA402State state = decodeCiA402State(statusWord);
+    if (state == CIA402_FAULT || state == CIA402_FAULT_REACTION_ACTIVE) {
+        events |= DRIVE_EVENT_FAULT;
+    }
+    if (state == CIA402_QUICK_STOP_ACTIVE) {
+        events |= DRIVE_EVENT_QUICK_STOP;
+    }
+    if (statusWord & CIA402_SW_TARGET_REACHED) {
+        events |= DRIVE_EVENT_TARGET_REACHED;
+    }
+    if (positionMode && (statusWord & CIA402_SW_FOLLOWING_ERROR)) {
+        events |= DRIVE_EVENT_FOLLOWING_ERROR;
+    }
+    if (statusWord & CIA402_SW_WARNING) {
+        events |= DRIVE_EVENT_WARNING;
+    }
+    return events;
+}
+
+#endif
@@ -0,0 +1,320 @@
+/**
+ * \file CiA402Drive.h
+ * \author Justin Fong
+ * \brief A <code>Drive</code> configured from compile-time vendor traits: the supported control modes, the
+ * PDO layout and capacity of the drive, and its quirks. The configuration sequences of all control modes
+ * follow from the traits, so a vendor is added by describing it, not by copying a drive class:
+ *
+ * \code
+ *  struct MyDriveTraits : CiA402DriveTraits {
+ *      typedef MyPDOLayout Layout;           // PDOMapping and PDOList of each mode, see CiA402PDOLayout
+ *      static constexpr int noOfRPDOs = 4;
+ *  };
+ *  class MyDrive final : public CiA402Drive<MyDriveTraits> { ... };
+ * \endcode
+ *
+ * The accessors of the process image (setPos(), getPos(), getVel(), getTorque()) are final and inline:
+ * called on a vendor drive class, they compile to a direct access of the Object Dictionary.
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef CIA402DRIVE_H_INCLUDED
+#define CIA402DRIVE_H_INCLUDED
+#include "DebugMacro.h"
+#include "Drive.h"
+
+/**
+ * \brief Bit of a ControlMode in CiA402DriveTraits::modes
+ *
+ */
+#define CIA402_MODE(mode) (1u << (mode))
+
+/**
+ * \brief Traits of a standard CiA 402 drive, the defaults of the vendor traits
+ *
+ */
+struct CiA402DriveTraits {
+    /** PDO layout of the drive (see CiA402PDOLayout) */
+    typedef CiA402PDOLayout Layout;
+    /** Supported control modes, CIA402_MODE() bits */
+    static constexpr uint32_t modes = CIA402_MODE(POSITION_CONTROL) | CIA402_MODE(VELOCITY_CONTROL) | CIA402_MODE(TORQUE_CONTROL) |
+                                      CIA402_MODE(CSP_CONTROL) | CIA402_MODE(CSV_CONTROL) | CIA402_MODE(CST_CONTROL) |
+                                      CIA402_MODE(IP_CONTROL) | CIA402_MODE(HOMING_CONTROL);
+    /** Number of RPDOs of the drive */
+    static constexpr int noOfRPDOs = 8;
+    /** RPDO n of the layout (COB-ID n00+{NODE-ID}) is configured in the RPDO parameters n - rpdoParameterShift of the drive */
+    static constexpr int rpdoParameterShift = 0;
+    /** Unit of the drive velocities, in position counts/s (see Drive::getVelocityUnit()) */
+    static constexpr double velocityUnit = 1;
+    /** The drive needs Control Word 6 then 15 when set to profile position mode */
+    static constexpr bool enableInPositionConfig = false;
+    /** RPDO receiving the multiplexed setpoint frame (see initPackedSetpoints()), not used by the layout, 0 if none is free */
+    static constexpr int setpointMuxRPDO = 6;
+};
+
+/**
+ * \ingroup Robot
+ * \brief Drive described by Traits (see CiA402Drive.h and CiA402DriveTraits)
+ *
+ * \tparam Traits The vendor traits
+ */
+template <class Traits>
+class CiA402Drive : public Drive {
+   public:
+    typedef typename Traits::Layout Layout;
+
+    static_assert(Layout::RPDOs::maxNumber - Traits::rpdoParameterShift <= Traits::noOfRPDOs &&
+                      Layout::CSPRPDOs::maxNumber - Traits::rpdoParameterShift <= Traits::noOfRPDOs &&
+                      Layout::CSVRPDOs::maxNumber - Traits::rpdoParameterShift <= Traits::noOfRPDOs &&
+                      Layout::CSTRPDOs::maxNumber - Traits::rpdoParameterShift <= Traits::noOfRPDOs &&
+                      Layout::IPRPDOs::maxNumber - Traits::rpdoParameterShift <= Traits::noOfRPDOs,
+                  "PDO layout uses more RPDOs than the drive has");
+    static_assert(Layout::CSPRPDOs::template coveredBy<typename Layout::ProfileRPDOs>() &&
+                      Layout::CSVRPDOs::template coveredBy<typename Layout::ProfileRPDOs>() &&
+                      Layout::CSTRPDOs::template coveredBy<typename Layout::ProfileRPDOs>() &&
+                      Layout::IPRPDOs::template coveredBy<typename Layout::ProfileRPDOs>(),
+                  "PDO layout does not configure back all RPDOs remapped by the synchronous modes (ProfileRPDOs)");
+    static_assert(Traits::setpointMuxRPDO == 0 ||
+                      (!Layout::RPDOs::has(Traits::setpointMuxRPDO) && !Layout::ProfileRPDOs::has(Traits::setpointMuxRPDO) &&
+                       Traits::setpointMuxRPDO - Traits::rpdoParameterShift >= 1 &&
+                       Traits::setpointMuxRPDO - Traits::rpdoParameterShift <= Traits::noOfRPDOs),
+                  "Multiplexed setpoint RPDO is used by the PDO layout or not available on the drive");
+
+    /**
+     * \brief Check whether the drive supports a control mode
+     *
+     */
+    static constexpr bool supports(ControlMode mode) {
+        return (Traits::modes & CIA402_MODE(mode)) != 0;
+    }
+
+    /**
+     * \brief Construct a new drive object
+     *
+     * \param NodeID CANopen Node ID
+     */
+    CiA402Drive(int NodeID) : Drive(NodeID) {}
+
+    /**
+     * Initialises the drive (SDO start message)
+     *
+     * \return True if successful, False if not
+     */
+    bool Init() {
+        return false;
+    }
+
+    /**
+     * \brief Configures the PDOs of the layout (Layout::TPDOs and Layout::RPDOs)
+     *
+     */
+    bool initPDOs() {
+        DEBUG_OUT("Drive " << NodeID << ": set up TPDOs and RPDOs")
+        sendSDOMessages(generateTPDOConfigSDO(typename Layout::TPDOs()));
+        sendSDOMessages(generateRPDOConfigSDO(typename Layout::RPDOs()));
+        return true;
+    }
+
+    /**
+     * \brief Maps the Target Position of this drive from its slot of the multiplexed setpoint frame, in
+     * Traits::setpointMuxRPDO (see Drive::initPackedSetpoints())
+     *
+     */
+    bool initPackedSetpoints(int COB_ID, int slot) {
+        if (Traits::setpointMuxRPDO == 0) {
+            return Drive::initPackedSetpoints(COB_ID, slot);
+        }
+        DEBUG_OUT("Drive " << NodeID << ": multiplexed setpoints, COB-ID 0x" << std::hex << COB_ID << std::dec << " slot " << slot)
+        sendSDOMessages(generatePackedRPDOConfigSDO(ODEntryParameter<TARGET_POS>::value, Traits::setpointMuxRPDO - Traits::rpdoParameterShift, COB_ID, slot));
+        return true;
+    }
+
+    bool initPosControl(motorProfile posControlMotorProfile) {
+        DEBUG_OUT("NodeID " << NodeID << " Initialising Position Control")
+        if (!supports(POSITION_CONTROL)) {
+            return false;
+        }
+        restoreTargetRPDOs();
+#ifndef VIRTUAL
+        sendSDOMessages(generatePosControlConfigSDO(posControlMotorProfile));
+#endif
+        return true;
+    }
+
+    bool initVelControl(motorProfile velControlMotorProfile) {
+        DEBUG_OUT("NodeID " << NodeID << " Initialising Velocity Control")
+        if (!supports(VELOCITY_CONTROL)) {
+            return false;
+        }
+        /**
+         * \todo Tune velocity loop gain index 0x2381 to optimize V control
+         *
+         */
+        restoreTargetRPDOs();
+        sendSDOMessages(generateVelControlConfigSDO(velControlMotorProfile));
+        return true;
+    }
+
+    bool initTorqueControl() {
+        DEBUG_OUT("NodeID " << NodeID << " Initialising Torque Control")
+        if (!supports(TORQUE_CONTROL)) {
+            return false;
+        }
+        restoreTargetRPDOs();
+        sendSDOMessages(generateTorqueControlConfigSDO());
+        return true;
+    }
+
+    bool initCSPControl(uint32_t followingErrorWindow) {
+        DEBUG_OUT("NodeID " << NodeID << " Initialising Cyclic Synchronous Position Control")
+        if (!supports(CSP_CONTROL)) {
+            return false;
+        }
+        if (OD_communicationCyclePeriod == 0) {
+            DEBUG_OUT("NodeID " << NodeID << ": no SYNC period, no interpolation time period for the set points")
+            return false;
+        }
+        synchronousMode = CSP_CONTROL;
+        // the drive follows the target from the first SYNC in mode 8, hold the current position until set points come
+        setPos(getPos());
+        setVelOffset(0);
+        setTorqueOffset(0);
+#ifndef VIRTUAL
+        sendSDOMessages(generateCSPControlConfigSDO(OD_communicationCyclePeriod, followingErrorWindow));
+        sendSDOMessages(generateRPDOConfigSDO(typename Layout::CSPRPDOs()));
+#endif
+        return true;
+    }
+
+    bool initCSVControl() {
+        DEBUG_OUT("NodeID " << NodeID << " Initialising Cyclic Synchronous Velocity Control")
+        if (!supports(CSV_CONTROL)) {
+            return false;
+        }
+        synchronousMode = CSV_CONTROL;
+        setVel(0);
+        setTorqueOffset(0);
+#ifndef VIRTUAL
+        sendSDOMessages(generateCSVControlConfigSDO(OD_communicationCyclePeriod));
+        sendSDOMessages(generateRPDOConfigSDO(typename Layout::CSVRPDOs()));
+#endif
+        return true;
+    }
+
+    bool initCSTControl() {
+        DEBUG_OUT("NodeID " << NodeID << " Initialising Cyclic Synchronous Torque Control")
+        if (!supports(CST_CONTROL)) {
+            return false;
+        }
+        synchronousMode = CST_CONTROL;
+        setTorque(0);
+#ifndef VIRTUAL
+        sendSDOMessages(generateCSTControlConfigSDO(OD_communicationCyclePeriod));
+        sendSDOMessages(generateRPDOConfigSDO(typename Layout::CSTRPDOs()));
+#endif
+        return true;
+    }
+
+    bool initIPControl(uint16_t bufferSize) {
+        DEBUG_OUT("NodeID " << NodeID << " Initialising Interpolated Position Control")
+        if (!supports(IP_CONTROL)) {
+            return false;
+        }
+        restoreTargetRPDOs();
+        synchronousMode = IP_CONTROL;
+#ifndef VIRTUAL
+        sendSDOMessages(generateIPControlConfigSDO(OD_communicationCyclePeriod, bufferSize));
+        sendSDOMessages(generateRPDOConfigSDO(typename Layout::IPRPDOs()));
+        sendSDOMessages(generateTPDOConfigSDO(typename Layout::IPTPDOs()));
+#endif
+        return true;
+    }
+
+    bool initHomingControl(int8_t method, int32_t homeOffset) {
+        DEBUG_OUT("NodeID " << NodeID << " Initialising Homing")
+        if (!supports(HOMING_CONTROL)) {
+            return false;
+        }
+        restoreTargetRPDOs();
+#ifndef VIRTUAL
+        sendSDOMessages(generateHomingControlConfigSDO(method, homeOffset));
+#endif
+        return true;
+    }
+
+    bool setPos(int position) final {
+        *motorOD->targetPosition = position;
+        return true;
+    }
+
+    int getPos() final {
+#ifndef VIRTUAL
+        return *motorOD->actualPosition;
+#else
+        return *motorOD->targetPosition;
+#endif
+    }
+
+    int getVel() final {
+        return *motorOD->actualVelocity;
+    }
+
+    double getVelocityUnit() {
+        return Traits::velocityUnit;
+    }
+
+    int getTorque() final {
+        return *motorOD->actualTorque;
+    }
+
+   protected:
+    /**
+     * \brief Generates the SDO commands of profile position mode (see Drive::generatePosControlConfigSDO()),
+     * followed by Control Word 6 and 15 if Traits::enableInPositionConfig
+     *
+     */
+    std::vector<std::string> generatePosControlConfigSDO(motorProfile positionProfile) {
+        std::vector<std::string> CANCommands = Drive::generatePosControlConfigSDO(positionProfile);
+        if (Traits::enableInPositionConfig) {
+            std::stringstream sstream;
+            sstream << "[1] " << NodeID << " write 0x6040 0 i16 6";
+            CANCommands.push_back(sstream.str());
+            sstream.str(std::string());
+            sstream << "[1] " << NodeID << " write 0x6040 0 i16 15";
+            CANCommands.push_back(sstream.str());
+        }
+        return CANCommands;
+    }
+
+    /**
+     * \brief Generates the SDO commands of an RPDO, in the RPDO parameters of the drive (see Traits::rpdoParameterShift)
+     *
+     */
+    std::vector<std::string> generateRPDOConfigSDO(std::vector<OD_Entry_t> items, int PDO_Num, int UpdateTiming) {
+        return Drive::generateRPDOConfigSDO(items, PDO_Num, UpdateTiming, PDO_Num - Traits::rpdoParameterShift);
+    }
+    using Drive::generateRPDOConfigSDO;
+
+   private:
+    /**
+     * \brief Configures the target RPDOs back to the profile modes (Layout::ProfileRPDOs), if a cyclic synchronous
+     * or interpolated mode remapped them, and disables the TPDOs of interpolated position mode (Layout::IPTPDOs)
+     *
+     */
+    void restoreTargetRPDOs() {
+        if (synchronousMode == UNCONFIGURED) {
+            return;
+        }
+#ifndef VIRTUAL
+        sendSDOMessages(generateRPDOConfigSDO(typename Layout::ProfileRPDOs()));
+        if (synchronousMode == IP_CONTROL) {
+            sendSDOMessages(generateTPDODisableSDO(typename Layout::IPTPDOs()));
+        }
+#endif
+        synchronousMode = UNCONFIGURED;
+    }
+};
+
+#endif
@@ -6,12 +6,18 @@ Drive::Drive() {
     statusWord = 0;
     error = 0;
     this->NodeID = -1;
+    motorOD = &CO_OD_motorUnmapped;
 }
 
 Drive::Drive(int NodeID) {
     statusWord = 0;
     error = 0;
     this->NodeID = NodeID;
+    if (NodeID >= 1 && NodeID <= CO_NO_MOTORS) {
+        motorOD = &CO_OD_motors[NodeID - 1];
+    } else {
+        motorOD = &CO_OD_motorUnmapped;
+    }
 }
 
 int Drive::getNodeID() {
@@ -20,13 +26,13 @@ int Drive::getNodeID() {
 
 bool Drive::setPos(int position) {
     // DEBUG_OUT("Drive " << this->NodeID << " Writing " << position << " to 0x607A");
-    *(&CO_OD_RAM.targetMotorPositions.motor1 + ((this->NodeID - 1))) = position;
+    *motorOD->targetPosition = position;
     return true;
 }
 
 bool Drive::setVel(int velocity) {
     DEBUG_OUT("Drive " << NodeID << " Writing " << velocity << " to 0x60FF");
-    *(&CO_OD_RAM.targetMotorVelocities.motor1 + ((this->NodeID - 1))) = velocity;
+    *motorOD->targetVelocity = velocity;
     return true;
 }
 
@@ -36,7 +42,23 @@ bool Drive::setTorque(int torque) {
     *
     */
     DEBUG_OUT("Drive " << NodeID << " Writing " << torque << " to 0x6071");
-    *(&CO_OD_RAM.targetMotorTorques.motor1 + ((this->NodeID - 1))) = torque;
+    *motorOD->targetTorque = torque;
+    return true;
+}
+
+bool Drive::setVelOffset(int velocity) {
+    if (synchronousMode != CSP_CONTROL) {
+        return false;
+    }
+    *motorOD->targetVelocity = velocity;
+    return true;
+}
+
+bool Drive::setTorqueOffset(int torque) {
+    if (synchronousMode != CSP_CONTROL && synchronousMode != CSV_CONTROL) {
+        return false;
+    }
+    *motorOD->targetTorque = torque;
     return true;
 }
 
@@ -46,41 +68,88 @@ int Drive::getPos() {
     *
     */
 #ifndef VIRTUAL
-    return *(&CO_OD_RAM.actualMotorPositions.motor1 + ((this->NodeID - 1)));
+    return *motorOD->actualPosition;
 #endif
 #ifdef VIRTUAL
-    return *(&CO_OD_RAM.targetMotorPositions.motor1 + ((this->NodeID - 1)));
+    return *motorOD->targetPosition;
 #endif
 }
 
-int Drive::getVel() {
-    return (*(&CO_OD_RAM.actualMotorVelocities.motor1 + ((this->NodeID - 1))));
+int Drive::getFollowingError() {
+    return *motorOD->targetPosition - getPos();
 }
 
-int Drive::getTorque() {
-    /**
-    *  \todo Remove assumption that only drives 1-4 have access to the motor torques
-    *
-    */
-    if (this->NodeID < 5) {
-        return (*(&CO_OD_RAM.actualMotorTorques.motor1 + ((this->NodeID - 1))));
-    } else {
+const CO_RPDO_t *Drive::getFeedbackRPDO() {
+    if (CO == NULL) {
+        return NULL;
+    }
+    uint32_t config = CO->PDOconfigCounter;
+    if (config != feedbackPDOconfig) {
+        feedbackPDOconfig = config;
+        feedbackRPDO = NULL;
+        for (int i = 0; i < CO_NO_RPDO; i++) {
+            if (CO_RPDO_isMapped(CO->RPDO[i], motorOD->actualPosition)) {
+                feedbackRPDO = CO->RPDO[i];
+                break;
+            }
+        }
+    }
+    return feedbackRPDO;
+}
+
+uint32_t Drive::getFeedbackAge() {
+#ifdef VIRTUAL
+    // getPos() returns the target position, which is always current
+    return 0;
+#else
+    if (!feedbackFromRPDO) {
         return 0;
     }
+    const CO_RPDO_t *RPDO = getFeedbackRPDO();
+    return RPDO != NULL ? CO_RPDO_getAge(RPDO) : UINT32_MAX;
+#endif
+}
+
+uint32_t Drive::getFeedbackMissedCycles() {
+    if (!feedbackFromRPDO) {
+        return 0;
+    }
+    const CO_RPDO_t *RPDO = getFeedbackRPDO();
+    return RPDO != NULL ? RPDO->missedCycles : 0;
+}
+
+const CO_OD_motor_t *Drive::getMotorOD() {
+    return motorOD;
+}
+
+bool Drive::isFeedbackFromRPDO() {
+    return feedbackFromRPDO;
+}
+
+int Drive::getVel() {
+    return (*motorOD->actualVelocity);
+}
+
+double Drive::getVelocityUnit() {
+    return 1;
+}
+
+int Drive::getTorque() {
+    return (*motorOD->actualTorque);
 }
 
 bool Drive::readyToSwitchOn() {
-    *(&CO_OD_RAM.controlWords.motor1 + ((this->NodeID - 1))) = 0x06;
+    *motorOD->controlWord = 0x06;
     driveState = READY_TO_SWITCH_ON;
 }
 
 bool Drive::enable() {
-    *(&CO_OD_RAM.controlWords.motor1 + ((this->NodeID - 1))) = 0x0F;
+    *motorOD->controlWord = 0x0F;
     driveState = ENABLED;
 }
 
 bool Drive::disable() {
-    *(&CO_OD_RAM.controlWords.motor1 + ((this->NodeID - 1))) = 0x00;
+    *motorOD->controlWord = 0x00;
     driveState = DISABLED;
 }
 
@@ -89,13 +158,30 @@ DriveState Drive::getDriveState() {
 }
 
 int Drive::updateDriveStatus() {
-    statusWord = *(&CO_OD_RAM.statusWords.motor1 + ((this->NodeID - 1)));
+    statusWord = *motorOD->statusWord;
+    cia402State = decodeCiA402State(statusWord);
+    if (cia402State == CIA402_FAULT || cia402State == CIA402_FAULT_REACTION_ACTIVE) {
+        // power stage is off, whatever state was commanded
+        driveState = DISABLED;
+    }
     return statusWord;
 }
 
+CiA402State Drive::getCiA402State() {
+    return cia402State;
+}
+
+bool Drive::resetFault() {
+    if (cia402State != CIA402_FAULT) {
+        return false;
+    }
+    *motorOD->controlWord = (*motorOD->controlWord & 0x80) ? 0x00 : 0x80;
+    return true;
+}
+
 bool Drive::posControlConfirmSP() {
-    int controlWord = *(&CO_OD_RAM.controlWords.motor1 + ((this->NodeID - 1)));
-    *(&CO_OD_RAM.controlWords.motor1 + ((this->NodeID - 1))) = controlWord ^ 0x10;
+    int controlWord = *motorOD->controlWord;
+    *motorOD->controlWord = controlWord ^ 0x10;
     if ((controlWord & 0x10) > 0) {
         return false;
     } else {
@@ -103,25 +189,74 @@ bool Drive::posControlConfirmSP() {
     }
 }
 
+bool Drive::setIPEnabled(bool enable) {
+    if (synchronousMode != IP_CONTROL) {
+        return false;
+    }
+    int controlWord = *motorOD->controlWord;
+    if (enable) {
+        *motorOD->controlWord = controlWord | 0x10;
+    } else {
+        *motorOD->controlWord = controlWord & ~0x10;
+    }
+    return true;
+}
+
+bool Drive::isIPActive() {
+    return (*motorOD->statusWord & 0x1000) > 0;
+}
+
+bool Drive::clearIPBuffer() {
+    if (!setIPEnabled(false)) {
+        return false;
+    }
+#ifndef VIRTUAL
+    std::vector<std::string> CANCommands;
+    std::stringstream sstream;
+    sstream << "[1] " << NodeID << " write 0x60C4 6 u8 0";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    sstream << "[1] " << NodeID << " write 0x60C4 6 u8 1";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    sendSDOMessages(CANCommands);
+#endif
+    return true;
+}
+
+bool Drive::initHomingControl(int8_t /*method*/, int32_t /*homeOffset*/) {
+    return false;
+}
+
+bool Drive::startHoming(bool start) {
+    int controlWord = *motorOD->controlWord;
+    if (start) {
+        *motorOD->controlWord = controlWord | 0x10;
+    } else {
+        *motorOD->controlWord = controlWord & ~0x10;
+    }
+    return true;
+}
+
 bool Drive::initPDOs() {
     DEBUG_OUT("Drive::initPDOs")
     DEBUG_OUT("Set up STATUS_WORD TPDO")
-    sendSDOMessages(generateTPDOConfigSDO({STATUS_WORD}, 1, 0xFF));
+    sendSDOMessages(generateTPDOConfigSDO<CiA402PDOLayout::TPDO1>());
 
     DEBUG_OUT("Set up ACTUAL_POS and ACTUAL_VEL TPDO")
-    sendSDOMessages(generateTPDOConfigSDO({ACTUAL_POS, ACTUAL_VEL}, 2, 1));
+    sendSDOMessages(generateTPDOConfigSDO<CiA402PDOLayout::TPDO2>());
 
     DEBUG_OUT("Set up ACTUAL_TOR TPDO")
-    sendSDOMessages(generateTPDOConfigSDO({ACTUAL_TOR}, 3, 1));
+    sendSDOMessages(generateTPDOConfigSDO<CiA402PDOLayout::TPDO3>());
 
     DEBUG_OUT("Set up TARGET_POS RPDO")
-    sendSDOMessages(generateRPDOConfigSDO({TARGET_POS}, 3, 0xff));
+    sendSDOMessages(generateRPDOConfigSDO<CiA402PDOLayout::RPDO3>());
 
     DEBUG_OUT("Set up TARGET_VEL RPDO")
-    sendSDOMessages(generateRPDOConfigSDO({TARGET_VEL}, 4, 0xff));
+    sendSDOMessages(generateRPDOConfigSDO<CiA402PDOLayout::RPDO4>());
 
     DEBUG_OUT("Set up TARGET_TOR RPDO")
-    sendSDOMessages(generateRPDOConfigSDO({TARGET_TOR}, 5, 0xff));
+    sendSDOMessages(generateRPDOConfigSDO<CiA402PDOLayout::RPDO5>());
     return true;
 }
 
@@ -163,7 +298,7 @@ std::vector<std::string> Drive::generateTPDOConfigSDO(std::vector<OD_Entry_t> it
         sstream
             << "[1] " << NodeID << " write 0x" << std::hex
             << 0x1A00 + PDO_Num - 1 << " " << i << " u32 0x" << std::hex
-            << OD_Addresses[items[i - 1]] * 0x10000 + OD_Data_Size[items[i - 1]];
+            << ODEntryMappingParameter(items[i - 1]);
         CANCommands.push_back(sstream.str());
         sstream.str(std::string());
     }
@@ -185,7 +320,21 @@ std::vector<std::string> Drive::generateTPDOConfigSDO(std::vector<OD_Entry_t> it
     return CANCommands;
 }
 
+std::vector<std::string> Drive::generateTPDODisableSDO(int PDO_Num) {
+    std::vector<std::string> CANCommands;
+    std::stringstream sstream;
+    sstream
+        << "[1] " << NodeID << " write 0x" << std::hex
+        << 0x1800 + PDO_Num - 1 << " 1 u32 0x" << std::hex << 0x80000000 + 0x100 * PDO_Num + 0x80 + NodeID;
+    CANCommands.push_back(sstream.str());
+    return CANCommands;
+}
+
 std::vector<std::string> Drive::generateRPDOConfigSDO(std::vector<OD_Entry_t> items, int PDO_Num, int UpdateTiming) {
+    return generateRPDOConfigSDO(items, PDO_Num, UpdateTiming, PDO_Num);
+}
+
+std::vector<std::string> Drive::generateRPDOConfigSDO(std::vector<OD_Entry_t> items, int PDO_Num, int UpdateTiming, int parameterNum) {
     /**
      *  \todo Do a check to make sure that the OD_Entry_t items can be Received
      *
@@ -203,21 +352,21 @@ std::vector<std::string> Drive::generateRPDOConfigSDO(std::vector<OD_Entry_t> it
     // Disable PDO
     sstream
         << "[1] " << NodeID << " write 0x" << std::hex
-        << 0x1400 + PDO_Num - 1 << " 1 u32 0x" << std::hex << 0x80000000 + COB_ID;
+        << 0x1400 + parameterNum - 1 << " 1 u32 0x" << std::hex << 0x80000000 + COB_ID;
     CANCommands.push_back(sstream.str());
     sstream.str(std::string());
 
     // Set so that there no PDO items, enable mapping change
     sstream
         << "[1] " << NodeID << " write 0x" << std::hex
-        << 0x1600 + PDO_Num - 1 << " 0 u8 0";
+        << 0x1600 + parameterNum - 1 << " 0 u8 0";
     CANCommands.push_back(sstream.str());
     sstream.str(std::string());
 
     // Set the PDO so that it triggers every SYNC Message
     sstream
         << "[1] " << NodeID << " write 0x" << std::hex
-        << 0x1400 + PDO_Num - 1 << " 2 u8 0x" << std::hex << UpdateTiming;
+        << 0x1400 + parameterNum - 1 << " 2 u8 0x" << std::hex << UpdateTiming;
     CANCommands.push_back(sstream.str());
     sstream.str(std::string());
 
@@ -225,8 +374,8 @@ std::vector<std::string> Drive::generateRPDOConfigSDO(std::vector<OD_Entry_t> it
         // Set transmit parameters
         sstream
             << "[1] " << NodeID << " write 0x" << std::hex
-            << 0x1600 + PDO_Num - 1 << " " << i << " u32 0x"
-            << std::hex << OD_Addresses[items[i - 1]] * 0x10000 + OD_Data_Size[items[i - 1]];
+            << 0x1600 + parameterNum - 1 << " " << i << " u32 0x"
+            << std::hex << ODEntryMappingParameter(items[i - 1]);
         CANCommands.push_back(sstream.str());
         sstream.str(std::string());
     }
@@ -234,7 +383,64 @@ std::vector<std::string> Drive::generateRPDOConfigSDO(std::vector<OD_Entry_t> it
     // Sets Number of PDO items to reenable
     sstream
         << "[1] " << NodeID << " write 0x" << std::hex
-        << 0x1600 + PDO_Num - 1 << " 0 u8 " << std::dec << items.size();
+        << 0x1600 + parameterNum - 1 << " 0 u8 " << std::dec << items.size();
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    // Enable  PDO
+    sstream
+        << "[1] " << NodeID << " write 0x" << std::hex
+        << 0x1400 + parameterNum - 1 << " 1 u32 0x" << std::hex << COB_ID;
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    return CANCommands;
+}
+
+bool Drive::initPackedSetpoints(int /*COB_ID*/, int /*slot*/) {
+    DEBUG_OUT("Drive " << NodeID << " does not support multiplexed setpoints")
+    return false;
+}
+
+std::vector<std::string> Drive::generatePackedRPDOConfigSDO(uint32_t targetParameter, int PDO_Num, int COB_ID, int slot) {
+    std::vector<std::string> CANCommands;
+    std::stringstream sstream;
+
+    // Disable PDO
+    sstream
+        << "[1] " << NodeID << " write 0x" << std::hex
+        << 0x1400 + PDO_Num - 1 << " 1 u32 0x" << std::hex << 0x80000000 + COB_ID;
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    // Set so that there no PDO items, enable mapping change
+    sstream
+        << "[1] " << NodeID << " write 0x" << std::hex
+        << 0x1600 + PDO_Num - 1 << " 0 u8 0";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    // Apply immediately when received
+    sstream
+        << "[1] " << NodeID << " write 0x" << std::hex
+        << 0x1400 + PDO_Num - 1 << " 2 u8 0xff";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    // Skip the slot of the other drive with a dummy INTEGER32 entry
+    for (int i = 1; i <= slot + 1; i++) {
+        sstream
+            << "[1] " << NodeID << " write 0x" << std::hex
+            << 0x1600 + PDO_Num - 1 << " " << std::dec << i << " u32 0x"
+            << std::hex << (i <= slot ? 0x00040020 : targetParameter);
+        CANCommands.push_back(sstream.str());
+        sstream.str(std::string());
+    }
+
+    // Sets Number of PDO items to reenable
+    sstream
+        << "[1] " << NodeID << " write 0x" << std::hex
+        << 0x1600 + PDO_Num - 1 << " 0 u8 " << std::dec << slot + 1;
     CANCommands.push_back(sstream.str());
     sstream.str(std::string());
 
@@ -281,6 +487,132 @@ std::vector<std::string> Drive::generatePosControlConfigSDO(motorProfile positio
 
     return CANCommands;
 }
+/**
+ * \brief SDO commands selecting an interpolating mode (0x6060) and its interpolation time period (0x60C2)
+ */
+static std::vector<std::string> interpolatedModeConfigSDO(int NodeID, int mode, uint32_t interpolationPeriodUs) {
+    std::vector<std::string> CANCommands;
+    std::stringstream sstream;
+    // start drive
+    sstream << "[1] " << NodeID << " start";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    //enable interpolating mode
+    sstream << "[1] " << NodeID << " write 0x6060 0 i8 " << std::dec << mode;
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    // Interpolation time period is value * 10^index seconds, value is 8 bit: use the coarsest exact unit
+    uint32_t value = interpolationPeriodUs;
+    int index = -6;
+    while (index < -3 && value % 10 == 0) {
+        value /= 10;
+        index++;
+    }
+    while (value > 0xFF && index < 0) {
+        value = (value + 5) / 10;
+        index++;
+    }
+    sstream << "[1] " << NodeID << " write 0x60C2 1 u8 " << std::dec << value;
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    sstream << "[1] " << NodeID << " write 0x60C2 2 i8 " << std::dec << index;
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    return CANCommands;
+}
+
+std::vector<std::string> Drive::generateCSPControlConfigSDO(uint32_t interpolationPeriodUs, uint32_t followingErrorWindow) {
+    DEBUG_OUT("generating CSP Control config SDO")
+    std::vector<std::string> CANCommands = interpolatedModeConfigSDO(NodeID, 8, interpolationPeriodUs);
+    std::stringstream sstream;
+
+    //Clear feedforward, until the first offsets are received
+    sstream << "[1] " << NodeID << " write 0x60B1 0 i32 0";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    sstream << "[1] " << NodeID << " write 0x60B2 0 i16 0";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    //Set following error window
+    if (followingErrorWindow > 0) {
+        sstream << "[1] " << NodeID << " write 0x6065 0 u32 " << std::dec << followingErrorWindow;
+        CANCommands.push_back(sstream.str());
+        sstream.str(std::string());
+    }
+
+    return CANCommands;
+}
+
+std::vector<std::string> Drive::generateCSVControlConfigSDO(uint32_t interpolationPeriodUs) {
+    DEBUG_OUT("generating CSV Control config SDO")
+    std::vector<std::string> CANCommands = interpolatedModeConfigSDO(NodeID, 9, interpolationPeriodUs);
+    std::stringstream sstream;
+
+    //Clear torque feedforward, until the first offset is received
+    sstream << "[1] " << NodeID << " write 0x60B2 0 i16 0";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    return CANCommands;
+}
+
+std::vector<std::string> Drive::generateCSTControlConfigSDO(uint32_t interpolationPeriodUs) {
+    DEBUG_OUT("generating CST Control config SDO")
+    return interpolatedModeConfigSDO(NodeID, 10, interpolationPeriodUs);
+}
+
+std::vector<std::string> Drive::generateIPControlConfigSDO(uint32_t interpolationPeriodUs, uint16_t bufferSize) {
+    DEBUG_OUT("generating IP Control config SDO")
+    std::vector<std::string> CANCommands = interpolatedModeConfigSDO(NodeID, 7, interpolationPeriodUs);
+    std::stringstream sstream;
+
+    //Linear interpolation
+    sstream << "[1] " << NodeID << " write 0x60C0 0 i16 0";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    //FIFO buffer, cleared and resized
+    sstream << "[1] " << NodeID << " write 0x60C4 3 u8 0";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    sstream << "[1] " << NodeID << " write 0x60C4 6 u8 0";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    sstream << "[1] " << NodeID << " write 0x60C4 2 u32 " << std::dec << bufferSize;
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    sstream << "[1] " << NodeID << " write 0x60C4 6 u8 1";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    return CANCommands;
+}
+
+std::vector<std::string> Drive::generateHomingControlConfigSDO(int8_t method, int32_t homeOffset) {
+    DEBUG_OUT("generating Homing Control config SDO")
+    std::vector<std::string> CANCommands;
+    std::stringstream sstream;
+
+    sstream << "[1] " << NodeID << " start";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    //Homing mode
+    sstream << "[1] " << NodeID << " write 0x6060 0 i8 6";
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    //Method and home offset
+    sstream << "[1] " << NodeID << " write 0x6098 0 i8 " << std::dec << (int)method;
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+    sstream << "[1] " << NodeID << " write 0x607C 0 i32 " << std::dec << homeOffset;
+    CANCommands.push_back(sstream.str());
+    sstream.str(std::string());
+
+    return CANCommands;
+}
+
 std::vector<std::string> Drive::generateVelControlConfigSDO(motorProfile velocityProfile) {
     // Define Vector to be returned as part of this method
     std::vector<std::string> CANCommands;
@@ -359,11 +691,11 @@ sdoReturnCode_t Drive::sendSDOMessages(std::vector<std::string> messages) {
 }
 bool Drive::changeSetPointImmediately(bool immediate) {
     if (driveState == ENABLED) {
-        int controlWord = *(&CO_OD_RAM.controlWords.motor1 + ((this->NodeID - 1)));
+        int controlWord = *motorOD->controlWord;
         if (immediate) {
-            *(&CO_OD_RAM.controlWords.motor1 + ((this->NodeID - 1))) = controlWord | 0x20;
+            *motorOD->controlWord = controlWord | 0x20;
         } else {
-            *(&CO_OD_RAM.controlWords.motor1 + ((this->NodeID - 1))) = controlWord & ~0x20;
+            *motorOD->controlWord = controlWord & ~0x20;
         }
         return true;
     } else {
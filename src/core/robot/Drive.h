@@ -18,10 +18,13 @@
 #include <CO_command.h>
 #include <string.h>
 
-#include <map>
 #include <sstream>
 #include <vector>
 
+#include "CO_OD_motors.h"
+#include "CiA402.h"
+#include "PDOMapping.h"
+
 /**
  * \brief Supported drive control modes
  * 
@@ -31,6 +34,11 @@ enum ControlMode {
     POSITION_CONTROL = 1, /**< 1 */
     VELOCITY_CONTROL = 2, /**< 2 */
     TORQUE_CONTROL = 3,   /**< 3 */
+    CSP_CONTROL = 4,      /**< 4 */
+    CSV_CONTROL = 5,      /**< 5 */
+    CST_CONTROL = 6,      /**< 6 */
+    IP_CONTROL = 7,       /**< 7 */
+    HOMING_CONTROL = 8,   /**< 8 */
     ERROR = -1            /**< -1 */
 };
 
@@ -44,52 +52,6 @@ enum DriveState {
     ENABLED = 2,            /**< 2 */
 };
 
-/**
- * \brief Commonly-used Object Dictionary (OD) entries for CiA402 Drives
- * 
- */
-enum OD_Entry_t {
-    STATUS_WORD = 0, /**< 0 */
-    ACTUAL_POS = 1,  /**< 1 */
-    ACTUAL_VEL = 2,  /**< 2 */
-    ACTUAL_TOR = 3,  /**< 3 */
-    TARGET_POS = 11, /**< 11 */
-    TARGET_VEL = 12, /**< 12 */
-    TARGET_TOR = 13  /**< 13 */
-};
-
-/**
- * \brief Map between commonly-used Object Dictionary (OD) entries and their respective memory addresses
- *
- *  Used to generate PDO Configurations
- *  NOTE: The addresses are written in hexadecimal
- * 
- */
-static std::map<OD_Entry_t, int> OD_Addresses = {
-    {STATUS_WORD, 0x6041},
-    {ACTUAL_POS, 0x6064},
-    {ACTUAL_VEL, 0x606C},
-    {ACTUAL_TOR, 0x6077},
-    {TARGET_POS, 0x607A},
-    {TARGET_VEL, 0x60FF},
-    {TARGET_TOR, 0x6071}};
-
-/**
- * \brief Map between commonly-used Object Dictionary (OD) entries and their respective data lengths
- *  
- *  Used to generate PDO Configurations
- *  NOTE: The addresses are written in hexadecimal
- * 
- */
-static std::map<OD_Entry_t, int> OD_Data_Size = {
-    {STATUS_WORD, 0x0010},
-    {ACTUAL_POS, 0x0020},
-    {ACTUAL_VEL, 0x0020},
-    {ACTUAL_TOR, 0x0010},
-    {TARGET_POS, 0x0020},
-    {TARGET_VEL, 0x0020},
-    {TARGET_TOR, 0x0010}};
-
 /**
  * \brief Struct for Drive motor controller motion profile
  *
@@ -123,6 +85,14 @@ class Drive {
      */
     int NodeID;
 
+    /**
+     * \brief Pointers to the entries of this drive in the motor records of the Object Dictionary
+     * (0x6040 controlWords, 0x6064 actualMotorPositions...). Drives whose Node ID has no
+     * entry in the Object Dictionary (see CO_NO_MOTORS) use CO_OD_motorUnmapped.
+     *
+     */
+    const CO_OD_motor_t *motorOD;
+
     /**
      * \brief Generates the list of SDO commands required to configure TPDOs on the drive
      * 
@@ -137,6 +107,51 @@ class Drive {
 
     std::vector<std::string> generateTPDOConfigSDO(std::vector<OD_Entry_t> items, int PDO_Num, int SyncRate);
 
+    /**
+     * \brief Generates the list of SDO commands required to configure a TPDO described by a PDOMapping
+     * 
+     * \tparam Mapping The PDOMapping (number, transmission type and entries) of this TPDO
+     * \return std::vector<std::string> 
+     */
+    template <class Mapping>
+    std::vector<std::string> generateTPDOConfigSDO() {
+        return generateTPDOConfigSDO(Mapping::entries(), Mapping::number, Mapping::transmission);
+    }
+
+    /**
+     * \brief Generates the list of SDO commands required to configure the TPDOs of a PDOList, in order
+     * 
+     * \return std::vector<std::string> 
+     */
+    template <class... Mappings>
+    std::vector<std::string> generateTPDOConfigSDO(PDOList<Mappings...>) {
+        std::vector<std::string> CANCommands;
+        int expand[] = {0, (appendCommands(CANCommands, generateTPDOConfigSDO<Mappings>()), 0)...};
+        (void)expand;
+        return CANCommands;
+    }
+
+    /**
+     * \brief Generates the SDO command which disables a TPDO (COB-ID invalid bit), its mapping is kept
+     * 
+     * \param PDO_Num The number/index of this PDO
+     * \return std::vector<std::string> 
+     */
+    std::vector<std::string> generateTPDODisableSDO(int PDO_Num);
+
+    /**
+     * \brief Generates the SDO commands which disable the TPDOs of a PDOList
+     * 
+     * \return std::vector<std::string> 
+     */
+    template <class... Mappings>
+    std::vector<std::string> generateTPDODisableSDO(PDOList<Mappings...>) {
+        std::vector<std::string> CANCommands;
+        int expand[] = {0, (appendCommands(CANCommands, generateTPDODisableSDO(Mappings::number)), 0)...};
+        (void)expand;
+        return CANCommands;
+    }
+
     /**
      * \brief Generates the list of SDO commands required to configure RPDOs on the drives
      * 
@@ -149,7 +164,63 @@ class Drive {
      * \return std::vector<std::string> 
      */
 
-    std::vector<std::string> generateRPDOConfigSDO(std::vector<OD_Entry_t> items, int PDO_Num, int UpdateTiming);
+    virtual std::vector<std::string> generateRPDOConfigSDO(std::vector<OD_Entry_t> items, int PDO_Num, int UpdateTiming);
+
+    /**
+     * \brief Generates the list of SDO commands required to configure RPDOs on drives, whose RPDO parameters
+     * are not numbered as their PDOs (e.g. RPDO3, COB-ID 300+{NODE-ID}, configured in 0x1401/0x1601)
+     *
+     * \param parameterNum Number of the RPDO communication and mapping parameters of the drive (0x1400 + parameterNum - 1)
+     * \return std::vector<std::string>
+     */
+    std::vector<std::string> generateRPDOConfigSDO(std::vector<OD_Entry_t> items, int PDO_Num, int UpdateTiming, int parameterNum);
+
+    /**
+     * \brief Generates the list of SDO commands required to configure an RPDO described by a PDOMapping
+     * 
+     * \tparam Mapping The PDOMapping (number, transmission type and entries) of this RPDO
+     * \return std::vector<std::string> 
+     */
+    template <class Mapping>
+    std::vector<std::string> generateRPDOConfigSDO() {
+        return generateRPDOConfigSDO(Mapping::entries(), Mapping::number, Mapping::transmission);
+    }
+
+    /**
+     * \brief Generates the list of SDO commands required to configure the RPDOs of a PDOList, in order
+     * 
+     * \return std::vector<std::string> 
+     */
+    template <class... Mappings>
+    std::vector<std::string> generateRPDOConfigSDO(PDOList<Mappings...>) {
+        std::vector<std::string> CANCommands;
+        int expand[] = {0, (appendCommands(CANCommands, generateRPDOConfigSDO<Mappings>()), 0)...};
+        (void)expand;
+        return CANCommands;
+    }
+
+    /**
+     * \brief Appends a list of SDO commands to another
+     *
+     */
+    static void appendCommands(std::vector<std::string> &commands, const std::vector<std::string> &more) {
+        commands.insert(commands.end(), more.begin(), more.end());
+    }
+
+    /**
+     * \brief Generates the list of SDO commands required to configure an RPDO receiving one slot of the
+     * multiplexed setpoint frame (see CO_setpointMux.h)
+     *
+     * The slot before the slot of this drive is mapped to a dummy INTEGER32 entry (0x0004), so the frame
+     * can be shared by two drives.
+     *
+     * \param targetParameter Mapping parameter of the 32 bit drive object receiving the slot (e.g. Target Position)
+     * \param PDO_Num The number/index of this PDO
+     * \param COB_ID The CAN identifier of the multiplexed frame
+     * \param slot The slot of this drive in the frame (0-1)
+     * \return std::vector<std::string>
+     */
+    std::vector<std::string> generatePackedRPDOConfigSDO(uint32_t targetParameter, int PDO_Num, int COB_ID, int slot);
 
     /**
      * \brief Generates the list of SDO commands required to configure position control in CANopen motor drive
@@ -164,6 +235,78 @@ class Drive {
 
     std::vector<std::string> generatePosControlConfigSDO(motorProfile positionProfile);
 
+    /**
+     * \brief Generates the list of SDO commands required to configure cyclic synchronous position control
+     * (mode 8) in CANopen motor drive
+     *
+     * In this mode the drive interpolates between the target positions received every SYNC, there is no
+     * set point handshake (Control Word bit 4) and no profile (0x6081, 0x6083, 0x6084 are not used).
+     *
+     * \param interpolationPeriodUs Interpolation time period (0x60C2), should be the SYNC period [us]
+     * \param followingErrorWindow Following error window (0x6065) in position counts, 0 keeps the drive setting
+     * \return std::vector<std::string> representing a generated list of SDO configuration commands for CSP control
+     */
+    std::vector<std::string> generateCSPControlConfigSDO(uint32_t interpolationPeriodUs, uint32_t followingErrorWindow);
+
+    /**
+     * \brief Generates the list of SDO commands required to configure cyclic synchronous velocity control
+     * (mode 9) in CANopen motor drive
+     *
+     * The drive follows the target velocity received every SYNC, without acceleration profile. The
+     * torque offset (0x60B2) is cleared.
+     *
+     * \param interpolationPeriodUs Interpolation time period (0x60C2), should be the SYNC period [us]
+     * \return std::vector<std::string> representing a generated list of SDO configuration commands for CSV control
+     */
+    std::vector<std::string> generateCSVControlConfigSDO(uint32_t interpolationPeriodUs);
+
+    /**
+     * \brief Generates the list of SDO commands required to configure cyclic synchronous torque control
+     * (mode 10) in CANopen motor drive
+     *
+     * \param interpolationPeriodUs Interpolation time period (0x60C2), should be the SYNC period [us]
+     * \return std::vector<std::string> representing a generated list of SDO configuration commands for CST control
+     */
+    std::vector<std::string> generateCSTControlConfigSDO(uint32_t interpolationPeriodUs);
+
+    /**
+     * \brief Generates the list of SDO commands required to configure interpolated position control
+     * (mode 7) in CANopen motor drive
+     *
+     * Linear interpolation (0x60C0) between the points of a FIFO buffer (0x60C4), which is cleared and
+     * resized. The drive takes one point every interpolation time period, while Interpolated Position mode
+     * is enabled (see setIPEnabled()).
+     *
+     * \param interpolationPeriodUs Interpolation time period (0x60C2), should be the SYNC period [us]
+     * \param bufferSize Number of points of the drive buffer (0x60C4 sub 2)
+     * \return std::vector<std::string> representing a generated list of SDO configuration commands for IP control
+     */
+    std::vector<std::string> generateIPControlConfigSDO(uint32_t interpolationPeriodUs, uint16_t bufferSize);
+
+    /**
+     * \brief Generates the list of SDO commands required to configure homing (mode 6) in CANopen motor drive
+     *
+     * \param method Homing method (0x6098): CiA 402 methods 1 to 35, negative methods are manufacturer specific
+     * \param homeOffset Position of the home position found by the method (0x607C) [drive units]
+     * \return std::vector<std::string> representing a generated list of SDO configuration commands for homing
+     */
+    std::vector<std::string> generateHomingControlConfigSDO(int8_t method, int32_t homeOffset);
+
+    /**
+     * \brief Mode set by initCSPControl(), initCSVControl(), initCSTControl() or initIPControl(), UNCONFIGURED
+     * otherwise. The target RPDOs remapped by these are configured back to the standard layout when the
+     * drive leaves these modes.
+     *
+     */
+    ControlMode synchronousMode = UNCONFIGURED;
+
+    /**
+     * \brief False for drives whose actual values are written into the Object Dictionary by the host
+     * (e.g. SimulatedDrive), the feedback is then always current (see getFeedbackAge())
+     *
+     */
+    bool feedbackFromRPDO = true;
+
     /**
      * \brief Generates the list of SDO commands required to configure velocity control in CANopen motor drive
      * 
@@ -209,11 +352,38 @@ class Drive {
     int error;
 
     /**
-     * \brief Current state of the drive - Initialised in DISABLED state
+     * \brief RPDO which writes the actual position of this drive (0x6064), NULL if none.
+     * Found again when the PDO configuration changes (see CO_t::PDOconfigCounter).
+     *
+     */
+    const CO_RPDO_t *feedbackRPDO = NULL;
+
+    /**
+     * \brief CO->PDOconfigCounter when feedbackRPDO was found
+     *
+     */
+    uint32_t feedbackPDOconfig = 0;
+
+    /**
+     * \brief Finds (if the PDO configuration changed) the RPDO which writes the actual position
+     *
+     * \return const CO_RPDO_t* the RPDO, NULL if the actual position is not received by an RPDO
+     */
+    const CO_RPDO_t *getFeedbackRPDO();
+
+    /**
+     * \brief Current state of the drive - Initialised in DISABLED state. Set by the state modifiers
+     * when commanded, and to DISABLED by updateDriveStatus() when the drive reports a fault.
      * 
      */
     DriveState driveState = DISABLED;
 
+    /**
+     * \brief State of the drive decoded from its status word by the last updateDriveStatus()
+     * 
+     */
+    CiA402State cia402State = CIA402_NOT_READY_TO_SWITCH_ON;
+
     /**
      * \brief Current control mode of the drive - Initialised in UNCONFIGURED control mode
      * 
@@ -267,6 +437,7 @@ class Drive {
     *   RPDO4: COB-ID 400+{NODE-ID} | Target Velocity (0x60FF) | Applied immediately when received    
     *   RPDO5: COB-ID 500+{NODE-ID} | Target Torque (0x6071) | Applied immediately when received       
     * 
+    *   The layout is described by CiA402PDOLayout.
     * 
     * \return true if successful
     * \return false if unsuccessful
@@ -274,6 +445,20 @@ class Drive {
 
     virtual bool initPDOs();
 
+    /**
+     * \brief Configures the drive to receive its target position from a multiplexed setpoint frame
+     * shared with another drive (see CO_setpointMux.h), in addition to the Target Position RPDO.
+     *
+     * Drives with a free RPDO override this (see CiA402Drive::initPackedSetpoints() and
+     * generatePackedRPDOConfigSDO()). Drives which don't keep receiving their setpoints in per node PDOs.
+     *
+     * \param COB_ID The CAN identifier of the multiplexed frame
+     * \param slot The slot of this drive in the frame (0-1)
+     * \return true if the drive was configured
+     * \return false if the drive does not support multiplexed setpoints (default)
+     */
+    virtual bool initPackedSetpoints(int COB_ID, int slot);
+
     /**
      * \brief Sets the drive to position control with the provided %motorProfile parameters using SDO messages
      * 
@@ -299,6 +484,98 @@ class Drive {
      */
     virtual bool initVelControl(motorProfile velControlMotorProfile) = 0;
 
+    /**
+     * \brief Sets the drive to cyclic synchronous position control using SDO messages
+     *
+     * The interpolation time period is the SYNC period of this node (0x1006) and the Target Position
+     * RPDO is applied at the next SYNC, so all drives move to their target positions together. The target
+     * position is set to the actual position before the switch, so the drive holds its position.
+     *
+     * \param followingErrorWindow Following error window (0x6065) in position counts, 0 keeps the drive setting
+     * \return true if successful
+     * \return false if unsuccessful, or if no SYNC period is set
+     */
+    virtual bool initCSPControl(uint32_t followingErrorWindow) = 0;
+
+    /**
+     * \brief Sets the drive to cyclic synchronous velocity control using SDO messages
+     *
+     * The Target Velocity and Torque Offset RPDOs are applied at the next SYNC.
+     *
+     * \return true if successful
+     * \return false if unsuccessful
+     */
+    virtual bool initCSVControl() = 0;
+
+    /**
+     * \brief Sets the drive to cyclic synchronous torque control using SDO messages
+     *
+     * The Target Torque RPDO is applied at the next SYNC.
+     *
+     * \return true if successful
+     * \return false if unsuccessful
+     */
+    virtual bool initCSTControl() = 0;
+
+    /**
+     * \brief Sets the drive to interpolated position control using SDO messages
+     *
+     * The Target Position RPDO is mapped to the Interpolation Data Record (0x60C1 sub 1), each
+     * position received is added to the drive buffer (see CO_ipBuffer.h). The drive sends its Buffer
+     * Position (0x60C4 sub 4) every SYNC, and follows the buffer after setIPEnabled().
+     *
+     * \param bufferSize Number of points of the drive buffer
+     * \return true if successful
+     * \return false if unsuccessful
+     */
+    virtual bool initIPControl(uint16_t bufferSize) = 0;
+
+    /**
+     * \brief Sets or clears Bit 4 of Control Word (0x6040), which enables Interpolated Position mode
+     *
+     * \param enable true to start taking points from the buffer, false to hold the position
+     * \return true if successful
+     * \return false if the drive is not in interpolated position control
+     */
+    virtual bool setIPEnabled(bool enable);
+
+    /**
+     * \brief Checks Bit 12 of Status Word (0x6041), Interpolated Position mode active
+     *
+     * \return true if the drive takes points from its buffer
+     */
+    virtual bool isIPActive();
+
+    /**
+     * \brief Disables Interpolated Position mode and clears the drive buffer (0x60C4 sub 6) using SDO messages,
+     * dropping the points of an interrupted motion
+     *
+     * \return true if successful
+     * \return false if the drive is not in interpolated position control
+     */
+    virtual bool clearIPBuffer();
+
+    /**
+     * \brief Sets the drive to homing (mode 6) with the given method using SDO messages
+     *
+     * The drive searches its home position after startHoming(), and reports the result in the Status Word
+     * (CIA402_SW_HOMING_ATTAINED, CIA402_SW_HOMING_ERROR).
+     *
+     * \param method Homing method (0x6098)
+     * \param homeOffset Home offset (0x607C) [drive units]
+     * \return true if successful
+     * \return false if unsuccessful, or not supported by the drive
+     */
+    virtual bool initHomingControl(int8_t method, int32_t homeOffset);
+
+    /**
+     * \brief Sets or clears Bit 4 of Control Word (0x6040), which starts homing in homing mode
+     *
+     * \param start true to start homing, false to stop it
+     * \return true if successful
+     */
+    virtual bool startHoming(bool start);
+
     /**
      * \brief Sets the drive to torque control with the provided %motorProfile parameters using SDO messages
      * 
@@ -310,12 +587,29 @@ class Drive {
     virtual bool initTorqueControl() = 0;
 
     /**
-     * \brief Updates the internal representation of the state of the drive 
+     * \brief Updates the internal representation of the state of the drive: decodes the status word
+     * (see getCiA402State()) and, if the drive reports a fault, sets the drive state to DISABLED
      * 
      * \return int representing the current value of the drive status word (0x6041)
      */
     virtual int updateDriveStatus();
 
+    /**
+     * \brief Get the state of the drive decoded from its status word by the last updateDriveStatus()
+     * 
+     * \return CiA402State the state reported by the drive
+     */
+    CiA402State getCiA402State();
+
+    /**
+     * \brief Resets a fault of the drive (rising edge of Control Word bit 7, so it must be called on
+     * consecutive cycles until the drive leaves the FAULT state). The drive is then switch on disabled.
+     * 
+     * \return true if the drive was in the FAULT state at the last updateDriveStatus()
+     * \return false otherwise (Control Word not changed)
+     */
+    virtual bool resetFault();
+
     /**
      * \brief Writes the desired position to the Target Position entry of the motor drive (0x607A)
      * 
@@ -343,6 +637,31 @@ class Drive {
      */
     virtual bool setTorque(int torque);
 
+    /**
+     * \brief Writes the velocity feedforward, sent to the Velocity Offset entry of the motor drive (0x60B1)
+     * in CSP mode
+     *
+     * The master Object Dictionary has no offset records: in CSP mode the target velocity of this drive is
+     * unused, its entry and TPDO (COB-ID 400+{NODE-ID}) carry the offset, which the drive maps to 0x60B1.
+     *
+     * \param velocity the velocity offset, in drive velocity units
+     * \return true if successful
+     * \return false if the drive is not in CSP mode
+     */
+    virtual bool setVelOffset(int velocity);
+
+    /**
+     * \brief Writes the torque feedforward, sent to the Torque Offset entry of the motor drive (0x60B2)
+     * in CSP and CSV modes
+     *
+     * As setVelOffset(), the Target Torque entry and TPDO (COB-ID 500+{NODE-ID}) of this drive carry the offset.
+     *
+     * \param torque the torque offset, in drive torque units
+     * \return true if successful
+     * \return false if the drive is not in CSP or CSV mode
+     */
+    virtual bool setTorqueOffset(int torque);
+
     /**
      * \brief Gets the current position from the motor drive (0x6064)
      * 
@@ -354,18 +673,67 @@ class Drive {
      * \brief Gets the current velocity from the motor drive (0x606C)
      * 
      * \return int representing the current velocity of the drive. 
-     * Returns 0 if Node ID is 5 or 6 as these have no OD entry.
      */
     virtual int getVel();
 
+    /**
+     * \brief Unit of the velocities of the motor drive (0x606C, 0x60FF, 0x60B1 and the profile velocity)
+     *
+     * \return double position counts/s per velocity unit, 1 (default) for counts/s
+     */
+    virtual double getVelocityUnit();
+
     /**
      * \brief Gets the current torque from the motor drive (0x6077)
      * 
      * \return int representing the current torque of the drive
-     * Returns 0 if Node ID is 5 or 6 as these have no OD entry.
      */
     virtual int getTorque();
 
+    /**
+     * \brief Gets the following error, difference between the Target Position (0x607A) sent to the drive
+     * and its Actual Position (0x6064)
+     *
+     * In CSP mode the actual position is sampled at the SYNC, at which the previous target was applied, so
+     * the error includes the motion of one cycle. The drive's own following error (0x60F4) is checked
+     * against the window set by initCSPControl().
+     *
+     * \return int following error in position counts
+     */
+    virtual int getFollowingError();
+
+    /**
+     * \brief Gets the age of the actual position (0x6064) returned by getPos(), in SYNC cycles
+     *
+     * The drive sends its actual position after every SYNC message, so the age is 0 or 1 while
+     * the drive is communicating and grows when its PDOs are lost.
+     *
+     * \return uint32_t number of SYNC cycles since the actual position was last received,
+     * UINT32_MAX if it was never received or is not mapped to any RPDO
+     */
+    virtual uint32_t getFeedbackAge();
+
+    /**
+     * \brief Gets the number of SYNC cycles which ended without the actual position (0x6064) of this drive
+     *
+     * \return uint32_t number of missed cycles since the CANopen communication reset
+     */
+    virtual uint32_t getFeedbackMissedCycles();
+
+    /**
+     * \brief Gets the Object Dictionary entries of this drive in the master, for reading the process
+     * image of several drives in one pass (see JointStateBlock)
+     *
+     * \return const CO_OD_motor_t* pointers to the OD variables of the drive (CO_OD_motorUnmapped if the drive has none)
+     */
+    const CO_OD_motor_t *getMotorOD();
+
+    /**
+     * \brief True if the actual values are received by RPDO, sampled by the drive on SYNC (see feedbackFromRPDO)
+     *
+     */
+    bool isFeedbackFromRPDO();
+
     // Drive State Modifiers
     /**
      * \brief Changes the state of the drive to "ready to switch on". 
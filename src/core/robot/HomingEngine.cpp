@@ -0,0 +1,253 @@
+/**
+ * @file HomingEngine.cpp
+ * @author William Campbell
+ * @brief Concurrent homing of the drives, see HomingEngine.h
+ * @version 0.1
+ * @date 2020-10-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "HomingEngine.h"
+
+#include <cstdlib>
+
+#include "CiA402.h"
+
+/**
+ * \brief Time after Control Word bit 4 is set before homing attained is trusted: the Status Word of the
+ * previous homing takes a TPDO to be cleared by the drive [s]
+ *
+ */
+static const double homingAttainedDelay = 0.1;
+
+/**
+ * \brief Enable a drive through the power drive state machine, from its Status Word
+ *
+ * \return true once the drive reports operation enabled
+ */
+static bool enableDrive(Drive *drive) {
+    switch (decodeCiA402State(*drive->getMotorOD()->statusWord)) {
+        case CIA402_OPERATION_ENABLED:
+            return true;
+        case CIA402_SWITCH_ON_DISABLED:
+            drive->readyToSwitchOn();
+            break;
+        case CIA402_READY_TO_SWITCH_ON:
+        case CIA402_SWITCHED_ON:
+            drive->enable();
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+
+static bool isFaulted(Drive *drive) {
+    return (*drive->getMotorOD()->statusWord & CIA402_SW_FAULT) != 0;
+}
+
+CiA402Homing::CiA402Homing(int8_t method, int32_t homeOffset, double timeout) : method(method), homeOffset(homeOffset), timeout(timeout) {
+}
+
+bool CiA402Homing::start(Drive *drive, HomingResult &result) {
+    started = false;
+    if (!drive->initHomingControl(method, homeOffset)) {
+        result.error = "homing mode not supported";
+        return false;
+    }
+    drive->readyToSwitchOn();
+    return true;
+}
+
+HomingStatus CiA402Homing::update(Drive *drive, double elapsed, HomingResult &result) {
+    uint16_t statusWord = *drive->getMotorOD()->statusWord;
+    if (isFaulted(drive)) {
+        result.error = "drive fault";
+        return HOMING_FAILED;
+    }
+    if (elapsed > timeout) {
+        result.error = "timeout";
+        return HOMING_FAILED;
+    }
+    if (!started) {
+        if (enableDrive(drive)) {
+            drive->startHoming(true);
+            started = true;
+            startedAt = elapsed;
+        }
+        return HOMING_RUNNING;
+    }
+    if (statusWord & CIA402_SW_HOMING_ERROR) {
+        result.error = "homing error reported by the drive";
+        return HOMING_FAILED;
+    }
+    if (elapsed - startedAt >= homingAttainedDelay && (statusWord & CIA402_SW_HOMING_ATTAINED) && (statusWord & CIA402_SW_TARGET_REACHED)) {
+        result.position = drive->getPos();
+        drive->startHoming(false);
+        return HOMING_DONE;
+    }
+    return HOMING_RUNNING;
+}
+
+void CiA402Homing::stop(Drive *drive) {
+    drive->startHoming(false);
+}
+
+HardStopHoming::HardStopHoming(int velocity, int acceleration, int stallVelocity, double stallTime, double timeout)
+    : velocity(velocity), acceleration(acceleration), stallVelocity(stallVelocity), stallTime(stallTime), timeout(timeout) {
+}
+
+bool HardStopHoming::start(Drive *drive, HomingResult &result) {
+    moving = false;
+    stalledSince = -1;
+    motorProfile profile = {0, acceleration, acceleration};
+    if (velocity == 0 || acceleration <= 0 || !drive->initVelControl(profile)) {
+        result.error = "velocity mode not supported";
+        return false;
+    }
+    drive->setVel(0);
+    drive->readyToSwitchOn();
+    return true;
+}
+
+HomingStatus HardStopHoming::update(Drive *drive, double elapsed, HomingResult &result) {
+    if (isFaulted(drive)) {
+        result.error = "drive fault";
+        return HOMING_FAILED;
+    }
+    if (elapsed > timeout) {
+        result.error = "timeout, no end stop found";
+        return HOMING_FAILED;
+    }
+    if (!moving) {
+        if (enableDrive(drive)) {
+            drive->setVel(velocity);
+            moving = true;
+            movingSince = elapsed;
+        }
+        return HOMING_RUNNING;
+    }
+    // the joint is slow while it accelerates, a stall only counts once it could be at full velocity
+    double accelerationTime = std::abs(velocity) / (double)acceleration;
+    if (elapsed - movingSince < accelerationTime || std::abs(drive->getVel() * drive->getVelocityUnit()) >= stallVelocity) {
+        stalledSince = -1;
+        return HOMING_RUNNING;
+    }
+    if (stalledSince < 0) {
+        stalledSince = elapsed;
+    }
+    if (elapsed - stalledSince < stallTime) {
+        return HOMING_RUNNING;
+    }
+    result.position = drive->getPos();
+    drive->setVel(0);
+    return HOMING_DONE;
+}
+
+void HardStopHoming::stop(Drive *drive) {
+    drive->setVel(0);
+}
+
+HomingEngine::HomingEngine() {
+}
+
+HomingEngine::~HomingEngine() {
+    clear();
+}
+
+void HomingEngine::add(Drive *drive, HomingRoutine *routine) {
+    drives.push_back(drive);
+    routines.push_back(routine);
+    results.push_back(HomingResult());
+}
+
+void HomingEngine::clear() {
+    for (HomingRoutine *routine : routines) {
+        delete routine;
+    }
+    drives.clear();
+    routines.clear();
+    results.clear();
+    running = false;
+}
+
+int HomingEngine::size() const {
+    return (int)drives.size();
+}
+
+bool HomingEngine::start(const timespec &now) {
+    bool allStarted = true;
+    startTime = now;
+    elapsed = 0;
+    running = false;
+    for (size_t i = 0; i < drives.size(); i++) {
+        results[i] = HomingResult();
+        if (routines[i]->start(drives[i], results[i])) {
+            results[i].status = HOMING_RUNNING;
+            running = true;
+        } else {
+            results[i].status = HOMING_FAILED;
+            allStarted = false;
+        }
+    }
+    return allStarted;
+}
+
+bool HomingEngine::update(const timespec &now) {
+    if (!running) {
+        return true;
+    }
+    elapsed = (now.tv_sec - startTime.tv_sec) + (now.tv_nsec - startTime.tv_nsec) * 1e-9;
+    running = false;
+    for (size_t i = 0; i < drives.size(); i++) {
+        if (results[i].status != HOMING_RUNNING) {
+            continue;
+        }
+        HomingStatus status = routines[i]->update(drives[i], elapsed, results[i]);
+        if (status == HOMING_RUNNING) {
+            running = true;
+        } else {
+            finish(i, status, elapsed);
+        }
+    }
+    return !running;
+}
+
+void HomingEngine::abort(const std::string &reason) {
+    for (size_t i = 0; i < drives.size(); i++) {
+        if (results[i].status == HOMING_RUNNING) {
+            results[i].error = reason;
+            finish(i, HOMING_FAILED, elapsed);
+        }
+    }
+    running = false;
+}
+
+bool HomingEngine::isRunning() const {
+    return running;
+}
+
+bool HomingEngine::isSuccessful() const {
+    if (running || results.empty()) {
+        return false;
+    }
+    for (const HomingResult &result : results) {
+        if (result.status != HOMING_DONE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const std::vector<HomingResult> &HomingEngine::getResults() const {
+    return results;
+}
+
+void HomingEngine::finish(int i, HomingStatus status, double duration) {
+    if (status == HOMING_FAILED) {
+        routines[i]->stop(drives[i]);
+    }
+    results[i].status = status;
+    results[i].duration = duration;
+}
@@ -0,0 +1,234 @@
+/**
+ * \file HomingEngine.h
+ * \author William Campbell
+ * \brief Homing of the drives of a robot in process: each drive runs a homing routine, CiA 402 homing
+ * (mode 6) or a custom routine, and all routines run concurrently, stepped once per control cycle.
+ * The routines follow the drives through the Status Word of the process image (TPDO), no SDO is
+ * read while homing: the SDO configuration is only sent when a routine starts.
+ *
+ * The engine reports the drive position at the home position of each joint and the time it took,
+ * for the robot to write into the calibration of its joints.
+ * \code
+ *  engine.add(drive, new CiA402Homing(35, 0, 30));
+ *  engine.start(now);
+ *  // every cycle, after the process image is read
+ *  if (engine.update(now))
+ *      // engine.getResults()[i].status, .position, .duration
+ * \endcode
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef HOMINGENGINE_H_INCLUDED
+#define HOMINGENGINE_H_INCLUDED
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "Drive.h"
+
+/**
+ * \brief State of the homing of a drive
+ *
+ */
+enum HomingStatus {
+    HOMING_IDLE = 0,    /**< 0 */
+    HOMING_RUNNING = 1, /**< 1 */
+    HOMING_DONE = 2,    /**< 2 */
+    HOMING_FAILED = 3,  /**< 3 */
+};
+
+/**
+ * \brief Result of the homing of a drive
+ *
+ */
+struct HomingResult {
+    HomingStatus status = HOMING_IDLE;
+    /** Drive position at the home position [drive units], once HOMING_DONE */
+    int32_t position = 0;
+    /** Time from start to done or failed [s] */
+    double duration = 0;
+    /** Reason of the failure */
+    std::string error;
+};
+
+/**
+ * \brief A homing routine of one drive, stepped every control cycle by the HomingEngine
+ *
+ */
+class HomingRoutine {
+   public:
+    virtual ~HomingRoutine() {}
+
+    /**
+     * \brief Configure the drive and start homing
+     *
+     * \param drive The drive
+     * \param result Set to the failure reason if the routine cannot start
+     * \return true if started
+     */
+    virtual bool start(Drive *drive, HomingResult &result) = 0;
+
+    /**
+     * \brief Step the routine, from the process image of the drive
+     *
+     * \param drive The drive
+     * \param elapsed Time since start() [s]
+     * \param result Set to the home position once done, or the failure reason
+     * \return HomingStatus HOMING_RUNNING until the routine is done or failed
+     */
+    virtual HomingStatus update(Drive *drive, double elapsed, HomingResult &result) = 0;
+
+    /**
+     * \brief Stop the motion of the drive, when the routine is aborted or failed
+     *
+     */
+    virtual void stop(Drive *drive) = 0;
+};
+
+/**
+ * \brief CiA 402 homing (mode 6): the drive searches its home position with one of its homing methods
+ * (0x6098), e.g. 35 to take the current position as home, then reports homing attained or homing error
+ * in the Status Word.
+ *
+ */
+class CiA402Homing : public HomingRoutine {
+   public:
+    /**
+     * \param method Homing method (0x6098)
+     * \param homeOffset Home offset (0x607C) [drive units]
+     * \param timeout Time after which the routine fails [s]
+     */
+    CiA402Homing(int8_t method, int32_t homeOffset, double timeout);
+
+    bool start(Drive *drive, HomingResult &result);
+    HomingStatus update(Drive *drive, double elapsed, HomingResult &result);
+    void stop(Drive *drive);
+
+   private:
+    int8_t method;
+    int32_t homeOffset;
+    double timeout;
+    /** Control Word bit 4 set, homing started in the drive, and when [s] */
+    bool started = false;
+    double startedAt = 0;
+};
+
+/**
+ * \brief Homing against a hard stop, for drives without a suitable homing method: the drive moves in
+ * profile velocity mode until the joint stalls on its mechanical end stop, whose position is home.
+ *
+ */
+class HardStopHoming : public HomingRoutine {
+   public:
+    /**
+     * \param velocity Velocity towards the end stop [drive units/s]
+     * \param acceleration Profile acceleration and deceleration [drive units/s^2]
+     * \param stallVelocity Velocity below which the joint is stalled [counts/s] (see Drive::getVelocityUnit())
+     * \param stallTime Time the joint must stay stalled [s]
+     * \param timeout Time after which the routine fails [s]
+     */
+    HardStopHoming(int velocity, int acceleration, int stallVelocity, double stallTime, double timeout);
+
+    bool start(Drive *drive, HomingResult &result);
+    HomingStatus update(Drive *drive, double elapsed, HomingResult &result);
+    void stop(Drive *drive);
+
+   private:
+    int velocity;
+    int acceleration;
+    int stallVelocity;
+    double stallTime;
+    double timeout;
+    bool moving = false;
+    /** Time the joint started moving, and started to stall (-1 while not stalled) [s] */
+    double movingSince = 0;
+    double stalledSince = -1;
+};
+
+/**
+ * \brief Concurrent homing of several drives (see HomingEngine.h)
+ *
+ */
+class HomingEngine {
+   public:
+    HomingEngine();
+    ~HomingEngine();
+
+    /**
+     * \brief Add a drive to home
+     *
+     * \param drive The drive
+     * \param routine Its routine, owned by the engine
+     */
+    void add(Drive *drive, HomingRoutine *routine);
+
+    /**
+     * \brief Remove all drives and results
+     *
+     */
+    void clear();
+
+    /**
+     * \brief Number of drives added
+     *
+     */
+    int size() const;
+
+    /**
+     * \brief Start the routines of all drives
+     *
+     * \param now Current time
+     * \return true if all routines started, false if any failed (the others run)
+     */
+    bool start(const timespec &now);
+
+    /**
+     * \brief Step the routines of all drives, once per control cycle
+     *
+     * \param now Current time
+     * \return true once every routine is done or failed
+     */
+    bool update(const timespec &now);
+
+    /**
+     * \brief Stop the routines still running, as failed
+     *
+     * \param reason Failure reason of the stopped routines
+     */
+    void abort(const std::string &reason);
+
+    /**
+     * \brief Check whether routines are started and not all finished
+     *
+     */
+    bool isRunning() const;
+
+    /**
+     * \brief Check whether every routine is done
+     *
+     */
+    bool isSuccessful() const;
+
+    /**
+     * \brief Results of the drives, in the order they were added
+     *
+     */
+    const std::vector<HomingResult> &getResults() const;
+
+   private:
+    std::vector<Drive *> drives;
+    std::vector<HomingRoutine *> routines;
+    std::vector<HomingResult> results;
+    timespec startTime = {0, 0};
+    /** Time from start() to the last update() [s] */
+    double elapsed = 0;
+    bool running = false;
+
+    void finish(int i, HomingStatus status, double duration);
+};
+
+#endif
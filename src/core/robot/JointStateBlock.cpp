@@ -0,0 +1,200 @@
+/**
+ * @file JointStateBlock.cpp
+ * @author William Campbell
+ * @brief State of all joints of a robot as a structure of arrays, see JointStateBlock.h
+ * @version 0.1
+ * @date 2020-10-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "JointStateBlock.h"
+
+#include "ActuatedJoint.h"
+#include "CANopen.h"
+#include "CO_Linux_tasks.h"
+#include "DebugMacro.h"
+
+JointStateBlock::JointStateBlock() {
+    for (int i = 0; i < MAX_JOINTS; i++) {
+        joints[i] = NULL;
+        actuated[i] = NULL;
+        batched[i] = 0;
+    }
+}
+
+bool JointStateBlock::build(const std::vector<Joint *> &robotJoints) {
+    n = 0;
+    eventMask = 0;
+    newEventMask = 0;
+    if (robotJoints.size() > MAX_JOINTS) {
+        DEBUG_OUT("JointStateBlock: " << robotJoints.size() << " joints, at most " << MAX_JOINTS << " supported")
+        return false;
+    }
+    for (Joint *joint : robotJoints) {
+        int i = n++;
+        joints[i] = joint;
+        actuated[i] = NULL;
+        batched[i] = 0;
+        q[i] = joint->getQ();
+        qd[i] = 0;
+        tau[i] = 0;
+        status[i] = 0;
+        state[i] = CIA402_NOT_READY_TO_SWITCH_ON;
+        events[i] = 0;
+        newEvents[i] = 0;
+        age[i] = 0;
+        valid[i] = 1;
+        rawPos[i] = 0;
+        rawVel[i] = 0;
+        rawTor[i] = 0;
+        posScale[i] = 0;
+        velScale[i] = 0;
+        posOffset[i] = 0;
+        qdd[i] = 0;
+        syncSampled[i] = 0;
+        sampleCycle[i] = 0;
+        sampleTime[i] = 0;
+        estimators[i].configure(estimatorConfig);
+
+        ActuatedJoint *actuatedJoint = dynamic_cast<ActuatedJoint *>(joint);
+        if (actuatedJoint == NULL || actuatedJoint->getDrive() == NULL) {
+            continue;
+        }
+        actuated[i] = actuatedJoint;
+        const CO_OD_motor_t *motorOD = actuatedJoint->getDrive()->getMotorOD();
+        if (motorOD == NULL || !actuatedJoint->getLinearConversion(posScale[i], posOffset[i])) {
+            continue;
+        }
+        batched[i] = 1;
+        velScale[i] = posScale[i] * actuatedJoint->getDrive()->getVelocityUnit();
+#ifdef VIRTUAL
+        // as Drive::getPos(), the target position is the feedback
+        posSource[i] = motorOD->targetPosition;
+#else
+        posSource[i] = motorOD->actualPosition;
+#endif
+        velSource[i] = motorOD->actualVelocity;
+        torSource[i] = motorOD->actualTorque;
+#ifndef VIRTUAL
+        syncSampled[i] = actuatedJoint->getDrive()->isFeedbackFromRPDO();
+#endif
+    }
+    return true;
+}
+
+void JointStateBlock::setEstimator(const JointEstimatorConfig &config) {
+    estimatorConfig = config;
+    for (int i = 0; i < MAX_JOINTS; i++) {
+        estimators[i].configure(config);
+    }
+}
+
+void JointStateBlock::setClock(void (*newClock)(timespec *time)) {
+    clock = newClock;
+}
+
+double JointStateBlock::sampleInterval(int i, double updateInterval) {
+    if (!syncSampled[i]) {
+        return updateInterval;
+    }
+    // the drive sampled the feedback on the SYNC of the cycle it was received in
+    uint32_t c = cycle - age[i];
+    if (estimators[i].isInitialised() && c == sampleCycle[i]) {
+        return 0;
+    }
+    int64_t t = 0;
+    CO_SYNCjitter_t *jitter = CANrx_taskTmr_getSYNCjitter();
+    if (jitter == NULL || !CO_SYNCjitter_getTransmitTime(jitter, c, &t)) {
+        t = 0;
+    }
+    double interval;
+    if (t != 0 && sampleTime[i] != 0) {
+        interval = (t - sampleTime[i]) * 1e-9;
+    } else {
+        interval = (c - sampleCycle[i]) * (CO->SYNC->periodTime * 1e-6);
+    }
+    sampleCycle[i] = c;
+    sampleTime[i] = t;
+    return interval;
+}
+
+bool JointStateBlock::update() {
+    uint8_t fresh[MAX_JOINTS];
+    bool allValid = true;
+
+    timespec previousTime = time;
+    if (clock != NULL) {
+        clock(&time);
+    } else {
+        clock_gettime(CLOCK_MONOTONIC, &time);
+    }
+    double updateInterval = (time.tv_sec - previousTime.tv_sec) + (time.tv_nsec - previousTime.tv_nsec) * 1e-9;
+    bool syncAvailable = CO != NULL && CO->SYNC != NULL && CO->SYNC->periodTime != 0;
+    cycle = syncAvailable ? CO->SYNC->cycle : 0;
+
+    // gather the process image
+    eventMask = 0;
+    newEventMask = 0;
+    for (int i = 0; i < n; i++) {
+        ActuatedJoint *joint = actuated[i];
+        fresh[i] = 0;
+        if (joint == NULL) {
+            continue;
+        }
+        Drive *drive = joint->getDrive();
+        ControlMode mode = joint->getMode();
+        status[i] = drive->Drive::updateDriveStatus();
+        state[i] = drive->getCiA402State();
+        uint16_t current = decodeDriveEvents(status[i], mode == POSITION_CONTROL || mode == CSP_CONTROL || mode == IP_CONTROL);
+        newEvents[i] = current & ~events[i];
+        events[i] = current;
+        eventMask |= current;
+        newEventMask |= newEvents[i];
+        if (!batched[i]) {
+            continue;
+        }
+        rawPos[i] = *posSource[i];
+        rawVel[i] = *velSource[i];
+        rawTor[i] = *torSource[i];
+        age[i] = drive->Drive::getFeedbackAge();
+        uint32_t maxAge = joint->getMaxFeedbackAge();
+        fresh[i] = maxAge == 0 || age[i] <= maxAge;
+    }
+
+    // convert, stale joints keep their previous value (as ActuatedJoint::updateValue())
+    for (int i = 0; i < n; i++) {
+        double newQ = (rawPos[i] - posOffset[i]) * posScale[i];
+        double newTau = rawTor[i];
+        q[i] = fresh[i] ? newQ : q[i];
+        tau[i] = fresh[i] ? newTau : tau[i];
+        valid[i] = fresh[i];
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (batched[i]) {
+            joints[i]->setQ(q[i]);
+        } else {
+            valid[i] = joints[i]->updateValue();
+            q[i] = joints[i]->getQ();
+        }
+        allValid &= valid[i] != 0;
+    }
+
+    // velocity and acceleration of the joints with a new sample
+    for (int i = 0; i < n; i++) {
+        if (!valid[i]) {
+            continue;
+        }
+        double interval = syncAvailable ? sampleInterval(i, updateInterval) : updateInterval;
+        if (interval == 0) {
+            continue;
+        }
+        estimators[i].update(q[i], rawVel[i] * velScale[i], interval);
+        qd[i] = estimators[i].qd;
+        qdd[i] = estimators[i].qdd;
+        joints[i]->setQd(qd[i]);
+        joints[i]->setQdd(qdd[i]);
+    }
+    return allValid;
+}
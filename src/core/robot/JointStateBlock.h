@@ -0,0 +1,250 @@
+/**
+ * \file JointStateBlock.h
+ * \author William Campbell
+ * \brief The <code>JointStateBlock</code> class holds the state of all joints of a <code>Robot</code>
+ * as a structure of arrays, updated from the Object Dictionary in one pass per control cycle.
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef JOINTSTATEBLOCK_H_INCLUDED
+#define JOINTSTATEBLOCK_H_INCLUDED
+#include <stdint.h>
+#include <time.h>
+
+#include <vector>
+
+#include "CiA402.h"
+#include "Joint.h"
+#include "JointEstimator.h"
+
+class ActuatedJoint;
+
+/**
+ * @ingroup Robot
+ * \brief State of all joints of a robot in contiguous arrays (index i is joints[i] of the robot).
+ *
+ * update() reads the drive feedback of all joints from the process image (the master Object
+ * Dictionary, written by the RPDOs) into the raw arrays, converts them to joint units in one loop
+ * without calls, which the compiler can vectorise, and stores q back to the joints (Joint::setQ()),
+ * so Joint::getQ() keeps working. Joints, whose conversion is not linear (see
+ * ActuatedJoint::getLinearConversion()), and non-actuated joints are updated by their own
+ * updateValue() and only q of them is in the block.
+ *
+ * Velocity and acceleration of every joint are estimated from the positions (see JointEstimator) and
+ * stored back too (Joint::setQd(), Joint::setQdd()). Each position sample is taken at the time the
+ * drive sampled it: the transmit time of the SYNC of its cycle, from the kernel timestamp when the
+ * SYNC jitter object has it (see CO_SYNCjitter_getTransmitTime()), from the SYNC period otherwise. A
+ * sample already estimated (the control loop runs faster than SYNC) is not used twice. Joints without
+ * SYNC feedback (VIRTUAL, SimulatedDrive, not actuated) are sampled at the time of update().
+ *
+ * The status word of every drive is decoded in the same pass (see CiA402.h, Drive::updateDriveStatus()),
+ * so a fault reported in the process image is in events[] after the next update().
+ *
+ * The block has fixed capacity and does not allocate, its arrays are read directly:
+ * \code
+ *  const JointStateBlock &s = robot->getJointStateBlock();
+ *  for (int i = 0; i < s.n; i++)
+ *      sum += s.q[i];
+ * \endcode
+ */
+class JointStateBlock {
+   public:
+    /**
+     * \brief Maximum number of joints of the block
+     *
+     */
+    static const int MAX_JOINTS = 8;
+
+    /**
+     * \brief Number of joints in the arrays
+     *
+     */
+    int n = 0;
+
+    /**
+     * \brief Joint positions (joint units)
+     *
+     */
+    double q[MAX_JOINTS];
+
+    /**
+     * \brief Estimated joint velocities and accelerations (joint units per second, per second^2)
+     *
+     */
+    double qd[MAX_JOINTS];
+    double qdd[MAX_JOINTS];
+
+    /**
+     * \brief Joint torques (drive units, as ActuatedJoint::setTorque()), 0 for joints updated by updateValue()
+     *
+     */
+    double tau[MAX_JOINTS];
+
+    /**
+     * \brief Status word of the drives, 0 for non-actuated joints
+     *
+     */
+    uint16_t status[MAX_JOINTS];
+
+    /**
+     * \brief State of the drives decoded from status[], CIA402_NOT_READY_TO_SWITCH_ON for non-actuated joints
+     *
+     */
+    CiA402State state[MAX_JOINTS];
+
+    /**
+     * \brief Conditions reported by the drives (DriveEvent flags)
+     *
+     */
+    uint16_t events[MAX_JOINTS];
+
+    /**
+     * \brief Conditions, which were not reported by the drives before the last update() (DriveEvent flags)
+     *
+     */
+    uint16_t newEvents[MAX_JOINTS];
+
+    /**
+     * \brief Conditions reported by any drive, and reported by any drive for the first time (DriveEvent flags)
+     *
+     */
+    uint16_t eventMask = 0;
+    uint16_t newEventMask = 0;
+
+    /**
+     * \brief Age of the drive feedback in SYNC cycles (see Drive::getFeedbackAge()), 0 for joints updated by updateValue()
+     *
+     */
+    uint32_t age[MAX_JOINTS];
+
+    /**
+     * \brief 1 if the joint was updated by the last update(), 0 if it kept its previous value
+     *
+     */
+    uint8_t valid[MAX_JOINTS];
+
+    /**
+     * \brief SYNC cycle (CO_SYNC_t::cycle) of the last update()
+     *
+     */
+    uint32_t cycle = 0;
+
+    /**
+     * \brief Time (CLOCK_MONOTONIC) of the last update()
+     *
+     */
+    timespec time = {0, 0};
+
+    /**
+     * \brief Construct an empty block
+     *
+     */
+    JointStateBlock();
+
+    /**
+     * \brief Set up the block for the given joints: finds the OD variables and conversion of each joint.
+     * Must be called again when the joints change.
+     *
+     * \param joints Joints of the robot, at most MAX_JOINTS
+     * \return true if all joints fit into the block
+     * \return false if there are too many joints, the block is then empty
+     */
+    bool build(const std::vector<Joint *> &joints);
+
+    /**
+     * \brief Update the state of all joints
+     *
+     * \return true if all joints were updated
+     * \return false if at least one joint kept its previous value
+     */
+    bool update();
+
+    /**
+     * \brief Set the velocity and acceleration estimator of all joints, restarting the estimates. The drive
+     * velocity is only available to joints converted by the block (see ActuatedJoint::getLinearConversion()).
+     *
+     */
+    void setEstimator(const JointEstimatorConfig &config);
+
+    /**
+     * \brief Set the clock of update() (default CLOCK_MONOTONIC), e.g. the simulated time of SimulatedDrive
+     *
+     */
+    void setClock(void (*clock)(timespec *time));
+
+   private:
+    /**
+     * \brief Joints of the block
+     *
+     */
+    Joint *joints[MAX_JOINTS];
+
+    /**
+     * \brief Each actuated joint with a drive, NULL for other joints
+     *
+     */
+    ActuatedJoint *actuated[MAX_JOINTS];
+
+    /**
+     * \brief 1 for the joints converted by the block, 0 for joints updated by updateValue()
+     *
+     */
+    uint8_t batched[MAX_JOINTS];
+
+    /**
+     * \brief OD variables read by update(), valid where batched[i] is 1
+     *
+     */
+    const int32_t *posSource[MAX_JOINTS];
+    const int32_t *velSource[MAX_JOINTS];
+    const int32_t *torSource[MAX_JOINTS];
+
+    /**
+     * \brief Linear conversion of each joint, q = (raw - posOffset) * posScale and qd = raw * velScale (posScale
+     * in the velocity unit of the drive, see Drive::getVelocityUnit())
+     *
+     */
+    double posScale[MAX_JOINTS];
+    double posOffset[MAX_JOINTS];
+    double velScale[MAX_JOINTS];
+
+    /**
+     * \brief Raw values of the last update(), in drive units
+     *
+     */
+    int32_t rawPos[MAX_JOINTS];
+    int32_t rawVel[MAX_JOINTS];
+    int32_t rawTor[MAX_JOINTS];
+
+    /**
+     * \brief Velocity and acceleration estimators, and their configuration
+     *
+     */
+    JointEstimator estimators[MAX_JOINTS];
+    JointEstimatorConfig estimatorConfig;
+
+    /**
+     * \brief 1 for the joints sampled on SYNC (feedback received by RPDO), 0 for joints sampled at update()
+     *
+     */
+    uint8_t syncSampled[MAX_JOINTS];
+
+    /**
+     * \brief SYNC cycle of the last sample of each joint, and its SYNC transmit time (CLOCK_MONOTONIC, ns), 0 if unknown
+     *
+     */
+    uint32_t sampleCycle[MAX_JOINTS];
+    int64_t sampleTime[MAX_JOINTS];
+
+    void (*clock)(timespec *time) = NULL;
+
+    /**
+     * \brief Time since the last sample of joint i, 0 if it has no new sample
+     *
+     */
+    double sampleInterval(int i, double updateInterval);
+};
+
+#endif
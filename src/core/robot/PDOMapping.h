@@ -0,0 +1,324 @@
+/**
+ * \file PDOMapping.h
+ * \author Justin Fong
+ * \brief Compile-time descriptions of the CiA 402 objects which can be mapped into PDOs and
+ * of the PDO layouts used by the drives.
+ *
+ * A <code>PDOMapping</code> is a type which describes one PDO (its number, transmission type and mapped
+ * objects). The compiler checks that all objects are known and that the mapping fits in a CAN frame.
+ * The same description is used to generate the SDO configuration sequence (see Drive::generateTPDOConfigSDO)
+ * and to pack or unpack the PDO data, as the drive does (see testPDO, which checks the PDOs of the master
+ * Object Dictionary against the drive layouts).
+ *
+ * \version 0.1
+ * \date 2020-07-01
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef PDOMAPPING_H_INCLUDED
+#define PDOMAPPING_H_INCLUDED
+#include <stdint.h>
+
+#include <vector>
+
+/**
+ * \brief Commonly-used Object Dictionary (OD) entries for CiA402 Drives
+ *
+ */
+enum OD_Entry_t {
+    STATUS_WORD = 0, /**< 0 */
+    ACTUAL_POS = 1,  /**< 1 */
+    ACTUAL_VEL = 2,  /**< 2 */
+    ACTUAL_TOR = 3,  /**< 3 */
+    TARGET_POS = 11, /**< 11 */
+    TARGET_VEL = 12, /**< 12 */
+    TARGET_TOR = 13, /**< 13 */
+    VEL_OFFSET = 14, /**< 14 */
+    TOR_OFFSET = 15, /**< 15 */
+    IP_DATA = 16,    /**< 16 */
+    IP_BUFFER_POS = 17 /**< 17 */
+};
+
+/**
+ * \brief Description of an OD entry which can be mapped into a PDO: its data type, index, subindex
+ * and length. Only the entries specialised below are known, any other entry fails to compile.
+ *
+ * \tparam Entry the OD entry
+ */
+template <OD_Entry_t Entry>
+struct ODEntry;
+
+template <>
+struct ODEntry<STATUS_WORD> {
+    typedef uint16_t type;
+    static constexpr uint16_t index = 0x6041;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<ACTUAL_POS> {
+    typedef int32_t type;
+    static constexpr uint16_t index = 0x6064;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<ACTUAL_VEL> {
+    typedef int32_t type;
+    static constexpr uint16_t index = 0x606C;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<ACTUAL_TOR> {
+    typedef int16_t type;
+    static constexpr uint16_t index = 0x6077;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<TARGET_POS> {
+    typedef int32_t type;
+    static constexpr uint16_t index = 0x607A;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<TARGET_VEL> {
+    typedef int32_t type;
+    static constexpr uint16_t index = 0x60FF;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<TARGET_TOR> {
+    typedef int16_t type;
+    static constexpr uint16_t index = 0x6071;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<VEL_OFFSET> {
+    typedef int32_t type;
+    static constexpr uint16_t index = 0x60B1;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<TOR_OFFSET> {
+    typedef int16_t type;
+    static constexpr uint16_t index = 0x60B2;
+    static constexpr uint8_t subIndex = 0;
+};
+template <>
+struct ODEntry<IP_DATA> {
+    typedef int32_t type;
+    static constexpr uint16_t index = 0x60C1;
+    static constexpr uint8_t subIndex = 1;
+};
+template <>
+struct ODEntry<IP_BUFFER_POS> {
+    typedef uint16_t type;
+    static constexpr uint16_t index = 0x60C4;
+    static constexpr uint8_t subIndex = 4;
+};
+
+/**
+ * \brief PDO mapping parameter (index, subindex and length in bits) of a known OD entry, as written to 0x1600/0x1A00
+ *
+ * \tparam Entry the OD entry
+ */
+template <OD_Entry_t Entry>
+struct ODEntryParameter {
+    static constexpr uint32_t value = ((uint32_t)ODEntry<Entry>::index << 16) |
+                                      ((uint32_t)ODEntry<Entry>::subIndex << 8) |
+                                      (8 * sizeof(typename ODEntry<Entry>::type));
+};
+
+/**
+ * \brief PDO mapping parameter of an OD entry known at run time only
+ *
+ * \param entry the OD entry
+ * \return uint32_t the mapping parameter, e.g. 0x60410010 for STATUS_WORD
+ */
+constexpr uint32_t ODEntryMappingParameter(OD_Entry_t entry) {
+    return entry == STATUS_WORD ? ODEntryParameter<STATUS_WORD>::value
+         : entry == ACTUAL_POS  ? ODEntryParameter<ACTUAL_POS>::value
+         : entry == ACTUAL_VEL  ? ODEntryParameter<ACTUAL_VEL>::value
+         : entry == ACTUAL_TOR  ? ODEntryParameter<ACTUAL_TOR>::value
+         : entry == TARGET_POS  ? ODEntryParameter<TARGET_POS>::value
+         : entry == TARGET_VEL  ? ODEntryParameter<TARGET_VEL>::value
+         : entry == TARGET_TOR  ? ODEntryParameter<TARGET_TOR>::value
+         : entry == VEL_OFFSET  ? ODEntryParameter<VEL_OFFSET>::value
+         : entry == TOR_OFFSET  ? ODEntryParameter<TOR_OFFSET>::value
+         : entry == IP_DATA     ? ODEntryParameter<IP_DATA>::value
+         : entry == IP_BUFFER_POS ? ODEntryParameter<IP_BUFFER_POS>::value
+                                : 0;
+}
+static_assert(ODEntryMappingParameter(STATUS_WORD) == 0x60410010, "Unexpected STATUS_WORD mapping");
+static_assert(ODEntryMappingParameter(TARGET_TOR) == 0x60710010, "Unexpected TARGET_TOR mapping");
+static_assert(ODEntryMappingParameter(TOR_OFFSET) == 0x60B20010, "Unexpected TOR_OFFSET mapping");
+static_assert(ODEntryMappingParameter(IP_DATA) == 0x60C10120, "Unexpected IP_DATA mapping");
+static_assert(ODEntryMappingParameter(IP_BUFFER_POS) == 0x60C40410, "Unexpected IP_BUFFER_POS mapping");
+
+/**
+ * \brief Sum of the lengths (in bits) of a list of OD entries
+ */
+template <OD_Entry_t... Entries>
+struct ODEntriesBits;
+
+template <>
+struct ODEntriesBits<> {
+    static constexpr int value = 0;
+};
+template <OD_Entry_t First, OD_Entry_t... Rest>
+struct ODEntriesBits<First, Rest...> {
+    static constexpr int value = 8 * sizeof(typename ODEntry<First>::type) + ODEntriesBits<Rest...>::value;
+};
+
+/**
+ * \brief Compile-time description of one PDO
+ *
+ * \tparam Num The number of the PDO (1 for the first PDO, i.e. 0x1400/0x1800)
+ * \tparam Transmission The PDO transmission type (0-240 synchronous, 0xFF event driven)
+ * \tparam Entries The mapped OD entries, in order
+ */
+template <int Num, int Transmission, OD_Entry_t... Entries>
+struct PDOMapping {
+    static_assert(Num >= 1 && Num <= 512, "PDO number must be 1-512");
+    static_assert(Transmission >= 0 && Transmission <= 0xFF, "PDO transmission type must be 0-255");
+    static_assert(sizeof...(Entries) > 0, "PDO must map at least one OD entry");
+
+    /** Number of the PDO */
+    static constexpr int number = Num;
+    /** Transmission type of the PDO */
+    static constexpr int transmission = Transmission;
+    /** Total length of the mapped data in bits */
+    static constexpr int bits = ODEntriesBits<Entries...>::value;
+    /** Total length of the mapped data in bytes (CAN frame DLC) */
+    static constexpr int size = bits / 8;
+    static_assert(bits <= 64, "PDO mapping exceeds 64 bits");
+
+    /**
+     * \brief The mapped OD entries, in order (used for generating SDO configuration commands)
+     */
+    static std::vector<OD_Entry_t> entries() {
+        return std::vector<OD_Entry_t>{Entries...};
+    }
+
+    /**
+     * \brief Pack values into PDO data (little endian, as transmitted on the CAN bus)
+     *
+     * \param data PDO data, at least <code>size</code> bytes
+     * \param values One value per mapped entry, in mapping order
+     */
+    static void pack(uint8_t *data, typename ODEntry<Entries>::type... values) {
+        int offset = 0;
+        int expand[] = {0, (packValue(data, offset, values), 0)...};
+        (void)expand;
+    }
+
+    /**
+     * \brief Unpack PDO data into values
+     *
+     * \param data PDO data, at least <code>size</code> bytes
+     * \param values One reference per mapped entry, in mapping order
+     */
+    static void unpack(const uint8_t *data, typename ODEntry<Entries>::type &... values) {
+        int offset = 0;
+        int expand[] = {0, (unpackValue(data, offset, values), 0)...};
+        (void)expand;
+    }
+
+   private:
+    template <typename T>
+    static void packValue(uint8_t *data, int &offset, T value) {
+        for (unsigned int i = 0; i < sizeof(T); i++) {
+            data[offset + i] = (uint8_t)((uint64_t)value >> (8 * i));
+        }
+        offset += sizeof(T);
+    }
+
+    template <typename T>
+    static void unpackValue(const uint8_t *data, int &offset, T &value) {
+        uint64_t v = 0;
+        for (unsigned int i = 0; i < sizeof(T); i++) {
+            v |= (uint64_t)data[offset + i] << (8 * i);
+        }
+        value = (T)v;
+        offset += sizeof(T);
+    }
+};
+
+/**
+ * \brief Compile-time list of PDOMapping, configured one after the other (see Drive::generateRPDOConfigSDO)
+ *
+ * \tparam Mappings The PDOMapping of each PDO, in configuration order
+ */
+template <class... Mappings>
+struct PDOList;
+
+template <>
+struct PDOList<> {
+    /** Number of PDOs */
+    static constexpr int size = 0;
+    /** Largest PDO number of the list, 0 if empty */
+    static constexpr int maxNumber = 0;
+    /** Check whether the list has the PDO number */
+    static constexpr bool has(int) { return false; }
+    /** Check whether every PDO number of the list is in List */
+    template <class List>
+    static constexpr bool coveredBy() { return true; }
+};
+template <class First, class... Rest>
+struct PDOList<First, Rest...> {
+    static constexpr int size = 1 + sizeof...(Rest);
+    static constexpr int maxNumber = First::number > PDOList<Rest...>::maxNumber ? First::number : PDOList<Rest...>::maxNumber;
+    static constexpr bool has(int number) { return First::number == number || PDOList<Rest...>::has(number); }
+    template <class List>
+    static constexpr bool coveredBy() { return List::has(First::number) && PDOList<Rest...>::template coveredBy<List>(); }
+};
+
+/**
+ * \brief Standard CiA 402 PDO layout, configured by Drive::initPDOs
+ *
+ * Besides the PDOs, a layout lists the PDOs configured for each control mode (see CiA402Drive): the
+ * standard PDOs, the target RPDOs of the profile modes, the RPDOs remapped by the cyclic
+ * synchronous and interpolated position modes, and the TPDOs of interpolated position mode.
+ *
+ */
+struct CiA402PDOLayout {
+    /** TPDO1: COB-ID 180+{NODE-ID}, Status Word, sent on internal event */
+    typedef PDOMapping<1, 0xFF, STATUS_WORD> TPDO1;
+    /** TPDO2: COB-ID 280+{NODE-ID}, Actual Position and Velocity, sent every SYNC */
+    typedef PDOMapping<2, 1, ACTUAL_POS, ACTUAL_VEL> TPDO2;
+    /** TPDO3: COB-ID 380+{NODE-ID}, Actual Torque, sent every SYNC */
+    typedef PDOMapping<3, 1, ACTUAL_TOR> TPDO3;
+    /** TPDO4 in interpolated position mode: COB-ID 480+{NODE-ID}, Buffer Position (points in the drive buffer), sent every SYNC */
+    typedef PDOMapping<4, 1, IP_BUFFER_POS> TPDO4IP;
+    /** RPDO3: COB-ID 300+{NODE-ID}, Target Position, applied immediately */
+    typedef PDOMapping<3, 0xFF, TARGET_POS> RPDO3;
+    /** RPDO3 in cyclic synchronous position mode: Target Position, applied at the next SYNC */
+    typedef PDOMapping<3, 1, TARGET_POS> RPDO3CSP;
+    /** RPDO3 in interpolated position mode: Interpolation Data Record, added to the drive buffer when received */
+    typedef PDOMapping<3, 0xFF, IP_DATA> RPDO3IP;
+    /** RPDO4: COB-ID 400+{NODE-ID}, Target Velocity, applied immediately */
+    typedef PDOMapping<4, 0xFF, TARGET_VEL> RPDO4;
+    /** RPDO4 in cyclic synchronous position mode: Velocity Offset (feedforward), applied at the next SYNC */
+    typedef PDOMapping<4, 1, VEL_OFFSET> RPDO4CSP;
+    /** RPDO4 in cyclic synchronous velocity mode: Target Velocity, applied at the next SYNC */
+    typedef PDOMapping<4, 1, TARGET_VEL> RPDO4CSV;
+    /** RPDO5: COB-ID 500+{NODE-ID}, Target Torque, applied immediately */
+    typedef PDOMapping<5, 0xFF, TARGET_TOR> RPDO5;
+    /** RPDO5 in cyclic synchronous position and velocity modes: Torque Offset (feedforward), applied at the next SYNC */
+    typedef PDOMapping<5, 1, TOR_OFFSET> RPDO5CSP;
+    /** RPDO5 in cyclic synchronous torque mode: Target Torque, applied at the next SYNC */
+    typedef PDOMapping<5, 1, TARGET_TOR> RPDO5CST;
+
+    /** PDOs configured by initPDOs() */
+    typedef PDOList<TPDO1, TPDO2, TPDO3> TPDOs;
+    typedef PDOList<RPDO3, RPDO4, RPDO5> RPDOs;
+    /** Target RPDOs of the profile modes, configured back when a drive leaves a synchronous mode */
+    typedef PDOList<RPDO3, RPDO4, RPDO5> ProfileRPDOs;
+    /** RPDOs of the cyclic synchronous and interpolated position modes */
+    typedef PDOList<RPDO3CSP, RPDO4CSP, RPDO5CSP> CSPRPDOs;
+    typedef PDOList<RPDO4CSV, RPDO5CSP> CSVRPDOs;
+    typedef PDOList<RPDO5CST> CSTRPDOs;
+    typedef PDOList<RPDO3IP> IPRPDOs;
+    /** TPDOs of interpolated position mode, disabled when the drive leaves it */
+    typedef PDOList<TPDO4IP> IPTPDOs;
+};
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * \file PlanarChain.h
+ * \author William Campbell
+ * \brief Rigid body dynamics of a serial chain of N revolute joints moving in a vertical plane,
+ * from a fixed base, with fixed-size Eigen types: no allocation, sized at compile time.
+ *
+ * Angles are in radians. The absolute angle of link i is the base angle plus the joint angles up
+ * to i, measured from the downward vertical, positive towards +x (x forward, y up, gravity -y).
+ * Link i starts at joint i and ends at joint i + 1, its centre of mass lies on its axis.
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef PLANARCHAIN_H_INCLUDED
+#define PLANARCHAIN_H_INCLUDED
+#include <Eigen>
+#include <cmath>
+
+/**
+ * \brief Parameters of a link of a PlanarChain, SI units
+ *
+ */
+struct PlanarLink {
+    double length = 0;  /**< distance from its joint to the next joint */
+    double com = 0;     /**< distance from its joint to its centre of mass */
+    double mass = 0;    /**< mass */
+    double inertia = 0; /**< moment of inertia about its centre of mass */
+};
+
+/**
+ * \brief Serial chain of N links in a vertical plane (see PlanarChain.h)
+ *
+ * \tparam N number of joints
+ */
+template <int N>
+class PlanarChain {
+   public:
+    typedef Eigen::Matrix<double, N, 1> Vector;
+
+    PlanarLink links[N];
+
+    /**
+     * \brief Gravitational acceleration (m/s^2)
+     *
+     */
+    double g = 9.81;
+
+    /**
+     * \brief Joint torques for the given motion (recursive Newton-Euler): gravity, inertia, Coriolis and
+     * centrifugal torques, as needed by the joints to follow it
+     *
+     * \param q, qd, qdd Joint angles, velocities and accelerations
+     * \param tau Joint torques (Nm), positive towards increasing angle
+     * \param baseAngle Angle of the base from the downward vertical
+     */
+    void inverseDynamics(const Vector &q, const Vector &qd, const Vector &qdd, Vector &tau, double baseAngle = 0) const {
+        Eigen::Vector2d u[N], n[N], acc[N];
+        double alpha[N];
+        // outwards: link accelerations, with the base accelerating upwards by g for gravity
+        Eigen::Vector2d a(0, g);
+        double phi = baseAngle, omega = 0, dOmega = 0;
+        for (int i = 0; i < N; i++) {
+            phi += q[i];
+            omega += qd[i];
+            dOmega += qdd[i];
+            double s = std::sin(phi), c = std::cos(phi);
+            u[i] << s, -c;
+            n[i] << c, s;
+            alpha[i] = dOmega;
+            Eigen::Vector2d tangential = dOmega * n[i] - omega * omega * u[i];
+            acc[i] = a + links[i].com * tangential;
+            a += links[i].length * tangential;
+        }
+        // inwards: forces and moments about each joint
+        Eigen::Vector2d force(0, 0);
+        double moment = 0;
+        for (int i = N - 1; i >= 0; i--) {
+            Eigen::Vector2d inertial = links[i].mass * acc[i];
+            moment += links[i].inertia * alpha[i] + cross(links[i].com * u[i], inertial) + cross(links[i].length * u[i], force);
+            force += inertial;
+            tau[i] = moment;
+        }
+    }
+
+    /**
+     * \brief Joint torques holding the chain still against gravity
+     *
+     * \param q Joint angles
+     * \param tau Joint torques (Nm), positive towards increasing angle
+     * \param baseAngle Angle of the base from the downward vertical
+     */
+    void gravityTorques(const Vector &q, Vector &tau, double baseAngle = 0) const {
+        // horizontal position of each joint and centre of mass, the moment of a weight is m g dx
+        double x[N], xc[N];
+        double phi = baseAngle, px = 0;
+        for (int i = 0; i < N; i++) {
+            phi += q[i];
+            double s = std::sin(phi);
+            x[i] = px;
+            xc[i] = px + links[i].com * s;
+            px += links[i].length * s;
+        }
+        double mass = 0, massX = 0;
+        for (int i = N - 1; i >= 0; i--) {
+            mass += links[i].mass;
+            massX += links[i].mass * xc[i];
+            tau[i] = g * (massX - mass * x[i]);
+        }
+    }
+
+   private:
+    static double cross(const Eigen::Vector2d &a, const Eigen::Vector2d &b) {
+        return a.x() * b.y() - a.y() * b.x();
+    }
+};
+
+#endif
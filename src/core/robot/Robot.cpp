@@ -38,12 +38,36 @@ bool Robot::initialise() {
 }
 
 void Robot::updateRobot() {
-    for (auto joint : joints)
-        joint->updateValue();
+    if (jointStates.n != (int)joints.size()) {
+        if (!jointStates.build(joints)) {
+            // too many joints for the block, update each joint on its own
+            feedbackValid = true;
+            for (auto joint : joints)
+                feedbackValid &= joint->updateValue();
+            return;
+        }
+    }
+    feedbackValid = jointStates.update();
     // for (auto input : inputs)
     //     input->updateInput();
 }
 
+bool Robot::isFeedbackValid() {
+    return feedbackValid;
+}
+
+const JointStateBlock &Robot::getJointStateBlock() {
+    return jointStates;
+}
+
+uint16_t Robot::getDriveEvents() {
+    return jointStates.eventMask;
+}
+
+void Robot::setJointEstimator(const JointEstimatorConfig &config) {
+    jointStates.setEstimator(config);
+}
+
 void Robot::printStatus() {
     std::cout << "Robot Joint Angles: ";
     for (auto joint : joints)
@@ -25,6 +25,7 @@
 
 #include "InputDevice.h"
 #include "Joint.h"
+#include "JointStateBlock.h"
 using namespace std;
 
 /**
@@ -45,6 +46,18 @@ class Robot {
 
     vector<InputDevice*> inputs;
 
+    /**
+ * \brief True if all joints were updated by the last updateRobot()
+ * 
+ */
+    bool feedbackValid = true;
+
+    /**
+ * \brief State of all joints, updated by updateRobot(). Built again when the number of joints changes.
+ * 
+ */
+    JointStateBlock jointStates;
+
    public:
     //Setup
     /**
@@ -93,11 +106,38 @@ class Robot {
     //Core  functions
     /**
     * \brief Update all of this <code>Robot<code> software joint positions 
-    * from object dictionary entries.
+    * from object dictionary entries, in one pass over the joints (see JointStateBlock).
     * 
     */
     virtual void updateRobot();
     /**
+    * \brief Check whether all joints were updated by the last updateRobot(). A joint is not
+    * updated if its feedback is stale (see ActuatedJoint::setMaxFeedbackAge()).
+    * 
+    * \return true if all joints were updated
+    * \return false if at least one joint kept its previous value
+    */
+    bool isFeedbackValid();
+    /**
+    * \brief Get the state of all joints from the last updateRobot(), in contiguous arrays
+    * (index i is the i-th joint of the robot)
+    * 
+    * \return const JointStateBlock& the joint positions, estimated velocities and accelerations, torques, status words and feedback ages
+    */
+    const JointStateBlock &getJointStateBlock();
+    /**
+    * \brief Get the conditions reported by the drives at the last updateRobot() (see CiA402.h)
+    * 
+    * \return uint16_t DriveEvent flags reported by any drive, e.g. DRIVE_EVENT_FAULT
+    */
+    uint16_t getDriveEvents();
+    /**
+    * \brief Set the velocity and acceleration estimator of all joints (see JointEstimator), restarting the estimates
+    * 
+    * \param config Estimator and its parameters
+    */
+    void setJointEstimator(const JointEstimatorConfig &config);
+    /**
  * \brief print out status of robot and all of its joints
  * 
  */
@@ -0,0 +1,168 @@
+/**
+ * @file RobotDescription.cpp
+ * @author William Campbell
+ * @brief Description of the joints and drives of a robot, see RobotDescription.h
+ * @version 0.1
+ * @date 2020-10-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "RobotDescription.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "DebugMacro.h"
+
+bool RobotDescription::load(const std::string &fileName) {
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        return false;
+    }
+    return parse(file, fileName);
+}
+
+bool RobotDescription::parse(std::istream &input, const std::string &source) {
+    std::vector<JointDescription> newJoints;
+    std::string line, error;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword)) {
+            continue;
+        }
+        JointDescription joint;
+        if (keyword != "joint") {
+            error = "unknown keyword \"" + keyword + "\"";
+        } else if (parseJoint(line.substr(line.find(keyword) + keyword.size()), newJoints.size(), joint, error)) {
+            for (auto &other : newJoints) {
+                if (other.id == joint.id) {
+                    error = "joint " + std::to_string(joint.id) + " described twice";
+                } else if (other.nodeID == joint.nodeID && other.bus == joint.bus) {
+                    error = "node " + std::to_string(joint.nodeID) + " used by joints " + std::to_string(other.id) + " and " + std::to_string(joint.id);
+                }
+            }
+            if (error.empty() && joint.id != (int)newJoints.size()) {
+                // the robot indexes its joints, and the joints of its trajectories, by ID
+                error = "joint " + std::to_string(joint.id) + " out of order, joint " + std::to_string(newJoints.size()) + " expected";
+            }
+        }
+        if (!error.empty()) {
+            DEBUG_OUT("Robot description " << source << ":" << lineNumber << ": " << error)
+            return false;
+        }
+        newJoints.push_back(joint);
+    }
+    if (newJoints.empty()) {
+        DEBUG_OUT("Robot description " << source << ": no joints")
+        return false;
+    }
+    joints = newJoints;
+    return true;
+}
+
+bool RobotDescription::parseJoint(const std::string &line, int index, JointDescription &joint, std::string &error) {
+    std::istringstream fields(line);
+    std::string field;
+    bool hasMin = false, hasMax = false, hasKnown = false;
+    joint.id = index;
+    while (fields >> field) {
+        size_t equal = field.find('=');
+        if (equal == std::string::npos) {
+            error = "expected key=value, got \"" + field + "\"";
+            return false;
+        }
+        std::string key = field.substr(0, equal);
+        std::istringstream value(field.substr(equal + 1));
+        bool ok = true;
+        if (key == "id") {
+            ok = (bool)(value >> joint.id);
+        } else if (key == "name") {
+            ok = (bool)(value >> joint.name);
+        } else if (key == "drive") {
+            ok = (bool)(value >> joint.driveType);
+        } else if (key == "node") {
+            ok = (bool)(value >> joint.nodeID);
+        } else if (key == "bus") {
+            ok = (bool)(value >> joint.bus);
+        } else if (key == "min") {
+            ok = hasMin = (bool)(value >> joint.min);
+        } else if (key == "max") {
+            ok = hasMax = (bool)(value >> joint.max);
+        } else if (key == "known") {
+            char colon1, comma, colon2;
+            ok = hasKnown = (value >> joint.driveA >> colon1 >> joint.jointA >> comma >> joint.driveB >> colon2 >> joint.jointB) &&
+                            colon1 == ':' && comma == ',' && colon2 == ':';
+        } else if (key == "calibration") {
+            ok = (bool)(value >> joint.calibrationFile);
+        } else if (key == "setpoints") {
+            std::string setpoints;
+            ok = (value >> setpoints) && (setpoints == "mux" || setpoints == "pdo");
+            joint.multiplexedSetpoints = setpoints == "mux";
+        } else if (key == "maxAge") {
+            ok = (bool)(value >> joint.maxFeedbackAge);
+        } else if (key == "torque") {
+            ok = (bool)(value >> joint.torqueScale);
+        } else if (key == "maxError") {
+            ok = (bool)(value >> joint.maxTrackingError);
+        } else if (key == "maxRms") {
+            ok = (bool)(value >> joint.maxTrackingRms);
+        } else if (key == "homing") {
+            std::string homing = value.str();
+            if (homing == "none") {
+                joint.homing.clear();
+                value.str(std::string());
+            } else if (homing.compare(0, 9, "hardstop:") == 0) {
+                joint.homing = "hardstop";
+                value.str(homing.substr(9));
+                ok = (value >> joint.homingVelocity) && joint.homingVelocity != 0;
+            } else {
+                joint.homing = "cia402";
+                ok = (value >> joint.homingMethod) && joint.homingMethod >= -128 && joint.homingMethod <= 127;
+            }
+        } else if (key == "homeOffset") {
+            ok = (bool)(value >> joint.homeOffset);
+        } else if (key == "home") {
+            ok = joint.hasHome = (bool)(value >> joint.home);
+        } else {
+            error = "unknown key \"" + key + "\"";
+            return false;
+        }
+        std::string rest;
+        if (!ok || (value >> rest)) {
+            error = "invalid value of \"" + key + "\"";
+            return false;
+        }
+    }
+
+    if (joint.nodeID < 0) {
+        joint.nodeID = joint.id + 1;
+    }
+    if (joint.id < 0) {
+        error = "invalid joint ID";
+    } else if (joint.driveType.empty()) {
+        error = "joint " + std::to_string(joint.id) + ": no drive type";
+    } else if (joint.nodeID < 1 || joint.nodeID > 127) {
+        error = "joint " + std::to_string(joint.id) + ": node ID out of 1..127";
+    } else if (!hasMin || !hasMax || !(joint.min < joint.max)) {
+        error = "joint " + std::to_string(joint.id) + ": min and max needed, min < max";
+    } else if (!hasKnown || joint.driveA == joint.driveB || joint.jointA == joint.jointB) {
+        error = "joint " + std::to_string(joint.id) + ": two distinct known positions needed";
+    } else if (joint.homing == "hardstop" && !joint.hasHome) {
+        error = "joint " + std::to_string(joint.id) + ": home needed for hardstop homing";
+    }
+    return error.empty();
+}
+
+const JointDescription *RobotDescription::getJoint(int id) const {
+    for (auto &joint : joints) {
+        if (joint.id == id) {
+            return &joint;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,111 @@
+/**
+ * \file RobotDescription.h
+ * \author William Campbell
+ * \brief Description of the joints and drives of a robot, loaded once at startup from a text file,
+ * from which the robot builds its joints and drives instead of hard-coding them.
+ *
+ * One joint per line, as key=value fields, '#' starts a comment:
+ *
+ *     joint id=0 name=left_hip drive=copley node=1 min=70 max=210 known=250880:90,0:180
+ *
+ * - id: joint ID, the index of the line (default), name: for logging
+ * - drive: drive type, as understood by the robot (e.g. copley, schneider, simulated)
+ * - node: CANopen node ID of the drive (default id + 1), bus: CAN interface index (default 0)
+ * - min, max: joint limits, joint units
+ * - known: two known positions, drive counts:joint value, for the linear conversion of the joint
+ * - calibration: optional calibration table (see JointCalibration::loadTable())
+ * - setpoints: mux (default) to send the target position in the multiplexed setpoint frames when the
+ *   drive supports it, pdo to keep the per node Target Position PDO
+ * - maxAge: maximum feedback age in SYNC cycles (see ActuatedJoint::setMaxFeedbackAge()), -1 (default) for the robot default
+ * - torque: drive torque units per Nm of joint torque, for torque feedforward (the motions from standing up to sitting
+ *   down are then in cyclic synchronous position control), 0 (default) for none
+ * - maxError, maxRms: limits of the following error of the joint over a motion, joint units (see TrackingMonitor),
+ *   0 for none, -1 (default) for the robot default
+ * - homing: in-process homing of the drive (see HomingEngine), none (default), a CiA 402 homing method (e.g. 35
+ *   for the current position), or hardstop:velocity to move at velocity (drive units/s) until the joint stalls
+ * - homeOffset: home offset of a CiA 402 homing method, drive counts: the drive position at home (default 0)
+ * - home: joint value at the home position. The calibration of the joint is shifted to it once homed, needed
+ *   for hardstop; a CiA 402 method sets the drive position to homeOffset, for which known may already account
+ *
+ * The PDO layout of a drive follows from its type (e.g. CiA402PDOLayout or SchneiderPDOLayout).
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef ROBOTDESCRIPTION_H_INCLUDED
+#define ROBOTDESCRIPTION_H_INCLUDED
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Description of one joint and its drive
+ *
+ */
+struct JointDescription {
+    int id = -1;
+    std::string name;
+    std::string driveType;
+    int nodeID = -1;
+    int bus = 0;
+    double min = 0;
+    double max = 0;
+    /** Known positions: drive counts and joint values */
+    double driveA = 0, jointA = 0, driveB = 1, jointB = 1;
+    std::string calibrationFile;
+    bool multiplexedSetpoints = true;
+    int maxFeedbackAge = -1;
+    double torqueScale = 0;
+    double maxTrackingError = -1, maxTrackingRms = -1;
+    /** Homing: "" for none, "cia402" (homingMethod) or "hardstop" (homingVelocity) */
+    std::string homing;
+    int homingMethod = 0;
+    int homingVelocity = 0;
+    int homeOffset = 0;
+    bool hasHome = false;
+    double home = 0;
+};
+
+/**
+ * \brief Description of the joints and drives of a robot (see RobotDescription.h for the format)
+ *
+ */
+class RobotDescription {
+   public:
+    /**
+     * \brief Joints of the robot, in the order of the file, which is the order of their IDs: joints[i].id == i
+     *
+     */
+    std::vector<JointDescription> joints;
+
+    /**
+     * \brief Load the description from a file, replacing the current one
+     *
+     * \param fileName File to read
+     * \return true if the file exists and is valid, the description is unchanged otherwise
+     */
+    bool load(const std::string &fileName);
+
+    /**
+     * \brief Parse a description, replacing the current one
+     *
+     * \param input Description text
+     * \param source Name of the source, for the error messages
+     * \return true if valid, the description is unchanged otherwise
+     */
+    bool parse(std::istream &input, const std::string &source);
+
+    /**
+     * \brief Find the description of a joint
+     *
+     * \param id Joint ID
+     * \return const JointDescription* the description, NULL if there is no such joint
+     */
+    const JointDescription *getJoint(int id) const;
+
+   private:
+    static bool parseJoint(const std::string &line, int index, JointDescription &joint, std::string &error);
+};
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file TrackingMonitor.cpp
+ * @author William Campbell
+ * @brief Following error monitor of the joints, see TrackingMonitor.h
+ * @version 0.1
+ * @date 2020-10-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "TrackingMonitor.h"
+
+#include <cmath>
+
+TrackingMonitor::TrackingMonitor() {
+    start(0);
+    running = false;
+}
+
+void TrackingMonitor::setLimits(int joint, const TrackingLimits &jointLimits) {
+    if (joint >= 0 && joint < JointStateBlock::MAX_JOINTS) {
+        limits[joint] = jointLimits;
+    }
+}
+
+void TrackingMonitor::start(int n) {
+    summary.n = n < JointStateBlock::MAX_JOINTS ? n : JointStateBlock::MAX_JOINTS;
+    for (int i = 0; i < JointStateBlock::MAX_JOINTS; i++) {
+        summary.samples[i] = 0;
+        summary.rms[i] = 0;
+        summary.max[i] = 0;
+        summary.last[i] = 0;
+        sumSquares[i] = 0;
+    }
+    summary.exceededJoint = -1;
+    summary.exceededRms = false;
+    running = true;
+}
+
+bool TrackingMonitor::update(const double *commanded, const double *actual, const uint8_t *valid) {
+    if (!running) {
+        return !isExceeded();
+    }
+    for (int i = 0; i < summary.n; i++) {
+        if (valid != NULL && !valid[i]) {
+            continue;
+        }
+        double error = commanded[i] - actual[i];
+        uint32_t samples = ++summary.samples[i];
+        sumSquares[i] += error * error;
+        summary.rms[i] = std::sqrt(sumSquares[i] / samples);
+        summary.last[i] = error;
+        if (std::fabs(error) > summary.max[i]) {
+            summary.max[i] = std::fabs(error);
+        }
+        if (summary.exceededJoint >= 0) {
+            continue;
+        }
+        if (limits[i].maxError > 0 && std::fabs(error) > limits[i].maxError) {
+            summary.exceededJoint = i;
+            summary.exceededRms = false;
+        } else if (limits[i].maxRms > 0 && samples >= minSamples && summary.rms[i] > limits[i].maxRms) {
+            summary.exceededJoint = i;
+            summary.exceededRms = true;
+        }
+    }
+    return !isExceeded();
+}
+
+const TrackingSummary &TrackingMonitor::finish() {
+    running = false;
+    return summary;
+}
+
+bool TrackingMonitor::isRunning() const {
+    return running;
+}
+
+bool TrackingMonitor::isExceeded() const {
+    return summary.exceededJoint >= 0;
+}
+
+const TrackingSummary &TrackingMonitor::getSummary() {
+    return summary;
+}
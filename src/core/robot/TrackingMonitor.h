@@ -0,0 +1,135 @@
+/**
+ * \file TrackingMonitor.h
+ * \author William Campbell
+ * \brief Monitor of the following error of all joints during a motion: commanded minus actual position
+ * of every joint each control cycle, with its running RMS and maximum over the motion.
+ *
+ * Each joint has two limits, in joint units: the largest error of a single sample and the RMS error of
+ * the motion, checked once the motion has minSamples samples (the error is large at the start of a
+ * motion, the drives lag the first set points). Once a limit is exceeded, the monitor stays exceeded
+ * until the next start().
+ *
+ * The state has fixed size, update() does not allocate.
+ * \code
+ *  monitor.start(n);
+ *  // every cycle
+ *  if (!monitor.update(commanded, block.q, block.valid))
+ *      // limit exceeded by monitor.getSummary().exceededJoint
+ *  // end of the motion
+ *  const TrackingSummary &summary = monitor.finish();
+ * \endcode
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef TRACKINGMONITOR_H_INCLUDED
+#define TRACKINGMONITOR_H_INCLUDED
+#include <stdint.h>
+
+#include "JointStateBlock.h"
+
+/**
+ * \brief Limits of the following error of a joint (joint units), 0 for no limit
+ *
+ */
+struct TrackingLimits {
+    double maxError = 0;
+    double maxRms = 0;
+};
+
+/**
+ * \brief Following error of the joints over a motion (joint units)
+ *
+ */
+struct TrackingSummary {
+    /** Number of joints */
+    int n = 0;
+    /** Number of samples, per joint: samples with invalid feedback are not counted */
+    uint32_t samples[JointStateBlock::MAX_JOINTS];
+    /** RMS and largest absolute error, and the error of the last sample */
+    double rms[JointStateBlock::MAX_JOINTS];
+    double max[JointStateBlock::MAX_JOINTS];
+    double last[JointStateBlock::MAX_JOINTS];
+    /** Joint, whose limit was exceeded first, -1 if none */
+    int exceededJoint = -1;
+    /** Limit exceeded: the maximum error (false) or the RMS error (true) */
+    bool exceededRms = false;
+};
+
+/**
+ * \brief Following error monitor of the joints of a robot (see TrackingMonitor.h)
+ *
+ */
+class TrackingMonitor {
+   public:
+    /**
+     * \brief Samples of a motion before its RMS error is checked
+     *
+     */
+    uint32_t minSamples = 25;
+
+    /**
+     * \brief Construct a monitor without limits
+     *
+     */
+    TrackingMonitor();
+
+    /**
+     * \brief Set the limits of a joint
+     *
+     * \param joint Index of the joint, 0..JointStateBlock::MAX_JOINTS - 1
+     */
+    void setLimits(int joint, const TrackingLimits &limits);
+
+    /**
+     * \brief Start a motion, clearing the errors and the exceeded limit
+     *
+     * \param n Number of joints, at most JointStateBlock::MAX_JOINTS
+     */
+    void start(int n);
+
+    /**
+     * \brief Add the error of one cycle
+     *
+     * \param commanded Commanded joint positions
+     * \param actual Actual joint positions
+     * \param valid 1 for the joints whose actual position is up to date (see JointStateBlock::valid), NULL for all
+     * \return true if no limit is exceeded
+     */
+    bool update(const double *commanded, const double *actual, const uint8_t *valid = NULL);
+
+    /**
+     * \brief End the motion
+     *
+     * \return const TrackingSummary& the errors of the motion
+     */
+    const TrackingSummary &finish();
+
+    /**
+     * \brief Check whether a motion is started and not finished
+     *
+     */
+    bool isRunning() const;
+
+    /**
+     * \brief Check whether a limit was exceeded since start()
+     *
+     */
+    bool isExceeded() const;
+
+    /**
+     * \brief Get the errors of the current, or last, motion
+     *
+     */
+    const TrackingSummary &getSummary();
+
+   private:
+    TrackingLimits limits[JointStateBlock::MAX_JOINTS];
+    /** Sum of the squared errors of the motion */
+    double sumSquares[JointStateBlock::MAX_JOINTS];
+    TrackingSummary summary;
+    bool running = false;
+};
+
+#endif
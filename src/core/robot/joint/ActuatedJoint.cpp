@@ -11,6 +11,8 @@
 
 #include "ActuatedJoint.h"
 
+#include <cmath>
+
 #include "DebugMacro.h"
 
 ActuatedJoint::ActuatedJoint(int jointID, double jointMin, double jointMax, Drive *drive) : Joint(jointID, jointMin, jointMax) {
@@ -23,6 +25,27 @@ ControlMode ActuatedJoint::setMode(ControlMode driveMode_, motorProfile profile)
             driveMode = driveMode_;
             return POSITION_CONTROL;
         }
+    } else if (driveMode_ == CSP_CONTROL) {
+        int window = toDriveUnits(followingErrorWindow) - toDriveUnits(0);
+        if (drive->initCSPControl(window < 0 ? -window : window)) {
+            driveMode = driveMode_;
+            return CSP_CONTROL;
+        }
+    } else if (driveMode_ == CSV_CONTROL) {
+        if (drive->initCSVControl()) {
+            driveMode = driveMode_;
+            return CSV_CONTROL;
+        }
+    } else if (driveMode_ == CST_CONTROL) {
+        if (drive->initCSTControl()) {
+            driveMode = driveMode_;
+            return CST_CONTROL;
+        }
+    } else if (driveMode_ == IP_CONTROL) {
+        if (drive->initIPControl(ipBufferSize)) {
+            driveMode = driveMode_;
+            return IP_CONTROL;
+        }
     } else if (driveMode_ == VELOCITY_CONTROL) {
         if (drive->initVelControl(profile)) {
             driveMode = driveMode_;
@@ -37,12 +60,66 @@ ControlMode ActuatedJoint::setMode(ControlMode driveMode_, motorProfile profile)
     return ERROR;
 }
 
+void ActuatedJoint::setMaxFeedbackAge(uint32_t cycles) {
+    maxFeedbackAge = cycles;
+}
+
+bool ActuatedJoint::isFeedbackStale() {
+    return maxFeedbackAge != 0 && drive->getFeedbackAge() > maxFeedbackAge;
+}
+
+ControlMode ActuatedJoint::getMode() {
+    return driveMode;
+}
+
+uint32_t ActuatedJoint::getMaxFeedbackAge() {
+    return maxFeedbackAge;
+}
+
+Drive *ActuatedJoint::getDrive() {
+    return drive;
+}
+
+bool ActuatedJoint::getLinearConversion(double &scale, double &offset) {
+    return false;
+}
+
+int ActuatedJoint::toDriveVelocity(double jointVelocity) {
+    double scale, offset;
+    double counts = getLinearConversion(scale, offset) && scale != 0 ? jointVelocity / scale
+                                                                     : toDriveUnits(jointVelocity) - toDriveUnits(0);
+    return (int)std::lround(counts / drive->getVelocityUnit());
+}
+
+void ActuatedJoint::setFollowingErrorWindow(double window) {
+    followingErrorWindow = window;
+}
+
+double ActuatedJoint::getFollowingError() {
+    return fromDriveUnits(drive->getFollowingError()) - fromDriveUnits(0);
+}
+
+void ActuatedJoint::setIPBufferSize(uint16_t points) {
+    ipBufferSize = points;
+}
+
+int ActuatedJoint::toDrivePosition(double desQ) {
+    return toDriveUnits(desQ);
+}
+
 setMovementReturnCode_t ActuatedJoint::setPosition(double desQ) {
+    if (isFeedbackStale()) {
+        return STALE_FEEDBACK;
+    }
     if (driveMode == POSITION_CONTROL) {
         //DEBUG_OUT("Setting joint " << this->id << "to: " << desQ << "deg")
         drive->setPos(toDriveUnits(desQ));
         drive->posControlConfirmSP();
         return SUCCESS;
+    } else if (driveMode == CSP_CONTROL) {
+        // Streamed every cycle, the drive applies it at the next SYNC without handshake
+        drive->setPos(toDriveUnits(desQ));
+        return SUCCESS;
     } else {
         // Replace once complete
         return INCORRECT_MODE;
@@ -50,7 +127,10 @@ setMovementReturnCode_t ActuatedJoint::setPosition(double desQ) {
 }
 
 setMovementReturnCode_t ActuatedJoint::setVelocity(double velocity) {
-    if (driveMode == VELOCITY_CONTROL) {
+    if (isFeedbackStale()) {
+        return STALE_FEEDBACK;
+    }
+    if (driveMode == VELOCITY_CONTROL || driveMode == CSV_CONTROL) {
         drive->setVel(toDriveUnits(velocity));
         return SUCCESS;
     } else {
@@ -60,7 +140,10 @@ setMovementReturnCode_t ActuatedJoint::setVelocity(double velocity) {
 }
 
 setMovementReturnCode_t ActuatedJoint::setTorque(double torque) {
-    if (driveMode == TORQUE_CONTROL) {
+    if (isFeedbackStale()) {
+        return STALE_FEEDBACK;
+    }
+    if (driveMode == TORQUE_CONTROL || driveMode == CST_CONTROL) {
         /**
         * \todo A conversion to the drive value for torque
         * 
@@ -71,6 +154,21 @@ setMovementReturnCode_t ActuatedJoint::setTorque(double torque) {
     return INCORRECT_MODE;
 }
 
+setMovementReturnCode_t ActuatedJoint::setFeedforward(double velocity, double torque) {
+    if (isFeedbackStale()) {
+        return STALE_FEEDBACK;
+    }
+    if (driveMode == CSP_CONTROL) {
+        drive->setVelOffset(toDriveVelocity(velocity));
+        drive->setTorqueOffset(torque);
+        return SUCCESS;
+    } else if (driveMode == CSV_CONTROL) {
+        drive->setTorqueOffset(torque);
+        return SUCCESS;
+    }
+    return INCORRECT_MODE;
+}
+
 void ActuatedJoint::readyToSwitchOn() {
     drive->readyToSwitchOn();
 }
@@ -36,6 +36,7 @@ enum setMovementReturnCode_t {
     SUCCESS = 1,
     OUTSIDE_LIMITS = -1,
     INCORRECT_MODE = -2,
+    STALE_FEEDBACK = -3,
     UNKNOWN_ERROR = -100
 };
 
@@ -59,6 +60,26 @@ class ActuatedJoint : public Joint {
          */
     ControlMode driveMode = UNCONFIGURED;
 
+    /**
+         * \brief Maximum age of the drive feedback (in SYNC cycles, see Drive::getFeedbackAge())
+         * accepted for control. 0 disables the check.
+         * 
+         */
+    uint32_t maxFeedbackAge = 0;
+
+    /**
+         * \brief Following error window (in joint units) configured on the drive when entering
+         * CSP_CONTROL. 0 keeps the drive setting.
+         * 
+         */
+    double followingErrorWindow = 0;
+
+    /**
+         * \brief Size of the drive buffer (in points) configured when entering IP_CONTROL
+         * 
+         */
+    uint16_t ipBufferSize = 16;
+
     /**
          * \brief Converts from the joint value to the equivalent value for the drive
          * 
@@ -90,6 +111,15 @@ class ActuatedJoint : public Joint {
          */
     virtual double fromDriveUnits(int driveValue) = 0;
 
+    /**
+         * \brief Converts a joint velocity to the velocity unit of the drive (see Drive::getVelocityUnit()), with
+         * the scale of the linear conversion if the joint has one, else with the drive counts around joint value 0
+         * 
+         * \param jointVelocity The joint velocity (joint units per second)
+         * \return int The drive velocity
+         */
+    int toDriveVelocity(double jointVelocity);
+
    public:
     /**
          * \brief Construct a new Actuated Joint object
@@ -101,7 +131,7 @@ class ActuatedJoint : public Joint {
     ActuatedJoint(int jointID, double jointMin, double jointMax, Drive *drive);
 
     /**
-         * \brief Set the mode of the device (nominally, position, velocity or torque control)
+         * \brief Set the mode of the device (nominally, position, cyclic synchronous position, velocity or torque control)
          * 
          * \param driveMode The mode to be used if possible
          * \param motorProfile variables for desired mode, e.g. postion: v,a and deceleration.
@@ -109,6 +139,13 @@ class ActuatedJoint : public Joint {
          */
     virtual ControlMode setMode(ControlMode driveMode_, motorProfile = motorProfile{0,0,0});
 
+    /**
+         * \brief Get the mode set by setMode()
+         * 
+         * \return ControlMode the mode of the drive, UNCONFIGURED if none was set
+         */
+    ControlMode getMode();
+
     /**
          * \brief Set the Position object
          * 
@@ -133,6 +170,90 @@ class ActuatedJoint : public Joint {
          */
     virtual setMovementReturnCode_t setTorque(double torque);
 
+    /**
+         * \brief Sets the velocity and torque feedforward added by the drive to its own control loops, sent
+         * with the set point of the same cycle (see Drive::setVelOffset()). Used in CSP_CONTROL (velocity and
+         * torque) and CSV_CONTROL (torque only, the velocity is the set point).
+         * 
+         * \param velocity The velocity feedforward (in joint units), ignored in CSV_CONTROL
+         * \param torque The torque feedforward (in drive units, as setTorque())
+         * \return setMovementReturnCode_t The result of the setting
+         */
+    virtual setMovementReturnCode_t setFeedforward(double velocity, double torque);
+
+    /**
+         * \brief Set the maximum age of the drive feedback accepted for control. Older feedback is
+         * not used by updateValue() and set points are rejected with STALE_FEEDBACK.
+         * 
+         * \param cycles Maximum age in SYNC cycles, 0 disables the check
+         */
+    void setMaxFeedbackAge(uint32_t cycles);
+
+    /**
+         * \brief Checks the age of the drive feedback against the maximum set by setMaxFeedbackAge()
+         * 
+         * \return true if the feedback is older than allowed
+         * \return false if the feedback is fresh or the check is disabled
+         */
+    bool isFeedbackStale();
+
+    /**
+         * \brief Gets the maximum age of the drive feedback set by setMaxFeedbackAge()
+         * 
+         * \return uint32_t maximum age in SYNC cycles, 0 if the check is disabled
+         */
+    uint32_t getMaxFeedbackAge();
+
+    /**
+         * \brief Gets the Drive object of this joint
+         * 
+         * \return Drive* the drive
+         */
+    Drive *getDrive();
+
+    /**
+         * \brief Gets the coefficients of a linear conversion from drive units, jointValue = (driveValue - offset) * scale,
+         * so the positions of several joints can be converted in one pass (see JointStateBlock). A joint which
+         * returns false is updated by its own updateValue().
+         * 
+         * Default implementation returns false, as fromDriveUnits() may not be linear.
+         * 
+         * \param scale Set to the joint units per drive unit
+         * \param offset Set to the drive value of joint value 0
+         * \return true if fromDriveUnits() is this linear conversion and updateValue() only converts the drive position
+         */
+    virtual bool getLinearConversion(double &scale, double &offset);
+
+    /**
+         * \brief Set the following error window used when the joint is set to CSP_CONTROL
+         * 
+         * \param window Maximum following error in joint units, 0 keeps the drive setting
+         */
+    void setFollowingErrorWindow(double window);
+
+    /**
+         * \brief Gets the following error of the drive (see Drive::getFollowingError())
+         * 
+         * \return double difference between the position set point and the actual position, in joint units
+         */
+    double getFollowingError();
+
+    /**
+         * \brief Set the size of the drive buffer used when the joint is set to IP_CONTROL
+         * 
+         * \param points Number of points of the drive buffer
+         */
+    void setIPBufferSize(uint16_t points);
+
+    /**
+         * \brief Converts a position set point to drive units, for set points which are not sent by
+         * setPosition() (e.g. the samples of the interpolated position buffer, see CO_ipBuffer.h)
+         * 
+         * \param desQ The desired position (in joint units)
+         * \return int The position in drive units
+         */
+    int toDrivePosition(double desQ);
+
     /**
       * \brief Set the joint ready to switch On 
       * 
@@ -15,10 +15,14 @@
 #include "DebugMacro.h"
 Joint::Joint(int jointID, double jointMin, double jointMax) : id(jointID), qMin(jointMin), qMax(jointMax) {
     q = 0;
+    qd = 0;
+    qdd = 0;
 }
 
 Joint::Joint(int jointID, double jointMin, double jointMax, double q0) : id(jointID), qMin(jointMin), qMax(jointMax) {
     q = q0;
+    qd = 0;
+    qdd = 0;
 }
 Joint::~Joint() {
     DEBUG_OUT(" Joint object deleted")
@@ -31,6 +35,14 @@ double Joint::getQ() {
     return q;
 }
 
+double Joint::getQd() {
+    return qd;
+}
+
+double Joint::getQdd() {
+    return qdd;
+}
+
 void Joint::getStatus() {
     std::cout << "Joint ID: " << id << " @ pos " << getQ() << " deg" << std::endl;
 }
@@ -35,6 +35,10 @@ class Joint {
      * The current state of the change in the joint position(i.e. the value), to be returned in SI units.
      */
     double qd;
+    /**
+     * The estimated acceleration of the joint, see JointEstimator.
+     */
+    double qdd;
     /**
      * The allowable limits of the joint. This should represent the theoretical limits
      * of the joint. Should these be exceeded, an error should be thrown. 
@@ -102,6 +106,12 @@ class Joint {
      * @return double The current internal representation of the value of the joint
      */
     double getQd();
+    /**
+     * @brief Returns the estimated acceleration of the joint (see JointStateBlock, JointEstimator)
+     * 
+     * @return double The last estimate, 0 if the joint is not estimated
+     */
+    double getQdd();
     /**
      * @brief prints out the status of the joints current position in degrees
      * 
@@ -127,6 +137,8 @@ class Joint {
     /*testing*/
     void bitFlip();
     void setQ(double _q) { q = _q; };
+    void setQd(double _qd) { qd = _qd; };
+    void setQdd(double _qdd) { qdd = _qdd; };
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,172 @@
+/**
+ * @file JointCalibration.cpp
+ * @author William Campbell
+ * @brief Conversion between drive and joint units, see JointCalibration.h
+ * @version 0.1
+ * @date 2020-10-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "JointCalibration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#include "DebugMacro.h"
+
+JointCalibration::JointCalibration() : scale(1), invScale(1), offset(0) {
+}
+
+JointCalibration::JointCalibration(double driveA, double jointA, double driveB, double jointB) {
+    scale = (jointB - jointA) / (driveB - driveA);
+    invScale = 1.0 / scale;
+    offset = driveA - jointA * invScale;
+}
+
+bool JointCalibration::setTable(const std::vector<double> &driveValues, const std::vector<double> &jointValues) {
+    size_t n = driveValues.size();
+    if (n < 2 || jointValues.size() != n) {
+        return false;
+    }
+    bool increasing = jointValues[1] > jointValues[0];
+    for (size_t i = 1; i < n; i++) {
+        if (!(driveValues[i] > driveValues[i - 1]) ||
+            !(increasing ? jointValues[i] > jointValues[i - 1] : jointValues[i] < jointValues[i - 1])) {
+            return false;
+        }
+    }
+
+    *this = JointCalibration(driveValues[0], jointValues[0], driveValues[1], jointValues[1]);
+    if (n > 2) {
+        tableDrive = driveValues;
+        tableJoint = jointValues;
+        segmentScale.resize(n - 1);
+        for (size_t i = 0; i + 1 < n; i++) {
+            segmentScale[i] = (tableJoint[i + 1] - tableJoint[i]) / (tableDrive[i + 1] - tableDrive[i]);
+        }
+    }
+    return true;
+}
+
+bool JointCalibration::loadTable(const std::string &fileName) {
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<double> driveValues, jointValues;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        double driveValue, jointValue;
+        if (!(fields >> driveValue >> jointValue)) {
+            DEBUG_OUT("Calibration " << fileName << ": invalid line \"" << line << "\"")
+            return false;
+        }
+        driveValues.push_back(driveValue);
+        jointValues.push_back(jointValue);
+    }
+    if (!setTable(driveValues, jointValues)) {
+        DEBUG_OUT("Calibration " << fileName << ": at least two strictly monotonic points are needed")
+        return false;
+    }
+    return true;
+}
+
+void JointCalibration::setHome(double driveValue, double jointValue) {
+    double shift;
+    if (isLinear()) {
+        shift = driveValue - (jointValue * invScale + offset);
+    } else {
+        int i = jointSegment(jointValue);
+        shift = driveValue - (tableDrive[i] + (jointValue - tableJoint[i]) / segmentScale[i]);
+        for (double &d : tableDrive) {
+            d += shift;
+        }
+    }
+    offset += shift;
+}
+
+bool JointCalibration::isLinear() const {
+    return tableDrive.empty();
+}
+
+double JointCalibration::getScale() const {
+    return scale;
+}
+
+double JointCalibration::getOffset() const {
+    return offset;
+}
+
+double JointCalibration::getMaxRoundTripError() const {
+    double steepest = std::fabs(scale);
+    for (double s : segmentScale) {
+        steepest = std::max(steepest, std::fabs(s));
+    }
+    return 0.5 * steepest;
+}
+
+int JointCalibration::driveSegment(double driveValue) const {
+    // tableDrive is increasing, segment n - 2 is extended past the last point
+    int i = std::upper_bound(tableDrive.begin() + 1, tableDrive.end() - 1, driveValue) - tableDrive.begin() - 1;
+    return i;
+}
+
+int JointCalibration::jointSegment(double jointValue) const {
+    int i;
+    if (tableJoint.back() > tableJoint.front()) {
+        i = std::upper_bound(tableJoint.begin() + 1, tableJoint.end() - 1, jointValue) - tableJoint.begin() - 1;
+    } else {
+        i = std::upper_bound(tableJoint.begin() + 1, tableJoint.end() - 1, jointValue, std::greater<double>()) - tableJoint.begin() - 1;
+    }
+    return i;
+}
+
+int JointCalibration::roundToDrive(double driveValue) {
+    driveValue = std::min(std::max(driveValue, (double)INT32_MIN), (double)INT32_MAX);
+    return (int)std::lround(driveValue);
+}
+
+double JointCalibration::fromDriveUnits(int driveValue) const {
+    if (isLinear()) {
+        return (driveValue - offset) * scale;
+    }
+    int i = driveSegment(driveValue);
+    return tableJoint[i] + (driveValue - tableDrive[i]) * segmentScale[i];
+}
+
+int JointCalibration::toDriveUnits(double jointValue) const {
+    if (isLinear()) {
+        return roundToDrive(jointValue * invScale + offset);
+    }
+    int i = jointSegment(jointValue);
+    return roundToDrive(tableDrive[i] + (jointValue - tableJoint[i]) / segmentScale[i]);
+}
+
+void JointCalibration::fromDriveUnits(const int32_t *driveValues, double *jointValues, int n) const {
+    if (isLinear()) {
+        const double s = scale, o = offset;
+        for (int i = 0; i < n; i++) {
+            jointValues[i] = (driveValues[i] - o) * s;
+        }
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        jointValues[i] = fromDriveUnits(driveValues[i]);
+    }
+}
+
+void JointCalibration::toDriveUnits(const double *jointValues, int32_t *driveValues, int n) const {
+    for (int i = 0; i < n; i++) {
+        driveValues[i] = toDriveUnits(jointValues[i]);
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ * \file JointCalibration.h
+ * \author William Campbell
+ * \brief The <code>JointCalibration</code> class converts between drive units (e.g. encoder counts) and
+ * joint units (e.g. degrees) of an <code>ActuatedJoint</code>.
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef JOINTCALIBRATION_H_INCLUDED
+#define JOINTCALIBRATION_H_INCLUDED
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * @ingroup Joint
+ * \brief Conversion between drive and joint units, computed once when the calibration is set.
+ *
+ * The conversion is either linear, through two known positions of the joint, or a table of
+ * calibrated points for joints with a nonlinear transmission. Between the points of a table
+ * the conversion is linear, outside of them the first and last segments are extended. Table
+ * values must be strictly monotonic in both drive and joint units.
+ *
+ * Drive values are rounded to the nearest count. Round trip error:
+ *  - toDriveUnits(fromDriveUnits(c)) == c for every 32 bit drive value c;
+ *  - |fromDriveUnits(toDriveUnits(q)) - q| is at most half a count in joint units, see
+ *    getMaxRoundTripError(). E.g. for a joint with 250880 counts per 90 degrees this is 1.8e-4 degrees.
+ */
+class JointCalibration {
+   public:
+    /**
+     * \brief Construct an identity calibration (one joint unit per drive unit)
+     *
+     */
+    JointCalibration();
+
+    /**
+     * \brief Construct a linear calibration through two known positions of the joint
+     *
+     * \param driveA Drive value at the first position
+     * \param jointA Joint value at the first position
+     * \param driveB Drive value at the second position, different from driveA
+     * \param jointB Joint value at the second position, different from jointA
+     */
+    JointCalibration(double driveA, double jointA, double driveB, double jointB);
+
+    /**
+     * \brief Replace the conversion with a table of calibrated points
+     *
+     * \param driveValues Drive values of the points, strictly increasing
+     * \param jointValues Joint values of the points, strictly monotonic
+     * \return true if the table is valid and used, false otherwise (the conversion is not changed)
+     */
+    bool setTable(const std::vector<double> &driveValues, const std::vector<double> &jointValues);
+
+    /**
+     * \brief Replace the conversion with a table read from a text file. Each line has the drive value and
+     * the joint value of one point, separated by spaces or a comma. Empty lines and lines starting with #
+     * are skipped.
+     *
+     * \param fileName Path of the calibration file
+     * \return true if the file was read and its table is used, false otherwise (the conversion is not changed)
+     */
+    bool loadTable(const std::string &fileName);
+
+    /**
+     * \brief Shift the calibration along the drive units, so that a homed position of the joint is read as its
+     * joint value: fromDriveUnits(driveValue) == jointValue. The scale, and the shape of a table, are kept.
+     *
+     * \param driveValue Drive value at the home position (e.g. found by homing the drive)
+     * \param jointValue Joint value of the home position
+     */
+    void setHome(double driveValue, double jointValue);
+
+    /**
+     * \brief Check whether the conversion is linear, jointValue = (driveValue - getOffset()) * getScale()
+     *
+     * \return true for a linear calibration, false for a table with more than two points
+     */
+    bool isLinear() const;
+
+    /**
+     * \brief Joint units per drive unit of a linear calibration
+     *
+     */
+    double getScale() const;
+
+    /**
+     * \brief Drive value at joint value 0 of a linear calibration
+     *
+     */
+    double getOffset() const;
+
+    /**
+     * \brief Largest error of fromDriveUnits(toDriveUnits(q)) in joint units (half a count of the steepest segment)
+     *
+     */
+    double getMaxRoundTripError() const;
+
+    /**
+     * \brief Convert a drive value to joint units
+     *
+     */
+    double fromDriveUnits(int driveValue) const;
+
+    /**
+     * \brief Convert a joint value to drive units, rounded to the nearest count and saturated to 32 bits
+     *
+     */
+    int toDriveUnits(double jointValue) const;
+
+    /**
+     * \brief Convert an array of drive values to joint units (e.g. recorded samples). A linear calibration is
+     * converted in a loop without calls or branches, which the compiler can vectorise.
+     *
+     * \param driveValues n drive values
+     * \param jointValues Set to the n joint values
+     * \param n Number of values
+     */
+    void fromDriveUnits(const int32_t *driveValues, double *jointValues, int n) const;
+
+    /**
+     * \brief Convert an array of joint values to drive units (e.g. the samples of a trajectory)
+     *
+     * \param jointValues n joint values
+     * \param driveValues Set to the n drive values, rounded as toDriveUnits()
+     * \param n Number of values
+     */
+    void toDriveUnits(const double *jointValues, int32_t *driveValues, int n) const;
+
+   private:
+    /**
+     * \brief Linear conversion, or the first segment of a table
+     *
+     */
+    double scale;
+    double invScale;
+    double offset;
+
+    /**
+     * \brief Points of a table, empty for a linear calibration
+     *
+     */
+    std::vector<double> tableDrive;
+    std::vector<double> tableJoint;
+
+    /**
+     * \brief Joint units per drive unit of each segment of a table (between points i and i + 1)
+     *
+     */
+    std::vector<double> segmentScale;
+
+    /**
+     * \brief Segment i of the table (extended at the ends) containing the value
+     *
+     */
+    int driveSegment(double driveValue) const;
+    int jointSegment(double jointValue) const;
+
+    /**
+     * \brief Round to the nearest drive count, saturated to 32 bits
+     *
+     */
+    static int roundToDrive(double driveValue);
+};
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * @file JointEstimator.cpp
+ * @author William Campbell
+ * @brief Velocity and acceleration estimator of a joint, see JointEstimator.h
+ * @version 0.1
+ * @date 2020-10-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "JointEstimator.h"
+
+void JointEstimatorConfig::setSmoothing(double theta) {
+    double r = 1 - theta;
+    alpha = 1 - theta * theta * theta;
+    beta = 1.5 * r * r * (1 + theta);
+    gamma = 0.5 * r * r * r;
+}
+
+void JointEstimator::configure(const JointEstimatorConfig &newConfig) {
+    config = newConfig;
+    reset();
+}
+
+void JointEstimator::reset() {
+    initialised = false;
+}
+
+bool JointEstimator::isInitialised() const {
+    return initialised;
+}
+
+void JointEstimator::restart(double position, double velocity) {
+    q = position;
+    qd = config.useDriveVelocity ? velocity : 0;
+    qdd = 0;
+    // nothing is known about the velocity and acceleration yet
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            P[i][j] = 0;
+        }
+    }
+    P[0][0] = config.positionVariance;
+    P[1][1] = config.useDriveVelocity ? config.velocityVariance : 1e6;
+    P[2][2] = 1e8;
+    initialised = true;
+}
+
+void JointEstimator::update(double position, double velocity, double dt) {
+    if (!initialised || !(dt > 0) || dt > config.maxInterval) {
+        restart(position, velocity);
+        return;
+    }
+
+    switch (config.mode) {
+        case ESTIMATOR_DIFFERENCE: {
+            double newQd = config.useDriveVelocity ? velocity : (position - q) / dt;
+            qdd = (newQd - qd) / dt;
+            qd = newQd;
+            q = position;
+            break;
+        }
+        case ESTIMATOR_ALPHA_BETA: {
+            // predict with constant acceleration, correct with the position residual
+            double predictedQ = q + qd * dt + 0.5 * qdd * dt * dt;
+            double predictedQd = qd + qdd * dt;
+            double residual = position - predictedQ;
+            q = predictedQ + config.alpha * residual;
+            qd = predictedQd + config.beta * residual / dt;
+            qdd = qdd + 2 * config.gamma * residual / (dt * dt);
+            if (config.useDriveVelocity) {
+                qd += config.velocityWeight * (velocity - qd);
+            }
+            break;
+        }
+        case ESTIMATOR_KALMAN:
+            updateKalman(position, velocity, dt);
+            break;
+    }
+}
+
+void JointEstimator::updateKalman(double position, double velocity, double dt) {
+    // x = F x, F = [1 dt dt^2/2; 0 1 dt; 0 0 1]
+    double dt2 = dt * dt / 2;
+    q += qd * dt + qdd * dt2;
+    qd += qdd * dt;
+
+    // P = F P F' + Q
+    double FP[3][3];
+    for (int j = 0; j < 3; j++) {
+        FP[0][j] = P[0][j] + dt * P[1][j] + dt2 * P[2][j];
+        FP[1][j] = P[1][j] + dt * P[2][j];
+        FP[2][j] = P[2][j];
+    }
+    for (int i = 0; i < 3; i++) {
+        P[i][0] = FP[i][0] + dt * FP[i][1] + dt2 * FP[i][2];
+        P[i][1] = FP[i][1] + dt * FP[i][2];
+        P[i][2] = FP[i][2];
+    }
+    // white jerk of spectral density jerkDensity, integrated over dt
+    double j = config.jerkDensity, dt3 = dt * dt * dt;
+    P[0][0] += j * dt3 * dt * dt / 20;
+    P[0][1] += j * dt3 * dt / 8;
+    P[0][2] += j * dt3 / 6;
+    P[1][0] += j * dt3 * dt / 8;
+    P[1][1] += j * dt3 / 3;
+    P[1][2] += j * dt * dt / 2;
+    P[2][0] += j * dt3 / 6;
+    P[2][1] += j * dt * dt / 2;
+    P[2][2] += j * dt;
+
+    // measurements are independent, applied one after the other
+    kalmanMeasurement(0, position, config.positionVariance);
+    if (config.useDriveVelocity) {
+        kalmanMeasurement(1, velocity, config.velocityVariance);
+    }
+}
+
+void JointEstimator::kalmanMeasurement(int k, double z, double variance) {
+    double x[3] = {q, qd, qdd};
+    double s = P[k][k] + variance;
+    if (!(s > 0)) {
+        return;
+    }
+    double K[3] = {P[0][k] / s, P[1][k] / s, P[2][k] / s};
+    double residual = z - x[k];
+    q += K[0] * residual;
+    qd += K[1] * residual;
+    qdd += K[2] * residual;
+    double Pk[3] = {P[k][0], P[k][1], P[k][2]};
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            P[i][j] -= K[i] * Pk[j];
+        }
+    }
+}
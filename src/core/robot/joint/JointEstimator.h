@@ -0,0 +1,110 @@
+/**
+ * \file JointEstimator.h
+ * \author William Campbell
+ * \brief Estimator of the velocity and acceleration of a joint from timestamped position samples and,
+ * optionally, the velocity measured by the drive.
+ *
+ * Three estimators are available (see JointEstimatorMode):
+ * - ESTIMATOR_DIFFERENCE: finite differences of the samples, no filtering;
+ * - ESTIMATOR_ALPHA_BETA: alpha-beta-gamma tracking filter, gains from one smoothing factor
+ *   (see JointEstimatorConfig::setSmoothing());
+ * - ESTIMATOR_KALMAN: Kalman filter of a constant acceleration model, driven by white jerk.
+ *
+ * The time between samples is given with each sample, so samples may be missed or come with
+ * jitter. The state has fixed size, update() does not allocate.
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef JOINTESTIMATOR_H_INCLUDED
+#define JOINTESTIMATOR_H_INCLUDED
+
+/**
+ * \brief Estimator of a JointEstimator
+ *
+ */
+enum JointEstimatorMode {
+    ESTIMATOR_DIFFERENCE = 0, /**< 0 */
+    ESTIMATOR_ALPHA_BETA = 1, /**< 1 */
+    ESTIMATOR_KALMAN = 2,     /**< 2 */
+};
+
+/**
+ * \brief Parameters of a JointEstimator, in joint units and seconds
+ *
+ */
+struct JointEstimatorConfig {
+    JointEstimatorMode mode = ESTIMATOR_ALPHA_BETA;
+    /** Use the velocity measured by the drive: as qd with ESTIMATOR_DIFFERENCE, as a second measurement with ESTIMATOR_KALMAN, blended with velocityWeight with ESTIMATOR_ALPHA_BETA */
+    bool useDriveVelocity = false;
+    /** Weight of the drive velocity in the ESTIMATOR_ALPHA_BETA velocity, 0..1 */
+    double velocityWeight = 0.5;
+    /** Gains of ESTIMATOR_ALPHA_BETA (gamma 0 for an alpha-beta filter), default setSmoothing(0.5) */
+    double alpha = 0.875, beta = 0.5625, gamma = 0.0625;
+    /** ESTIMATOR_KALMAN: spectral density of the jerk (units^2/s^5), variance of the position and drive velocity measurements */
+    double jerkDensity = 1e6;
+    double positionVariance = 1e-4;
+    double velocityVariance = 1;
+    /** Samples further apart than this (seconds) restart the estimator */
+    double maxInterval = 0.5;
+
+    /**
+     * \brief Set the ESTIMATOR_ALPHA_BETA gains of a critically damped (fading memory) filter
+     *
+     * \param theta Smoothing, from 0 (fastest response) to 1 (exclusive, heaviest smoothing)
+     */
+    void setSmoothing(double theta);
+};
+
+/**
+ * \brief Velocity and acceleration estimator of one joint (see JointEstimator.h)
+ *
+ */
+class JointEstimator {
+   public:
+    /**
+     * \brief Estimates at the time of the last sample
+     *
+     */
+    double q = 0, qd = 0, qdd = 0;
+
+    /**
+     * \brief Set the parameters and restart the estimator
+     *
+     */
+    void configure(const JointEstimatorConfig &config);
+
+    /**
+     * \brief Restart the estimator: the next sample sets q, qd and qdd to 0 (qd to the drive velocity, if used)
+     *
+     */
+    void reset();
+
+    /**
+     * \brief Add a position sample
+     *
+     * \param position Position
+     * \param velocity Velocity measured by the drive, used if configured (see JointEstimatorConfig::useDriveVelocity)
+     * \param dt Time since the previous sample (seconds), ignored for the first sample
+     */
+    void update(double position, double velocity, double dt);
+
+    /**
+     * \brief True once a sample was added since the last reset()
+     *
+     */
+    bool isInitialised() const;
+
+   private:
+    JointEstimatorConfig config;
+    bool initialised = false;
+    /** Covariance of ESTIMATOR_KALMAN (q, qd, qdd) */
+    double P[3][3];
+
+    void restart(double position, double velocity);
+    void updateKalman(double position, double velocity, double dt);
+    void kalmanMeasurement(int k, double z, double variance);
+};
+
+#endif
@@ -4,13 +4,6 @@ pocketBeagle::pocketBeagle() {
     DEBUG_OUT("Virtual pocket Beagle created")
 }
 
-void pocketBeagle::updateGO(bool go) {
-    if (go) {
-        *(&CO_OD_RAM.goButton) = 1;
-    } else {
-        *(&CO_OD_RAM.goButton) = 0;
-    }
-}
 RobotMode pocketBeagle::updateController(bool up, bool dwn, bool select) {
     RobotMode returnValue = RobotMode::INITIAL;
     if (up) {
@@ -59,8 +59,6 @@ class pocketBeagle {
  * \return std::string 
  */
     std::string printRobotMode(RobotMode mode);
-
-    void updateGO(bool go);
 };
 
 #endif
\ No newline at end of file
@@ -2,10 +2,10 @@
 /**
  * \file SchneiderDrive.h
  * \author Justin Fong
- * \brief  An implementation of the Drive Object, specifically for the Copley Drive
+ * \brief  An implementation of the Drive Object, specifically for the Schneider Drive
  * 
  * This class enables low level functions to the system. It does limited error 
- * checking. 
+ * checking. The configuration of the drive follows from SchneiderDriveTraits (see CiA402Drive.h).
  * \version 0.1
  * \date 2020-04-07
  * \version 0.1
@@ -14,124 +14,89 @@
  */
 #ifndef SchneiderDrive_H_INCLUDED
 #define SchneiderDrive_H_INCLUDED
-#include "Drive.h"
+#include "CiA402Drive.h"
 #include "RobotParams.h"
 
 /**
- * \brief An implementation of the Drive Object, specifically for Copley-branded devices (currently used on the X2 Exoskeleton)
+ * \brief PDO layout of the Schneider drives, configured by SchneiderDrive::initPDOs
  * 
  */
-class SchneiderDrive : public Drive {
+struct SchneiderPDOLayout {
+    /** TPDO1: COB-ID 180+{NODE-ID}, Status Word, sent on internal event */
+    typedef PDOMapping<1, 0xFF, STATUS_WORD> TPDO1;
+    /** TPDO2: COB-ID 280+{NODE-ID}, Actual Position and Velocity, sent every SYNC */
+    typedef PDOMapping<2, 1, ACTUAL_POS, ACTUAL_VEL> TPDO2;
+    /** TPDO4 in interpolated position mode: COB-ID 480+{NODE-ID}, Buffer Position (points in the drive buffer), sent every SYNC */
+    typedef PDOMapping<4, 1, IP_BUFFER_POS> TPDO4IP;
+    /** RPDO3: COB-ID 300+{NODE-ID}, Target Position, applied immediately */
+    typedef PDOMapping<3, 0xFF, TARGET_POS> RPDO3;
+    /** RPDO3 in cyclic synchronous position mode: Target Position, applied at the next SYNC */
+    typedef PDOMapping<3, 1, TARGET_POS> RPDO3CSP;
+    /** RPDO3 in interpolated position mode: Interpolation Data Record, added to the drive buffer when received */
+    typedef PDOMapping<3, 0xFF, IP_DATA> RPDO3IP;
+    /** RPDO4: COB-ID 400+{NODE-ID}, Target Velocity, applied immediately */
+    typedef PDOMapping<4, 0xFF, TARGET_VEL> RPDO4;
+    /** RPDO4 in cyclic synchronous position mode: Velocity Offset (feedforward), applied at the next SYNC */
+    typedef PDOMapping<4, 1, VEL_OFFSET> RPDO4CSP;
+    /** RPDO4 in cyclic synchronous velocity mode: Target Velocity, applied at the next SYNC */
+    typedef PDOMapping<4, 1, TARGET_VEL> RPDO4CSV;
+    /** RPDO5: COB-ID 500+{NODE-ID}, Target Torque, applied immediately */
+    typedef PDOMapping<5, 0xFF, TARGET_TOR> RPDO5;
+    /** RPDO5 in cyclic synchronous position and velocity modes: Torque Offset (feedforward), applied at the next SYNC */
+    typedef PDOMapping<5, 1, TOR_OFFSET> RPDO5CSP;
+    /** RPDO5 in cyclic synchronous torque mode: Target Torque, applied at the next SYNC */
+    typedef PDOMapping<5, 1, TARGET_TOR> RPDO5CST;
+
+    /** PDOs configured by initPDOs(), no Actual Torque PDO */
+    typedef PDOList<TPDO1, TPDO2> TPDOs;
+    typedef PDOList<RPDO3, RPDO4, RPDO5> RPDOs;
+    /** Target RPDOs of the profile modes, configured back when a drive leaves a synchronous mode: RPDO5 is
+     * remapped by all of them */
+    typedef PDOList<RPDO3, RPDO4, RPDO5> ProfileRPDOs;
+    /** RPDOs of the cyclic synchronous and interpolated position modes */
+    typedef PDOList<RPDO3CSP, RPDO4CSP, RPDO5CSP> CSPRPDOs;
+    typedef PDOList<RPDO4CSV, RPDO5CSP> CSVRPDOs;
+    typedef PDOList<RPDO5CST> CSTRPDOs;
+    typedef PDOList<RPDO3IP> IPRPDOs;
+    /** TPDOs of interpolated position mode, disabled when the drive leaves it */
+    typedef PDOList<TPDO4IP> IPTPDOs;
+};
+
+/**
+ * \brief Traits of the Schneider drives: profile position and velocity modes only, SchneiderPDOLayout in four
+ * RPDOs, whose parameters are numbered one below the PDOs (RPDO3, COB-ID 300+{NODE-ID}, in 0x1401/0x1601),
+ * Control Word cycled when set to profile position mode, and no multiplexed setpoints
+ * 
+ */
+struct SchneiderDriveTraits : CiA402DriveTraits {
+    typedef SchneiderPDOLayout Layout;
+    /** Profile torque, homing, cyclic synchronous and interpolated position modes are not configured on these drives */
+    static constexpr uint32_t modes = CIA402_MODE(POSITION_CONTROL) | CIA402_MODE(VELOCITY_CONTROL);
+    static constexpr int noOfRPDOs = 4;
+    static constexpr int rpdoParameterShift = 1;
+    static constexpr bool enableInPositionConfig = true;
+    /** No RPDO left for the multiplexed setpoints, the first one keeps the Control Word */
+    static constexpr int setpointMuxRPDO = 0;
+};
+
+/**
+ * \brief An implementation of the Drive Object, specifically for Schneider Electric drives (the ankles of Alex)
+ * 
+ */
+class SchneiderDrive final : public CiA402Drive<SchneiderDriveTraits> {
    public:
     /**
-         * \brief Construct a new Copley Drive object
+         * \brief Construct a new Schneider Drive object
          * 
          * \param NodeID CANopen Node ID
          */
     SchneiderDrive(int NodeID);
 
     /**
-         * \brief Destroy the Copley Drive object
+         * \brief Destroy the Schneider Drive object
          * 
          */
     ~SchneiderDrive();
-    /**
-         * Initialises the drive (SDO start message)
-         * 
-         * \return True if successful, False if not
-         */
-    bool Init();
-    /**
-     * \todo Move jointMinMap and jointMaxMap to set additional parameters (bit 5 in 0x6041 makes updates happen immediately)
-     * 
-     */
-    /**
-         * Sets the drive to Position control with default parameters (through SDO messages)
-         * 
-         * Note: Should be overloaded to allow parameters to be set
-         * 
-         * \return true if successful
-         * \return false if not
-         */
-    bool initPosControl(motorProfile posControlMotorProfile);
-    /**
-         * Sets the drive to Velocity control with default parameters (through SDO messages)
-         * 
-         * Note: Should be overloaded to allow parameters to be set
-         * 
-         * \return true if successful
-         * \return false if not
-         */
-    bool initVelControl(motorProfile velControlMotorProfile);
-
-    /**
-         * Sets the drive to Torque control with default parameters (through SDO messages)
-         * 
-         * Note: Should be overloaded to allow parameters to be set
-         * 
-         * \return true if successful
-         * \return false if not
-         */
-    bool initTorqueControl();
-    /**
-          * \brief Overloaded method from Drive, specifically for Copley Drive implementation.
-          *     Generates the list of commands required to configure Position control in CANopen motor drive
-          * 
-          * /param Profile Velocity, value used by position mode motor trajectory generator.
-          *            Units: 0.1 counts/sec
-          *            Range:0 - 500,000,000
-          * /param Profile Acceleration, value position mode motor trajectory generator will attempt to achieve.
-          *            Units: 10 counts/sec^2
-          *            Range:0 - 200,000,000
-          * /param Profile Deceleration, value position mode motor trajectory generator will use at end of trapezoidal profile.
-          *             see programmers manual for other profile types use.
-          *            Units: 10 counts/sec^2
-          *            Range:0 - 200,000,000
-          * 
-          *    NOTE: More details on params and profiles can be found in the CANopne CiA 402 series specifications:
-          *           https://www.can-cia.org/can-knowledge/canopen/cia402/
-          * 
-          */
-
-    std::vector<std::string> generatePosControlConfigSDO(motorProfile positionProfile);
-    /**
-          * \brief Overloaded method from Drive, specifically for Copley Drive implementation.
-          *     Generates the list of commands required to configure Velocity control in CANopen motor drive
-          * 
-          * /param Profile Acceleration, value Velocity mode motor trajectory generator will attempt to achieve.
-          *            Units: 10 counts/sec^2
-          *            Range:0 - 200,000,000
-          * /param Profile Deceleration, value Velocity mode motor trajectory generator will use at end of trapezoidal profile.
-          *             see programmers manual for other profile types use.
-          *            Units: 10 counts/sec^2
-          *            Range:0 - 200,000,000
-          * 
-          *    NOTE: More details on params and profiles can be found in the CANopne CiA 402 series specifications:
-          *           https://www.can-cia.org/can-knowledge/canopen/cia402/
-          * 
-          */
-    std::vector<std::string> generateVelControlConfigSDO(motorProfile velocityProfile);
-    /**
-          * \brief Overloaded method from Drive, specifically for Copley Drive implementation.
-          *     Generates the list of commands required to configure Torque control in CANopen motor drive
-          *
-          *    NOTE: More details on params and profiles can be found in the CANopne CiA 402 series specifications:
-          *           https://www.can-cia.org/can-knowledge/canopen/cia402/
-          *
-          */
-    std::vector<std::string> generateTorqueControlConfigSDO();
-    /**
- * \brief Overload Drive class initPDO function for Schenider implementation
- * 
- * \return true 
- * \return false 
- */
-    bool initPDOs();
-    /**
-     * \brief Overload Drive class generateRPDOConfigSDO function for Schenider ankle implementation
-     * 
-     */
-    std::vector<std::string> generateRPDOConfigSDO(std::vector<OD_Entry_t> items, int PDO_Num, int UpdateTiming);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,277 @@
+/**
+ * @brief An implementation of the Drive Object, which simulates the drive and its joint
+ *
+ */
+#include "SimulatedDrive.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "DebugMacro.h"
+
+/* Control loops of the drive and the joint model are integrated with steps of at most this (seconds) */
+#define SIMULATED_DRIVE_SUBSTEP 1e-4
+/* Target reached window of the position modes without a following error window (counts) */
+#define SIMULATED_DRIVE_TARGET_WINDOW 100
+
+std::vector<SimulatedDrive *> SimulatedDrive::drives;
+double SimulatedDrive::simulatedTime = 0;
+
+SimulatedDrive::SimulatedDrive(int NodeID, SimulatedJointModel model, int initialPosition) : Drive::Drive(NodeID),
+                                                                                             model(model),
+                                                                                             noiseGenerator(model.seed + NodeID),
+                                                                                             noise(0, model.positionNoise > 0 ? model.positionNoise : 1) {
+    this->NodeID = NodeID;
+    // the actual values are written by step(), not received by an RPDO
+    feedbackFromRPDO = false;
+    this->model.latency = std::min(model.latency, (unsigned int)MAX_LATENCY);
+    position = reference = initialPosition;
+    velocity = torque = 0;
+    for (unsigned int i = 0; i <= MAX_LATENCY; i++) {
+        historyPos[i] = initialPosition;
+        historyVel[i] = 0;
+        historyTor[i] = 0;
+    }
+    // the joint holds its position when enabled before the first set point
+    *motorOD->targetPosition = initialPosition;
+    publish();
+    drives.push_back(this);
+}
+
+SimulatedDrive::~SimulatedDrive() {
+    drives.erase(std::remove(drives.begin(), drives.end(), this), drives.end());
+    DEBUG_OUT(" SimulatedDrive Deleted ")
+}
+
+void SimulatedDrive::stepAll(double dt) {
+    CO_LOCK_OD();
+    for (auto drive : drives) {
+        drive->step(dt);
+    }
+    simulatedTime += dt;
+    CO_UNLOCK_OD();
+}
+
+void SimulatedDrive::getTime(timespec *time) {
+    time->tv_sec = (time_t)simulatedTime;
+    time->tv_nsec = (long)((simulatedTime - time->tv_sec) * 1e9);
+}
+
+void SimulatedDrive::step(double dt) {
+    updateState();
+
+    int substeps = std::max(1, (int)std::ceil(dt / SIMULATED_DRIVE_SUBSTEP));
+    double h = dt / substeps;
+    for (int i = 0; i < substeps; i++) {
+        torque = controlTorque(h);
+        double friction = model.damping * velocity + model.coulombFriction * std::tanh(velocity / 10.0);
+        velocity += (torque - friction) / model.inertia * h;
+        position += velocity * h;
+    }
+
+    double measured = position;
+    if (model.positionNoise > 0) {
+        measured += noise(noiseGenerator);
+    }
+    historyIndex = (historyIndex + 1) % (MAX_LATENCY + 1);
+    historyPos[historyIndex] = (int32_t)std::lround(measured);
+    historyVel[historyIndex] = (int32_t)std::lround(velocity / model.velocityUnit);
+    historyTor[historyIndex] = (int32_t)std::lround(torque);
+    publish();
+}
+
+void SimulatedDrive::updateState() {
+    uint16_t controlWord = *motorOD->controlWord;
+    CiA402State previous = simState;
+
+    if (fault) {
+        // fault reset on the rising edge of bit 7
+        if ((controlWord & 0x80) && !(lastControlWord & 0x80)) {
+            fault = false;
+            simState = CIA402_SWITCH_ON_DISABLED;
+        } else {
+            simState = CIA402_FAULT;
+        }
+    } else if (!(controlWord & 0x02)) {
+        simState = CIA402_SWITCH_ON_DISABLED;
+    } else if (!(controlWord & 0x04)) {
+        simState = (simState == CIA402_OPERATION_ENABLED || simState == CIA402_QUICK_STOP_ACTIVE) ? CIA402_QUICK_STOP_ACTIVE : CIA402_SWITCH_ON_DISABLED;
+    } else if ((controlWord & 0x0F) == 0x0F) {
+        // states between are passed in one step
+        simState = CIA402_OPERATION_ENABLED;
+    } else if ((controlWord & 0x0F) == 0x07) {
+        simState = CIA402_SWITCHED_ON;
+    } else {
+        simState = CIA402_READY_TO_SWITCH_ON;
+    }
+    lastControlWord = controlWord;
+
+    if (simState == CIA402_OPERATION_ENABLED && previous != CIA402_OPERATION_ENABLED) {
+        // profile starts at the actual position
+        reference = position;
+    }
+}
+
+double SimulatedDrive::controlTorque(double dt) {
+    double demand = 0;
+    if (simState == CIA402_QUICK_STOP_ACTIVE) {
+        demand = -model.velocityGain * velocity;
+    } else if (simState == CIA402_OPERATION_ENABLED) {
+        switch (mode) {
+            case POSITION_CONTROL: {
+                double target = *motorOD->targetPosition;
+                double step = target - reference;
+                if (profileVelocity > 0) {
+                    step = std::max(-profileVelocity * dt, std::min(profileVelocity * dt, step));
+                }
+                reference += step;
+                demand = model.positionGain * (reference - position) + model.velocityGain * (step / dt - velocity);
+                break;
+            }
+            case CSP_CONTROL:
+                reference = *motorOD->targetPosition;
+                demand = model.positionGain * (reference - position) + model.velocityGain * (*motorOD->targetVelocity * model.velocityUnit - velocity) + *motorOD->targetTorque;
+                break;
+            case VELOCITY_CONTROL:
+                demand = model.velocityGain * (*motorOD->targetVelocity * model.velocityUnit - velocity);
+                break;
+            case CSV_CONTROL:
+                demand = model.velocityGain * (*motorOD->targetVelocity * model.velocityUnit - velocity) + *motorOD->targetTorque;
+                break;
+            case TORQUE_CONTROL:
+            case CST_CONTROL:
+                demand = *motorOD->targetTorque;
+                break;
+            default:
+                break;
+        }
+    }
+    return std::max(-model.maxTorque, std::min(model.maxTorque, demand));
+}
+
+void SimulatedDrive::publish() {
+    unsigned int index = (historyIndex + MAX_LATENCY + 1 - model.latency) % (MAX_LATENCY + 1);
+    *motorOD->actualPosition = historyPos[index];
+    *motorOD->actualVelocity = historyVel[index];
+    *motorOD->actualTorque = historyTor[index];
+
+    uint16_t statusWord = 0x0200;  // remote
+    switch (simState) {
+        case CIA402_NOT_READY_TO_SWITCH_ON:
+            break;
+        case CIA402_SWITCH_ON_DISABLED:
+            statusWord |= 0x40;
+            break;
+        case CIA402_READY_TO_SWITCH_ON:
+            statusWord |= 0x21;
+            break;
+        case CIA402_SWITCHED_ON:
+            statusWord |= 0x23;
+            break;
+        case CIA402_OPERATION_ENABLED:
+            statusWord |= 0x27;
+            break;
+        case CIA402_QUICK_STOP_ACTIVE:
+            statusWord |= 0x07;
+            break;
+        case CIA402_FAULT_REACTION_ACTIVE:
+            statusWord |= 0x0F;
+            break;
+        case CIA402_FAULT:
+            statusWord |= 0x08;
+            break;
+    }
+    if (mode == POSITION_CONTROL || mode == CSP_CONTROL) {
+        double window = followingErrorWindow > 0 ? followingErrorWindow : SIMULATED_DRIVE_TARGET_WINDOW;
+        if (std::fabs(*motorOD->targetPosition - position) <= window) {
+            statusWord |= CIA402_SW_TARGET_REACHED;
+        }
+        if (simState == CIA402_OPERATION_ENABLED && followingErrorWindow > 0 && std::fabs(reference - position) > followingErrorWindow) {
+            statusWord |= CIA402_SW_FOLLOWING_ERROR;
+        }
+    }
+    *motorOD->statusWord = statusWord;
+}
+
+void SimulatedDrive::injectFault() {
+    fault = true;
+    simState = CIA402_FAULT;
+    publish();
+}
+
+double SimulatedDrive::getTruePosition() {
+    return position;
+}
+
+int SimulatedDrive::getPos() {
+    return *motorOD->actualPosition;
+}
+
+double SimulatedDrive::getVelocityUnit() {
+    return model.velocityUnit;
+}
+
+bool SimulatedDrive::Init() {
+    return true;
+}
+
+bool SimulatedDrive::initPDOs() {
+    // no PDOs, the simulation works on the master Object Dictionary
+    return true;
+}
+
+bool SimulatedDrive::initPosControl(motorProfile posControlMotorProfile) {
+    DEBUG_OUT("NodeID " << NodeID << " Initialising simulated Position Control")
+    synchronousMode = UNCONFIGURED;
+    mode = POSITION_CONTROL;
+    profileVelocity = posControlMotorProfile.profileVelocity * model.velocityUnit;
+    return true;
+}
+
+bool SimulatedDrive::initVelControl(motorProfile /*velControlMotorProfile*/) {
+    DEBUG_OUT("NodeID " << NodeID << " Initialising simulated Velocity Control")
+    synchronousMode = UNCONFIGURED;
+    mode = VELOCITY_CONTROL;
+    return true;
+}
+
+bool SimulatedDrive::initTorqueControl() {
+    DEBUG_OUT("NodeID " << NodeID << " Initialising simulated Torque Control")
+    synchronousMode = UNCONFIGURED;
+    mode = TORQUE_CONTROL;
+    return true;
+}
+
+bool SimulatedDrive::initCSPControl(uint32_t followingErrorWindow) {
+    DEBUG_OUT("NodeID " << NodeID << " Initialising simulated Cyclic Synchronous Position Control")
+    synchronousMode = CSP_CONTROL;
+    mode = CSP_CONTROL;
+    this->followingErrorWindow = followingErrorWindow;
+    setPos(getPos());
+    setVelOffset(0);
+    setTorqueOffset(0);
+    return true;
+}
+
+bool SimulatedDrive::initCSVControl() {
+    DEBUG_OUT("NodeID " << NodeID << " Initialising simulated Cyclic Synchronous Velocity Control")
+    synchronousMode = CSV_CONTROL;
+    mode = CSV_CONTROL;
+    setVel(0);
+    setTorqueOffset(0);
+    return true;
+}
+
+bool SimulatedDrive::initCSTControl() {
+    DEBUG_OUT("NodeID " << NodeID << " Initialising simulated Cyclic Synchronous Torque Control")
+    synchronousMode = CST_CONTROL;
+    mode = CST_CONTROL;
+    setTorque(0);
+    return true;
+}
+
+bool SimulatedDrive::initIPControl(uint16_t /*bufferSize*/) {
+    DEBUG_OUT("NodeID " << NodeID << " Interpolated Position Control is not simulated")
+    return false;
+}
@@ -0,0 +1,209 @@
+/**
+ * \file SimulatedDrive.h
+ * \author William Campbell
+ * \brief  An implementation of the Drive Object, which simulates a drive and the joint it moves
+ *
+ * The drive has no CAN communication: it reads its Control Word and set points from the master
+ * Object Dictionary and writes its Status Word and actual values back, as the PDOs of a real drive
+ * would. The joint is a second-order model (inertia, viscous and Coulomb friction) driven by the
+ * torque of the drive control loops of the current mode. All drives are advanced together by
+ * stepAll(), with a fixed time step, so a run is deterministic (including the noise, from a seeded
+ * generator) and independent of the wall clock: it may run faster than real time.
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef SIMULATEDDRIVE_H_INCLUDED
+#define SIMULATEDDRIVE_H_INCLUDED
+#include <time.h>
+
+#include <random>
+#include <vector>
+
+#include "Drive.h"
+
+/**
+ * \brief Parameters of the simulated joint and drive, in drive units (counts, counts/s, torque units of 0x6071).
+ * The velocities of the Object Dictionary and of the motor profiles are in velocityUnit.
+ *
+ */
+struct SimulatedJointModel {
+    double inertia = 1e-4;         /**< torque units per counts/s^2 */
+    double damping = 1e-4;         /**< viscous friction, torque units per counts/s */
+    double coulombFriction = 0;    /**< torque units, opposing the motion */
+    double positionGain = 0.4;     /**< drive position loop, torque units per count */
+    double velocityGain = 0.009;   /**< drive velocity loop, torque units per counts/s */
+    double maxTorque = 3000;       /**< torque limit of the drive */
+    double positionNoise = 0;      /**< standard deviation of the measured position, counts */
+    unsigned int latency = 0;      /**< age of the feedback written to the Object Dictionary, in steps */
+    unsigned int seed = 1;         /**< seed of the noise, the NodeID is added */
+    double velocityUnit = 0.1;     /**< counts/s per drive velocity unit, 0.1 as the Copley drives */
+};
+
+/**
+ * \brief An implementation of the Drive Object, which simulates the drive and its joint (see SimulatedDrive.h)
+ *
+ */
+class SimulatedDrive : public Drive {
+   public:
+    /**
+     * \brief Maximum latency of the feedback, in steps
+     *
+     */
+    static const unsigned int MAX_LATENCY = 31;
+
+    /**
+     * \brief Construct a new Simulated Drive object, added to the drives advanced by stepAll()
+     *
+     * \param NodeID CANopen Node ID, selects the Object Dictionary entries of the drive
+     * \param model Parameters of the joint and drive
+     * \param initialPosition Position of the joint at start, counts
+     */
+    SimulatedDrive(int NodeID, SimulatedJointModel model = SimulatedJointModel(), int initialPosition = 0);
+
+    /**
+     * \brief Destroy the Simulated Drive object, removed from the drives advanced by stepAll()
+     *
+     */
+    ~SimulatedDrive();
+
+    /**
+     * \brief Advance all simulated drives, must be called with the Object Dictionary unlocked
+     *
+     * \param dt Time step, seconds
+     */
+    static void stepAll(double dt);
+
+    /**
+     * \brief Get the simulated time: the sum of the steps of stepAll()
+     *
+     * \param time Set to the simulated time
+     */
+    static void getTime(timespec *time);
+
+    /**
+     * \brief Advance this drive
+     *
+     * \param dt Time step, seconds
+     */
+    void step(double dt);
+
+    /**
+     * \brief Put the drive into the FAULT state, as a drive detecting an error would. Left with a fault
+     * reset (see Drive::resetFault()).
+     *
+     */
+    void injectFault();
+
+    /**
+     * \brief Get the true position of the joint (without noise and latency)
+     *
+     * \return double position, counts
+     */
+    double getTruePosition();
+
+    bool Init();
+    bool initPDOs();
+    bool initPosControl(motorProfile posControlMotorProfile);
+    bool initVelControl(motorProfile velControlMotorProfile);
+    bool initTorqueControl();
+    bool initCSPControl(uint32_t followingErrorWindow);
+    bool initCSVControl();
+    bool initCSTControl();
+
+    /**
+     * \brief Interpolated Position mode is not simulated
+     *
+     * \return false
+     */
+    bool initIPControl(uint16_t bufferSize);
+
+    /**
+     * \brief Gets the actual position written by the simulation
+     *
+     */
+    int getPos();
+
+    /**
+     * \brief Unit of the simulated drive velocities (SimulatedJointModel::velocityUnit)
+     *
+     */
+    double getVelocityUnit();
+
+   private:
+    SimulatedJointModel model;
+
+    /**
+     * \brief Mode of the drive control loops
+     *
+     */
+    ControlMode mode = UNCONFIGURED;
+
+    /**
+     * \brief Profile velocity of POSITION_CONTROL (counts/s), 0 for none
+     *
+     */
+    double profileVelocity = 0;
+
+    /**
+     * \brief Following error window of the position modes (counts), 0 for none
+     *
+     */
+    double followingErrorWindow = 0;
+
+    /**
+     * \brief State of the joint
+     *
+     */
+    double position, velocity, torque;
+
+    /**
+     * \brief Position reference of POSITION_CONTROL, moving to the target at the profile velocity
+     *
+     */
+    double reference;
+
+    /**
+     * \brief State of the power drive state machine, Control Word of the previous step
+     *
+     */
+    CiA402State simState = CIA402_SWITCH_ON_DISABLED;
+    uint16_t lastControlWord = 0;
+    bool fault = false;
+
+    /**
+     * \brief Feedback of the last MAX_LATENCY + 1 steps
+     *
+     */
+    int32_t historyPos[MAX_LATENCY + 1];
+    int32_t historyVel[MAX_LATENCY + 1];
+    int32_t historyTor[MAX_LATENCY + 1];
+    unsigned int historyIndex = 0;
+
+    std::mt19937 noiseGenerator;
+    std::normal_distribution<double> noise;
+
+    /**
+     * \brief Update simState from the Control Word
+     *
+     */
+    void updateState();
+
+    /**
+     * \brief Torque of the drive control loops for the current mode and state
+     *
+     */
+    double controlTorque(double dt);
+
+    /**
+     * \brief Write the Status Word and the feedback of latency steps ago
+     *
+     */
+    void publish();
+
+    static std::vector<SimulatedDrive *> drives;
+    static double simulatedTime;
+};
+
+#endif
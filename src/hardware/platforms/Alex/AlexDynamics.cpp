@@ -0,0 +1,78 @@
+/**
+ * @file AlexDynamics.cpp
+ * @author William Campbell
+ * @brief Sagittal plane dynamics of the legs of Alex, see AlexDynamics.h
+ * @version 0.1
+ * @date 2020-10-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "AlexDynamics.h"
+
+/**
+ * \brief Joints of each leg, from the pelvis, and the chain angle of each: sign * (q - offset), radians.
+ * The thigh is at the pelvis angle with the hip at 180 degrees, knee flexion moves the shank backwards.
+ *
+ */
+static const int legJoints[2][3] = {{LEFT_HIP, LEFT_KNEE, LEFT_ANKLE}, {RIGHT_HIP, RIGHT_KNEE, RIGHT_ANKLE}};
+static const double jointSign[3] = {-1, -1, 1};
+static const double jointOffset[3] = {M_PI, 0, 0};
+
+static PlanarLink segment(double length, double mass, double com, double gyration) {
+    PlanarLink link;
+    link.length = length;
+    link.mass = mass;
+    link.com = com * length;
+    link.inertia = mass * (gyration * length) * (gyration * length);
+    return link;
+}
+
+AlexDynamics::AlexDynamics() {
+    PilotParameters pilot{};
+    pilot.upperleg_length = 0.44;
+    pilot.lowerleg_length = 0.44;
+    pilot.foot_length = 0.30;
+    setPilotParameters(pilot);
+}
+
+void AlexDynamics::setPilotParameters(const PilotParameters &pilot) {
+    for (Leg &leg : legs) {
+        leg.links[0] = segment(pilot.upperleg_length, ALEX_THIGH_MASS, ALEX_THIGH_COM, ALEX_THIGH_GYRATION);
+        leg.links[1] = segment(pilot.lowerleg_length, ALEX_SHANK_MASS, ALEX_SHANK_COM, ALEX_SHANK_GYRATION);
+        leg.links[2] = segment(pilot.foot_length, ALEX_FOOT_MASS, ALEX_FOOT_COM, ALEX_FOOT_GYRATION);
+    }
+}
+
+void AlexDynamics::setPelvisAngle(double angle) {
+    pelvisAngle = angle;
+}
+
+void AlexDynamics::computeTorques(const double *q, const double *qd, const double *qdd, int n, double *tau, bool inertia) const {
+    for (int side = 0; side < 2; side++) {
+        Leg::Vector legQ, legQd, legQdd, legTau;
+        for (int j = 0; j < 3; j++) {
+            int i = legJoints[side][j];
+            bool present = i < n;
+            legQ[j] = jointSign[j] * ((present ? deg2rad(q[i]) : M_PI_2) - jointOffset[j]);
+            legQd[j] = present && inertia ? jointSign[j] * deg2rad(qd[i]) : 0;
+            legQdd[j] = present && inertia ? jointSign[j] * deg2rad(qdd[i]) : 0;
+        }
+        // a forward lean of the pelvis moves the thigh backwards (see AlexTrajectoryGenerator forward kinematics)
+        if (inertia) {
+            legs[side].inverseDynamics(legQ, legQd, legQdd, legTau, -pelvisAngle);
+        } else {
+            legs[side].gravityTorques(legQ, legTau, -pelvisAngle);
+        }
+        for (int j = 0; j < 3; j++) {
+            int i = legJoints[side][j];
+            if (i < n) {
+                tau[i] = jointSign[j] * legTau[j];
+            }
+        }
+    }
+}
+
+const AlexDynamics::Leg &AlexDynamics::getLeg(bool left) const {
+    return legs[left ? 0 : 1];
+}
@@ -0,0 +1,74 @@
+/**
+ * \file AlexDynamics.h
+ * \author William Campbell
+ * \brief Sagittal plane dynamics of the legs of the Alex exoskeleton and its pilot, for torque feedforward.
+ *
+ * Each leg is a PlanarChain of three links (thigh, shank, foot) hanging from a fixed pelvis, sized from
+ * the PilotParameters and the segment parameters of RobotParams.h. The torques are those of a leg
+ * moving freely (swing leg): a leg carrying the body is not modelled.
+ *
+ * Joint angles are those of the robot (degrees, see AlexTrajectoryGenerator): hip 180 and knee 0 with the
+ * leg straight, ankle 90 with the foot at right angle to the shank. Without ankle joints the foot is held
+ * at 90 degrees.
+ * \version 0.1
+ * \date 2020-10-19
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef ALEXDYNAMICS_H_INCLUDED
+#define ALEXDYNAMICS_H_INCLUDED
+
+#include "AlexTrajectoryGenerator.h"
+#include "PlanarChain.h"
+#include "RobotParams.h"
+
+/**
+ * \brief Dynamics of the two legs of Alex (see AlexDynamics.h)
+ *
+ */
+class AlexDynamics {
+   public:
+    typedef PlanarChain<3> Leg;
+
+    /**
+     * \brief Construct the model with default limb lengths (0.44 m thigh and shank, 0.3 m foot)
+     *
+     */
+    AlexDynamics();
+
+    /**
+     * \brief Size the legs from the pilot
+     *
+     */
+    void setPilotParameters(const PilotParameters &pilot);
+
+    /**
+     * \brief Set the forward lean of the pelvis from vertical (radians), 0 by default
+     *
+     */
+    void setPelvisAngle(double angle);
+
+    /**
+     * \brief Joint torques for the given motion of the robot joints
+     *
+     * \param q, qd, qdd Joint angles (degrees), velocities and accelerations (per second, per second^2),
+     * indexed by robotJoints
+     * \param n Number of joints (4 without ankles, 6 with)
+     * \param tau Joint torques (Nm), positive towards increasing joint angle
+     * \param inertia false for gravity torques only (qd and qdd are then not used)
+     */
+    void computeTorques(const double *q, const double *qd, const double *qdd, int n, double *tau, bool inertia = true) const;
+
+    /**
+     * \brief Get the model of a leg
+     *
+     * \param left true for the left leg
+     */
+    const Leg &getLeg(bool left) const;
+
+   private:
+    Leg legs[2];
+    double pelvisAngle = 0;
+};
+
+#endif
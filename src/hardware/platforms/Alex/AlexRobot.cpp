@@ -1,7 +1,26 @@
 #include "AlexRobot.h"
 
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
 #include "DebugMacro.h"
 
+/**
+ * \brief Time base of the trajectories: the simulated time of the drives with SIMULATED, so a
+ * simulation runs at any speed, the monotonic clock otherwise
+ *
+ */
+static void getRobotTime(timespec *time) {
+#ifdef SIMULATED
+    SimulatedDrive::getTime(time);
+#else
+    clock_gettime(CLOCK_MONOTONIC, time);
+#endif
+}
+
 AlexRobot::AlexRobot(AlexTrajectoryGenerator *tj) {
     trajectoryGenerator = tj;
 }
@@ -19,6 +38,7 @@ AlexRobot::~AlexRobot() {
 bool AlexRobot::initPositionControl() {
     DEBUG_OUT("Initialising Position Control on all joints ")
     bool returnValue = true;
+    stopIPControl();
     for (auto p : joints) {
         if (((ActuatedJoint *)p)->setMode(POSITION_CONTROL, posControlMotorProfile) != POSITION_CONTROL) {
             // Something back happened if were are here
@@ -35,12 +55,50 @@ bool AlexRobot::initPositionControl() {
     for (auto p : joints) {
         ((AlexJoint *)p)->enableContinuousProfile();
     }
+    activateSetpointMux(true);
     return returnValue;
 }
 
+bool AlexRobot::initCSPControl() {
+    DEBUG_OUT("Initialising Cyclic Synchronous Position Control on all joints ")
+    bool returnValue = true;
+    stopIPControl();
+    activateSetpointMux(false);
+    for (auto p : joints) {
+        if (((ActuatedJoint *)p)->setMode(CSP_CONTROL) != CSP_CONTROL) {
+            DEBUG_OUT("Failed to initialize Cyclic Synchronous Position Control")
+            returnValue = false;
+        }
+        ((ActuatedJoint *)p)->readyToSwitchOn();
+    }
+    for (auto p : joints) {
+        ((ActuatedJoint *)p)->enable();
+    }
+    if (!returnValue) {
+        initPositionControl();
+        return false;
+    }
+    noOfPreviousSetPoints = 0;
+    return true;
+}
+
+bool AlexRobot::isCSPControl() {
+    return !joints.empty() && ((ActuatedJoint *)joints[0])->getMode() == CSP_CONTROL;
+}
+
+bool AlexRobot::initTrajectoryControl() {
+    // the torque offsets are only applied in cyclic synchronous modes
+    if (TRAJECTORY_CONTROL_MODE == CSP_CONTROL || torqueFeedforward) {
+        return initCSPControl();
+    }
+    return initIPControl();
+}
+
 bool AlexRobot::initTorqueControl() {
     DEBUG_OUT("Initialising Torque Control on all joints ")
     bool returnValue = true;
+    stopIPControl();
+    activateSetpointMux(false);
     for (auto p : joints) {
         if (((ActuatedJoint *)p)->setMode(TORQUE_CONTROL) != TORQUE_CONTROL) {
             // Something back happened if were are here
@@ -58,20 +116,113 @@ bool AlexRobot::initTorqueControl() {
     }
     return returnValue;
 }
+bool AlexRobot::initIPControl() {
+    DEBUG_OUT("Initialising Interpolated Position Control on all joints ")
+    stopIPControl();
+#if defined(VIRTUAL) || defined(SIMULATED)
+    DEBUG_OUT("Virtual drives have no buffers, using position control")
+    initPositionControl();
+    return false;
+#else
+    if (CO_ipBuffer_init(&ipBuffer, CO->SYNC, IP_BUFFER_SIZE, IP_BUFFER_LEAD, IP_BUFFER_BURST) != CO_ERROR_NO) {
+        return false;
+    }
+    for (auto drive : Drives) {
+        int nodeID = drive->getNodeID();
+        // Samples are for all joints, every drive needs its Target Position TPDO and its Buffer Position RPDO
+        if (nodeID < 1 || nodeID > CO_NO_MOTORS ||
+            CO_ipBuffer_addAxis(&ipBuffer, CO_OD_motors[nodeID - 1].targetPosition, CO_OD_motors[nodeID - 1].statusWord,
+                                CO->TPDO, CO_NO_TPDO, CO_OD_motors[nodeID - 1].ipBufferPosition, CO->RPDO, CO_NO_RPDO) != CO_ERROR_NO) {
+            DEBUG_OUT("No Target Position TPDO or Buffer Position RPDO for drive " << nodeID << ", using position control")
+            return false;
+        }
+    }
+    // the buffer sends the points in the Target Position TPDOs
+    activateSetpointMux(false);
+    bool returnValue = true;
+    for (auto p : joints) {
+        ((ActuatedJoint *)p)->setIPBufferSize(IP_BUFFER_SIZE);
+        if (((ActuatedJoint *)p)->setMode(IP_CONTROL) != IP_CONTROL) {
+            DEBUG_OUT("Failed to initialize Interpolated Position Control")
+            returnValue = false;
+        }
+        ((ActuatedJoint *)p)->readyToSwitchOn();
+    }
+    // Pause for a bit to let commands go
+    usleep(2000);
+    for (auto p : joints) {
+        ((ActuatedJoint *)p)->enable();
+    }
+    if (!returnValue) {
+        initPositionControl();
+        return false;
+    }
+    CANrx_taskTmr_setIPbuffer(&ipBuffer);
+    ipControl = true;
+    ipNextSample = 0;
+    ipRunning = false;
+    return true;
+#endif
+}
+
+bool AlexRobot::isIPControl() {
+    return ipControl;
+}
+
+void AlexRobot::stopIPControl() {
+    if (!ipControl) {
+        return;
+    }
+    CANrx_taskTmr_setIPbuffer(NULL);
+    for (auto drive : Drives) {
+        drive->setIPEnabled(false);
+    }
+    ipControl = false;
+    ipRunning = false;
+}
+
 void AlexRobot::startNewTraj() {
     // Index Resetting
     currTrajProgress = 0;
-    clock_gettime(CLOCK_MONOTONIC, &prevTime);
+    getRobotTime(&prevTime);
+    if (tracking.isRunning()) {
+        finishTracking("interrupted");
+    }
+    tracking.start(joints.size());
+    trackingCommandValid = false;
+    if (ipControl) {
+        // Points of an interrupted motion are still in the drive buffers
+        CO_LOCK_OD();
+        bool interrupted = ipBuffer.noOfPushed > 0 && !CO_ipBuffer_isDone(&ipBuffer);
+        CO_ipBuffer_clear(&ipBuffer);
+        CO_UNLOCK_OD();
+        for (auto drive : Drives) {
+            if (interrupted) {
+                drive->clearIPBuffer();
+            } else {
+                drive->setIPEnabled(false);
+            }
+        }
+        ipNextSample = 0;
+        ipRunning = false;
+    }
 }
 
 bool AlexRobot::moveThroughTraj() {
+    if (ipControl) {
+        return moveThroughTrajIP();
+    }
     bool returnValue = true;
     timespec currTime;
-    clock_gettime(CLOCK_MONOTONIC, &currTime);
+    getRobotTime(&currTime);
 
     double elapsedSec = currTime.tv_sec - prevTime.tv_sec + (currTime.tv_nsec - prevTime.tv_nsec) / 1e9;
     double trajTimeUS = trajectoryGenerator->getStepDuration();
     prevTime = currTime;
+    // the feedback of this cycle follows the set points of the previous one
+    if (trackingCommandValid) {
+        updateTracking(trackingCommand);
+    }
     // This should check to make sure that the "GO" button is pressed.
     if (getGo()) {
         currTrajProgress += elapsedSec;
@@ -85,58 +236,411 @@ bool AlexRobot::moveThroughTraj() {
             if (setPosCode == INCORRECT_MODE) {
                 std::cout << "Joint ID: " << p->getId() << ": is not in Position Control " << std::endl;
                 returnValue = false;
+            } else if (setPosCode == STALE_FEEDBACK) {
+                std::cout << "Joint " << p->getId() << ": stale feedback, set point rejected " << std::endl;
+                returnValue = false;
             } else if (setPosCode != SUCCESS) {
                 // Something bad happened
                 std::cout << "Joint " << p->getId() << ": Unknown Error " << std::endl;
                 returnValue = false;
             }
+            trackingCommand[i] = rad2deg(setPoints[i]);
             i++;
         }
+        trackingCommandValid = true;
         //std::cout << std::endl;
+        if (torqueFeedforward && isCSPControl()) {
+            applyTorqueFeedforward(setPoints, elapsedSec);
+        }
     } else {
         //DEBUG_OUT("PRESS Go to go!")
+        noOfPreviousSetPoints = 0;
+    }
+    if (tracking.isRunning() && trajectoryGenerator->isTrajectoryFinished(currTrajProgress)) {
+        finishTracking("done");
     }
 
     return returnValue;
 }
 
+void AlexRobot::updateTracking(const double *commanded) {
+    if (!tracking.isRunning() || jointStates.n != (int)joints.size()) {
+        return;
+    }
+    if (!tracking.update(commanded, jointStates.q, jointStates.valid)) {
+        const TrackingSummary &summary = tracking.getSummary();
+        int i = summary.exceededJoint;
+        DEBUG_OUT("Joint " << joints[i]->getId() << ": following error " << summary.last[i] << " deg, "
+                           << (summary.exceededRms ? "RMS " : "") << "limit exceeded")
+        finishTracking("limit exceeded");
+    }
+}
+
+void AlexRobot::finishTracking(const char *reason) {
+    const TrackingSummary &summary = tracking.finish();
+    uint32_t head = trackingQueueHead;
+    if (head - __atomic_load_n(&trackingQueueTail, __ATOMIC_ACQUIRE) >= TRACKING_QUEUE_SIZE) {
+        __atomic_fetch_add(&trackingQueueOverflows, 1U, __ATOMIC_RELAXED);
+        return;
+    }
+    TrackingRecord &record = trackingQueue[head % TRACKING_QUEUE_SIZE];
+    record.time = time(NULL);
+    record.state = CO_OD_RAM.currentState;
+    record.motion = static_cast<int>(getCurrentMotion());
+    record.reason = reason;
+    record.summary = summary;
+    __atomic_store_n(&trackingQueueHead, head + 1, __ATOMIC_RELEASE);
+}
+
+void AlexRobot::applyTorqueFeedforward(const std::vector<double> &setPoints, double dt) {
+    int n = joints.size();
+    double q[NUM_JOINTS], qd[NUM_JOINTS], qdd[NUM_JOINTS], tau[NUM_JOINTS];
+    for (int i = 0; i < n; i++) {
+        q[i] = rad2deg(setPoints[i]);
+        qd[i] = 0;
+        qdd[i] = 0;
+    }
+    // backward differences of the set points, the trajectory is smooth
+    bool inertia = TORQUE_FEEDFORWARD_INERTIA && noOfPreviousSetPoints == 2 && dt > 0;
+    if (inertia) {
+        for (int i = 0; i < n; i++) {
+            qd[i] = (q[i] - previousSetPoints[0][i]) / dt;
+            qdd[i] = (q[i] - 2 * previousSetPoints[0][i] + previousSetPoints[1][i]) / (dt * dt);
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        previousSetPoints[1][i] = previousSetPoints[0][i];
+        previousSetPoints[0][i] = q[i];
+    }
+    noOfPreviousSetPoints = std::min(noOfPreviousSetPoints + 1, 2);
+
+    // only a leg off the ground follows the model, both feet are on the ground to sit and stand
+    const TrajectoryParameters &trajectory = trajectoryGenerator->getTrajectoryParameters();
+    bool stepping = trajectory.stepType != StepType::Sit && trajectory.stepType != StepType::Stand && trajectory.stepType != StepType::Sitting;
+    bool leftSwing = stepping && trajectory.stance_foot == Foot::Right;
+    bool rightSwing = stepping && trajectory.stance_foot == Foot::Left;
+    dynamics.setPilotParameters(trajectoryGenerator->getPilotParameters());
+    dynamics.setPelvisAngle(trajectory.torso_forward_angle);
+    dynamics.computeTorques(q, qd, qdd, n, tau, inertia);
+
+    for (int i = 0; i < n; i++) {
+        bool left = i == LEFT_HIP || i == LEFT_KNEE || i == LEFT_ANKLE;
+        bool swing = left ? leftSwing : rightSwing;
+        double torque = swing ? tau[i] * description.joints[i].torqueScale : 0;
+        ((ActuatedJoint *)joints[i])->setFeedforward(0, (int)std::lround(torque));
+    }
+}
+
+bool AlexRobot::moveThroughTrajIP() {
+    // Drives take one sample every SYNC period
+    double periodSec = OD_communicationCyclePeriod / 1e6;
+    double trajTimeSec = trajectoryGenerator->getStepDuration();
+    uint32_t noOfSamples = (uint32_t)ceil(trajTimeSec / periodSec) + 1;
+    std::vector<int32_t> sample(joints.size());
+
+    CO_LOCK_OD();
+    uint16_t free = CO_ipBuffer_getFree(&ipBuffer);
+    CO_UNLOCK_OD();
+    // Samples are computed without the OD locked, the realtime task only waits for the pushes
+    for (; free > 0 && ipNextSample < noOfSamples; free--, ipNextSample++) {
+        double fracTrajProgress = std::min(1.0, ipNextSample * periodSec / trajTimeSec);
+        std::vector<double> setPoints = trajectoryGenerator->getSetPoint(fracTrajProgress);
+        for (unsigned int i = 0; i < joints.size(); i++) {
+            sample[i] = ((ActuatedJoint *)joints[i])->toDrivePosition(rad2deg(setPoints[i]));
+        }
+        CO_LOCK_OD();
+        CO_ipBuffer_push(&ipBuffer, sample.data());
+        if (ipNextSample + 1 == noOfSamples) {
+            CO_ipBuffer_finish(&ipBuffer);
+        }
+        CO_UNLOCK_OD();
+    }
+
+    CO_LOCK_OD();
+    uint16_t level = CO_ipBuffer_getMinLevel(&ipBuffer);
+    // Motion shorter than the lead starts, when all its samples are sent
+    bool sent = ipBuffer.finished && CO_ipBuffer_getFree(&ipBuffer) == CO_IP_BUFFER_RING_SIZE;
+    currTrajProgress = CO_ipBuffer_getNoOfTaken(&ipBuffer) * periodSec;
+    CO_UNLOCK_OD();
+
+    // the drives are at the last sample they took
+    if (tracking.isRunning()) {
+        std::vector<double> setPoints = trajectoryGenerator->getSetPoint(std::min(1.0, currTrajProgress / trajTimeSec));
+        for (unsigned int i = 0; i < joints.size(); i++) {
+            trackingCommand[i] = rad2deg(setPoints[i]);
+        }
+        updateTracking(trackingCommand);
+        if (tracking.isRunning() && trajectoryGenerator->isTrajectoryFinished(currTrajProgress)) {
+            finishTracking("done");
+        }
+    }
+
+    // This should check to make sure that the "GO" button is pressed.
+    bool run = getGo() && (ipRunning || level >= IP_BUFFER_LEAD || sent);
+    if (run != ipRunning) {
+        for (auto drive : Drives) {
+            drive->setIPEnabled(run);
+        }
+        ipRunning = run;
+    }
+    return true;
+}
+
 bool AlexRobot::initialiseJoints() {
-    JointKnownPos hipParam{250880, 0, 90, 180};
-    JointKnownPos kneeParam{250880, 0, 90, 0};
-    JointKnownPos ankleParam{0, -800000, 90, 115};
-
-    for (int id = 0; id < 4; id++) {
-        if (id == LEFT_HIP || id == RIGHT_HIP) {
-            Drives.push_back(new CopleyDrive(id + 1));
-            joints.push_back(new AlexJoint(id, jointMinMap[id], jointMaxMap[id], Drives[id], hipParam));
-        } else if (id == LEFT_KNEE || id == RIGHT_KNEE) {
-            Drives.push_back(new CopleyDrive(id + 1));
-            joints.push_back(new AlexJoint(id, jointMinMap[id], jointMaxMap[id], Drives[id], kneeParam));
-        } else {  // is an ankle  ->  CHANGE DRIVE to Ankle drives NOT COPLEY
-            Drives.push_back(new SchneiderDrive(id + 1));
-            joints.push_back(new AlexJoint(id, jointMinMap[id], jointMaxMap[id], Drives[id], ankleParam));
+    std::ifstream file(ROBOT_DESCRIPTION_FILE);
+    if (!file.is_open()) {
+        DEBUG_OUT("No " << ROBOT_DESCRIPTION_FILE << ", using the default description")
+        std::istringstream defaultDescription(ALEX_DEFAULT_DESCRIPTION);
+        description.parse(defaultDescription, "ALEX_DEFAULT_DESCRIPTION");
+    } else if (!description.parse(file, ROBOT_DESCRIPTION_FILE)) {
+        // an invalid file is an error, running another robot than described is not safe
+        return false;
+    }
+    if (description.joints.size() > NUM_JOINTS) {
+        // the trajectory generator plans NUM_JOINTS joints, joint IDs are their indices (see RobotDescription::joints)
+        DEBUG_OUT("Robot description: " << description.joints.size() << " joints, at most " << NUM_JOINTS << " supported")
+        return false;
+    }
+
+    for (auto &jointDescription : description.joints) {
+        Drive *drive = createDrive(jointDescription);
+        if (drive == NULL) {
+            DEBUG_OUT("Joint " << jointDescription.id << ": unknown drive type " << jointDescription.driveType)
+            return false;
+        }
+        if (jointDescription.bus != 0) {
+            DEBUG_OUT("Joint " << jointDescription.id << ": bus " << jointDescription.bus << " not available, drive on bus 0")
+        }
+        // known positions as described, distinct (see RobotDescription::parse()), so the conversion has a finite scale
+        JointKnownPos knownPos{jointDescription.driveA, jointDescription.driveB, jointDescription.jointA, jointDescription.jointB};
+        AlexJoint *joint = new AlexJoint(jointDescription.id, jointDescription.min, jointDescription.max, drive, knownPos);
+        Drives.push_back(drive);
+        joints.push_back(joint);
+
+        // Drives send their position every SYNC, do not control on feedback lost for several cycles
+        joint->setMaxFeedbackAge(jointDescription.maxFeedbackAge >= 0 ? jointDescription.maxFeedbackAge : MAX_FEEDBACK_AGE);
+        if (!jointDescription.calibrationFile.empty()) {
+            if (!joint->loadCalibration(jointDescription.calibrationFile)) {
+                DEBUG_OUT("Joint " << jointDescription.id << ": cannot load calibration " << jointDescription.calibrationFile)
+                return false;
+            }
+        } else {
+            joint->loadCalibration(JOINT_CALIBRATION_DIR "joint" + std::to_string(jointDescription.id) + ".csv");
+        }
+    }
+
+    for (unsigned int i = 0; i < description.joints.size(); i++) {
+        const JointDescription &jointDescription = description.joints[i];
+        torqueFeedforward |= jointDescription.torqueScale != 0;
+        TrackingLimits limits;
+        limits.maxError = jointDescription.maxTrackingError >= 0 ? jointDescription.maxTrackingError : TRACKING_MAX_ERROR;
+        limits.maxRms = jointDescription.maxTrackingRms >= 0 ? jointDescription.maxTrackingRms : TRACKING_MAX_RMS;
+        tracking.setLimits(i, limits);
+    }
+    tracking.minSamples = TRACKING_MIN_SAMPLES;
+
+    JointEstimatorConfig estimator;
+    estimator.setSmoothing(JOINT_ESTIMATOR_SMOOTHING);
+    setJointEstimator(estimator);
+    // joints without SYNC feedback are sampled on the robot time base
+    jointStates.setClock(getRobotTime);
+    return true;
+}
+
+Drive *AlexRobot::createDrive(const JointDescription &joint) {
+#ifdef SIMULATED
+    return new SimulatedDrive(joint.nodeID);
+#else
+    if (joint.driveType == "copley") {
+        return new CopleyDrive(joint.nodeID);
+    } else if (joint.driveType == "schneider") {
+        return new SchneiderDrive(joint.nodeID);
+    } else if (joint.driveType == "simulated") {
+        return new SimulatedDrive(joint.nodeID);
+    }
+    return NULL;
+#endif
+}
+
+bool AlexRobot::isTrackingLimitExceeded() {
+    return tracking.isExceeded();
+}
+
+const TrackingSummary &AlexRobot::getTrackingSummary() {
+    return tracking.getSummary();
+}
+
+void AlexRobot::writeTrackingLog() {
+    uint32_t overflows = __atomic_exchange_n(&trackingQueueOverflows, 0U, __ATOMIC_RELAXED);
+    if (overflows > 0) {
+        std::cout << "Following error: " << overflows << " summaries dropped, queue full" << std::endl;
+    }
+    uint32_t tail = trackingQueueTail;
+    uint32_t head = __atomic_load_n(&trackingQueueHead, __ATOMIC_ACQUIRE);
+    if (tail == head) {
+        return;
+    }
+    std::ofstream log;
+    if (TRACKING_LOG_FILE[0] != '\0') {
+        log.open(TRACKING_LOG_FILE, std::ios::app);
+    }
+    for (; tail != head; tail++) {
+        const TrackingRecord &record = trackingQueue[tail % TRACKING_QUEUE_SIZE];
+        std::ostringstream line;
+        line << "state " << record.state << " motion " << record.motion << " " << record.reason;
+        for (int i = 0; i < record.summary.n; i++) {
+            line << " | " << (description.joints[i].name.empty() ? "joint" + std::to_string(joints[i]->getId()) : description.joints[i].name)
+                 << " rms " << record.summary.rms[i] << " max " << record.summary.max[i];
+        }
+        std::cout << "Following error (deg): " << line.str() << std::endl;
+        if (log.is_open()) {
+            char date[32];
+            strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&record.time));
+            log << date << " " << line.str() << std::endl;
+        }
+        // record read, free for the control loop
+        __atomic_store_n(&trackingQueueTail, tail + 1, __ATOMIC_RELEASE);
+    }
+}
+
+bool AlexRobot::startHoming() {
+    homing.clear();
+    homingJoints.clear();
+    for (unsigned int i = 0; i < description.joints.size(); i++) {
+        const JointDescription &jointDescription = description.joints[i];
+        if (jointDescription.homing == "cia402") {
+            homing.add(Drives[i], new CiA402Homing(jointDescription.homingMethod, jointDescription.homeOffset, HOMING_TIMEOUT));
+        } else if (jointDescription.homing == "hardstop") {
+            homing.add(Drives[i], new HardStopHoming(jointDescription.homingVelocity, HOMING_ACCELERATION, HOMING_STALL_VELOCITY,
+                                                     HOMING_STALL_TIME, HOMING_TIMEOUT));
+        } else {
+            continue;
         }
+        homingJoints.push_back(i);
+    }
+    if (homing.size() == 0) {
+        DEBUG_OUT("No joint with a homing routine in the robot description")
+        return false;
+    }
+    stopIPControl();
+    timespec now;
+    getRobotTime(&now);
+    DEBUG_OUT("Homing " << homing.size() << " joints")
+    homing.start(now);
+    if (!homing.isRunning()) {
+        finishHoming();
     }
     return true;
 }
 
+bool AlexRobot::updateHoming() {
+    if (!homing.isRunning()) {
+        return true;
+    }
+    timespec now;
+    getRobotTime(&now);
+    if (!homing.update(now)) {
+        return false;
+    }
+    finishHoming();
+    return true;
+}
+
+void AlexRobot::stopHoming() {
+    if (homing.isRunning()) {
+        homing.abort("stopped");
+        finishHoming();
+    }
+}
+
+bool AlexRobot::isHoming() {
+    return homing.isRunning();
+}
+
+bool AlexRobot::isHomingSuccessful() {
+    return homing.isSuccessful();
+}
+
+void AlexRobot::finishHoming() {
+    const std::vector<HomingResult> &results = homing.getResults();
+    bool calibrated = false;
+    for (unsigned int k = 0; k < results.size(); k++) {
+        int i = homingJoints[k];
+        const JointDescription &jointDescription = description.joints[i];
+        const HomingResult &result = results[k];
+        std::cout << "Homing " << (jointDescription.name.empty() ? "joint" + std::to_string(joints[i]->getId()) : jointDescription.name);
+        if (result.status != HOMING_DONE) {
+            std::cout << ": failed after " << result.duration << " s, " << result.error << std::endl;
+            continue;
+        }
+        std::cout << ": done in " << result.duration << " s, home at " << result.position << " counts" << std::endl;
+        if (jointDescription.hasHome) {
+            ((AlexJoint *)joints[i])->setHome(result.position, jointDescription.home);
+            calibrated = true;
+        }
+    }
+    // the process image converts with the calibration of the joints, cached when built
+    if (calibrated) {
+        jointStates.build(joints);
+    }
+}
+
+const RobotDescription &AlexRobot::getDescription() {
+    return description;
+}
+
 bool AlexRobot::initialiseNetwork() {
     DEBUG_OUT("AlexRobot::initialiseNetwork()");
-#ifndef VIRTUAL
+#if !defined(VIRTUAL) && !defined(SIMULATED)
     bool status;
     for (auto joint : joints) {
         status = joint->initNetwork();
         if (!status)
             return false;
     }
+    initSetpointMux();
 #endif
     return true;
 }
+bool AlexRobot::initSetpointMux() {
+    activateSetpointMux(false);
+    setpointMuxEnabled = false;
+    if (CO_setpointMux_init(&setpointMux, CO->CANmodule[0], SETPOINT_MUX_COB_ID, SETPOINT_MUX_REPEATS) != CO_ERROR_NO) {
+        return false;
+    }
+    // Drives[i] is the drive of description.joints[i]
+    for (unsigned int i = 0; i < Drives.size(); i++) {
+        Drive *drive = Drives[i];
+        int slot = setpointMux.noOfSlots;
+        int COB_ID = SETPOINT_MUX_COB_ID + slot / CO_SETPOINT_MUX_SLOTS_PER_FRAME;
+        int nodeID = drive->getNodeID();
+        if (!description.joints[i].multiplexedSetpoints ||
+            nodeID < 1 || nodeID > CO_NO_MOTORS || slot >= CO_SETPOINT_MUX_MAX_SLOTS ||
+            !drive->initPackedSetpoints(COB_ID, slot % CO_SETPOINT_MUX_SLOTS_PER_FRAME)) {
+            continue;
+        }
+        if (CO_setpointMux_addSlot(&setpointMux, CO_OD_motors[nodeID - 1].targetPosition, CO->TPDO, CO_NO_TPDO) != CO_ERROR_NO) {
+            DEBUG_OUT("No Target Position TPDO for drive " << nodeID << ", multiplexed setpoints ignored")
+        }
+    }
+    if (setpointMux.noOfSlots == 0) {
+        DEBUG_OUT("No drive supports multiplexed setpoints, using per node PDOs")
+        return false;
+    }
+    setpointMuxEnabled = true;
+    return true;
+}
+void AlexRobot::activateSetpointMux(bool active) {
+    CANrx_taskTmr_setSetpointMux(active && setpointMuxEnabled ? &setpointMux : NULL);
+}
 bool AlexRobot::initialiseInputs() {
     inputs.push_back(new Keyboard());
     return true;
 }
 void AlexRobot::freeMemory() {
+    activateSetpointMux(false);
+    setpointMuxEnabled = false;
+    stopIPControl();
     keyboard.~Keyboard();
     for (auto p : joints) {
         DEBUG_OUT("Delete Joint ID: " << p->getId())
@@ -148,21 +652,71 @@ void AlexRobot::freeMemory() {
     }
 }
 void AlexRobot::updateRobot() {
+#ifdef SIMULATED
+    // one control period of the drives, with the set points of the last cycle
+    SimulatedDrive::stepAll(SIMULATED_STEP);
+#endif
     Robot::updateRobot();
     keyboard.updateInput();
     buttons.updateInput();
+    processCrutchNotifications();
+}
+bool AlexRobot::initCrutchNotifications(CO_SDO_t *SDO) {
+    CO_ODnotify_init(&crutchNotify, SDO);
+    bool returnValue = CO_ODnotify_subscribe(&crutchNotify, OD_6002_currentMovement, 0) == CO_ERROR_NO &&
+                       CO_ODnotify_subscribe(&crutchNotify, OD_6003_nextMovement, 0) == CO_ERROR_NO &&
+                       CO_ODnotify_subscribe(&crutchNotify, OD_6004_goButton, 0) == CO_ERROR_NO;
+    if (!returnValue) {
+        DEBUG_OUT("Crutch OD notifications failed, reading OD entries directly")
+        return false;
+    }
+    goButton = *(&CO_OD_RAM.goButton) == 1;
+    nextMotion = static_cast<RobotMode>(*(&CO_OD_RAM.nextMovement));
+    currentMotion = static_cast<RobotMode>(*(&CO_OD_RAM.currentMovement));
+    crutchNotifyOverflows = 0;
+    crutchNotifyEnabled = true;
+    return true;
+}
+void AlexRobot::processCrutchNotifications() {
+    if (!crutchNotifyEnabled) {
+        return;
+    }
+    CO_ODnotify_event_t event;
+    while (CO_ODnotify_pop(&crutchNotify, &event)) {
+        switch (event.index) {
+            case OD_6002_currentMovement:
+                currentMotion = static_cast<RobotMode>(event.newValue);
+                break;
+            case OD_6003_nextMovement:
+                nextMotion = static_cast<RobotMode>(event.newValue);
+                break;
+            case OD_6004_goButton:
+                goButton = event.newValue == 1;
+                break;
+        }
+    }
+    // Some changes were lost: resynchronise with the OD
+    uint32_t overflows = CO_ODnotify_getOverflows(&crutchNotify);
+    if (overflows != crutchNotifyOverflows) {
+        crutchNotifyOverflows = overflows;
+        goButton = *(&CO_OD_RAM.goButton) == 1;
+        nextMotion = static_cast<RobotMode>(*(&CO_OD_RAM.nextMovement));
+        currentMotion = static_cast<RobotMode>(*(&CO_OD_RAM.currentMovement));
+    }
 }
 double AlexRobot::getCurrTrajProgress() {
     return currTrajProgress;
 }
 std::vector<double> AlexRobot::getJointStates() {
-    std::vector<double> robotJointspace;
-    int i = 0;
-    for (auto joint : joints) {
-        robotJointspace.push_back(joint->getQ());
-        i++;
+    if (jointStates.n != (int)joints.size()) {
+        // not updated yet
+        std::vector<double> robotJointspace;
+        for (auto joint : joints) {
+            robotJointspace.push_back(joint->getQ());
+        }
+        return robotJointspace;
     }
-    return robotJointspace;
+    return std::vector<double>(jointStates.q, jointStates.q + jointStates.n);
 }
 void AlexRobot::bitFlip() {
     for (auto joint : joints) {
@@ -170,16 +724,28 @@ void AlexRobot::bitFlip() {
     }
 }
 void AlexRobot::setCurrentMotion(RobotMode mode) {
-    *(&CO_OD_RAM.currentMovement) = static_cast<int>(mode);
+    if (!crutchNotifyEnabled || !CO_ODnotify_write(&crutchNotify, OD_6002_currentMovement, 0, static_cast<int>(mode))) {
+        *(&CO_OD_RAM.currentMovement) = static_cast<int>(mode);
+    }
+    currentMotion = mode;
 }
 
 RobotMode AlexRobot::getCurrentMotion() {
+    if (crutchNotifyEnabled) {
+        return currentMotion;
+    }
     return static_cast<RobotMode>(*(&CO_OD_RAM.currentMovement));
 }
 void AlexRobot::setNextMotion(RobotMode mode) {
-    *(&CO_OD_RAM.nextMovement) = static_cast<int>(mode);
+    if (!crutchNotifyEnabled || !CO_ODnotify_write(&crutchNotify, OD_6003_nextMovement, 0, static_cast<int>(mode))) {
+        *(&CO_OD_RAM.nextMovement) = static_cast<int>(mode);
+    }
+    nextMotion = mode;
 }
 RobotMode AlexRobot::getNextMotion() {
+    if (crutchNotifyEnabled) {
+        return nextMotion;
+    }
     return static_cast<RobotMode>(*(&CO_OD_RAM.nextMovement));
 }
 void AlexRobot::setCurrentState(AlexState state) {
@@ -187,11 +753,20 @@ void AlexRobot::setCurrentState(AlexState state) {
     //:" << *(&CO_OD_RAM.currentState));
 }
 bool AlexRobot::getGo() {
+    if (crutchNotifyEnabled) {
+        return goButton;
+    }
     if (*(&CO_OD_RAM.goButton) == 1) {
         return true;
     }
     return false;
 }
+void AlexRobot::setGo(bool go) {
+    if (!crutchNotifyEnabled || !CO_ODnotify_write(&crutchNotify, OD_6004_goButton, 0, go ? 1 : 0)) {
+        *(&CO_OD_RAM.goButton) = go ? 1 : 0;
+    }
+    goButton = go;
+}
 
 void AlexRobot::setResetFlag(bool value) {
     resetTrajectory = value;
@@ -202,6 +777,14 @@ bool AlexRobot::getResetFlag() {
     ;
 }
 
+bool AlexRobot::resetDriveFaults() {
+    bool faulted = false;
+    for (auto drive : Drives) {
+        faulted |= drive->resetFault();
+    }
+    return faulted;
+}
+
 bool AlexRobot::disableJoints() {
     bool tmp = true;
     for (auto p : joints) {
@@ -21,21 +21,26 @@
 #include <time.h>
 
 #include <map>
+#include <string>
+#include <vector>
 
+#include "AlexDynamics.h"
 #include "AlexJoint.h"
 #include "AlexTrajectoryGenerator.h"
 #include "CopleyDrive.h"
+#include "HomingEngine.h"
 #include "Keyboard.h"
 #include "Buttons.h"
+#include "CO_Linux_tasks.h"
+#include "CO_ODnotify.h"
 #include "Robot.h"
+#include "RobotDescription.h"
 #include "RobotParams.h"
 #include "SchneiderDrive.h"
+#include "SimulatedDrive.h"
+#include "TrackingMonitor.h"
 #include "pocketBeagle.h"
 
-/**
-     * \todo Load in paramaters and dictionary entries from JSON file.
-     * 
-     */
 /**
  * \brief Example implementation of the Robot class, representing an X2 Exoskeleton, using DummyActuatedJoint and AlexTrajectoryGenerator.
  * 
@@ -55,6 +60,177 @@ class AlexRobot : public Robot {
 
     motorProfile posControlMotorProfile{4000000, 190000, 190000};
 
+    /**
+     * \brief Notifications of changes of the crutch OD entries (goButton, nextMovement, currentMovement),
+     * written by RPDO or SDO and processed in updateRobot().
+     *
+     */
+    CO_ODnotify_t crutchNotify;
+    bool crutchNotifyEnabled = false;
+    uint32_t crutchNotifyOverflows = 0;
+    /** Crutch OD entries, updated from notifications */
+    bool goButton = false;
+    RobotMode nextMotion = RobotMode::INITIAL;
+    RobotMode currentMotion = RobotMode::INITIAL;
+
+    /**
+     * \brief Update the crutch entries from the queued OD change notifications
+     * (or read them all from the OD if notifications were lost).
+     *
+     */
+    void processCrutchNotifications();
+
+    /**
+     * \brief Target positions of the drives with a free RPDO, packed into shared frames (two drives per
+     * frame) instead of one PDO per drive. Enabled if any drive supports them.
+     *
+     */
+    CO_setpointMux_t setpointMux;
+    bool setpointMuxEnabled = false;
+
+    /**
+     * \brief Configure the drives for multiplexed setpoints. Drives which don't support it keep their per
+     * node Target Position PDOs.
+     *
+     * \return true if at least one drive receives multiplexed setpoints
+     */
+    bool initSetpointMux();
+
+    /**
+     * \brief Register the multiplexer with the realtime task, if enabled, in profile position mode only: the
+     * synchronous modes and the interpolation buffer send their points in the per node PDOs
+     *
+     * \param active true in position control, false otherwise
+     */
+    void activateSetpointMux(bool active);
+
+    /**
+     * \brief Joints and drives of the robot, loaded from ROBOT_DESCRIPTION_FILE (ALEX_DEFAULT_DESCRIPTION without it)
+     *
+     */
+    RobotDescription description;
+
+    /**
+     * \brief Create the drive of a joint from its description
+     *
+     * \return Drive* the drive, NULL for an unknown drive type
+     */
+    Drive *createDrive(const JointDescription &joint);
+
+    /**
+     * \brief Samples of the current trajectory, fed into the buffers of the drives in interpolated position
+     * control (see initIPControl()). Registered with the realtime task while the joints are in IP_CONTROL.
+     *
+     */
+    CO_ipBuffer_t ipBuffer;
+    bool ipControl = false;
+    /** Index of the next trajectory sample pushed into ipBuffer */
+    uint32_t ipNextSample = 0;
+    /** True while the drives take points from their buffers */
+    bool ipRunning = false;
+
+    /**
+     * \brief Unregister ipBuffer from the realtime task, before the joints leave IP_CONTROL
+     *
+     */
+    void stopIPControl();
+
+    /**
+     * \brief moveThroughTraj() in interpolated position control: push the trajectory samples ahead of
+     * the drives and start or hold the drives with the Go button
+     *
+     * \return true if successful
+     */
+    bool moveThroughTrajIP();
+
+    /**
+     * \brief Dynamics of the legs, for the torque feedforward of CSP_CONTROL. Enabled if a joint of the
+     * description has a torque scale.
+     *
+     */
+    AlexDynamics dynamics;
+    bool torqueFeedforward = false;
+    /** Set points of the two previous cycles (degrees) and their number, for the trajectory velocity and acceleration */
+    double previousSetPoints[2][NUM_JOINTS];
+    int noOfPreviousSetPoints = 0;
+
+    /**
+     * \brief Send the torque of the swing leg along the trajectory as feedforward of the drives (see
+     * ActuatedJoint::setFeedforward()), zero for the other joints
+     *
+     * \param setPoints Set points of this cycle (radians)
+     * \param dt Time since the previous set points (seconds)
+     */
+    void applyTorqueFeedforward(const std::vector<double> &setPoints, double dt);
+
+    /**
+     * \brief Following error of the joints along the trajectories, one motion per startNewTraj(). Limits from
+     * the description, TRACKING_MAX_ERROR and TRACKING_MAX_RMS without them.
+     *
+     */
+    TrackingMonitor tracking;
+    /** Position commanded by the last moveThroughTraj() (degrees), compared with the feedback of the next one */
+    double trackingCommand[NUM_JOINTS];
+    bool trackingCommandValid = false;
+
+    /**
+     * \brief Compare the commanded positions with the joint positions of the last updateRobot(), and end the
+     * motion when a limit is exceeded
+     *
+     * \param commanded Commanded positions (degrees), indexed as joints
+     */
+    void updateTracking(const double *commanded);
+
+    /**
+     * \brief End the motion of the tracking monitor and queue its summary, printed and appended to
+     * TRACKING_LOG_FILE by writeTrackingLog(): nothing is formatted, locked or written in the control loop
+     *
+     * \param reason Why the motion ended, a string literal, e.g. "done"
+     */
+    void finishTracking(const char *reason);
+
+    /**
+     * \brief Summary of an ended motion, queued by finishTracking()
+     *
+     */
+    struct TrackingRecord {
+        /** Time the motion ended */
+        time_t time;
+        /** State and motion of the robot */
+        int state;
+        int motion;
+        /** Why the motion ended, see finishTracking() */
+        const char *reason;
+        TrackingSummary summary;
+    };
+    /** Records not written yet, a power of 2 */
+    static constexpr uint32_t TRACKING_QUEUE_SIZE = 8;
+    static_assert((TRACKING_QUEUE_SIZE & (TRACKING_QUEUE_SIZE - 1)) == 0, "TRACKING_QUEUE_SIZE must be a power of 2");
+    /**
+     * Lock-free queue of a single producer (finishTracking(), control loop) and a single consumer
+     * (writeTrackingLog(), mainline): each index is written by one side only, and read by the other one
+     * with acquire/release ordering. Records finished while the queue is full are counted and dropped.
+     */
+    TrackingRecord trackingQueue[TRACKING_QUEUE_SIZE];
+    uint32_t trackingQueueHead = 0;
+    uint32_t trackingQueueTail = 0;
+    uint32_t trackingQueueOverflows = 0;
+
+    /**
+     * \brief In-process homing of the joints with a homing routine in the description, all joints at once.
+     * homingJoints[k] is the joint of the k-th drive of the engine.
+     *
+     */
+    HomingEngine homing;
+    std::vector<int> homingJoints;
+
+    /**
+     * \brief Write the home positions found into the calibration of the joints with a home in the description,
+     * and print the result and time of each joint
+     *
+     */
+    void finishHoming();
+
    public:
     AlexRobot();
     /**
@@ -94,6 +270,48 @@ class AlexRobot : public Robot {
    */
     bool initTorqueControl();
 
+    /**
+       * \brief Initialises all joints to interpolated position control mode. Trajectories are then
+       * sampled every SYNC period and fed into the buffers of the drives ahead of time, so
+       * moveThroughTraj() only tops up the samples and the motion tolerates control loop jitter.
+       *
+       * \return true If all joints are successfully configured
+       * \return false  If some or all joints fail the configuration, position control is used then
+       */
+    bool initIPControl();
+
+    /**
+     * \brief Check whether the joints are in interpolated position control (see initIPControl())
+     *
+     */
+    bool isIPControl();
+
+    /**
+       * \brief Initialises all joints to cyclic synchronous position control mode: the set points of
+       * moveThroughTraj() are streamed every cycle, with the gravity and inertia torques of the swing leg
+       * as torque feedforward (see AlexDynamics) for joints with a torque scale in the description.
+       *
+       * \return true If all joints are successfully configured
+       * \return false  If some or all joints fail the configuration, position control is used then
+       */
+    bool initCSPControl();
+
+    /**
+     * \brief Check whether the joints are in cyclic synchronous position control (see initCSPControl())
+     *
+     */
+    bool isCSPControl();
+
+    /**
+       * \brief Initialises all joints to the control mode of the motions from standing up to sitting down
+       * (TRAJECTORY_CONTROL_MODE): interpolated or cyclic synchronous position control, the latter whenever
+       * a joint has torque feedforward (torque scale in the description)
+       *
+       * \return true If all joints are successfully configured
+       * \return false  If some or all joints fail the configuration, position control is used then
+       */
+    bool initTrajectoryControl();
+
     /** 
       * /brief For each joint, move through(send appropriate commands to joints) the currently 
       * generated trajectory of the TrajectoryGenerator object - this assumes the trajectory and robot is in position control. 
@@ -143,6 +361,15 @@ class AlexRobot : public Robot {
        * Example. for a keyboard input this would poll the keyboard for any button presses at this moment in time.
        */
     void updateRobot();
+    /**
+     * \brief Subscribe to changes of the crutch OD entries, so that getGo(), getNextMotion() and
+     * getCurrentMotion() don't read the OD on each call. Must be called in the CANopen communication
+     * reset section (see app_communicationReset()). Without it the entries are read from the OD directly.
+     *
+     * \param SDO SDO server object of the Object Dictionary
+     * \return true if all entries were subscribed
+     */
+    bool initCrutchNotifications(CO_SDO_t *SDO);
     /**
        * \brief getter method for currentTrajectory progress variable.
        *
@@ -191,6 +418,12 @@ class AlexRobot : public Robot {
      */
     bool getGo();
     /**
+     * \brief Set the Go OD entry, as the go button of the crutch would (e.g. from the virtual pocket beagle)
+     *
+     * \param go 
+     */
+    void setGo(bool go);
+    /**
  * \brief Set the Current State object
  * 
  * @param state 
@@ -209,37 +442,68 @@ class AlexRobot : public Robot {
  * \return false 
  */
     bool getResetFlag();
-    /**
-    * \todo Move jointMinMap and jointMaxMap to RobotParams.h
-    * 
-    */
 
    /**
     * \brief disable all joints of the robot, returns true if successful
     * 
     */
    bool disableJoints();
+   /**
+    * \brief reset the fault of the drives which report one, must be called on consecutive cycles
+    * until they leave the fault (see Drive::resetFault())
+    * 
+    * \return true if any drive is still in fault
+    */
+   bool resetDriveFaults();
     /**
-       * \brief Joint Limit Map between Joint value and max Degrees possible
-       * \param int Joint value
-       * \return int maxDeg 
-       */
-    std::map<int, double> jointMinMap = {{LEFT_HIP, 70},
-                                         {LEFT_KNEE, 0},
-                                         {RIGHT_HIP, 70},
-                                         {RIGHT_KNEE, 0},
-                                         {LEFT_ANKLE, 75},
-                                         {RIGHT_ANKLE, 75}};
-    /**
-       * \brief Joint Limit Map between Joint value and max Degrees possible
-       * \param int Joint value
-       * \return int maxDeg 
-       */
-    std::map<int, double> jointMaxMap = {{LEFT_HIP, 210},
-                                         {LEFT_KNEE, 120},
-                                         {RIGHT_HIP, 210},
-                                         {RIGHT_KNEE, 120},
-                                         {LEFT_ANKLE, 105},
-                                         {RIGHT_ANKLE, 105}};
+     * \brief Check whether the following error of the current trajectory exceeded a limit (see TrackingMonitor),
+     * until the next startNewTraj()
+     *
+     */
+    bool isTrackingLimitExceeded();
+    /**
+     * \brief Get the following error of the current, or last, trajectory (degrees)
+     *
+     */
+    const TrackingSummary &getTrackingSummary();
+    /**
+     * \brief Print the summaries queued by the control loop and append them to TRACKING_LOG_FILE. Called from
+     * a non realtime thread (the mainline of the application), without blocking the control loop.
+     *
+     */
+    void writeTrackingLog();
+    /**
+     * \brief Start homing the joints with a homing routine in the description (see HomingEngine), concurrently
+     *
+     * \return true if there are joints to home
+     */
+    bool startHoming();
+    /**
+     * \brief Step the homing routines, once per cycle after updateRobot(). Once all are finished, the
+     * calibration of the joints is updated (see finishHoming()).
+     *
+     * \return true once homing is finished
+     */
+    bool updateHoming();
+    /**
+     * \brief Stop the homing routines still running, as failed
+     *
+     */
+    void stopHoming();
+    /**
+     * \brief Check whether homing is started and not finished
+     *
+     */
+    bool isHoming();
+    /**
+     * \brief Check whether every joint of the last homing was homed
+     *
+     */
+    bool isHomingSuccessful();
+    /**
+     * \brief Get the description the joints and drives were built from
+     *
+     */
+    const RobotDescription &getDescription();
 };
 #endif /*AlexRobot_H*/
\ No newline at end of file
@@ -42,7 +42,8 @@ enum class AlexState { Init,         /**< 0 */
                StepR,        /**< 13 */
                BackStepR,    /**< 14 */
                BackStepL,    /**< 15 */
-               Error         /**< 16 */
+               Error,        /**< 16 */
+               Homing        /**< 17 */
 };
 /**
  * An enum type.
@@ -77,27 +78,112 @@ enum class RobotMode {
 };
 /**
  * 
- * Paramater definitions: Knee motor reading and corresponding angle. Used for mapping between degree and motor values.
+ * Maximum age of the drive position feedback (in SYNC cycles) accepted for control, see ActuatedJoint::setMaxFeedbackAge().
  */
-#define KNEE_MOTOR_POS1 (250880)
-#define KNEE_MOTOR_DEG1 (90)
-#define KNEE_MOTOR_POS2 (0)
-#define KNEE_MOTOR_DEG2 (0)
+#define MAX_FEEDBACK_AGE (3)
 /**
  * 
- * Paramater definitions: Hip motor reading and corresponding angle. Used for mapping between degree and motor values.
+ * Velocity and acceleration estimation of the joints (see JointEstimator): smoothing of the alpha-beta-gamma
+ * filter, from 0 (fastest response) to 1 (exclusive, heaviest smoothing).
  */
-#define HIP_MOTOR_POS1 (250880)
-#define HIP_MOTOR_DEG1 (90)
-#define HIP_MOTOR_POS2 (0)
-#define HIP_MOTOR_DEG2 (180)
+#define JOINT_ESTIMATOR_SMOOTHING (0.5)
 /**
  * 
- * Paramater definitions: Ankle motor reading and corresponding angle. Used for mapping between degree and motor values.
+ * Multiplexed setpoint frames (see CO_setpointMux.h): COB-ID of the first frame, the next ones follow
+ * (0x680-0x6DF is neither restricted by CiA 301 nor used by the predefined connection set or the PDOs of the
+ * Object Dictionary), and number of cycles a frame is repeated after its setpoints stopped changing.
  */
-#define ANKLE_MOTOR_POS1 (0)
-#define ANKLE_MOTOR_DEG1 (90)
-#define ANKLE_MOTOR_POS2 (-800000)
-#define ANKLE_MOTOR_DEG2 (115)
+#define SETPOINT_MUX_COB_ID (0x680)
+#define SETPOINT_MUX_REPEATS (10)
+/**
+ * 
+ * Control mode of the motions from standing up to sitting down (see AlexRobot::initTrajectoryControl()): IP_CONTROL
+ * (trajectory fed ahead into the drive buffers) or CSP_CONTROL (set points streamed every SYNC). CSP_CONTROL is used
+ * anyway if a joint has a torque scale in the description, for the torque feedforward. Profile position control is
+ * used if a drive does not support the mode (e.g. the Schneider drives of the ankles).
+ */
+#define TRAJECTORY_CONTROL_MODE (IP_CONTROL)
+/**
+ * 
+ * Interpolated position mode (see CO_ipBuffer.h): size of the drive buffers, points kept in them
+ * (SYNC periods of tolerance to the control loop) and maximum points sent to a drive per realtime cycle.
+ */
+#define IP_BUFFER_SIZE (16)
+#define IP_BUFFER_LEAD (8)
+#define IP_BUFFER_BURST (2)
+/**
+ * 
+ * Description of the joints and drives (see RobotDescription.h), read at startup from ROBOT_DESCRIPTION_FILE.
+ * Without the file, ALEX_DEFAULT_DESCRIPTION is used: Copley drives on the hips and knees, Schneider drives on the
+ * ankles, known positions (motor counts:degrees) used for mapping between degree and motor values.
+ */
+#define ROBOT_DESCRIPTION_FILE "alex.robot"
+#define ALEX_DESCRIPTION_HIPS_KNEES                                                           \
+    "joint id=0 name=left_hip drive=copley node=1 min=70 max=210 known=250880:90,0:180\n"    \
+    "joint id=1 name=left_knee drive=copley node=2 min=0 max=120 known=250880:90,0:0\n"      \
+    "joint id=2 name=right_hip drive=copley node=3 min=70 max=210 known=250880:90,0:180\n"   \
+    "joint id=3 name=right_knee drive=copley node=4 min=0 max=120 known=250880:90,0:0\n"
+#define ALEX_DESCRIPTION_ANKLES                                                                      \
+    "joint id=4 name=left_ankle drive=schneider node=5 min=75 max=105 known=0:90,-800000:115\n"     \
+    "joint id=5 name=right_ankle drive=schneider node=6 min=75 max=105 known=0:90,-800000:115\n"
+#ifndef _NOANKLES
+#define ALEX_DEFAULT_DESCRIPTION ALEX_DESCRIPTION_HIPS_KNEES ALEX_DESCRIPTION_ANKLES
+#else
+#define ALEX_DEFAULT_DESCRIPTION ALEX_DESCRIPTION_HIPS_KNEES
+#endif
+/**
+ * 
+ * Dynamics of the legs (see AlexDynamics): mass of each segment, pilot and exoskeleton (kg), distance of its centre
+ * of mass from the proximal joint and its radius of gyration about the centre of mass, as fractions of its length.
+ */
+#define ALEX_THIGH_MASS (9.0)
+#define ALEX_SHANK_MASS (4.5)
+#define ALEX_FOOT_MASS (1.5)
+#define ALEX_THIGH_COM (0.433)
+#define ALEX_SHANK_COM (0.433)
+#define ALEX_FOOT_COM (0.5)
+#define ALEX_THIGH_GYRATION (0.323)
+#define ALEX_SHANK_GYRATION (0.302)
+#define ALEX_FOOT_GYRATION (0.475)
+/**
+ * 
+ * Torque feedforward of the swing leg from standing up to sitting down, in CSP_CONTROL (see AlexRobot::initTrajectoryControl()), for joints with a torque scale in
+ * the description: 1 to add the inertia torques of the trajectory to gravity compensation, 0 for gravity only.
+ */
+#define TORQUE_FEEDFORWARD_INERTIA (1)
+/**
+ * 
+ * Directory of the optional calibration tables of the joints (jointN.csv for joint ID N, see JointCalibration::loadTable()),
+ * for joints without a calibration file in the description. Joints without a table use the linear mapping of their known positions.
+ */
+#define JOINT_CALIBRATION_DIR "calibration/"
+/**
+ * 
+ * Following error monitor of the trajectories (see TrackingMonitor), limits in degrees for joints without limits in the
+ * description (0 for none) and samples of a motion before its RMS error is checked. A summary of each motion is appended
+ * to TRACKING_LOG_FILE ("" for none).
+ */
+#define TRACKING_MAX_ERROR (15)
+#define TRACKING_MAX_RMS (6)
+#define TRACKING_MIN_SAMPLES (25)
+#define TRACKING_LOG_FILE "tracking.log"
+/**
+ * 
+ * In-process homing of the joints with a homing routine in the description (see HomingEngine): time after which the
+ * homing of a joint fails (seconds), and the hardstop routine: profile acceleration (drive units), velocity below which
+ * the joint is stalled on its end stop (counts/s, whatever the velocity unit of the drive) and time it must stay stalled
+ * (seconds).
+ */
+#define HOMING_TIMEOUT (30)
+#define HOMING_ACCELERATION (30000)
+#define HOMING_STALL_VELOCITY (2000)
+#define HOMING_STALL_TIME (0.2)
+/**
+ * 
+ * Simulation (build with SIMULATED, see SimulatedDrive.h): time step of the drives per control loop cycle (seconds),
+ * and speed of the control loop relative to real time (e.g. 10 for batch runs ten times faster than real time).
+ */
+#define SIMULATED_STEP (0.008)
+#define SIMULATED_TIME_SCALE (1)
 
 #endif /*ROBOT_PARAMS_H*/
\ No newline at end of file
@@ -16,11 +16,17 @@
 
 AlexJoint::AlexJoint(int jointID, double jointMin, double jointMax, Drive *drive, JointKnownPos jointParams) : ActuatedJoint(jointID, jointMin, jointMax, drive) {
     jointParamaters = jointParams;
+    // conversion computed once, not on each call
+    calibration = JointCalibration(jointParams.motorCountA, jointParams.motorDegPosA, jointParams.motorCountB, jointParams.motorDegPosB);
     DEBUG_OUT("MY JOINT ID: " << this->id)
     // Do nothing else
 }
 
 bool AlexJoint::updateValue() {
+    if (isFeedbackStale()) {
+        // Keep the last value rather than present old feedback as current
+        return false;
+    }
     q = fromDriveUnits(drive->getPos());
     // FOR TESTING w/o real robot -> set current pos to last setPosition
     //q = lastQCommand;
@@ -54,28 +60,33 @@ bool AlexJoint::initNetwork() {
 double AlexJoint::getQ() {
     return q;
 }
-double AlexJoint::fromDriveUnits(int driveValue) {
-    if (A == 0) {
-        //is first run -> calculate + set A and B
-        linearInterpolatePreCalc();
+bool AlexJoint::getLinearConversion(double &scale, double &offset) {
+    if (!calibration.isLinear()) {
+        return false;
     }
-    return (double)(driveValue - B) / A;
+    scale = calibration.getScale();
+    offset = calibration.getOffset();
+    return true;
 }
-int AlexJoint::toDriveUnits(double jointValue) {
-    if (A == 0) {
-        //is first run -> calculate + store A and B
-        linearInterpolatePreCalc();
+bool AlexJoint::loadCalibration(const std::string &fileName) {
+    if (!calibration.loadTable(fileName)) {
+        return false;
     }
-    int output = (int)(A * jointValue + B);
-    return output;
+    DEBUG_OUT("Joint " << this->id << " calibration loaded from " << fileName << ", round trip error " << calibration.getMaxRoundTripError() << " deg")
+    return true;
+}
+const JointCalibration &AlexJoint::getCalibration() {
+    return calibration;
+}
+void AlexJoint::setHome(int driveValue, double jointValue) {
+    calibration.setHome(driveValue, jointValue);
+    DEBUG_OUT("Joint " << this->id << " homed: " << jointValue << " deg at " << driveValue << " counts")
 }
-void AlexJoint::linearInterpolatePreCalc() {
-    long y1 = jointParamaters.motorCountA;
-    long y2 = jointParamaters.motorCountB;
-    long x1 = jointParamaters.motorDegPosA;
-    long x2 = jointParamaters.motorDegPosB;
-    A = 1.0 * (y2 - y1) / (x2 - x1);
-    B = 1.0 * (y1 * x2 - y2 * x1) / (x2 - x1);
+double AlexJoint::fromDriveUnits(int driveValue) {
+    return calibration.fromDriveUnits(driveValue);
+}
+int AlexJoint::toDriveUnits(double jointValue) {
+    return calibration.toDriveUnits(jointValue);
 }
 
 void AlexJoint::bitFlip() {
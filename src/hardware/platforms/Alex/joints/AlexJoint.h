@@ -11,11 +11,16 @@
 #define AlexJoint_H_INCLUDED
 
 #include "ActuatedJoint.h"
+#include "JointCalibration.h"
+/**
+ * \brief Two distinct known positions of the joint, in drive units (motorCount) and degrees (motorDegPos)
+ *
+ */
 typedef struct JointKnownPos {
-    int motorCountA;
-    int motorCountB;
-    int motorDegPosA;
-    int motorDegPosB;
+    double motorCountA;
+    double motorCountB;
+    double motorDegPosA;
+    double motorDegPosB;
 } JointKnownPos;
 /**
  * \brief implementation of the ActuatedJoints class for the Alex Exoskeleton. 
@@ -27,8 +32,11 @@ class AlexJoint : public ActuatedJoint {
    private:
     JointKnownPos jointParamaters;
     double lastQCommand = 0;
-    long A = 0; /* For use in drive and motor unit conversion, differs for each joints implementation*/
-    long B = 0; /* For use in drive and motor unit conversion, differs for each joints implementation*/
+    /**
+     * \brief Conversion between motor counts and joint angles, linear through the jointParamaters
+     * unless a calibration table is loaded (see loadCalibration())
+     */
+    JointCalibration calibration;
 
     /**
      * \brief converter drive motor count value to joint values (angles)
@@ -44,14 +52,6 @@ class AlexJoint : public ActuatedJoint {
      * \return int driver Value for use by this joints Drive object
      */
     int toDriveUnits(double jointValue);
-    /**
-     * \brief precalulate A and B values for faster linear interpolating calculation of y and x in y = Ax+B
-     *  Note: these values are used in determining motor degree position from motor count readings and vice versa.
-     * 
-     * The function uses the specified joints joint Paramaters, set at construction.
-     * 
-     */
-    void linearInterpolatePreCalc();
 
    public:
     AlexJoint(int jointID, double jointMin, double jointMax, Drive *drive, JointKnownPos jointParams);
@@ -59,6 +59,28 @@ class AlexJoint : public ActuatedJoint {
     setMovementReturnCode_t setPosition(double desQ);
     bool initNetwork();
     double getQ();
+    bool getLinearConversion(double &scale, double &offset);
+    /**
+     * \brief Replace the linear conversion of the joint with a table of calibrated points, for a
+     * nonlinear transmission (see JointCalibration::loadTable())
+     * 
+     * \param fileName Path of the calibration file
+     * \return true if the table was loaded, false if the linear conversion is kept
+     */
+    bool loadCalibration(const std::string &fileName);
+    /**
+     * \brief Get the conversion between motor counts and joint angles
+     * 
+     */
+    const JointCalibration &getCalibration();
+    /**
+     * \brief Shift the calibration so that the motor count found by homing reads as the home angle of the joint
+     * (see JointCalibration::setHome())
+     * 
+     * \param driveValue Motor count at the home position
+     * \param jointValue Joint angle of the home position
+     */
+    void setHome(int driveValue, double jointValue);
     /*testing*/
     void bitFlip();
     bool enableContinuousProfile();
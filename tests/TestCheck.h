@@ -0,0 +1,52 @@
+/**
+ * \file TestCheck.h
+ * \author William Campbell
+ * \brief Checks of the test scripts: each check prints OK or FAIL with what it checks, and the script returns
+ * checkSummary(), non-zero if any check failed
+ * \code
+ *  check(value == 1, "value set");
+ *  return checkSummary();
+ * \endcode
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#ifndef TESTCHECK_H_INCLUDED
+#define TESTCHECK_H_INCLUDED
+#include <iostream>
+
+/**
+ * \brief Number of failed checks
+ *
+ */
+inline int &checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+/**
+ * \brief Print the result of a check, counted if it failed
+ *
+ * \param ok Result of the check
+ * \param what What is checked
+ */
+inline void check(bool ok, const char *what) {
+    std::cout << (ok ? "    OK   " : "    FAIL ") << what << std::endl;
+    if (!ok) {
+        checkFailures()++;
+    }
+}
+
+/**
+ * \brief Print whether all checks passed
+ *
+ * \return int Exit code of the script: 0 if all checks passed, 1 otherwise
+ */
+inline int checkSummary() {
+    std::cout << (checkFailures() == 0 ? "All checks passed" : "Some checks FAILED") << std::endl;
+    return checkFailures() == 0 ? 0 : 1;
+}
+
+#endif
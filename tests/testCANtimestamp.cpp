@@ -0,0 +1,134 @@
+/**
+ * \file testCANtimestamp.cpp
+ * \author William Campbell
+ * \brief A script to test the kernel transmit timestamps of the socketCAN driver: delivery, draining of the
+ * socket error queue whatever the number of pending timestamps, and the report when the CAN driver does not
+ * provide them. A UDP socket connected to itself on loopback stands in for the CAN socket.
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "CANopen.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+static int timestamps = 0;
+
+static void onTimestamp(void * /*object*/, const struct timespec *timestamp) {
+    if (timestamp->tv_sec != 0 || timestamp->tv_nsec != 0) {
+        timestamps++;
+    }
+}
+
+/* UDP socket on loopback connected to itself */
+static int loopbackSocket() {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0 || getsockname(fd, (sockaddr *)&addr, &length) != 0 ||
+        connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("loopback socket");
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+/* wait until the socket is reported by poll, as by epoll in the realtime thread */
+static bool readable(int fd) {
+    pollfd p = {fd, POLLIN, 0};
+    return poll(&p, 1, 100) == 1;
+}
+
+int main() {
+    CO_CANmodule_t module;
+    CO_CANtx_t buffer;
+    CO_EM_t em;
+    uint8_t errorStatusBits[10];
+    memset(&module, 0, sizeof(module));
+    memset(&buffer, 0, sizeof(buffer));
+    memset(&em, 0, sizeof(em));
+    memset(errorStatusBits, 0, sizeof(errorStatusBits));
+    em.errorStatusBits = errorStatusBits;
+    em.errorStatusBitsSize = sizeof(errorStatusBits);
+    em.bufEnd = em.buf + sizeof(em.buf);
+    em.bufWritePtr = em.buf;
+    em.bufReadPtr = em.buf;
+    module.em = &em;
+    module.fd = loopbackSocket();
+    buffer.ident = 0x80;
+    buffer.DLC = 1;
+
+    std::cout << "1. Timestamp delivered\n";
+    {
+        check(CO_CANtxTimestampInit(&module, &buffer, NULL, onTimestamp) == CO_ERROR_NO, "timestamps requested");
+        check(CO_CANsend(&module, &buffer) == CO_ERROR_NO && module.txTimestampPending == 1, "sent, timestamp pending");
+        // the frame comes back on loopback, the timestamp on the error queue
+        for (int i = 0; i < 4 && readable(module.fd); i++) {
+            CO_CANrxWait(&module);
+        }
+        check(timestamps == 1 && module.txTimestampPending == 0, "timestamp read from the error queue");
+        check(!readable(module.fd), "socket drained");
+    }
+
+    std::cout << "2. Error queue drained whatever the pending count\n";
+    {
+        timestamps = 0;
+        CO_CANsend(&module, &buffer);
+        CO_CANsend(&module, &buffer);
+        // timestamps not counted, e.g. late ones of a frame sent before the requests stopped
+        module.txTimestampPending = 0;
+        for (int i = 0; i < 8 && readable(module.fd); i++) {
+            CO_CANrxWait(&module);
+        }
+        check(timestamps == 2 && module.txTimestampPending == 0, "both timestamps read");
+        check(!readable(module.fd), "socket not reported again");
+    }
+
+    std::cout << "3. CAN driver without timestamps\n";
+    {
+        // timestamps not read before the next requests, as if the CAN driver did not provide them
+        for (int i = 0; i < 4; i++) {
+            CO_CANsend(&module, &buffer);
+        }
+        check(buffer.txTimestamp && !module.txTimestampDisabled && !CO_isError(&em, CO_EM_CAN_TX_TIMESTAMP), "4 timestamps pending");
+        check(CO_CANsend(&module, &buffer) == CO_ERROR_NO && !buffer.txTimestamp && module.txTimestampDisabled,
+              "requests stopped at the next frame, which is still sent");
+        check(CO_isError(&em, CO_EM_CAN_TX_TIMESTAMP), "emergency reported");
+        timestamps = 0;
+        for (int i = 0; i < 16 && readable(module.fd); i++) {
+            CO_CANrxWait(&module);
+        }
+        check(timestamps == 4 && !readable(module.fd), "late timestamps drained");
+    }
+
+    close(module.fd);
+    return checkSummary();
+}
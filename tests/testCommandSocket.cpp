@@ -0,0 +1,206 @@
+/**
+ * \file testCommandSocket.cpp
+ * \author William Campbell
+ * \brief A script to test the CANopen command socket (CO_command), served in process: several clients connected
+ * at the same time, each one pipelining requests before reading the responses, which may come back in any order.
+ * SDO requests are sent without a node, so they are answered with an error by the SDO thread without a CAN
+ * transfer, in the order of the queue. The throughput of the local commands is printed.
+ * \version 0.1
+ * \date 2020-07-01
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CANopen.h"
+#include "CO_command.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+static char socketPath[] = "/tmp/testCommandSocket";
+
+static int connectClient() {
+    struct sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(struct sockaddr_un));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+    if (fd == -1 || connect(fd, (struct sockaddr *)&addr, sizeof(struct sockaddr_un)) == -1) {
+        perror("Can't connect to command socket");
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+/**
+ * \brief Responses of one client
+ *
+ */
+struct ClientResult {
+    int answered = 0;
+    int expected = 0;
+    bool inOrder = true;
+};
+
+/**
+ * \brief Send all requests of one client, then collect the responses
+ *
+ * \param first Sequence number of the first request, following ones are numbered on
+ * \param expected Beginning of the expected responses, e.g. "OK"
+ */
+static ClientResult runClient(int first, int requests, std::string command, std::string expected) {
+    int fd = connectClient();
+    std::thread writer([=]() {
+        for (int i = 0; i < requests; i++) {
+            std::string req = "[" + std::to_string(first + i) + "] " + command + "\n";
+            if (write(fd, req.c_str(), req.size()) != (ssize_t)req.size()) {
+                perror("write");
+                return;
+            }
+        }
+    });
+
+    ClientResult result;
+    std::vector<bool> answered(requests, false);
+    std::string pending;
+    char buf[4096];
+    int last = -1;
+    ssize_t n;
+    while (result.answered < requests && (n = read(fd, buf, sizeof(buf))) > 0) {
+        /* responses are terminated with "\r\n\0", drop the terminators */
+        for (ssize_t k = 0; k < n; k++) {
+            if (buf[k] != '\0' && buf[k] != '\r') pending.push_back(buf[k]);
+        }
+        size_t eol;
+        while ((eol = pending.find('\n')) != std::string::npos) {
+            std::string line = pending.substr(0, eol);
+            int seq = atoi(line.c_str() + 1) - first;
+            size_t end = line.find("] ");
+            if (line[0] == '[' && seq >= 0 && seq < requests && !answered[seq]) {
+                answered[seq] = true;
+                result.answered++;
+                if (end != std::string::npos && line.compare(end + 2, expected.size(), expected) == 0) {
+                    result.expected++;
+                }
+                if (seq < last) {
+                    result.inOrder = false;
+                }
+                last = seq;
+            }
+            pending.erase(0, eol + 1);
+        }
+    }
+    writer.join();
+    close(fd);
+    return result;
+}
+
+/**
+ * \brief Run clients concurrently, and sum their results
+ *
+ */
+static ClientResult runClients(int clients, int requests, std::string command, std::string expected) {
+    std::vector<std::thread> threads;
+    std::vector<ClientResult> results(clients);
+    for (int c = 0; c < clients; c++) {
+        threads.push_back(std::thread([&, c]() { results[c] = runClient(c * requests, requests, command, expected); }));
+    }
+    ClientResult total;
+    for (int c = 0; c < clients; c++) {
+        threads[c].join();
+        total.answered += results[c].answered;
+        total.expected += results[c].expected;
+        total.inOrder = total.inOrder && results[c].inOrder;
+    }
+    return total;
+}
+
+int main() {
+    // only the SDO client is checked, no SDO transfer is started without a node
+    CO_t co;
+    CO_SDOclient_t SDOclient;
+    memset(&co, 0, sizeof(co));
+    co.SDOclient = &SDOclient;
+    CO = &co;
+    CO_command_socketPath = socketPath;
+    unlink(socketPath);
+    CO_command_init();
+
+    std::cout << "1. Pipelined local commands of concurrent clients\n";
+    {
+        const int clients = 4, requests = 1000;
+        timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        ClientResult result = runClients(clients, requests, "set sdo_timeout 500", "OK");
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double elapsedSec = end.tv_sec - start.tv_sec + (end.tv_nsec - start.tv_nsec) / 1e9;
+        std::cout << "    " << result.answered / elapsedSec << " commands/s" << std::endl;
+        check(result.answered == clients * requests, "every request answered once");
+        check(result.expected == clients * requests, "every request OK");
+    }
+
+    std::cout << "2. Queued SDO requests\n";
+    {
+        const int clients = 4, requests = 100;
+        ClientResult result = runClients(clients, requests, "read 0x1017 0 u16", "ERROR");
+        check(result.answered == clients * requests && result.expected == clients * requests, "every request answered, no default node");
+        check(result.inOrder, "SDO requests of a client answered in order");
+    }
+
+    std::cout << "3. Client hanging up with queued requests\n";
+    {
+        int fd = connectClient();
+        std::string requests;
+        for (int i = 0; i < 100; i++) {
+            requests += "[" + std::to_string(i) + "] read 0x1017 0 u16\n";
+        }
+        check(write(fd, requests.c_str(), requests.size()) == (ssize_t)requests.size(), "requests sent");
+        close(fd);
+        ClientResult result = runClient(0, 10, "set sdo_timeout 500", "OK");
+        check(result.answered == 10 && result.expected == 10, "next client answered");
+    }
+
+    std::cout << "4. Clear and initialise again\n";
+    {
+        // connected clients are disconnected by the clear
+        int idle = connectClient();
+        char response[32];
+        check(write(idle, "[1] set sdo_timeout 500\n", 24) == 24 && read(idle, response, sizeof(response)) > 0, "client connected");
+        check(CO_command_clear() == 0, "cleared with a client connected");
+        check(access(socketPath, F_OK) != 0, "socket removed");
+        char c;
+        check(read(idle, &c, 1) == 0, "client disconnected");
+        close(idle);
+        CO_command_init();
+        ClientResult result = runClient(0, 10, "set sdo_timeout 500", "OK");
+        check(result.answered == 10 && result.expected == 10, "initialised again, client answered");
+        check(CO_command_clear() == 0, "cleared");
+    }
+
+    return checkSummary();
+}
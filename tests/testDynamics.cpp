@@ -0,0 +1,158 @@
+/**
+ * \file testDynamics.cpp
+ * \author William Campbell
+ * \brief A script to test the planar chain dynamics and the Alex leg model, with a benchmark of the torque computation
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <time.h>
+
+#include <cmath>
+#include <iostream>
+
+#include "AlexDynamics.h"
+#include "CANopen.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+typedef PlanarChain<3> Chain;
+
+/* Mass matrix from the inverse dynamics: column j is the torque of a unit acceleration of joint j, less the velocity and gravity torques */
+static Eigen::Matrix3d massMatrix(const Chain &chain, const Chain::Vector &q) {
+    Eigen::Matrix3d M;
+    Chain::Vector zero = Chain::Vector::Zero(), bias, tau;
+    chain.inverseDynamics(q, zero, zero, bias);
+    for (int j = 0; j < 3; j++) {
+        chain.inverseDynamics(q, zero, Chain::Vector::Unit(j), tau);
+        M.col(j) = tau - bias;
+    }
+    return M;
+}
+
+/* Kinetic and potential energy of the chain */
+static double energy(const Chain &chain, const Chain::Vector &q, const Chain::Vector &qd) {
+    double potential = 0, phi = 0, y = 0;
+    for (int i = 0; i < 3; i++) {
+        phi += q[i];
+        potential += chain.links[i].mass * chain.g * (y - chain.links[i].com * std::cos(phi));
+        y -= chain.links[i].length * std::cos(phi);
+    }
+    return 0.5 * qd.dot(massMatrix(chain, q) * qd) + potential;
+}
+
+/* Joint accelerations without torques */
+static Chain::Vector forwardDynamics(const Chain &chain, const Chain::Vector &q, const Chain::Vector &qd) {
+    Chain::Vector bias;
+    chain.inverseDynamics(q, qd, Chain::Vector::Zero(), bias);
+    return massMatrix(chain, q).ldlt().solve(-bias);
+}
+
+int main() {
+    AlexDynamics alex;
+    const Chain &leg = alex.getLeg(true);
+
+    std::cout << "1. Pendulum\n";
+    {
+        PlanarChain<1> pendulum;
+        pendulum.links[0].length = 1;
+        pendulum.links[0].com = 0.5;
+        pendulum.links[0].mass = 2;
+        pendulum.links[0].inertia = 0.1;
+        PlanarChain<1>::Vector q, qd, qdd, tau;
+        q << 0.3;
+        qd << 1.5;
+        qdd << -2;
+        pendulum.inverseDynamics(q, qd, qdd, tau);
+        double expected = (0.1 + 2 * 0.25) * -2 + 2 * 9.81 * 0.5 * std::sin(0.3);
+        check(std::fabs(tau[0] - expected) < 1e-12, "torque is (I + m c^2) qdd + m g c sin(q)");
+    }
+
+    std::cout << "2. Leg model\n";
+    {
+        Chain::Vector q, qd, tauGravity, tau;
+        q << 0.4, -0.7, 1.2;
+        leg.gravityTorques(q, tauGravity);
+        leg.inverseDynamics(q, Chain::Vector::Zero(), Chain::Vector::Zero(), tau);
+        check((tau - tauGravity).norm() < 1e-12, "gravity torques equal inverse dynamics at rest");
+
+        // gravity torques are the gradient of the potential energy
+        bool gradient = true;
+        for (int j = 0; j < 3; j++) {
+            Chain::Vector h = 1e-6 * Chain::Vector::Unit(j);
+            double dV = (energy(leg, q + h, Chain::Vector::Zero()) - energy(leg, q - h, Chain::Vector::Zero())) / 2e-6;
+            gradient &= std::fabs(dV - tauGravity[j]) < 1e-5;
+        }
+        check(gradient, "gravity torques are the gradient of the potential energy");
+
+        Eigen::Matrix3d M = massMatrix(leg, q);
+        check((M - M.transpose()).norm() < 1e-12 && M.llt().info() == Eigen::Success, "mass matrix symmetric and positive definite");
+
+        // swinging freely, the energy is conserved only with the right velocity torques (RK4)
+        qd << 2, -3, 1;
+        double e0 = energy(leg, q, qd), dt = 1e-4;
+        for (int k = 0; k < 10000; k++) {
+            Chain::Vector k1q = qd, k1v = forwardDynamics(leg, q, qd);
+            Chain::Vector k2q = qd + dt / 2 * k1v, k2v = forwardDynamics(leg, q + dt / 2 * k1q, k2q);
+            Chain::Vector k3q = qd + dt / 2 * k2v, k3v = forwardDynamics(leg, q + dt / 2 * k2q, k3q);
+            Chain::Vector k4q = qd + dt * k3v, k4v = forwardDynamics(leg, q + dt * k3q, k4q);
+            q += dt / 6 * (k1q + 2 * k2q + 2 * k3q + k4q);
+            qd += dt / 6 * (k1v + 2 * k2v + 2 * k3v + k4v);
+        }
+        check(std::fabs(energy(leg, q, qd) - e0) < 1e-6 * std::fabs(e0) + 1e-6, "energy conserved over 1 s of free swing");
+    }
+
+    std::cout << "3. Alex joints\n";
+    {
+        double q[6] = {180, 0, 180, 0, 90, 90}, zero[6] = {0}, tau[6];
+        alex.computeTorques(q, zero, zero, 6, tau, false);
+        check(std::fabs(tau[LEFT_KNEE] + ALEX_FOOT_MASS * 9.81 * ALEX_FOOT_COM * 0.3) < 1e-9 && tau[LEFT_KNEE] == tau[RIGHT_KNEE],
+              "straight legs: the knees hold the feet with an extension torque");
+        double sitting[6] = {90, 90, 90, 90, 90, 90};
+        alex.computeTorques(sitting, zero, zero, 6, tau, false);
+        double thigh = ALEX_THIGH_MASS * ALEX_THIGH_COM * 0.44 + (ALEX_SHANK_MASS + ALEX_FOOT_MASS) * 0.44;
+        check(std::fabs(tau[LEFT_HIP] + 9.81 * (thigh + ALEX_FOOT_MASS * ALEX_FOOT_COM * 0.3)) < 1e-9,
+              "thigh horizontal: the hip holds the leg with a flexion torque");
+        alex.computeTorques(sitting, zero, zero, 4, tau, false);
+        check(std::fabs(tau[LEFT_HIP] + 9.81 * (thigh + ALEX_FOOT_MASS * ALEX_FOOT_COM * 0.3)) < 1e-9, "without ankles the foot is held at 90 degrees");
+    }
+
+    std::cout << "4. Benchmark\n";
+    {
+        const int runs = 1000000;
+        double q[6] = {160, 30, 170, 10, 95, 85}, qd[6] = {20, -40, 10, 5, 0, 3}, qdd[6] = {100, -50, 30, 0, 10, 0}, tau[6];
+        double sum = 0;
+        timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int k = 0; k < runs; k++) {
+            q[0] = 160 + (k & 15);
+            alex.computeTorques(q, qd, qdd, 6, tau);
+            sum += tau[0];
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double us = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / 1e3 / runs;
+        std::cout << "    " << us << " us per computeTorques() of 6 joints (" << sum << ")" << std::endl;
+        // Eigen is only fast with optimisation, the time is checked in optimised builds
+#ifdef __OPTIMIZE__
+        check(us < 5, "inverse dynamics of both legs in a few microseconds");
+#endif
+    }
+
+    return checkSummary();
+}
@@ -0,0 +1,220 @@
+/**
+ * \file testHoming.cpp
+ * \author William Campbell
+ * \brief A script to test the in-process homing: CiA 402 homing and hard stop routines of several drives at once,
+ * against drives emulated on their Object Dictionary, and the calibration shift of the home position
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <cmath>
+#include <iostream>
+
+#include "CANopen.h"
+#include "HomingEngine.h"
+#include "JointCalibration.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+/**
+ * Drive emulated on its Object Dictionary entries: follows the power drive state machine from the control word,
+ * homes in homingTime (or reports a homing error), or moves in velocity mode until an end stop
+ */
+class TestDrive : public Drive {
+   public:
+    bool homingSupported = true;
+    bool enables = true;
+    double homingTime = 0.5;
+    bool homingError = false;
+    int endStop = 5000;
+    ControlMode mode = UNCONFIGURED;
+    double homingSince = -1;
+    /* homing attained of a previous homing, cleared a cycle after homing starts */
+    bool previousAttained = false;
+    /* counts/s per velocity unit */
+    double velocityUnit = 1;
+
+    TestDrive(int NodeID) : Drive(NodeID) {
+        *motorOD->statusWord = 0x40;
+        *motorOD->controlWord = 0;
+        *motorOD->actualPosition = 0;
+        *motorOD->actualVelocity = 0;
+        *motorOD->targetVelocity = 0;
+    }
+    bool Init() { return true; }
+    bool initPosControl(motorProfile) { return true; }
+    bool initVelControl(motorProfile) {
+        mode = VELOCITY_CONTROL;
+        return true;
+    }
+    bool initTorqueControl() { return true; }
+    bool initCSPControl(uint32_t) { return true; }
+    bool initCSVControl() { return true; }
+    bool initCSTControl() { return true; }
+    bool initIPControl(uint16_t) { return true; }
+    bool initHomingControl(int8_t, int32_t) {
+        mode = HOMING_CONTROL;
+        return homingSupported;
+    }
+    int getPos() { return *motorOD->actualPosition; }
+    double getVelocityUnit() { return velocityUnit; }
+
+    /* one step of the drive, dt seconds at time t */
+    void step(double t, double dt) {
+        uint16_t controlWord = *motorOD->controlWord, state = 0x40;
+        if (enables && (controlWord & 0x0F) == 0x0F) {
+            state = 0x27;
+        } else if (enables && (controlWord & 0x0F) == 0x06) {
+            state = 0x21;
+        }
+        if (state == 0x27 && mode == HOMING_CONTROL && (controlWord & 0x10)) {
+            if (homingSince < 0) {
+                homingSince = t;
+            } else {
+                previousAttained = false;
+            }
+            if (homingError && t - homingSince >= homingTime) {
+                state |= 0x2000;
+            } else if (t - homingSince >= homingTime) {
+                *motorOD->actualPosition = 0;
+                state |= 0x1400;
+            }
+        }
+        if (previousAttained) {
+            state |= 0x1400;
+        }
+        if (state == 0x27 && mode == VELOCITY_CONTROL) {
+            int velocity = *motorOD->targetVelocity;
+            int position = *motorOD->actualPosition + (int)std::lround(velocity * velocityUnit * dt);
+            if (position >= endStop) {
+                position = endStop;
+                velocity = 0;
+            }
+            *motorOD->actualPosition = position;
+            *motorOD->actualVelocity = velocity;
+        }
+        *motorOD->statusWord = state;
+    }
+};
+
+/* run the engine with the drives until it finishes or maxTime, 10 ms cycles */
+static double run(HomingEngine &engine, TestDrive **drives, int n, double maxTime) {
+    timespec now = {100, 0};
+    engine.start(now);
+    double t = 0;
+    for (; t < maxTime; t += 0.01) {
+        for (int i = 0; i < n; i++) {
+            drives[i]->step(t, 0.01);
+        }
+        now.tv_sec = 100 + (time_t)std::floor(t);
+        now.tv_nsec = (long)std::lround((t - std::floor(t)) * 1e9);
+        if (engine.update(now)) {
+            break;
+        }
+    }
+    return t;
+}
+
+int main() {
+    std::cout << "1. Home position in the calibration\n";
+    {
+        JointCalibration linear(250880, 90, 0, 180);
+        linear.setHome(1000, 180);
+        check(std::fabs(linear.fromDriveUnits(1000) - 180) < 1e-9 && std::fabs(linear.getScale() + 90.0 / 250880) < 1e-15,
+              "linear: home read as its joint value, scale kept");
+        JointCalibration table;
+        table.setTable({0, 100, 300}, {0, 10, 20});
+        table.setHome(1150, 15);
+        check(std::fabs(table.fromDriveUnits(1150) - 15) < 1e-9 && std::fabs(table.fromDriveUnits(1050) - 10) < 1e-9,
+              "table: shifted, shape kept");
+    }
+
+    std::cout << "2. CiA 402 homing of several drives\n";
+    {
+        TestDrive a(1), b(2), c(3);
+        b.homingTime = 0.3;
+        b.homingError = true;
+        c.homingTime = 0.2;
+        *c.getMotorOD()->actualPosition = 777;
+        // c still reports the homing attained of a previous homing
+        c.previousAttained = true;
+        TestDrive *drives[3] = {&a, &b, &c};
+        HomingEngine engine;
+        for (TestDrive *drive : drives) {
+            engine.add(drive, new CiA402Homing(35, 0, 5));
+        }
+        run(engine, drives, 3, 10);
+        const std::vector<HomingResult> &results = engine.getResults();
+        check(!engine.isRunning() && results.size() == 3, "all routines finished");
+        check(results[0].status == HOMING_DONE && results[0].position == 0 && results[0].duration > 0.5 && results[0].duration < 0.6,
+              "homed, in the time of the drive plus enabling");
+        check(results[1].status == HOMING_FAILED && results[1].error.find("homing error") != std::string::npos && results[1].duration < 0.5,
+              "homing error of the drive, the others still run");
+        check(results[2].status == HOMING_DONE && results[2].position == 0 && results[2].duration > 0.2,
+              "homing attained of the previous homing ignored");
+        check((*a.getMotorOD()->controlWord & 0x10) == 0 && (*b.getMotorOD()->controlWord & 0x10) == 0, "homing stopped (control word bit 4)");
+        check(!engine.isSuccessful(), "not successful with a failed drive");
+    }
+
+    std::cout << "3. Hard stop\n";
+    {
+        TestDrive a(4);
+        TestDrive *drives[1] = {&a};
+        HomingEngine engine;
+        engine.add(&a, new HardStopHoming(10000, 30000, 2000, 0.2, 5));
+        double t = run(engine, drives, 1, 10);
+        const HomingResult &result = engine.getResults()[0];
+        check(result.status == HOMING_DONE && result.position == 5000 && *a.getMotorOD()->targetVelocity == 0,
+              "stalled on the end stop, velocity back to 0");
+        check(t > 0.5 + 0.2 && t < 1, "after the move and the stall time");
+        check(engine.isSuccessful(), "successful");
+
+        // 15000 units of 0.1 counts/s are below the stall velocity of 2000 counts/s
+        TestDrive b(7);
+        b.velocityUnit = 0.1;
+        drives[0] = &b;
+        HomingEngine slow;
+        slow.add(&b, new HardStopHoming(15000, 30000, 2000, 0.2, 5));
+        run(slow, drives, 1, 10);
+        check(slow.getResults()[0].status == HOMING_DONE && slow.getResults()[0].position < 5000,
+              "stall velocity in counts/s, whatever the velocity unit of the drive");
+    }
+
+    std::cout << "4. Failures\n";
+    {
+        TestDrive a(5), b(6);
+        a.homingSupported = false;
+        b.enables = false;
+        TestDrive *drives[2] = {&a, &b};
+        HomingEngine engine;
+        engine.add(&a, new CiA402Homing(35, 0, 1));
+        engine.add(&b, new CiA402Homing(35, 0, 1));
+        timespec now = {0, 0};
+        check(!engine.start(now) && engine.getResults()[0].status == HOMING_FAILED && engine.isRunning(),
+              "unsupported drive fails at start, the others run");
+        run(engine, drives + 1, 1, 10);
+        check(engine.getResults()[1].status == HOMING_FAILED && engine.getResults()[1].error == "timeout", "drive never enabled: timeout");
+
+        engine.start(now);
+        engine.abort("stopped");
+        check(!engine.isRunning() && engine.getResults()[1].error == "stopped", "abort");
+    }
+
+    return checkSummary();
+}
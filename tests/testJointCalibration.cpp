@@ -0,0 +1,127 @@
+/**
+ * \file testJointCalibration.cpp
+ * \author William Campbell
+ * \brief A script to test the round trip guarantees of JointCalibration, for linear and table calibrations:
+ * toDriveUnits(fromDriveUnits(c)) == c for every count, and |fromDriveUnits(toDriveUnits(q)) - q| at most
+ * getMaxRoundTripError(), around the segment edges of the tables too
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "CANopen.h"
+#include "JointCalibration.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+/* counts checked: every count of a range around 0, the 32 bit limits, and random counts of the 32 bit range */
+static std::vector<int> testCounts(const std::vector<double> &edges) {
+    std::vector<int> counts;
+    for (int c = -300000; c <= 300000; c++) {
+        counts.push_back(c);
+    }
+    for (int c = 0; c < 1000; c++) {
+        counts.push_back(INT32_MIN + c);
+        counts.push_back(INT32_MAX - c);
+    }
+    for (double edge : edges) {
+        for (int c = -1000; c <= 1000; c++) {
+            counts.push_back((int)std::floor(edge) + c);
+        }
+    }
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> any(INT32_MIN, INT32_MAX);
+    for (int i = 0; i < 1000000; i++) {
+        counts.push_back(any(generator));
+    }
+    return counts;
+}
+
+/* check both guarantees of a calibration, edges are the drive values of the table points */
+static void checkRoundTrip(const JointCalibration &calibration, const std::vector<double> &edges, const std::string &name) {
+    int countErrors = 0;
+    for (int c : testCounts(edges)) {
+        if (calibration.toDriveUnits(calibration.fromDriveUnits(c)) != c) {
+            if (countErrors++ == 0) {
+                std::cout << "    count " << c << " read back as " << calibration.toDriveUnits(calibration.fromDriveUnits(c)) << std::endl;
+            }
+        }
+    }
+    check(countErrors == 0, (name + ": toDriveUnits(fromDriveUnits(c)) == c").c_str());
+
+    // joint values in the 32 bit range, around the points of the table and in between
+    double low = std::min(calibration.fromDriveUnits(INT32_MIN + 1), calibration.fromDriveUnits(INT32_MAX - 1));
+    double high = std::max(calibration.fromDriveUnits(INT32_MIN + 1), calibration.fromDriveUnits(INT32_MAX - 1));
+    std::vector<double> values;
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> any(low, high), near(-1, 1);
+    for (int i = 0; i < 1000000; i++) {
+        values.push_back(any(generator));
+    }
+    for (double edge : edges) {
+        double q = calibration.fromDriveUnits((int)std::lround(edge));
+        for (int i = 0; i < 10000; i++) {
+            values.push_back(q + near(generator) * 10 * calibration.getMaxRoundTripError());
+        }
+    }
+    double maxError = 0;
+    for (double q : values) {
+        maxError = std::max(maxError, std::fabs(calibration.fromDriveUnits(calibration.toDriveUnits(q)) - q));
+    }
+    std::cout << "    largest error " << maxError << ", bound " << calibration.getMaxRoundTripError() << std::endl;
+    // the bound is half a count, plus the rounding of the double computation
+    check(maxError <= calibration.getMaxRoundTripError() * (1 + 1e-9), (name + ": joint round trip within getMaxRoundTripError()").c_str());
+}
+
+int main() {
+    std::cout << "1. Linear calibrations\n";
+    {
+        checkRoundTrip(JointCalibration(250880, 90, 0, 180), {}, "250880 counts per 90 degrees, decreasing");
+        checkRoundTrip(JointCalibration(-1000, -0.5, 3000, 1.5), {}, "2000 counts per unit, offset");
+        checkRoundTrip(JointCalibration(), {}, "identity");
+    }
+
+    std::cout << "2. Table calibrations\n";
+    {
+        JointCalibration increasing;
+        std::vector<double> drive = {0, 100, 300, 1000, 250000};
+        check(increasing.setTable(drive, {0, 10, 20, 50, 90}), "increasing table set");
+        checkRoundTrip(increasing, drive, "increasing table");
+
+        JointCalibration decreasing;
+        drive = {-50000.5, -1200.25, 0, 4000.75, 90000};
+        check(decreasing.setTable(drive, {120, 100, 95, 30, -45}), "decreasing table with fractional points set");
+        checkRoundTrip(decreasing, drive, "decreasing table");
+
+        // home shifts the points by a fraction of a count
+        // joint value 60 is at drive value 35/65 * 4000.75 between the points (0, 95) and (4000.75, 30)
+        decreasing.setHome(1000, 60);
+        const double shift = 1000 - 35.0 / 65 * 4000.75;
+        for (double &d : drive) {
+            d += shift;
+        }
+        checkRoundTrip(decreasing, drive, "decreasing table, homed");
+    }
+
+    return checkSummary();
+}
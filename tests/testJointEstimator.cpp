@@ -0,0 +1,125 @@
+/**
+ * \file testJointEstimator.cpp
+ * \author William Campbell
+ * \brief A script to test the joint velocity and acceleration estimators on known motions
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "CANopen.h"
+#include "JointEstimator.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+/* Track q = a t^2 / 2 sampled every dt (every third sample missed if requested), return the errors of the last estimate */
+static void trackParabola(JointEstimatorConfig config, double a, bool missSamples, double noise, double &qdError, double &qddError) {
+    JointEstimator estimator;
+    estimator.configure(config);
+    std::mt19937 generator(1);
+    std::normal_distribution<double> distribution(0, noise > 0 ? noise : 1);
+    double dt = 0.01, last = 0;
+    double sumQd = 0, sumQdd = 0;
+    int n = 0;
+    for (int k = 0; k <= 400; k++) {
+        double t = k * dt;
+        if (missSamples && k % 3 == 2) {
+            continue;
+        }
+        double q = a * t * t / 2 + (noise > 0 ? distribution(generator) : 0);
+        estimator.update(q, a * t, t - last);
+        last = t;
+        if (k > 200) {
+            sumQd += std::fabs(estimator.qd - a * t);
+            sumQdd += std::fabs(estimator.qdd - a);
+            n++;
+        }
+    }
+    qdError = sumQd / n;
+    qddError = sumQdd / n;
+}
+
+int main() {
+    double qdError, qddError;
+
+    std::cout << "1. Finite differences\n";
+    {
+        JointEstimatorConfig config;
+        config.mode = ESTIMATOR_DIFFERENCE;
+        trackParabola(config, 10, false, 0, qdError, qddError);
+        check(qdError < 0.06 && qddError < 1e-6, "velocity lags half a sample, exact acceleration");
+        config.useDriveVelocity = true;
+        trackParabola(config, 10, false, 0, qdError, qddError);
+        check(qdError < 1e-9, "drive velocity used as is");
+    }
+
+    std::cout << "2. Alpha-beta-gamma filter\n";
+    {
+        JointEstimatorConfig config;
+        config.mode = ESTIMATOR_ALPHA_BETA;
+        config.setSmoothing(0.5);
+        trackParabola(config, 10, false, 0, qdError, qddError);
+        check(qdError < 1e-6 && qddError < 1e-6, "no lag on constant acceleration");
+        trackParabola(config, 10, true, 0, qdError, qddError);
+        check(qdError < 1e-3 && qddError < 1e-3, "samples missed: irregular intervals tracked");
+
+        double noisyDifference, smoothed;
+        JointEstimatorConfig difference;
+        difference.mode = ESTIMATOR_DIFFERENCE;
+        trackParabola(difference, 10, false, 0.01, noisyDifference, qddError);
+        config.setSmoothing(0.8);
+        trackParabola(config, 10, false, 0.01, smoothed, qddError);
+        check(smoothed < noisyDifference / 2, "noise reduced compared to differences");
+    }
+
+    std::cout << "3. Kalman filter\n";
+    {
+        JointEstimatorConfig config;
+        config.mode = ESTIMATOR_KALMAN;
+        config.positionVariance = 1e-4;
+        config.jerkDensity = 100;
+        trackParabola(config, 10, false, 0.01, qdError, qddError);
+        double positionOnly = qdError;
+        JointEstimatorConfig difference;
+        difference.mode = ESTIMATOR_DIFFERENCE;
+        double noisyDifference;
+        trackParabola(difference, 10, false, 0.01, noisyDifference, qddError);
+        check(positionOnly < noisyDifference / 2, "noise reduced compared to differences");
+        config.useDriveVelocity = true;
+        config.velocityVariance = 1e-4;
+        trackParabola(config, 10, true, 0.01, qdError, qddError);
+        check(qdError < positionOnly, "drive velocity improves the estimate");
+    }
+
+    std::cout << "4. Restart\n";
+    {
+        JointEstimator estimator;
+        JointEstimatorConfig config;
+        estimator.configure(config);
+        estimator.update(1, 0, 0.01);
+        estimator.update(2, 0, 0.01);
+        estimator.update(5, 0, 10);
+        check(estimator.q == 5 && estimator.qd == 0 && estimator.qdd == 0, "gap longer than maxInterval restarts");
+    }
+
+    return checkSummary();
+}
@@ -40,10 +40,10 @@ int main() {
     cout << "current OD position : " << testDrive->getPos() << std::endl;
     testDrive->setPos(10);
     cout << "current OD position : " << testDrive->getPos() << std::endl;
-    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor1: " << CO_OD_RAM.targetMotorPositions.motor1 << std::endl;
-    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor2: " << CO_OD_RAM.targetMotorPositions.motor2 << std::endl;
-    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor3: " << CO_OD_RAM.targetMotorPositions.motor3 << std::endl;
-    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor4: " << CO_OD_RAM.targetMotorPositions.motor4 << std::endl;
-    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor5: " << CO_OD_RAM.targetMotorPositions.motor5 << std::endl;
-    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor6: " << CO_OD_RAM.targetMotorPositions.motor6 << std::endl;
+    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor[0]: " << CO_OD_RAM.targetMotorPositions.motor[0] << std::endl;
+    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor[1]: " << CO_OD_RAM.targetMotorPositions.motor[1] << std::endl;
+    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor[2]: " << CO_OD_RAM.targetMotorPositions.motor[2] << std::endl;
+    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor[3]: " << CO_OD_RAM.targetMotorPositions.motor[3] << std::endl;
+    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor[4]: " << CO_OD_RAM.targetMotorPositions.motor[4] << std::endl;
+    cout << "Read Specifically from CO_OD_RAM.targetMotorPositions.motor[5]: " << CO_OD_RAM.targetMotorPositions.motor[5] << std::endl;
 }
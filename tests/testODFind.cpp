@@ -0,0 +1,149 @@
+/**
+ * \file testODFind.cpp
+ * \author William Campbell
+ * \brief A script to check and benchmark CO_OD_find() with the generated index table (CO_OD_index.c)
+ * against the binary search of the sorted Object Dictionary.
+ *
+ * Two workloads are timed:
+ *  - SDO scan: every index 0x0000-0xFFFF is looked up, as an SDO client scanning the dictionary does.
+ *  - PDO remapping: every object mapped in the 32 RPDOs and 32 TPDOs is resolved as CO_PDOfindMap()
+ *    does (find, attribute, length and data pointer).
+ *
+ * Usage: testODFind [repetitions]
+ * \version 0.1
+ * \date 2020-07-01
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <stdlib.h>
+#include <time.h>
+
+#include <iostream>
+
+#include "CANopen.h"
+
+extern const CO_OD_entry_t CO_OD[CO_OD_NoOfElements];
+extern const CO_OD_index_t CO_OD_index;
+
+static CO_OD_extension_t ODExtensions[CO_OD_NoOfElements];
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+static double elapsed(const timespec &start, const timespec &end) {
+    return end.tv_sec - start.tv_sec + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/**
+ * \brief Look up every index, return the number of existing entries (to keep the work from being optimised out)
+ */
+static unsigned long scan(CO_SDO_t *SDO, int repetitions) {
+    unsigned long found = 0;
+    for (int r = 0; r < repetitions; r++) {
+        for (uint32_t index = 0; index <= 0xFFFF; index++) {
+            found += CO_OD_find(SDO, (uint16_t)index) != 0xFFFF;
+        }
+    }
+    return found;
+}
+
+/**
+ * \brief Resolve every mapped object of every PDO, return the total mapped length
+ */
+static unsigned long remap(CO_SDO_t *SDO, int repetitions) {
+    unsigned long length = 0;
+    for (int r = 0; r < repetitions; r++) {
+        for (int pdo = 0; pdo < 64; pdo++) {
+            /* RPDO and TPDO mapping parameters have the same layout */
+            const OD_RPDOMappingParameter_t *map = pdo < 32 ? &OD_RPDOMappingParameter[pdo]
+                                                            : (const OD_RPDOMappingParameter_t *)&OD_TPDOMappingParameter[pdo - 32];
+            const uint32_t *mapped = &map->mappedObject1;
+            for (int i = 0; i < map->numberOfMappedObjects && i < 8; i++) {
+                uint16_t index = (uint16_t)(mapped[i] >> 16);
+                uint8_t subIndex = (uint8_t)(mapped[i] >> 8);
+                uint16_t entryNo = CO_OD_find(SDO, index);
+                if (entryNo == 0xFFFF || subIndex > SDO->OD[entryNo].maxSubIndex) {
+                    continue;
+                }
+                if (CO_OD_getAttribute(SDO, entryNo, subIndex) & CO_ODA_RPDO_MAPABLE &&
+                    CO_OD_getDataPointer(SDO, entryNo, subIndex) != NULL) {
+                    length += CO_OD_getLength(SDO, entryNo, subIndex);
+                }
+            }
+        }
+    }
+    return length;
+}
+
+int main(int argc, char *argv[]) {
+    int repetitions = argc > 1 ? atoi(argv[1]) : 100;
+
+    CO_SDO_t SDO = {};
+    SDO.OD = CO_OD;
+    SDO.ODSize = CO_OD_NoOfElements;
+    SDO.ODExtensions = ODExtensions;
+
+    /* The index table must agree with the binary search for every possible index */
+    if (CO_OD_setIndex(&SDO, &CO_OD_index) != CO_ERROR_NO) {
+        std::cout << "Index table does not match CO_OD[], run tools/ODGenerator/genODIndex.py" << std::endl;
+        return 1;
+    }
+    for (uint32_t index = 0; index <= 0xFFFF; index++) {
+        SDO.ODIndex = &CO_OD_index;
+        uint16_t indexed = CO_OD_find(&SDO, (uint16_t)index);
+        SDO.ODIndex = NULL;
+        if (indexed != CO_OD_find(&SDO, (uint16_t)index)) {
+            std::cout << "Mismatch for index 0x" << std::hex << index << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Index table matches binary search for all " << 0x10000 << " indexes" << std::endl;
+
+    /* An entry of the table pointing to another index is not trusted, the index is searched */
+    static uint16_t entries[1][256];
+    static uint8_t pages[256];
+    for (int i = 0; i < 256; i++) entries[0][i] = 0xFFFF;
+    pages[SDO.OD[1].index >> 8] = 1;
+    entries[0][SDO.OD[1].index & 0xFF] = 0;
+    entries[0][(SDO.OD[1].index + 1) & 0xFF] = 1;
+    const CO_OD_index_t corrupted = {pages, entries};
+    SDO.ODIndex = &corrupted;
+    uint16_t wrong = CO_OD_find(&SDO, SDO.OD[1].index), absent = CO_OD_find(&SDO, (uint16_t)(SDO.OD[1].index + 1));
+    SDO.ODIndex = NULL;
+    if (wrong != 1 || absent != CO_OD_find(&SDO, (uint16_t)(SDO.OD[1].index + 1))) {
+        std::cout << "Entries of the index table pointing to another index are used" << std::endl;
+        return 1;
+    }
+    std::cout << "Entries of the index table pointing to another index are searched" << std::endl;
+
+    const char *names[] = {"binary search", "index table"};
+    const CO_OD_index_t *tables[] = {NULL, &CO_OD_index};
+    for (int t = 0; t < 2; t++) {
+        SDO.ODIndex = tables[t];
+        timespec start, mid, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        unsigned long found = scan(&SDO, repetitions);
+        clock_gettime(CLOCK_MONOTONIC, &mid);
+        unsigned long length = remap(&SDO, repetitions * 100);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        std::cout << names[t] << ": SDO scan " << elapsed(start, mid) / (repetitions * 65536.0) * 1e9
+                  << " ns/lookup (" << found / repetitions << " entries), PDO remapping "
+                  << elapsed(mid, end) / (repetitions * 100) * 1e6 << " us/all PDOs (" << length / (repetitions * 100)
+                  << " bytes mapped)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * \file testODStorage.cpp
+ * \author William Campbell
+ * \brief A script to test the double-buffered OD storage: save and load, fallback to the other slot on
+ * corruption, restore of the default values and import of the old file format
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "CANopen.h"
+#include "CO_OD_storage.h"
+#include "crc16-ccitt.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+/* memory block of 600 bytes: three pages */
+static const uint32_t odSize = 600;
+
+static std::string readFile(const std::string &name) {
+    std::ifstream file(name, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string &name, const std::string &content) {
+    std::ofstream file(name, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+static void fill(uint8_t *od, uint8_t value) {
+    for (uint32_t i = 0; i < odSize; i++) {
+        od[i] = (uint8_t)(value + i);
+    }
+}
+
+static bool filled(const uint8_t *od, uint8_t value) {
+    for (uint32_t i = 0; i < odSize; i++) {
+        if (od[i] != (uint8_t)(value + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* open the storage into a fresh memory block (zeroes: the default values), then unmap it */
+static CO_ReturnError_t load(const std::string &name, uint8_t *od) {
+    CO_OD_storage_t storage;
+    memset(od, 0, odSize);
+    CO_ReturnError_t ret = CO_OD_storage_init(&storage, od, odSize, (char *)name.c_str());
+    CO_OD_storage_autoSaveClose(&storage);
+    return ret;
+}
+
+static bool zero(const uint8_t *od) {
+    for (uint32_t i = 0; i < odSize; i++) {
+        if (od[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    char directory[] = "/tmp/testODStorageXXXXXX";
+    if (mkdtemp(directory) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+    std::string name = std::string(directory) + "/od.persist";
+    uint8_t od[odSize], loaded[odSize];
+
+    std::cout << "1. Save and load\n";
+    {
+        CO_OD_storage_t storage;
+        check(CO_OD_storage_init(&storage, od, odSize, (char *)name.c_str()) == CO_ERROR_NO, "new file");
+        fill(od, 1);
+        check(CO_OD_storage_saveSecure(&storage) == 0, "saved");
+        fill(od, 2);
+        check(CO_OD_storage_saveSecure(&storage) == 0, "saved again, into the other slot");
+        CO_OD_storage_autoSaveClose(&storage);
+        check(load(name, loaded) == CO_ERROR_NO && filled(loaded, 2), "newest slot loaded");
+    }
+
+    std::cout << "2. Slot fallback on corruption\n";
+    {
+        // the newest slot (the second one) is in the second half of the file
+        std::string content = readFile(name);
+        content[content.size() - 8] ^= 0xFF;
+        writeFile(name, content);
+        check(load(name, loaded) == CO_ERROR_NO && filled(loaded, 1), "corrupt newest slot: older slot loaded");
+        content[content.size() / 2 - 8] ^= 0xFF;
+        writeFile(name, content);
+        check(load(name, loaded) == CO_ERROR_CRC && zero(loaded), "both slots corrupt: CRC error, default values");
+    }
+
+    std::cout << "3. Restore default values\n";
+    {
+        CO_OD_storage_t storage;
+        CO_OD_storage_init(&storage, od, odSize, (char *)name.c_str());
+        fill(od, 3);
+        CO_OD_storage_saveSecure(&storage);
+        check(CO_OD_storage_restoreSecure(&storage) == 0, "restored");
+        CO_OD_storage_autoSaveClose(&storage);
+        check(load(name, loaded) == CO_ERROR_NO && zero(loaded), "default values on the next start");
+    }
+
+    std::cout << "4. Old file format\n";
+    {
+        std::string legacy(odSize + 2, '\0');
+        fill((uint8_t *)&legacy[0], 4);
+        uint16_t CRC = crc16_ccitt((unsigned char *)&legacy[0], odSize, 0);
+        memcpy(&legacy[odSize], &CRC, 2);
+        writeFile(name, legacy);
+        check(load(name, loaded) == CO_ERROR_NO && filled(loaded, 4), "imported");
+        check(readFile(name).size() != legacy.size() && load(name, loaded) == CO_ERROR_NO && filled(loaded, 4),
+              "converted to the slot format");
+
+        std::string backup = name + ".bak";
+        legacy[10] ^= 0xFF;
+        writeFile(name, legacy);
+        check(load(name, loaded) == CO_ERROR_CRC && zero(loaded), "CRC error: default values");
+        check(readFile(backup) == legacy, "file kept as backup, unchanged");
+        check(load(name, loaded) == CO_ERROR_NO, "storage usable again");
+
+        legacy.resize(odSize - 100);
+        writeFile(name, legacy);
+        check(load(name, loaded) == CO_ERROR_DATA_CORRUPT && readFile(backup) == legacy,
+              "file of a different memory block: kept as backup");
+
+        writeFile(name, "-\n");
+        check(load(name, loaded) == CO_ERROR_NO && zero(loaded), "\"-\" file: default values");
+        unlink(backup.c_str());
+    }
+
+    unlink(name.c_str());
+    rmdir(directory);
+    return checkSummary();
+}
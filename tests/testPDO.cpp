@@ -0,0 +1,371 @@
+/**
+ * \file testPDO.cpp
+ * \author William Campbell
+ * \brief A script to check and benchmark copying of PDO data between CAN messages and the Object Dictionary.
+ *
+ * All 32 RPDOs and 32 TPDOs are initialised from the mapping of the Object Dictionary (no CAN interface is
+ * needed, TPDOs are written to /dev/null). The data of every mapped object is checked against the mapping
+ * parameters and, for the first drive, against the CiA 402 drive layout (PDOMapping pack/unpack). Age of the
+ * received data and multiplexed setpoints are checked, then three paths are timed:
+ *  - RPDO: CAN receive callback and CO_RPDO_process() (message copied into the OD variables);
+ *  - TPDO: CO_TPDOsend() (OD variables copied into the message and sent);
+ *  - COS: CO_TPDOisCOS() (change of state detection, no change).
+ *
+ * Usage: testPDO [repetitions]
+ * \version 0.1
+ * \date 2020-07-08
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iostream>
+
+#include "CANopen.h"
+#include "CO_OD_motors.h"
+#include "CO_setpointMux.h"
+#include "CO_ipBuffer.h"
+#include "PDOMapping.h"
+
+extern const CO_OD_entry_t CO_OD[CO_OD_NoOfElements];
+extern const CO_OD_index_t CO_OD_index;
+
+static CO_OD_extension_t ODExtensions[CO_OD_NoOfElements];
+static CO_CANrx_t rxArray[CO_NO_RPDO];
+static CO_CANtx_t txArray[CO_NO_TPDO];
+static CO_RPDO_t RPDO[CO_NO_RPDO];
+static CO_TPDO_t TPDO[CO_NO_TPDO];
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+static double elapsed(const timespec &start, const timespec &end) {
+    return end.tv_sec - start.tv_sec + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/**
+ * \brief Check the PDO data against the OD variables, following the mapping parameters byte by byte
+ *
+ * \return true if every mapped (non dummy) byte matches
+ */
+static bool matchesMapping(CO_SDO_t *SDO, const uint32_t *mapped, uint8_t noOfMapped, const uint8_t *data) {
+    int offset = 0;
+    for (int i = 0; i < noOfMapped; i++) {
+        uint16_t index = (uint16_t)(mapped[i] >> 16);
+        uint8_t subIndex = (uint8_t)(mapped[i] >> 8);
+        int length = (uint8_t)mapped[i] >> 3;
+        if (index > 7) {
+            uint16_t entryNo = CO_OD_find(SDO, index);
+            const uint8_t *pData = (const uint8_t *)CO_OD_getDataPointer(SDO, entryNo, subIndex);
+            if (memcmp(pData, &data[offset], length) != 0) {
+                return false;
+            }
+        }
+        offset += length;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    int repetitions = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    CO_SDO_t SDO = {};
+    SDO.OD = CO_OD;
+    SDO.ODSize = CO_OD_NoOfElements;
+    SDO.ODExtensions = ODExtensions;
+    CO_OD_setIndex(&SDO, &CO_OD_index);
+
+    CO_CANmodule_t CANmodule = {};
+    CANmodule.rxArray = rxArray;
+    CANmodule.rxSize = CO_NO_RPDO;
+    CANmodule.txArray = txArray;
+    CANmodule.txSize = CO_NO_TPDO;
+    CANmodule.filter = (struct can_filter *)calloc(CO_NO_RPDO, sizeof(struct can_filter));
+    CANmodule.fd = open("/dev/null", O_WRONLY);
+
+    CO_EM_t em = {};
+    CO_SYNC_t SYNC = {};
+    CO_NMT_internalState_t operatingState = CO_NMT_OPERATIONAL;
+
+    int noOfRPDO = 0, noOfTPDO = 0;
+    for (int i = 0; i < CO_NO_RPDO; i++) {
+        CO_RPDO_init(&RPDO[i], &em, &SDO, &SYNC, &operatingState, NULL, 1, 0, 0,
+                     (CO_RPDOCommPar_t *)&OD_RPDOCommunicationParameter[i], (CO_RPDOMapPar_t *)&OD_RPDOMappingParameter[i],
+                     OD_H1400_RXPDO_1_PARAM + i, OD_H1600_RXPDO_1_MAPPING + i, &CANmodule, i);
+        noOfRPDO += RPDO[i].valid;
+    }
+    for (int i = 0; i < CO_NO_TPDO; i++) {
+        CO_TPDO_init(&TPDO[i], &em, &SDO, &operatingState, NULL, 1, 0, 0,
+                     (CO_TPDOCommPar_t *)&OD_TPDOCommunicationParameter[i], (CO_TPDOMapPar_t *)&OD_TPDOMappingParameter[i],
+                     OD_H1800_TXPDO_1_PARAM + i, OD_H1A00_TXPDO_1_MAPPING + i, &CANmodule, i);
+        noOfTPDO += TPDO[i].valid;
+    }
+    std::cout << noOfRPDO << " valid RPDOs, " << noOfTPDO << " valid TPDOs" << std::endl;
+
+    /* Received data must end up in the mapped OD variables */
+    CO_CANrxMsg_t msg = {};
+    msg.DLC = 8;
+    for (int i = 0; i < CO_NO_RPDO; i++) {
+        if (!RPDO[i].valid) continue;
+        for (int b = 0; b < 8; b++) msg.data[b] = (uint8_t)rand();
+        rxArray[i].pFunct(rxArray[i].object, &msg);
+        CO_RPDO_process(&RPDO[i], false);
+        if (!matchesMapping(&SDO, &OD_RPDOMappingParameter[i].mappedObject1, OD_RPDOMappingParameter[i].numberOfMappedObjects, msg.data)) {
+            std::cout << "RPDO " << i + 1 << " data does not match its mapping" << std::endl;
+            return 1;
+        }
+    }
+    /* Age of the received data counts SYNC cycles, missed cycles are counted with the next message */
+    for (int i = 0; i < CO_NO_RPDO; i++) {
+        if (!RPDO[i].valid) continue;
+        rxArray[i].pFunct(rxArray[i].object, &msg);
+        CO_RPDO_process(&RPDO[i], false);
+        uint32_t missed = RPDO[i].missedCycles;
+        SYNC.cycle += 3;
+        if (CO_RPDO_getAge(&RPDO[i]) != 3) {
+            std::cout << "RPDO " << i + 1 << " age is " << CO_RPDO_getAge(&RPDO[i]) << ", expected 3" << std::endl;
+            return 1;
+        }
+        rxArray[i].pFunct(rxArray[i].object, &msg);
+        CO_RPDO_process(&RPDO[i], false);
+        if (CO_RPDO_getAge(&RPDO[i]) != 0 || RPDO[i].missedCycles != missed + 2) {
+            std::cout << "RPDO " << i + 1 << " freshness is not updated on reception" << std::endl;
+            return 1;
+        }
+        if (!CO_RPDO_isMapped(&RPDO[i], RPDO[i].mapOps[0].pData)) {
+            std::cout << "RPDO " << i + 1 << " does not report its mapped variable" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "RPDO data age and missed cycles are counted" << std::endl;
+
+    /* Sent data must come from the mapped OD variables */
+    for (int i = 0; i < CO_NO_TPDO; i++) {
+        if (!TPDO[i].valid) continue;
+        CO_TPDOsend(&TPDO[i]);
+        if (!matchesMapping(&SDO, &OD_TPDOMappingParameter[i].mappedObject1, OD_TPDOMappingParameter[i].numberOfMappedObjects, TPDO[i].CANtxBuff->data)) {
+            std::cout << "TPDO " << i + 1 << " data does not match its mapping" << std::endl;
+            return 1;
+        }
+        if (CO_TPDOisCOS(&TPDO[i])) {
+            std::cout << "TPDO " << i + 1 << " detects change of state right after it was sent" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "PDO data matches the mapping of all valid PDOs" << std::endl;
+
+    /* PDOs of the first drive, packed and unpacked as the drive does with the CiA 402 layout */
+    CO_RPDO_t *actualRPDO = NULL;
+    CO_RPDO_t *bufferRPDO = NULL;
+    CO_TPDO_t *targetTPDO = NULL;
+    for (int i = 0; i < CO_NO_RPDO; i++) {
+        if (RPDO[i].valid && CO_RPDO_isMapped(&RPDO[i], CO_OD_motors[0].actualPosition)) actualRPDO = &RPDO[i];
+        if (RPDO[i].valid && CO_RPDO_isMapped(&RPDO[i], CO_OD_motors[0].ipBufferPosition)) bufferRPDO = &RPDO[i];
+    }
+    for (int i = 0; i < CO_NO_TPDO; i++) {
+        if (TPDO[i].valid && CO_TPDO_isMapped(&TPDO[i], CO_OD_motors[0].targetPosition)) targetTPDO = &TPDO[i];
+    }
+    if (actualRPDO == NULL || bufferRPDO == NULL || targetTPDO == NULL) {
+        std::cout << "No PDO maps the actual position, buffer position or target position of drive 1" << std::endl;
+        return 1;
+    }
+    if (OD_RPDOCommunicationParameter[bufferRPDO - RPDO].COB_IDUsedByRPDO != 0x400 + 0x80 + 1) {
+        std::cout << "Buffer position of drive 1 is not received from its TPDO4" << std::endl;
+        return 1;
+    }
+    memset(msg.data, 0, sizeof(msg.data));
+    CiA402PDOLayout::TPDO2::pack(msg.data, -123456, 7890);
+    rxArray[actualRPDO - RPDO].pFunct(rxArray[actualRPDO - RPDO].object, &msg);
+    CO_RPDO_process(actualRPDO, false);
+    CiA402PDOLayout::TPDO4IP::pack(msg.data, 12);
+    rxArray[bufferRPDO - RPDO].pFunct(rxArray[bufferRPDO - RPDO].object, &msg);
+    CO_RPDO_process(bufferRPDO, false);
+    *CO_OD_motors[0].targetPosition = -654321;
+    CO_TPDOsend(targetTPDO);
+    int32_t target = 0;
+    CiA402PDOLayout::RPDO3::unpack(targetTPDO->CANtxBuff->data, target);
+    if (*CO_OD_motors[0].actualPosition != -123456 || *CO_OD_motors[0].actualVelocity != 7890 || *CO_OD_motors[0].ipBufferPosition != 12 ||
+        target != -654321) {
+        std::cout << "PDOs of drive 1 do not match the CiA 402 drive layout" << std::endl;
+        return 1;
+    }
+    std::cout << "PDOs of drive 1 match the CiA 402 drive layout" << std::endl;
+
+    /* Target positions of the first three drives in two frames: sent absolute when changed, then repeated */
+    CO_TPDO_t *TPDOptr[CO_NO_TPDO];
+    for (int i = 0; i < CO_NO_TPDO; i++) TPDOptr[i] = &TPDO[i];
+    CO_setpointMux_t mux;
+    CO_setpointMux_init(&mux, &CANmodule, 0x680, 2);
+    for (int i = 0; i < 3; i++) {
+        if (CO_setpointMux_addSlot(&mux, CO_OD_motors[i].targetPosition, TPDOptr, CO_NO_TPDO) != CO_ERROR_NO) {
+            std::cout << "No TPDO maps the target position of drive " << i + 1 << std::endl;
+            return 1;
+        }
+        *CO_OD_motors[i].targetPosition = -100000 * (i + 1);
+    }
+    int32_t expectedFrames[] = {2, 4, 6, 7, 7};
+    for (int r = 0; r < 5; r++) {
+        if (r == 1) *CO_OD_motors[0].targetPosition += 40000;
+        CO_setpointMux_process(&mux);
+        for (int i = 0; i < 3; i++) {
+            const uint8_t *data = &mux.CANtxBuff[i / 2].data[4 * (i % 2)];
+            int32_t sent = (int32_t)((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+            if (sent != *CO_OD_motors[i].targetPosition || CO_TPDOisCOS(mux.slots[i].TPDO)) {
+                std::cout << "Setpoint of drive " << i + 1 << " is not multiplexed correctly" << std::endl;
+                return 1;
+            }
+        }
+        if ((int32_t)mux.noOfFrames != expectedFrames[r] || mux.CANtxBuff[0].DLC != 8 || mux.CANtxBuff[1].DLC != 4 ||
+            mux.CANtxBuff[1].ident != 0x681) {
+            std::cout << "Multiplexed frames are not sent when changed, then repeated" << std::endl;
+            return 1;
+        }
+    }
+    operatingState = CO_NMT_PRE_OPERATIONAL;
+    CO_setpointMux_process(&mux);
+    operatingState = CO_NMT_OPERATIONAL;
+    CO_setpointMux_process(&mux);
+    if (mux.noOfFrames != 7 + 2) {
+        std::cout << "Multiplexed setpoints are not sent again when operational" << std::endl;
+        return 1;
+    }
+    std::cout << "Setpoints of 3 drives are multiplexed into two frames" << std::endl;
+
+    /* Interpolated position buffers of two drives: topped up to the lead, one point taken per SYNC while active */
+    CO_ipBuffer_t ip;
+    CO_ipBuffer_init(&ip, &SYNC, 16, 4, 2);
+    for (int i = 0; i < 2; i++) {
+        if (CO_ipBuffer_addAxis(&ip, CO_OD_motors[i].targetPosition, CO_OD_motors[i].statusWord, TPDOptr, CO_NO_TPDO, NULL, NULL, 0) != CO_ERROR_NO) {
+            std::cout << "No TPDO maps the target position of drive " << i + 1 << std::endl;
+            return 1;
+        }
+        *CO_OD_motors[i].statusWord = 0;
+    }
+    for (int k = 0; k < 10; k++) {
+        int32_t sample[2] = {1000 + k, 2000 + k};
+        CO_ipBuffer_push(&ip, sample);
+    }
+    CO_ipBuffer_finish(&ip);
+    for (int r = 0; r < 3; r++) CO_ipBuffer_process(&ip);
+    if (ip.axes[0].level != 4 || ip.axes[1].noOfSent != 4 || *CO_OD_motors[1].targetPosition != 2003 || CO_TPDOisCOS(ip.axes[1].TPDO)) {
+        std::cout << "Interpolated position buffers are not topped up to the lead" << std::endl;
+        return 1;
+    }
+    *CO_OD_motors[0].statusWord = CO_IP_BUFFER_STATUS_ACTIVE;
+    SYNC.cycle++;
+    CO_ipBuffer_process(&ip);
+    if (ip.axes[0].noOfSent != 5 || ip.axes[1].noOfSent != 4 || CO_ipBuffer_getNoOfTaken(&ip) != 0) {
+        std::cout << "Interpolated position buffer levels do not follow the active drives" << std::endl;
+        return 1;
+    }
+    *CO_OD_motors[1].statusWord = CO_IP_BUFFER_STATUS_ACTIVE;
+    for (int r = 0; r < 20; r++) {
+        SYNC.cycle++;
+        CO_ipBuffer_process(&ip);
+    }
+    if (!CO_ipBuffer_isDone(&ip) || ip.axes[0].noOfUnderruns != 0 || ip.axes[1].noOfUnderruns != 0) {
+        std::cout << "Interpolated position motion is not done without underruns" << std::endl;
+        return 1;
+    }
+    CO_ipBuffer_clear(&ip);
+    int32_t sample[2] = {0, 0};
+    CO_ipBuffer_push(&ip, sample);
+    CO_ipBuffer_process(&ip);
+    SYNC.cycle += 3;
+    CO_ipBuffer_process(&ip);
+    if (ip.axes[0].noOfUnderruns != 2 || CO_ipBuffer_getFree(&ip) != CO_IP_BUFFER_RING_SIZE) {
+        std::cout << "Interpolated position buffer underruns are not counted" << std::endl;
+        return 1;
+    }
+    *CO_OD_motors[0].statusWord = *CO_OD_motors[1].statusWord = 0;
+    std::cout << "Interpolated position buffers are fed ahead of the drives" << std::endl;
+
+    /* Interpolated position buffer level from the buffer position sent by the drive every SYNC */
+    CO_RPDO_t *RPDOptr[CO_NO_RPDO];
+    for (int i = 0; i < CO_NO_RPDO; i++) RPDOptr[i] = &RPDO[i];
+    CO_ipBuffer_init(&ip, &SYNC, 16, 4, 2);
+    if (CO_ipBuffer_addAxis(&ip, CO_OD_motors[0].targetPosition, CO_OD_motors[0].statusWord, TPDOptr, CO_NO_TPDO,
+                            CO_OD_motorUnmapped.ipBufferPosition, RPDOptr, CO_NO_RPDO) != CO_ERROR_ILLEGAL_ARGUMENT ||
+        CO_ipBuffer_addAxis(&ip, CO_OD_motors[0].targetPosition, CO_OD_motors[0].statusWord, TPDOptr, CO_NO_TPDO,
+                            CO_OD_motors[0].ipBufferPosition, RPDOptr, CO_NO_RPDO) != CO_ERROR_NO) {
+        std::cout << "Buffer position is not checked against the RPDOs" << std::endl;
+        return 1;
+    }
+    for (int32_t k = 0; k < 10; k++) {
+        CO_ipBuffer_push(&ip, &k);
+    }
+    *CO_OD_motors[0].ipBufferPosition = 0;
+    *CO_OD_motors[0].statusWord = CO_IP_BUFFER_STATUS_ACTIVE;
+    for (int r = 0; r < 2; r++) CO_ipBuffer_process(&ip);
+    // drive took one point and lost another one: 2 points left instead of 3
+    SYNC.cycle++;
+    *CO_OD_motors[0].ipBufferPosition = 2;
+    CO_ipBuffer_process(&ip);
+    if (ip.axes[0].noOfSent != 6 || ip.axes[0].level != 4) {
+        std::cout << "Interpolated position buffer level does not follow the buffer position of the drive" << std::endl;
+        return 1;
+    }
+    *CO_OD_motors[0].statusWord = 0;
+    *CO_OD_motors[0].ipBufferPosition = 0;
+    std::cout << "Interpolated position buffer level follows the buffer position of the drive" << std::endl;
+
+    timespec start, end;
+    unsigned long n = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < repetitions; r++) {
+        for (int i = 0; i < CO_NO_RPDO; i++) {
+            if (!RPDO[i].valid) continue;
+            msg.data[0] = (uint8_t)r;
+            rxArray[i].pFunct(rxArray[i].object, &msg);
+            CO_RPDO_process(&RPDO[i], false);
+            n++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    std::cout << "RPDO receive and process: " << elapsed(start, end) / n * 1e9 << " ns/PDO" << std::endl;
+
+    n = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < repetitions / 10; r++) {
+        for (int i = 0; i < CO_NO_TPDO; i++) {
+            if (!TPDO[i].valid) continue;
+            CO_TPDOsend(&TPDO[i]);
+            n++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    std::cout << "TPDO send (including write() to /dev/null): " << elapsed(start, end) / n * 1e9 << " ns/PDO" << std::endl;
+
+    n = 0;
+    unsigned long changed = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < repetitions; r++) {
+        for (int i = 0; i < CO_NO_TPDO; i++) {
+            if (!TPDO[i].valid) continue;
+            changed += CO_TPDOisCOS(&TPDO[i]);
+            n++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    std::cout << "TPDO change of state: " << elapsed(start, end) / n * 1e9 << " ns/PDO (" << changed << " changed)" << std::endl;
+
+    close(CANmodule.fd);
+    free(CANmodule.filter);
+    return 0;
+}
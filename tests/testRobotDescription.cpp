@@ -0,0 +1,109 @@
+/**
+ * \file testRobotDescription.cpp
+ * \author William Campbell
+ * \brief A script to test the robot description parser: a valid description, and the errors which must reject a
+ * description and leave the current one unchanged (duplicate joint or node, joint out of order, missing keys,
+ * invalid values)
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "CANopen.h"
+#include "JointCalibration.h"
+#include "RobotDescription.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+static const std::string hip = "joint id=0 name=left_hip drive=copley node=1 min=70 max=210 known=250880:90,0:180\n";
+static const std::string knee = "joint id=1 name=left_knee drive=copley node=2 min=0 max=120 known=250880:90,0:0\n";
+
+static bool parse(RobotDescription &description, const std::string &text) {
+    std::istringstream input(text);
+    return description.parse(input, "test");
+}
+
+/* the description is rejected, and the valid one parsed before is kept */
+static void checkRejected(const std::string &text, const char *what) {
+    RobotDescription description;
+    parse(description, hip + knee);
+    check(!parse(description, text) && description.joints.size() == 2 && description.joints[1].name == "left_knee", what);
+}
+
+int main() {
+    std::cout << "1. Valid description\n";
+    {
+        RobotDescription description;
+        check(parse(description, "# Alex\n\n" + hip + "joint drive=schneider min=0 max=120 known=0:0,1000:10 homing=hardstop:-500 home=5 # ankle\n"),
+              "parsed, with comments and empty lines");
+        const JointDescription *ankle = description.getJoint(1);
+        check(description.joints.size() == 2 && ankle != NULL && ankle->nodeID == 2 && ankle->homing == "hardstop" &&
+                  ankle->homingVelocity == -500 && ankle->hasHome && ankle->home == 5,
+              "defaults: ID of the line, node ID + 1");
+
+        // known positions less than a count apart are used as described, not truncated to the same count
+        check(parse(description, "joint drive=schneider min=0 max=10 known=0.25:0,0.75:10\n"), "fractional known positions parsed");
+        const JointDescription &joint = description.joints[0];
+        check(joint.driveA == 0.25 && joint.driveB == 0.75 &&
+                  JointCalibration(joint.driveA, joint.jointA, joint.driveB, joint.jointB).fromDriveUnits(1) == 15,
+              "fractional known positions kept, 20 degrees per count");
+    }
+
+    std::cout << "2. Joints and nodes\n";
+    {
+        checkRejected(hip + hip, "joint described twice");
+        checkRejected(hip + "joint id=1 drive=copley node=1 min=0 max=120 known=250880:90,0:0\n", "node used by two joints");
+        RobotDescription twoBuses;
+        check(parse(twoBuses, hip + "joint id=1 drive=copley node=1 bus=1 min=0 max=120 known=250880:90,0:0\n"), "same node on another bus");
+        checkRejected(knee + hip, "joints out of order");
+        checkRejected(hip + "joint id=2 drive=copley node=3 min=0 max=120 known=250880:90,0:0\n", "joint ID skipped");
+        checkRejected("joint id=-1 drive=copley min=0 max=120 known=250880:90,0:0\n", "negative joint ID");
+        checkRejected("# nothing\n", "no joints");
+        checkRejected(hip + "motor id=1\n", "unknown keyword");
+    }
+
+    std::cout << "3. Missing keys\n";
+    {
+        checkRejected("joint min=70 max=210 known=250880:90,0:180\n", "no drive type");
+        checkRejected("joint drive=copley max=210 known=250880:90,0:180\n", "no min");
+        checkRejected("joint drive=copley min=70 known=250880:90,0:180\n", "no max");
+        checkRejected("joint drive=copley min=70 max=210\n", "no known positions");
+        checkRejected("joint drive=copley min=70 max=210 known=0:90,1000:180 homing=hardstop:100\n", "hardstop homing without home");
+    }
+
+    std::cout << "4. Invalid values\n";
+    {
+        checkRejected("joint drive=copley min=70 max=210 known=250880:90,0:180 speed=3\n", "unknown key");
+        checkRejected("joint drive=copley min=70 max=210 known=250880:90,0:180 node\n", "field without value");
+        checkRejected("joint drive=copley node=128 min=70 max=210 known=250880:90,0:180\n", "node ID out of range");
+        checkRejected("joint drive=copley node=1x min=70 max=210 known=250880:90,0:180\n", "trailing characters");
+        checkRejected("joint drive=copley min=210 max=70 known=250880:90,0:180\n", "min above max");
+        checkRejected("joint drive=copley min=70 max=210 known=250880:90;0:180\n", "known positions badly separated");
+        checkRejected("joint drive=copley min=70 max=210 known=0:90,0:180\n", "known positions at the same count");
+        checkRejected("joint drive=copley min=70 max=210 known=250880:90,0:180 setpoints=sdo\n", "unknown setpoints");
+        checkRejected("joint drive=copley min=70 max=210 known=250880:90,0:180 homing=200\n", "homing method out of range");
+        checkRejected("joint drive=copley min=70 max=210 known=250880:90,0:180 homing=hardstop:0 home=90\n", "hardstop velocity 0");
+        checkRejected("joint drive=copley min=70 max=210 known=250880:90,0:180 torque=abc\n", "torque not a number");
+    }
+
+    return checkSummary();
+}
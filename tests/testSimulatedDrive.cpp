@@ -0,0 +1,121 @@
+/**
+ * \file testSimulatedDrive.cpp
+ * \author William Campbell
+ * \brief A script to test the simulated drive: state machine, modes, faults and determinism
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <cmath>
+#include <iostream>
+
+#include "CANopen.h"
+#include "SimulatedDrive.h"
+#include "TestCheck.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+/* Move the drive to 100000 counts in position control for the given time, return the final position */
+static double moveTo(SimulatedJointModel model, double seconds) {
+    SimulatedDrive drive(1, model);
+    drive.initPosControl(motorProfile{4000000, 190000, 190000});
+    drive.readyToSwitchOn();
+    drive.enable();
+    drive.setPos(100000);
+    for (int i = 0; i < seconds / 0.008; i++) {
+        SimulatedDrive::stepAll(0.008);
+    }
+    return drive.getTruePosition();
+}
+
+int main() {
+    std::cout << "1. Power drive state machine\n";
+    {
+        SimulatedDrive drive(1);
+        SimulatedDrive::stepAll(0.008);
+        drive.updateDriveStatus();
+        check(drive.getCiA402State() == CIA402_SWITCH_ON_DISABLED, "switch on disabled at start");
+        drive.readyToSwitchOn();
+        SimulatedDrive::stepAll(0.008);
+        drive.updateDriveStatus();
+        check(drive.getCiA402State() == CIA402_READY_TO_SWITCH_ON, "ready to switch on after 0x06");
+        drive.enable();
+        SimulatedDrive::stepAll(0.008);
+        drive.updateDriveStatus();
+        check(drive.getCiA402State() == CIA402_OPERATION_ENABLED, "operation enabled after 0x0F");
+        drive.injectFault();
+        drive.updateDriveStatus();
+        check(drive.getCiA402State() == CIA402_FAULT && drive.getDriveState() == DISABLED, "fault disables the drive");
+        drive.resetFault();
+        SimulatedDrive::stepAll(0.008);
+        drive.updateDriveStatus();
+        check(drive.getCiA402State() == CIA402_SWITCH_ON_DISABLED, "fault reset");
+    }
+
+    std::cout << "2. Position control follows the profile\n";
+    {
+        SimulatedJointModel model;
+        double position = moveTo(model, 0.1);
+        check(position > 0 && position < 100000, "profile velocity limits the motion");
+        position = moveTo(model, 2);
+        check(std::fabs(position - 100000) < 100, "target reached");
+    }
+
+    std::cout << "3. Velocity and torque control\n";
+    {
+        SimulatedDrive drive(2);
+        drive.initVelControl(motorProfile{0, 0, 0});
+        drive.readyToSwitchOn();
+        drive.enable();
+        drive.setVel(20000);
+        for (int i = 0; i < 125; i++) {
+            SimulatedDrive::stepAll(0.008);
+        }
+        check(std::fabs(drive.getVel() - 20000) < 2000, "velocity follows the target");
+        drive.initTorqueControl();
+        drive.setTorque(0);
+        int before = drive.getVel();
+        for (int i = 0; i < 125; i++) {
+            SimulatedDrive::stepAll(0.008);
+        }
+        check(std::abs(drive.getVel()) < std::abs(before), "joint slows down without torque");
+    }
+
+    std::cout << "4. Noise, latency and determinism\n";
+    {
+        SimulatedJointModel model;
+        model.positionNoise = 5;
+        model.latency = 3;
+        double first = moveTo(model, 0.5);
+        double second = moveTo(model, 0.5);
+        check(first == second, "same run gives the same result");
+
+        SimulatedDrive drive(3, model);
+        drive.initPosControl(motorProfile{4000000, 190000, 190000});
+        drive.readyToSwitchOn();
+        drive.enable();
+        drive.setPos(100000);
+        for (int i = 0; i < 10; i++) {
+            SimulatedDrive::stepAll(0.008);
+        }
+        check(drive.getPos() < drive.getTruePosition() - 1000, "feedback lags the joint");
+        check(drive.getFeedbackAge() == 0, "feedback written every step");
+    }
+
+    return checkSummary();
+}
@@ -0,0 +1,97 @@
+/**
+ * \file testTrackingMonitor.cpp
+ * \author William Campbell
+ * \brief A script to test the following error monitor: RMS and maximum error of a motion, and its limits
+ * \version 0.1
+ * \date 2020-10-19
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+#include <cmath>
+#include <iostream>
+
+#include "CANopen.h"
+#include "TestCheck.h"
+#include "TrackingMonitor.h"
+
+pthread_mutex_t CO_CAN_VALID_mtx = PTHREAD_MUTEX_INITIALIZER;
+volatile uint32_t CO_timer1ms = 0U;
+
+/* Helper functions ***********************************************************/
+void CO_errExit(char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* send CANopen generic emergency message */
+void CO_error(const uint32_t info) {
+    CO_errorReport(CO->em, CO_EM_GENERIC_SOFTWARE_ERROR, CO_EMC_SOFTWARE_INTERNAL, info);
+    fprintf(stderr, "canopend generic error: 0x%X\n", info);
+}
+
+int main() {
+    TrackingMonitor monitor;
+    double commanded[2], actual[2];
+
+    std::cout << "1. Errors of a motion\n";
+    {
+        monitor.start(2);
+        // joint 0 lags by 3 and 4 alternately, joint 1 follows exactly
+        for (int k = 0; k < 100; k++) {
+            commanded[0] = k;
+            actual[0] = k - (k % 2 ? 4 : 3);
+            commanded[1] = actual[1] = -k;
+            monitor.update(commanded, actual);
+        }
+        const TrackingSummary &summary = monitor.finish();
+        check(summary.samples[0] == 100 && summary.samples[1] == 100, "every sample counted");
+        check(std::fabs(summary.rms[0] - std::sqrt(12.5)) < 1e-12 && summary.max[0] == 4 && summary.last[0] == 4, "RMS, maximum and last error");
+        check(summary.rms[1] == 0 && summary.max[1] == 0, "no error of the joint following exactly");
+        check(!monitor.isRunning() && !monitor.isExceeded(), "no limits, none exceeded");
+    }
+
+    std::cout << "2. Invalid feedback\n";
+    {
+        uint8_t valid[2] = {1, 0};
+        monitor.start(2);
+        commanded[0] = commanded[1] = 0;
+        actual[0] = 1;
+        actual[1] = 100;
+        monitor.update(commanded, actual, valid);
+        check(monitor.getSummary().samples[1] == 0 && monitor.getSummary().max[1] == 0, "stale joint not counted");
+        check(monitor.getSummary().samples[0] == 1 && monitor.getSummary().max[0] == 1, "other joints counted");
+    }
+
+    std::cout << "3. Limits\n";
+    {
+        TrackingLimits limits;
+        limits.maxError = 10;
+        limits.maxRms = 2;
+        monitor.setLimits(1, limits);
+        monitor.minSamples = 10;
+        monitor.start(2);
+        commanded[0] = actual[0] = 0;
+        commanded[1] = 0;
+        bool ok = true;
+        int k = 0;
+        // a constant error of 5 exceeds the RMS limit only once minSamples samples are in
+        for (actual[1] = 5; ok && k < 100; k++) {
+            ok = monitor.update(commanded, actual);
+        }
+        check(k == 10 && monitor.isExceeded() && monitor.getSummary().exceededJoint == 1 && monitor.getSummary().exceededRms,
+              "RMS limit checked after minSamples");
+
+        monitor.start(2);
+        check(!monitor.isExceeded(), "start() clears the exceeded limit");
+        actual[1] = 1;
+        monitor.update(commanded, actual);
+        actual[1] = -11;
+        check(!monitor.update(commanded, actual) && !monitor.getSummary().exceededRms, "maximum error checked every sample");
+        actual[1] = 0;
+        check(!monitor.update(commanded, actual), "limit stays exceeded");
+        check(monitor.getSummary().samples[1] == 3 && monitor.getSummary().max[1] == 11, "errors still summed");
+    }
+
+    return checkSummary();
+}
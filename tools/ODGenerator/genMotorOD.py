@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""
+Generate the per-motor part of the Object Dictionary (CO_OD.h / CO_OD.c).
+
+The Object Dictionary is generated by libedssharp, which emits every motor
+record (0x6040 controlWords, 0x6064 actualMotorPositions, ...) as a struct with
+members motor1..motorN. This script is run after libedssharp (or on its own, to
+change the number of drives) and rewrites those records from a compact
+description (objDict/motorOD.json):
+
+ - record types become true arrays:  UNSIGNED16 motor[CO_NO_MOTORS];
+ - record tables, OD entries, subindex defines and initial values are sized
+   from "numberOfMotors";
+ - CO_OD_motors.h/.c are emitted with a typed accessor table, one entry per
+   drive, so that Drive objects address their OD entries with a single
+   indexed access instead of pointer arithmetic on the struct layout.
+
+The script is idempotent and may be run on its own output. Run genODIndex.py
+afterwards if the list of OD entries changed.
+
+Usage: genMotorOD.py [path/to/objDict] [--motors N]
+"""
+import json
+import os
+import re
+import sys
+
+TYPE_SIZE = {"UNSIGNED8": 1, "INTEGER8": 1, "UNSIGNED16": 2, "INTEGER16": 2,
+             "UNSIGNED32": 4, "INTEGER32": 4, "REAL32": 4}
+
+HEADER = "/* Generated by tools/ODGenerator/genMotorOD.py from motorOD.json - DON'T EDIT */\n"
+
+
+def sub(pattern, repl, text, what):
+    """re.sub which must replace exactly one occurrence"""
+    result, n = re.subn(pattern, repl, text, count=1, flags=re.S)
+    if n != 1:
+        sys.exit("genMotorOD: can't find " + what)
+    return result
+
+
+def gen_header(h, desc):
+    n = desc["numberOfMotors"]
+
+    # number of motors, next to the other features
+    if "#define CO_NO_MOTORS" in h:
+        h = sub(r"#define CO_NO_MOTORS \d+[^\n]*", "#define CO_NO_MOTORS %d  //Number of motor drives, see CO_OD_motors.h" % n,
+                h, "CO_NO_MOTORS")
+    else:
+        h = sub(r"(#define CO_NO_NMT_MASTER \d+\n)", r"\1#define CO_NO_MOTORS %d  //Number of motor drives, see CO_OD_motors.h\n" % n,
+                h, "CO_NO_NMT_MASTER")
+
+    for r in desc["records"]:
+        idx = r["index"][2:].lower()
+        name = r["name"]
+        # record type
+        h = sub(r"/\*%s    \*/ typedef struct\s*\{\s*UNSIGNED8 numberOfMotors;.*?\} OD_%s_t;" % (idx, name),
+                "/*%s    */ typedef struct\n{\n    UNSIGNED8 numberOfMotors;\n    %s motor[CO_NO_MOTORS];\n} OD_%s_t;"
+                % (idx, r["type"], name),
+                h, "type of " + name)
+        # subindex defines
+        defines = "".join("\n#define OD_%s_%d_%s_motor%d %d" % (idx, i, name, i, i) for i in range(1, n + 1))
+        h = sub(r"(#define OD_%s_0_%s_maxSubIndex 0)(\n#define OD_%s_\d+_%s_motor\d+ \d+)*" % (idx, name, idx, name),
+                r"\1" + defines, h, "subindexes of " + name)
+    return h
+
+
+def gen_source(c, desc):
+    n = desc["numberOfMotors"]
+
+    for r in desc["records"]:
+        idx = r["index"][2:].lower()
+        name = r["name"]
+        size = TYPE_SIZE[r["type"]]
+        # initial values
+        c = sub(r"/\*%s\*/ \{0x[0-9a-fA-F]+L(, [^,}]+)*\}," % idx,
+                "/*%s*/ {0x%xL%s}," % (idx, n, ("," + " " + r["default"]) * n),
+                c, "initial values of " + name)
+        # record table
+        entries = "".join("\n    {(void *)&CO_OD_RAM.%s.motor[%d], %s, 0x%x}," % (name, i, r["attribute"], size)
+                          for i in range(n))
+        c = sub(r"/\*0x%s\*/ const CO_OD_entryRecord_t OD_record%s\[\d+\] = \{.*?\n\};" % (idx, idx),
+                "/*0x%s*/ const CO_OD_entryRecord_t OD_record%s[%d] = {\n"
+                "    {(void *)&CO_OD_RAM.%s.numberOfMotors, 0x06, 0x1},%s\n};"
+                % (idx, idx, n + 1, name, entries),
+                c, "record table of " + name)
+        # OD entry (max subindex)
+        c = sub(r"\{0x%s, 0x[0-9a-f]+, 0x00, 0, \(void \*\)&OD_record%s\}" % (idx, idx),
+                "{0x%s, 0x%02x, 0x00, 0, (void *)&OD_record%s}" % (idx, n, idx),
+                c, "OD entry of " + name)
+    return c
+
+
+def gen_accessors(desc):
+    records = desc["records"]
+    width = max(len(r["type"]) for r in records)
+
+    h = HEADER
+    h += "/**\n * Per drive accessors of the motor records of the Object Dictionary.\n *\n"
+    h += " * CO_OD_motors[i] points to the subindex i+1 (drive with node ID i+1) of\n"
+    h += " * each motor record. CO_OD_motorUnmapped points to scratch variables and may\n"
+    h += " * be used by drives which have no entry in the Object Dictionary.\n */\n"
+    h += "#ifndef CO_OD_MOTORS_H\n#define CO_OD_MOTORS_H\n\n#include \"CO_OD.h\"\n\n"
+    h += "typedef struct {\n"
+    for r in records:
+        h += "    %s *%s; /* %s %s */\n" % (r["type"].ljust(width), r["accessor"], r["index"], r["name"])
+    h += "} CO_OD_motor_t;\n\n"
+    h += "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n"
+    h += "extern const CO_OD_motor_t CO_OD_motors[CO_NO_MOTORS];\n"
+    h += "extern const CO_OD_motor_t CO_OD_motorUnmapped;\n\n"
+    h += "#ifdef __cplusplus\n}\n#endif\n\n#endif\n"
+
+    c = HEADER
+    c += "#include \"CO_OD_motors.h\"\n\n"
+    c += "const CO_OD_motor_t CO_OD_motors[CO_NO_MOTORS] = {\n"
+    for i in range(desc["numberOfMotors"]):
+        c += "    {" + ", ".join("&CO_OD_RAM.%s.motor[%d]" % (r["name"], i) for r in records) + "},\n"
+    c += "};\n\n"
+    c += "static struct {\n"
+    for r in records:
+        c += "    %s %s;\n" % (r["type"], r["accessor"])
+    c += "} CO_OD_motorScratch;\n\n"
+    c += "const CO_OD_motor_t CO_OD_motorUnmapped = {\n    "
+    c += ",\n    ".join("&CO_OD_motorScratch.%s" % r["accessor"] for r in records)
+    c += "};\n"
+    return h, c
+
+
+def main():
+    args = sys.argv[1:]
+    motors = None
+    if "--motors" in args:
+        i = args.index("--motors")
+        motors = int(args[i + 1])
+        del args[i:i + 2]
+    objDict = args[0] if args else os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../src/core/CANopen/objDict")
+
+    descPath = os.path.join(objDict, "motorOD.json")
+    with open(descPath) as f:
+        desc = json.load(f)
+    if motors is not None:
+        desc["numberOfMotors"] = motors
+        with open(descPath, "w") as f:
+            json.dump(desc, f, indent=4)
+            f.write("\n")
+    if not 1 <= desc["numberOfMotors"] <= 127:
+        sys.exit("genMotorOD: numberOfMotors must be 1-127")
+
+    for fileName, gen in (("CO_OD.h", gen_header), ("CO_OD.c", gen_source)):
+        path = os.path.join(objDict, fileName)
+        with open(path) as f:
+            text = f.read()
+        with open(path, "w") as f:
+            f.write(gen(text, desc))
+
+    h, c = gen_accessors(desc)
+    with open(os.path.join(objDict, "CO_OD_motors.h"), "w") as f:
+        f.write(h)
+    with open(os.path.join(objDict, "CO_OD_motors.c"), "w") as f:
+        f.write(c)
+
+
+if __name__ == "__main__":
+    main()
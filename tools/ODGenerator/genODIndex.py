@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+Generate the direct index table of the Object Dictionary (CO_OD_index.c).
+
+CO_OD_find() looks up an OD entry by its index on every SDO access, PDO
+mapping and CO_OD_configure() call. Without an index table it binary searches
+CO_OD[], which must then be sorted. This script reads the CO_OD[] array from
+CO_OD.c and emits a two-level table (see CO_OD_index_t in CO_SDO.h):
+
+ - page[index >> 8]: 0 if there is no entry with this high byte, otherwise
+   1 + the number of the page in entries[];
+ - entries[page - 1][index & 0xFF]: the entry number in CO_OD[], or 0xFFFF.
+
+Only the pages which hold entries are emitted (about 512 bytes each).
+
+Run it after libedssharp and genMotorOD.py, whenever the list of OD entries
+changes. CO_OD_setIndex() verifies the table against CO_OD[] at startup and
+falls back to the binary search if it is out of date.
+
+Usage: genODIndex.py [path/to/objDict]
+"""
+import os
+import re
+import sys
+
+HEADER = "/* Generated by tools/ODGenerator/genODIndex.py from CO_OD.c - DON'T EDIT */\n"
+
+
+def read_indexes(c):
+    m = re.search(r"const CO_OD_entry_t CO_OD\[CO_OD_NoOfElements\] = \{(.*?)\n\};", c, re.S)
+    if not m:
+        sys.exit("genODIndex: can't find CO_OD[] in CO_OD.c")
+    return [int(i, 16) for i in re.findall(r"^\s*\{(0x[0-9a-fA-F]+),", m.group(1), re.M)]
+
+
+def gen_index(indexes):
+    if len(indexes) >= 0xFFFF:
+        sys.exit("genODIndex: too many OD entries")
+    if len(set(indexes)) != len(indexes):
+        sys.exit("genODIndex: duplicate OD index")
+    if indexes != sorted(indexes):
+        print("genODIndex: warning: CO_OD[] is not sorted, CO_OD_find() requires the index table")
+
+    pages = sorted(set(i >> 8 for i in indexes))
+    pageNo = dict((p, n + 1) for n, p in enumerate(pages))
+    entries = dict((index, n) for n, index in enumerate(indexes))
+
+    c = HEADER
+    c += "#include \"CO_OD.h\"\n#include \"CO_SDO.h\"\n#include \"CO_driver.h\"\n\n"
+    c += "#if CO_OD_NoOfElements != %d\n" % len(indexes)
+    c += "    #error CO_OD_index.c is out of date, run tools/ODGenerator/genODIndex.py\n#endif\n\n"
+
+    c += "static const uint8_t CO_OD_indexPage[256] = {"
+    for h in range(256):
+        c += ("\n    " if h % 16 == 0 else " ") + "%d," % pageNo.get(h, 0)
+    c += "\n};\n\n"
+
+    c += "static const uint16_t CO_OD_indexEntries[%d][256] = {" % len(pages)
+    for p in pages:
+        c += "\n    /*0x%02x00*/ {" % p
+        for low in range(256):
+            c += ("\n        " if low % 16 == 0 else " ") + "0x%04x," % entries.get((p << 8) | low, 0xFFFF)
+        c += "\n    },"
+    c += "\n};\n\n"
+
+    c += "extern const CO_OD_index_t CO_OD_index = {CO_OD_indexPage, CO_OD_indexEntries};\n"
+    return c
+
+
+def main():
+    objDict = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../src/core/CANopen/objDict")
+    with open(os.path.join(objDict, "CO_OD.c")) as f:
+        indexes = read_indexes(f.read())
+    with open(os.path.join(objDict, "CO_OD_index.c"), "w") as f:
+        f.write(gen_index(indexes))
+
+
+if __name__ == "__main__":
+    main()